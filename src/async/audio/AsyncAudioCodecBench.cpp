@@ -0,0 +1,466 @@
+//
+// Benchmark and quality regression test for the Async audio codecs.
+//
+// Canned test signals are run through each available encoder/decoder pair
+// at a number of different codec settings. One CSV line is printed per run
+// so that the output easily can be tracked over time, e.g. by a CI system.
+// The columns are:
+//
+//   codec            - The codec name, as given to AudioEncoder::create
+//   options          - Encoder options used, NAME=VALUE separated by ';'
+//   signal           - The name of the test signal or file
+//   enc_pkt_per_s    - Encoded packets per CPU second (one core)
+//   dec_pkt_per_s    - Decoded packets per CPU second (one core)
+//   streams_per_core - Number of realtime encode+decode streams one core
+//                      can handle
+//   latency_ms       - Algorithmic latency, i.e. buffering in the codec plus
+//                      the signal delay found by cross correlation
+//   bytes_per_s      - Encoded bytes per second of audio
+//   snr_db           - Signal to noise ratio after delay compensation
+//   segsnr_db        - Segmental SNR over 20ms segments, a rough estimate of
+//                      perceived quality for waveform matching codecs
+//
+// Usage: AsyncAudioCodecBench [-c codec] [-s seconds] [file.raw...]
+//
+// Extra files must be raw, signed 16 bit little endian, mono audio sampled
+// at the internal sample rate (normally 16kHz), e.g.
+//
+//   sox speech.wav -r16000 -c1 -b16 -esigned-integer speech.raw
+//
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <cstdint>
+#include <unistd.h>
+
+#include "AsyncAudioEncoder.h"
+#include "AsyncAudioDecoder.h"
+#include "AsyncAudioSink.h"
+
+using namespace std;
+using namespace Async;
+
+
+namespace {
+
+const int BLOCK_SIZE = INTERNAL_SAMPLE_RATE / 50;        // 20ms
+const int MAX_DELAY = INTERNAL_SAMPLE_RATE / 10;         // 100ms
+const int SEGMENT_SIZE = INTERNAL_SAMPLE_RATE / 50;      // 20ms
+
+struct TestSignal
+{
+  string        name;
+  vector<float> samples;
+  bool          periodic;
+};
+
+struct CodecSetting
+{
+  const char *codec;
+  const char *options;
+};
+
+const CodecSetting settings[] =
+{
+  { "RAW",    "" },
+  { "S16",    "" },
+  { "GSM",    "" },
+  { "SPEEX",  "QUALITY=4" },
+  { "SPEEX",  "QUALITY=8" },
+  { "SPEEX",  "QUALITY=8;COMPLEXITY=8" },
+  { "OPUS",   "BITRATE=8000;COMPLEXITY=1" },
+  { "OPUS",   "BITRATE=16000;COMPLEXITY=5" },
+  { "OPUS",   "BITRATE=20000;COMPLEXITY=9" },
+  { "OPUS",   "BITRATE=32000;COMPLEXITY=10" },
+};
+
+
+class SampleCollector : public AudioSink
+{
+  public:
+    vector<float> samples;
+
+    virtual int writeSamples(const float *buf, int count)
+    {
+      samples.insert(samples.end(), buf, buf + count);
+      return count;
+    }
+
+    virtual void flushSamples(void)
+    {
+      sourceAllSamplesFlushed();
+    }
+};
+
+
+struct Packet
+{
+  vector<char>  data;
+  size_t        input_pos;
+};
+
+
+class PacketCollector : public sigc::trackable
+{
+  public:
+    vector<Packet>  packets;
+    size_t          input_pos = 0;
+
+    void write(const void *buf, int size)
+    {
+      const char *ptr = reinterpret_cast<const char*>(buf);
+      packets.push_back(Packet{vector<char>(ptr, ptr + size), input_pos});
+    }
+};
+
+
+double cpuTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+void addTone(vector<float>& buf, double fq, double ampl)
+{
+  for (size_t i=0; i<buf.size(); ++i)
+  {
+    buf[i] += ampl * sin(2.0 * M_PI * fq * i / INTERNAL_SAMPLE_RATE);
+  }
+}
+
+
+  // A crude vowel-like signal: a glottal pulse train with a varying pitch,
+  // shaped by three formant resonators and a syllabic envelope with pauses.
+vector<float> synthSpeech(size_t len)
+{
+  static const double formants[][2] =
+  {
+    { 700, 130 }, { 1220, 70 }, { 2600, 160 }
+  };
+  vector<float> buf(len, 0.0f);
+  double phase = 0.0;
+  double y[3][2] = {{0}};
+  unsigned rnd = 1;
+  for (size_t i=0; i<len; ++i)
+  {
+    double t = static_cast<double>(i) / INTERNAL_SAMPLE_RATE;
+    double f0 = 140.0 + 40.0 * sin(2.0 * M_PI * 0.7 * t);
+    phase += f0 / INTERNAL_SAMPLE_RATE;
+    double x = 0.0;
+    if (phase >= 1.0)
+    {
+      phase -= 1.0;
+      x = 1.0;
+    }
+    rnd = rnd * 1103515245 + 12345;
+    x += 0.02 * ((rnd >> 16) / 32768.0 - 1.0);
+
+    double out = 0.0;
+    for (int f=0; f<3; ++f)
+    {
+      double r = exp(-M_PI * formants[f][1] / INTERNAL_SAMPLE_RATE);
+      double theta = 2.0 * M_PI * formants[f][0] / INTERNAL_SAMPLE_RATE;
+      double v = (1.0 - r) * x + 2.0 * r * cos(theta) * y[f][0] -
+                 r * r * y[f][1];
+      y[f][1] = y[f][0];
+      y[f][0] = v;
+      out += v;
+    }
+
+    double env = sin(M_PI * fmod(t * 4.0, 1.0));
+    if (fmod(t, 2.0) > 1.6)
+    {
+      env = 0.0;
+    }
+    buf[i] = 0.8 * env * out;
+  }
+  return buf;
+}
+
+
+vector<TestSignal> cannedSignals(unsigned seconds)
+{
+  size_t len = seconds * INTERNAL_SAMPLE_RATE;
+  vector<TestSignal> signals;
+
+    // The sweep must come first since the delay for the periodic signals
+    // cannot be found by cross correlation. The delay measured for the
+    // sweep is used instead.
+  TestSignal sweep{"sweep", vector<float>(len, 0.0f), false};
+  double f1 = 100.0;
+  double f2 = 3400.0;
+  double k = log(f2 / f1) / len;
+  for (size_t i=0; i<len; ++i)
+  {
+    double phi = 2.0 * M_PI * f1 / INTERNAL_SAMPLE_RATE * (exp(k * i) - 1) / k;
+    sweep.samples[i] = 0.3 * sin(phi);
+  }
+  signals.push_back(sweep);
+
+  TestSignal tone{"tone_1k", vector<float>(len, 0.0f), true};
+  addTone(tone.samples, 1000.0, 0.3);
+  signals.push_back(tone);
+
+  TestSignal dtmf{"dtmf_1", vector<float>(len, 0.0f), true};
+  addTone(dtmf.samples, 697.0, 0.2);
+  addTone(dtmf.samples, 1209.0, 0.2);
+  signals.push_back(dtmf);
+
+  signals.push_back(TestSignal{"speech_synth", synthSpeech(len), false});
+
+  return signals;
+}
+
+
+bool readRawFile(const string& path, TestSignal& sig)
+{
+  ifstream ifs(path.c_str(), ios::in | ios::binary);
+  if (!ifs.good())
+  {
+    return false;
+  }
+  int16_t buf[1024];
+  while (ifs.read(reinterpret_cast<char*>(buf), sizeof(buf)) ||
+         ifs.gcount() > 0)
+  {
+    size_t cnt = ifs.gcount() / sizeof(*buf);
+    for (size_t i=0; i<cnt; ++i)
+    {
+      sig.samples.push_back(buf[i] / 32768.0f);
+    }
+  }
+  sig.name = path.substr(path.rfind('/') + 1);
+  return !sig.samples.empty();
+}
+
+
+  // Find the delay of the output signal relative to the input signal by
+  // looking for the maximum cross correlation
+size_t findDelay(const vector<float>& in, const vector<float>& out)
+{
+  size_t len = min(in.size(), static_cast<size_t>(INTERNAL_SAMPLE_RATE));
+  size_t best_delay = 0;
+  double best_corr = -1.0;
+  for (size_t d=0; d<static_cast<size_t>(MAX_DELAY); ++d)
+  {
+    if (d + len > out.size())
+    {
+      break;
+    }
+    double corr = 0.0;
+    for (size_t i=0; i<len; ++i)
+    {
+      corr += in[i] * out[i + d];
+    }
+    if (corr > best_corr)
+    {
+      best_corr = corr;
+      best_delay = d;
+    }
+  }
+  return best_delay;
+}
+
+
+void calcSnr(const vector<float>& in, const vector<float>& out, size_t delay,
+             double& snr, double& segsnr)
+{
+  size_t len = (out.size() > delay) ? min(in.size(), out.size() - delay) : 0;
+  double sig_tot = 0.0;
+  double err_tot = 0.0;
+  double seg_sum = 0.0;
+  unsigned seg_cnt = 0;
+  for (size_t pos=0; pos+SEGMENT_SIZE<=len; pos+=SEGMENT_SIZE)
+  {
+    double sig = 0.0;
+    double err = 0.0;
+    for (size_t i=pos; i<pos+SEGMENT_SIZE; ++i)
+    {
+      double e = in[i] - out[i + delay];
+      sig += in[i] * in[i];
+      err += e * e;
+    }
+    sig_tot += sig;
+    err_tot += err;
+      // Skip silent segments, about -50dBFS
+    if (sig / SEGMENT_SIZE > 1e-5)
+    {
+      double seg = 10.0 * log10(sig / max(err, 1e-12));
+      seg_sum += max(-10.0, min(35.0, seg));
+      ++seg_cnt;
+    }
+  }
+  snr = 10.0 * log10(sig_tot / max(err_tot, 1e-12));
+  segsnr = (seg_cnt > 0) ? (seg_sum / seg_cnt) : 0.0;
+}
+
+
+void setOptions(AudioEncoder *enc, const string& options)
+{
+  stringstream ss(options);
+  string opt;
+  while (getline(ss, opt, ';'))
+  {
+    size_t eq = opt.find('=');
+    if (eq != string::npos)
+    {
+      enc->setOption(opt.substr(0, eq), opt.substr(eq + 1));
+    }
+  }
+}
+
+
+size_t runBenchmark(const CodecSetting& setting, const TestSignal& sig,
+                    size_t delay)
+{
+  AudioEncoder *enc = AudioEncoder::create(setting.codec);
+  AudioDecoder *dec = AudioDecoder::create(setting.codec);
+  if ((enc == 0) || (dec == 0))
+  {
+    cerr << "*** ERROR: Could not create codec " << setting.codec << endl;
+    exit(1);
+  }
+  setOptions(enc, setting.options);
+
+  PacketCollector pkts;
+  enc->writeEncodedSamples.connect(
+      sigc::mem_fun(pkts, &PacketCollector::write));
+  SampleCollector output;
+  dec->registerSink(&output);
+
+    // Encode the whole signal, block by block, as it would be done live
+  const vector<float>& in = sig.samples;
+  double enc_start = cpuTime();
+  for (size_t pos=0; pos<in.size(); pos+=BLOCK_SIZE)
+  {
+    int cnt = min(static_cast<size_t>(BLOCK_SIZE), in.size() - pos);
+    pkts.input_pos = pos + cnt;
+    enc->writeSamples(&in[pos], cnt);
+  }
+  enc->flushSamples();
+  double enc_time = cpuTime() - enc_start;
+
+    // Decode the packets and keep track of how long the first sample in
+    // each packet have been waiting since its input block was written
+  size_t bytes = 0;
+  size_t max_buffered = 0;
+  double dec_start = cpuTime();
+  for (auto& pkt : pkts.packets)
+  {
+    size_t first = output.samples.size();
+    dec->writeEncodedSamples(&pkt.data[0], pkt.data.size());
+    bytes += pkt.data.size();
+    size_t block_end = min(in.size(), (first / BLOCK_SIZE + 1) * BLOCK_SIZE);
+    if ((output.samples.size() > first) && (pkt.input_pos > block_end))
+    {
+      max_buffered = max(max_buffered, pkt.input_pos - block_end);
+    }
+  }
+  dec->flushEncodedSamples();
+  double dec_time = cpuTime() - dec_start;
+
+  if (!sig.periodic)
+  {
+    delay = findDelay(in, output.samples);
+  }
+  double snr = 0.0;
+  double segsnr = 0.0;
+  calcSnr(in, output.samples, delay, snr, segsnr);
+
+  double audio_time = static_cast<double>(in.size()) / INTERNAL_SAMPLE_RATE;
+  double npkts = pkts.packets.size();
+  cout << setting.codec << ","
+       << setting.options << ","
+       << sig.name << ","
+       << (enc_time > 0.0 ? npkts / enc_time : 0.0) << ","
+       << (dec_time > 0.0 ? npkts / dec_time : 0.0) << ","
+       << audio_time / max(enc_time + dec_time, 1e-9) << ","
+       << 1000.0 * (max_buffered + delay) / INTERNAL_SAMPLE_RATE << ","
+       << bytes / audio_time << ","
+       << snr << ","
+       << segsnr << endl;
+
+  dec->unregisterSink();
+  delete dec;
+  delete enc;
+
+  return delay;
+}
+
+
+void usage(const char *prog)
+{
+  cerr << "Usage: " << prog << " [-c codec] [-s seconds] [file.raw...]"
+       << endl;
+  exit(1);
+}
+
+}; /* anonymous namespace */
+
+
+int main(int argc, char **argv)
+{
+  string codec_filter;
+  unsigned seconds = 10;
+  int opt;
+  while ((opt = getopt(argc, argv, "c:s:h")) != -1)
+  {
+    switch (opt)
+    {
+      case 'c':
+        codec_filter = optarg;
+        break;
+      case 's':
+        seconds = atoi(optarg);
+        break;
+      default:
+        usage(argv[0]);
+    }
+  }
+  if (seconds == 0)
+  {
+    usage(argv[0]);
+  }
+
+  vector<TestSignal> signals = cannedSignals(seconds);
+  for (int i=optind; i<argc; ++i)
+  {
+    TestSignal sig;
+    sig.periodic = false;
+    if (!readRawFile(argv[i], sig))
+    {
+      cerr << "*** ERROR: Could not read audio file " << argv[i] << endl;
+      exit(1);
+    }
+    signals.push_back(sig);
+  }
+
+  cout << "codec,options,signal,enc_pkt_per_s,dec_pkt_per_s,"
+          "streams_per_core,latency_ms,bytes_per_s,snr_db,segsnr_db"
+       << endl;
+  for (const auto& setting : settings)
+  {
+    if ((!codec_filter.empty() && (codec_filter != setting.codec)) ||
+        !AudioEncoder::isAvailable(setting.codec) ||
+        !AudioDecoder::isAvailable(setting.codec))
+    {
+      continue;
+    }
+    size_t delay = 0;
+    for (const auto& sig : signals)
+    {
+      delay = runBenchmark(setting, sig, delay);
+    }
+  }
+
+  return 0;
+}
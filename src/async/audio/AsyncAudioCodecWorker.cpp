@@ -0,0 +1,323 @@
+/**
+@file	 AsyncAudioCodecWorker.cpp
+@brief   A worker thread used to offload audio codec processing
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <system_error>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncMetrics.h"
+#include "AsyncAudioCodecWorker.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+MetricHistogram& AudioCodecWorker::processingTime(const std::string& codec,
+                                                  const std::string& direction)
+{
+  static const std::vector<double> bounds = {
+    0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025
+  };
+  return MetricsRegistry::instance().histogram(
+      "async_audio_codec_processing_seconds",
+      "Time spent in threaded audio codecs per block of audio",
+      bounds, {{"codec", codec}, {"direction", direction}});
+} /* AudioCodecWorker::processingTime */
+
+
+AudioCodecWorker::AudioCodecWorker(void)
+  : m_alive(make_shared<bool>(true))
+{
+  int fd[2];
+  if (pipe(fd) != 0)
+  {
+    char errbuf[256];
+    strerror_r(errno, errbuf, sizeof(errbuf));
+    cerr << "*** WARNING: Could not create codec worker notification pipe: "
+         << errbuf << ". Falling back to inline codec processing." << endl;
+    return;
+  }
+  fcntl(fd[0], F_SETFL, fcntl(fd[0], F_GETFL) | O_NONBLOCK);
+  fcntl(fd[0], F_SETFD, FD_CLOEXEC);
+  fcntl(fd[1], F_SETFD, FD_CLOEXEC);
+  m_notifier_wr = fd[1];
+  m_notifier_watch.activity.connect(
+      sigc::mem_fun(*this, &AudioCodecWorker::notificationReceived));
+  m_notifier_watch.setFd(fd[0], FdWatch::FD_WATCH_RD);
+  m_notifier_watch.setEnabled(true);
+
+  try
+  {
+    m_thread = std::thread(&AudioCodecWorker::workerFunc, this);
+  }
+  catch (const std::system_error& e)
+  {
+    cerr << "*** WARNING: Could not start codec worker thread: "
+         << e.what() << ". Falling back to inline codec processing." << endl;
+  }
+} /* AudioCodecWorker::AudioCodecWorker */
+
+
+AudioCodecWorker::~AudioCodecWorker(void)
+{
+  *m_alive = false;
+
+  if (m_thread.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      m_stop = true;
+      m_work_queue.clear();
+    }
+    m_work_cond.notify_one();
+    m_thread.join();
+  }
+
+  int fd = m_notifier_watch.fd();
+  if (fd >= 0)
+  {
+    m_notifier_watch.setFd(-1, FdWatch::FD_WATCH_RD);
+    close(fd);
+  }
+  if (m_notifier_wr >= 0)
+  {
+    close(m_notifier_wr);
+  }
+} /* AudioCodecWorker::~AudioCodecWorker */
+
+
+void AudioCodecWorker::post(WorkFunc work, DoneFunc done)
+{
+  if (!initOk())
+  {
+    work();
+    done();
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_work_queue.push_back(Job{std::move(work), std::move(done)});
+  }
+  m_work_cond.notify_one();
+} /* AudioCodecWorker::post */
+
+
+void AudioCodecWorker::sync(void)
+{
+  std::unique_lock<std::mutex> lk(m_mutex);
+  m_idle_cond.wait(lk, [this]{ return m_work_queue.empty() && !m_busy; });
+} /* AudioCodecWorker::sync */
+
+
+unsigned AudioCodecWorker::pending(void) const
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  return m_work_queue.size() + (m_busy ? 1 : 0) + m_done_queue.size();
+} /* AudioCodecWorker::pending */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+/*
+ *----------------------------------------------------------------------------
+ * Method:    AudioCodecWorker::workerFunc
+ * Purpose:   The main function of the worker thread. Execute the work
+ *            functions in order and hand the done functions over to the
+ *            main thread. The main thread is only woken up when the done
+ *            queue goes from empty to non-empty so that a burst of jobs
+ *            only cost one notification.
+ * Input:     None
+ * Output:    None
+ * Author:    agent
+ * Created:   2026-10-17
+ * Remarks:
+ * Bugs:
+ *----------------------------------------------------------------------------
+ */
+void AudioCodecWorker::workerFunc(void)
+{
+  std::unique_lock<std::mutex> lk(m_mutex);
+  for (;;)
+  {
+    m_work_cond.wait(lk, [this]{ return m_stop || !m_work_queue.empty(); });
+    if (m_stop)
+    {
+      break;
+    }
+
+    Job job(std::move(m_work_queue.front()));
+    m_work_queue.pop_front();
+    m_busy = true;
+    lk.unlock();
+
+    job.work();
+
+    lk.lock();
+    m_busy = false;
+    bool notify = m_done_queue.empty();
+    m_done_queue.push_back(std::move(job.done));
+    if (notify)
+    {
+      char ch = 0;
+      while ((write(m_notifier_wr, &ch, 1) == -1) && (errno == EINTR))
+      {
+      }
+    }
+    if (m_work_queue.empty())
+    {
+      m_idle_cond.notify_all();
+    }
+  }
+} /* AudioCodecWorker::workerFunc */
+
+
+void AudioCodecWorker::notificationReceived(FdWatch *w)
+{
+    // Drain the pipe before looking at the queue so that no wakeup is lost
+  char buf[64];
+  while (read(w->fd(), buf, sizeof(buf)) > 0)
+  {
+  }
+
+    // A done function may delete this object so check that we are still
+    // alive before each call
+  std::shared_ptr<bool> alive(m_alive);
+  while (*alive)
+  {
+    DoneFunc done;
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      if (m_done_queue.empty())
+      {
+        break;
+      }
+      done = std::move(m_done_queue.front());
+      m_done_queue.pop_front();
+    }
+    done();
+  }
+} /* AudioCodecWorker::notificationReceived */
+
+
+
+/*
+ * This file has not been truncated
+ */
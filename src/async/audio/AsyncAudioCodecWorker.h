@@ -0,0 +1,234 @@
+/**
+@file	 AsyncAudioCodecWorker.h
+@brief   A worker thread used to offload audio codec processing
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_AUDIO_CODEC_WORKER_INCLUDED
+#define ASYNC_AUDIO_CODEC_WORKER_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <string>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncFdWatch.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+class MetricHistogram;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	A worker thread used to offload audio codec processing
+@author agent
+@date   2026-10-17
+
+This class run jobs in a separate thread. Each job consist of two parts. The
+work function is executed in the worker thread and the done function is
+executed in the main thread, from the event loop, when the work function has
+finished. Jobs are executed in the order they were posted and the done
+functions are called in the same order.
+
+The worker thread is used by the AudioEncoderThreaded and AudioDecoderThreaded
+classes to move CPU intensive encoding and decoding out of the event loop.
+Since there only is one worker thread per object, the work functions never
+run concurrently so they may share state with each other without locking.
+They must however not touch anything that is also used by the main thread.
+*/
+class AudioCodecWorker
+{
+  public:
+    /**
+     * @brief   Get the histogram used to measure the codec processing time
+     * @param   codec The name of the codec
+     * @param   direction "encode" or "decode"
+     * @return  Returns the histogram in the application metrics registry
+     */
+    static MetricHistogram& processingTime(const std::string& codec,
+                                           const std::string& direction);
+
+    /**
+     * @brief   The type of function to run in the worker thread
+     */
+    typedef std::function<void(void)> WorkFunc;
+
+    /**
+     * @brief   The type of function to run in the main thread
+     */
+    typedef std::function<void(void)> DoneFunc;
+
+    /**
+     * @brief 	Default constructor
+     */
+    AudioCodecWorker(void);
+
+    /**
+     * @brief 	Destructor
+     *
+     * The worker thread will be stopped and joined. Jobs that have not yet
+     * been started are thrown away and no done functions will be called
+     * after the object has been destroyed.
+     */
+    ~AudioCodecWorker(void);
+
+    /**
+     * @brief   Check if the initialization was successful
+     * @return  Return \em true if the worker thread is running
+     *
+     * If the worker thread could not be started, posted jobs will be
+     * executed synchronously instead.
+     */
+    bool initOk(void) const { return m_thread.joinable(); }
+
+    /**
+     * @brief   Post a new job to the worker thread
+     * @param   work The function to execute in the worker thread
+     * @param   done The function to execute in the main thread afterwards
+     */
+    void post(WorkFunc work, DoneFunc done);
+
+    /**
+     * @brief   Wait for all posted work functions to finish
+     *
+     * Block the calling thread until the worker thread is idle. This is
+     * used before accessing state that is normally only touched by the
+     * worker thread, like codec options. Done functions that have not yet
+     * been dispatched are not affected.
+     */
+    void sync(void);
+
+    /**
+     * @brief   Get the number of jobs that have not yet been completed
+     * @return  Returns the number of jobs not yet dispatched in main thread
+     */
+    unsigned pending(void) const;
+
+  private:
+    struct Job
+    {
+      WorkFunc work;
+      DoneFunc done;
+    };
+
+    mutable std::mutex        m_mutex;
+    std::condition_variable   m_work_cond;
+    std::condition_variable   m_idle_cond;
+    std::deque<Job>           m_work_queue;
+    std::deque<DoneFunc>      m_done_queue;
+    bool                      m_busy = false;
+    bool                      m_stop = false;
+    std::thread               m_thread;
+    int                       m_notifier_wr = -1;
+    FdWatch                   m_notifier_watch;
+    std::shared_ptr<bool>     m_alive;
+
+    AudioCodecWorker(const AudioCodecWorker&);
+    AudioCodecWorker& operator=(const AudioCodecWorker&);
+    void workerFunc(void);
+    void notificationReceived(FdWatch *w);
+
+};  /* class AudioCodecWorker */
+
+
+} /* namespace */
+
+#endif /* ASYNC_AUDIO_CODEC_WORKER_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
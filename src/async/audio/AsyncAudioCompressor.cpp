@@ -33,6 +33,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
 
 
 /****************************************************************************
@@ -71,7 +74,13 @@ using namespace Async;
  ****************************************************************************/
 
 // DC offset to prevent denormal
-static const double DC_OFFSET = 1.0E-25;
+static const float DC_OFFSET = 1.0E-25f;
+
+  // log2(10) / 20, converts dB to log2 units
+static const double DB_2_LOG2 = 0.16609640474436811739351597147447;
+
+  // The number of samples processed in each pass of the kernel
+static const int BLOCK_SIZE = 64;
 
 
 
@@ -91,14 +100,6 @@ static const double DC_OFFSET = 1.0E-25;
  *
  ****************************************************************************/
 
-// linear -> dB conversion
-static inline double lin2dB( double lin )
-{
-    // 20 / ln( 10 )
-  static const double LOG_2_DB = 8.6858896380650365530225783783321;
-  return log( lin ) * LOG_2_DB;
-}
-
 // dB -> linear conversion
 static inline double dB2lin( double dB )
 {
@@ -107,6 +108,48 @@ static inline double dB2lin( double dB )
   return exp( dB * DB_2_LOG );
 }
 
+/*
+ * Fast base 2 logarithm. The mantissa is normalized to [sqrt(0.5), sqrt(2))
+ * using integer arithmetic on the IEEE 754 bit pattern and then the atanh
+ * series is evaluated to the fifth order. The absolute error is below 6e-6,
+ * which correspond to about 3.4e-5 dB. The input must be a positive normal
+ * number. There are no branches so loops using this function can be
+ * vectorized by the compiler.
+ */
+static inline float fastLog2( float x )
+{
+  int32_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  const int32_t e = (bits - 0x3f3504f3) >> 23;   // 0x3f3504f3 == sqrt(0.5)
+  bits -= static_cast<int32_t>(static_cast<uint32_t>(e) << 23);
+  float m;
+  memcpy(&m, &bits, sizeof(m));
+  const float t = (m - 1.0f) / (m + 1.0f);
+  const float t2 = t * t;
+  return static_cast<float>(e) +
+         t * (2.88539008f + t2 * (0.96179669f + t2 * 0.57707801f));
+}
+
+/*
+ * Fast base 2 exponential. The integer part goes directly into the exponent
+ * bits and the fractional part is evaluated using a fifth order polynomial.
+ * The relative error is below 9e-5 (about 7.5e-4 dB). The input must be
+ * in the range [-126, 126]. Clamping is left to the caller since it would
+ * prevent the compiler from vectorizing loops using this function.
+ */
+static inline float fastExp2( float x )
+{
+    // Biasing to a positive value make truncation equivalent to floor
+  const int32_t xi = static_cast<int32_t>(x + 128.0f) - 128;
+  const float f = x - static_cast<float>(xi);
+  const float p = 1.0f + f * (0.69314718f + f * (0.24022651f +
+                  f * (0.05550411f + f * (0.00961813f + f * 0.00133336f))));
+  const int32_t bits = (xi + 127) << 23;
+  float scale;
+  memcpy(&scale, &bits, sizeof(scale));
+  return p * scale;
+}
+
 
 
 /****************************************************************************
@@ -133,8 +176,8 @@ static inline double dB2lin( double dB )
  ****************************************************************************/
 
 AudioCompressor::AudioCompressor(void)
-  : threshdB_(0.0), ratio_(1.0), output_gain(1.0),att_(10.0), rel_(100.0),
-    envdB_(DC_OFFSET)
+  : threshdB_(0.0), ratio_(1.0), output_gain(1.0), gain_update_interval(1),
+    att_(10.0), rel_(100.0), env_(DC_OFFSET), gain_(1.0f)
 {
 } /* AudioCompressor::AudioCompressor */
 
@@ -182,9 +225,17 @@ void AudioCompressor::setOutputGain(float gain)
 } /* AudioCompressor::setOutputGain */
 
 
+void AudioCompressor::setGainUpdateInterval(unsigned interval)
+{
+  gain_update_interval = std::min(std::max(interval, 1U),
+                                  static_cast<unsigned>(BLOCK_SIZE));
+} /* AudioCompressor::setGainUpdateInterval */
+
+
 void AudioCompressor::reset(void)
 {
-  envdB_ = DC_OFFSET;
+  env_ = DC_OFFSET;
+  gain_ = 1.0f;
 } /* AudioCompressor::reset */
 
 
@@ -197,58 +248,80 @@ void AudioCompressor::reset(void)
 
 void AudioCompressor::processSamples(float *dest, const float *src, int count)
 {
-  //double max_sample = 0.0;
-  for (int i=0; i<count; ++i)
-  {
-    double rect = fabs(src[i]);	// rectify input
-
-    /* if desired, one could use another EnvelopeDetector to smooth
-     * the rectified signal.
+    /* The envelope is tracked in the log2 domain instead of in dB. The scale
+     * factor is folded into the threshold so that the fast log2/exp2
+     * approximations can be used directly.
      */
+  const float thresh = threshdB_ * DB_2_LOG2;
+  const float slope = ratio_ - 1.0;
+  const float att_coef = att_.getCoef();
+  const float rel_coef = rel_.getCoef();
+  const float out_gain = output_gain;
+  const int interval = gain_update_interval;
+
+  float env = env_;
+  float gain = gain_;
+  float over[BLOCK_SIZE];
+  float gr[BLOCK_SIZE];
+  while (count > 0)
+  {
+    const int n = std::min(count, BLOCK_SIZE);
 
-    rect += DC_OFFSET;			// add DC offset to avoid log( 0 )
-    double keydB = lin2dB( rect );	// convert linear -> dB
-
-    // threshold
-    double overdB = keydB - threshdB_;	// delta over threshold
-    if ( overdB < 0.0 )
-	    overdB = 0.0;
-
-    // attack/release
+      // Rectify input and convert to log2 units above threshold
+    for (int i=0; i<n; ++i)
+    {
+      over[i] = fastLog2(fabsf(src[i]) + DC_OFFSET) - thresh;
+    }
 
-    overdB += DC_OFFSET;		// add DC offset to avoid denormal
+      // Attack/release and transfer function. This is the only part with a
+      // dependency between samples so it can not be vectorized. The gain
+      // reduction is calculated here, in log2 units, and clamped to the
+      // valid range of fastExp2.
+    for (int i=0; i<n; ++i)
+    {
+      const float o = std::max(over[i], 0.0f) + DC_OFFSET;
+      const float coef = (o > env) ? att_coef : rel_coef;
+      env = o + coef * (env - o);
+      over[i] = std::min(std::max((env - DC_OFFSET) * slope, -126.0f), 126.0f);
+    }
 
-    if ( overdB > envdB_ )
+      // Convert gain reduction to linear
+    if (interval == 1)
     {
-      att_.run( overdB, envdB_ );		// attack
+      for (int i=0; i<n; ++i)
+      {
+        gr[i] = fastExp2(over[i]);
+      }
+      gain = gr[n-1];
     }
     else
     {
-      rel_.run( overdB, envdB_ );		// release
+      for (int start=0; start<n; start+=interval)
+      {
+        const int len = std::min(interval, n - start);
+        const float target = fastExp2(over[start+len-1]);
+        const float step = (target - gain) / len;
+        for (int i=0; i<len; ++i)
+        {
+          gr[start+i] = gain + step * (i + 1);
+        }
+        gain = target;
+      }
     }
 
-    overdB = envdB_ - DC_OFFSET;		// subtract DC offset
-    //cout << overdB << endl;
-
-    /* Regarding the DC offset: In this case, since the offset is added before 
-     * the attack/release processes, the envelope will never fall below the offset,
-     * thereby avoiding denormals. However, to prevent the offset from causing
-     * constant gain reduction, we must subtract it from the envelope, yielding
-     * a minimum value of 0dB.
-     */
-
-    // transfer function
-    double gr = overdB * ( ratio_ - 1.0 );    // gain reduction (dB)
-    gr = dB2lin( gr );			      // convert dB -> linear
+      // Apply gain reduction and output gain to input
+    for (int i=0; i<n; ++i)
+    {
+      dest[i] = out_gain * src[i] * gr[i];
+    }
 
-    // output gain
-    dest[i] = output_gain * src[i] * gr;      // apply gain reduction to input
-    
-    //if (fabs(dest[i]) > max_sample)
-    //  max_sample = dest[i];
+    src += n;
+    dest += n;
+    count -= n;
   }
-  
-  //cout << "max_sample=" << max_sample << endl;
+
+  env_ = env;
+  gain_ = gain;
   
 } /* AudioCompressor::writeSamples */
 
@@ -132,6 +132,9 @@ class EnvelopeDetector
 
     virtual double getSampleRate( void ) { return sampleRate_; }
 
+    // runtime coefficient, for use in block processing kernels
+    double getCoef( void ) const { return coef_; }
+
     // runtime function
     inline void run( double in, double &state )
     {
@@ -215,7 +218,19 @@ class AudioCompressor : public AudioProcessor
      * If gain < 1 the signal is attenuated.
      */
     void setOutputGain(float gain);
-  
+
+    /**
+     * @brief   Set how often the gain is recalculated
+     * @param   interval The gain update interval in samples
+     *
+     * The envelope is always tracked for every sample but the gain
+     * reduction, which requires an exponentiation, may be evaluated only
+     * every interval samples. In between the gain is linearly interpolated.
+     * The default is 1, which mean that the gain is calculated for every
+     * sample. The interval is limited to 64 samples.
+     */
+    void setGainUpdateInterval(unsigned interval);
+
     /**
      * @brief 	Reset the compressor
      */
@@ -231,13 +246,15 @@ class AudioCompressor : public AudioProcessor
     double threshdB_;	// threshold (dB)
     double ratio_;		// ratio (compression: < 1 ; expansion: > 1)
     double output_gain;
+    unsigned gain_update_interval;
 
     // attack/release
     EnvelopeDetector att_;	// attack
     EnvelopeDetector rel_;	// release
 
     // runtime variables
-    double envdB_;			// over-threshold envelope (dB)
+    float env_;			// over-threshold envelope (log2 units)
+    float gain_;		// last calculated gain reduction (linear)
     
     AudioCompressor(const AudioCompressor&);
     AudioCompressor& operator=(const AudioCompressor&);
@@ -0,0 +1,288 @@
+//
+// Error bound test and CPU benchmark for the AudioCompressor kernel.
+//
+// A number of test signals are run through the AudioCompressor and through
+// a reference implementation, which is the double precision per sample
+// kernel that was used before the block kernel. The gain applied by the two
+// implementations are compared, in dB, for every sample where the signal is
+// above -100 dBFS. The test fail if the largest deviation is above the bound
+// for the compressor setting under test. The settings tested are the ones
+// used by the compressor and the limiters in LocalTx and LocalRxBase, each
+// with different gain update intervals.
+//
+// After the error bounds have been checked the CPU time used per channel is
+// measured for the reference implementation and for the block kernel. The
+// columns printed are:
+//
+//   setting   - The compressor setting
+//   interval  - The gain update interval, "ref" for the reference kernel
+//   max_err   - Largest gain deviation from the reference, in dB
+//   bound     - The allowed deviation, in dB
+//   us/s      - CPU time in microseconds per second of audio and channel
+//   channels  - Number of realtime channels that one core can handle
+//
+// Usage: AsyncAudioCompressorTest [seconds]
+//
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+
+#include "AsyncAudioCompressor.h"
+
+using namespace std;
+using namespace Async;
+
+
+namespace {
+
+const int BLOCK_SIZE = 256;
+
+  // Expose the kernel so that it can be called without an audio pipe
+class TestCompressor : public AudioCompressor
+{
+  public:
+    using AudioCompressor::processSamples;
+};
+
+  // The double precision kernel that AudioCompressor used before
+class RefCompressor
+{
+  public:
+    RefCompressor(void)
+      : threshdB(0.0), ratio(1.0), output_gain(1.0), att(10.0), rel(100.0),
+        envdB(DC_OFFSET)
+    {
+    }
+
+    void setThreshold(double thresh_db) { threshdB = thresh_db; }
+    void setRatio(double r) { ratio = r; }
+    void setAttack(double attack_ms) { att.setTc(attack_ms); }
+    void setDecay(double decay_ms) { rel.setTc(decay_ms); }
+    void setOutputGain(float gain)
+    {
+      output_gain = gain;
+      if (gain == 0)
+      {
+        output_gain = pow(10.0, (threshdB * ratio - threshdB) / 20.0);
+      }
+    }
+
+    void processSamples(float *dest, const float *src, int count)
+    {
+      for (int i=0; i<count; ++i)
+      {
+        double rect = fabs(src[i]) + DC_OFFSET;
+        double overdB = 20.0 * log10(rect) - threshdB;
+        if (overdB < 0.0)
+        {
+          overdB = 0.0;
+        }
+        overdB += DC_OFFSET;
+        if (overdB > envdB)
+        {
+          att.run(overdB, envdB);
+        }
+        else
+        {
+          rel.run(overdB, envdB);
+        }
+        overdB = envdB - DC_OFFSET;
+        double gr = pow(10.0, overdB * (ratio - 1.0) / 20.0);
+        dest[i] = output_gain * src[i] * gr;
+      }
+    }
+
+  private:
+    static constexpr double DC_OFFSET = 1.0E-25;
+
+    double            threshdB;
+    double            ratio;
+    double            output_gain;
+    EnvelopeDetector  att;
+    EnvelopeDetector  rel;
+    double            envdB;
+};
+
+struct Setting
+{
+  const char* name;
+  double      thresh;
+  double      ratio;
+  double      attack;
+  double      decay;
+  float       output_gain;
+};
+
+const Setting settings[] =
+{
+  { "tx_comp",   -10.0, 0.25, 10.0, 100.0, 0.0f },
+  { "limiter",    -6.0, 0.1,   2.0,  20.0, 1.0f },
+  { "limiter_lo", -20.0, 0.1,  2.0,  20.0, 1.0f },
+};
+
+  // The allowed gain deviation in dB for each gain update interval. With
+  // interpolated gain the deviation is dominated by the attack of the
+  // envelope during one interval.
+struct Bound
+{
+  unsigned  interval;
+  double    max_err_db;
+};
+
+const Bound bounds[] =
+{
+  { 1,  0.01 },
+  { 4,  0.5 },
+  { 16, 1.5 },
+  { 64, 6.0 },
+};
+
+template <class Comp>
+void setup(Comp& comp, const Setting& s)
+{
+  comp.setThreshold(s.thresh);
+  comp.setRatio(s.ratio);
+  comp.setAttack(s.attack);
+  comp.setDecay(s.decay);
+  comp.setOutputGain(s.output_gain);
+}
+
+  // A test signal with tone bursts alternating between loud and weak,
+  // a level sweep, noise and silence
+void createSignal(vector<float>& sig, unsigned seconds)
+{
+  sig.resize(seconds * INTERNAL_SAMPLE_RATE);
+  srand(1);
+  for (size_t i=0; i<sig.size(); ++i)
+  {
+    const double t = static_cast<double>(i) / INTERNAL_SAMPLE_RATE;
+    const double phase = fmod(t, 4.0);
+    double val = 0.0;
+    if (phase < 1.0)
+    {
+      const double amp = (fmod(t, 0.5) < 0.25) ? 0.9 : 0.01;
+      val = amp * sin(2.0 * M_PI * 1000.0 * t);
+    }
+    else if (phase < 2.0)
+    {
+      const double amp = pow(10.0, (-80.0 + 80.0 * (phase - 1.0)) / 20.0);
+      val = amp * sin(2.0 * M_PI * 440.0 * t);
+    }
+    else if (phase < 3.0)
+    {
+      val = 0.5 * (static_cast<double>(rand()) / RAND_MAX - 0.5);
+    }
+    sig[i] = val;
+  }
+}
+
+double cpuTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+template <class Comp>
+double run(Comp& comp, const vector<float>& in, vector<float>& out)
+{
+  out.resize(in.size());
+  const double start = cpuTime();
+  for (size_t pos=0; pos<in.size(); pos+=BLOCK_SIZE)
+  {
+    const int count = min(static_cast<size_t>(BLOCK_SIZE), in.size() - pos);
+    comp.processSamples(&out[pos], &in[pos], count);
+  }
+  return cpuTime() - start;
+}
+
+double maxErrorDb(const vector<float>& in, const vector<float>& ref,
+                  const vector<float>& out)
+{
+  double max_err = 0.0;
+  for (size_t i=0; i<in.size(); ++i)
+  {
+    if (fabs(in[i]) < 1.0e-5)
+    {
+      continue;
+    }
+    const double err = fabs(20.0 * log10(out[i] / ref[i]));
+    if (!(err <= max_err))
+    {
+      max_err = err;
+    }
+  }
+  return max_err;
+}
+
+void printLine(const string& setting, const string& interval, double max_err,
+               double bound, double cpu, unsigned seconds)
+{
+  const double us_per_sec = 1.0e6 * cpu / seconds;
+  cout << setw(11) << setting << setw(9) << interval
+       << setw(10) << fixed << setprecision(4) << max_err
+       << setw(7) << setprecision(2) << bound
+       << setw(8) << setprecision(1) << us_per_sec
+       << setw(10) << setprecision(0) << 1.0e6 / us_per_sec
+       << endl;
+}
+
+} /* anonymous namespace */
+
+
+int main(int argc, char **argv)
+{
+  unsigned seconds = 60;
+  if (argc > 1)
+  {
+    seconds = atoi(argv[1]);
+  }
+  if (seconds == 0)
+  {
+    cerr << "Usage: AsyncAudioCompressorTest [seconds]" << endl;
+    return 1;
+  }
+
+  vector<float> in;
+  createSignal(in, seconds);
+
+  cout << setw(11) << "setting" << setw(9) << "interval" << setw(10)
+       << "max_err" << setw(7) << "bound" << setw(8) << "us/s"
+       << setw(10) << "channels" << endl;
+  bool ok = true;
+  for (const Setting& s : settings)
+  {
+    RefCompressor ref_comp;
+    setup(ref_comp, s);
+    vector<float> ref;
+    const double ref_cpu = run(ref_comp, in, ref);
+    printLine(s.name, "ref", 0.0, 0.0, ref_cpu, seconds);
+
+    for (const Bound& b : bounds)
+    {
+      TestCompressor comp;
+      setup(comp, s);
+      comp.setGainUpdateInterval(b.interval);
+      vector<float> out;
+      const double cpu = run(comp, in, out);
+      const double max_err = maxErrorDb(in, ref, out);
+      printLine(s.name, to_string(b.interval), max_err, b.max_err_db, cpu,
+                seconds);
+      if (!(max_err <= b.max_err_db))
+      {
+        cerr << "*** ERROR: The gain deviation for " << s.name
+             << " with gain update interval " << b.interval << " is "
+             << max_err << " dB, which is above the bound of "
+             << b.max_err_db << " dB" << endl;
+        ok = false;
+      }
+    }
+  }
+
+  return ok ? 0 : 1;
+}
@@ -32,6 +32,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <algorithm>
 
 
 /****************************************************************************
@@ -175,6 +176,18 @@ AudioDecoder *AudioDecoder::create(const std::string &name)
 }
 
 
+void AudioDecoder::writeSilence(unsigned count)
+{
+  static const float zeros[256] = {0};
+  while (count > 0)
+  {
+    unsigned len = std::min(count, 256U);
+    sinkWriteSamples(zeros, len);
+    count -= len;
+  }
+} /* AudioDecoder::writeSilence */
+
+
 /****************************************************************************
  *
  * Protected member functions
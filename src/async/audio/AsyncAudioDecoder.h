@@ -165,6 +165,16 @@ class AudioDecoder : public AudioSource, public sigc::trackable
      */
     virtual void flushEncodedSamples(void) { sinkFlushSamples(); }
     
+    /**
+     * @brief Write silence in place of encoded samples
+     * @param count The number of zero samples to write to the sink
+     *
+     * This function is called when the sending end has reported a run of
+     * silence instead of encoding it. The default implementation write the
+     * zero samples directly to the registered sink.
+     */
+    virtual void writeSilence(unsigned count);
+    
     /**
      * @brief Resume audio output to the sink
      * 
@@ -0,0 +1,291 @@
+/**
+@file	 AsyncAudioDecoderThreaded.cpp
+@brief   An audio decoder wrapper that decode in a worker thread
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cassert>
+#include <chrono>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncAudioSink.h"
+#include "AsyncAudioDecoderThreaded.h"
+#include "AsyncAudioCodecWorker.h"
+#include "AsyncMetrics.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+/**
+ * @brief An audio sink that collect the output from the wrapped decoder
+ *
+ * This sink is only used from the worker thread.
+ */
+class AudioDecoderThreaded::Capture : public AudioSink
+{
+  public:
+    std::shared_ptr<Job> job;
+
+    virtual int writeSamples(const float *samples, int count)
+    {
+      assert(job);
+      job->samples.insert(job->samples.end(), samples, samples + count);
+      return count;
+    }
+
+    virtual void flushSamples(void)
+    {
+      assert(job);
+      job->flush = true;
+      sourceAllSamplesFlushed();
+    }
+}; /* AudioDecoderThreaded::Capture */
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+AudioDecoderThreaded::AudioDecoderThreaded(AudioDecoder *dec)
+  : m_dec(dec), m_capture(0), m_worker(0), m_codec_time(0)
+{
+  assert(m_dec != 0);
+  m_codec_time = &AudioCodecWorker::processingTime(m_dec->name(), "decode");
+  m_capture = new Capture;
+  m_dec->registerSink(m_capture);
+  m_worker = new AudioCodecWorker;
+} /* AudioDecoderThreaded::AudioDecoderThreaded */
+
+
+AudioDecoderThreaded::~AudioDecoderThreaded(void)
+{
+    // The worker thread must be stopped before the decoder is deleted
+  delete m_worker;
+  m_worker = 0;
+  m_dec->unregisterSink();
+  delete m_dec;
+  m_dec = 0;
+  delete m_capture;
+  m_capture = 0;
+} /* AudioDecoderThreaded::~AudioDecoderThreaded */
+
+
+void AudioDecoderThreaded::setOption(const std::string &name,
+                                     const std::string &value)
+{
+  m_worker->sync();
+  m_dec->setOption(name, value);
+} /* AudioDecoderThreaded::setOption */
+
+
+void AudioDecoderThreaded::printCodecParams(void) const
+{
+  m_worker->sync();
+  m_dec->printCodecParams();
+} /* AudioDecoderThreaded::printCodecParams */
+
+
+void AudioDecoderThreaded::writeEncodedSamples(void *buf, int size)
+{
+  if (size <= 0)
+  {
+    return;
+  }
+
+  std::shared_ptr<Job> job = make_shared<Job>();
+  const char *ptr = reinterpret_cast<const char*>(buf);
+  job->data.assign(ptr, ptr + size);
+  postJob(job);
+} /* AudioDecoderThreaded::writeEncodedSamples */
+
+
+void AudioDecoderThreaded::flushEncodedSamples(void)
+{
+  postJob(make_shared<Job>());
+} /* AudioDecoderThreaded::flushEncodedSamples */
+
+
+void AudioDecoderThreaded::writeSilence(unsigned count)
+{
+  if (count == 0)
+  {
+    return;
+  }
+
+  std::shared_ptr<Job> job = make_shared<Job>();
+  job->silence = count;
+  postJob(job);
+} /* AudioDecoderThreaded::writeSilence */
+
+
+unsigned AudioDecoderThreaded::pendingJobs(void) const
+{
+  return m_worker->pending();
+} /* AudioDecoderThreaded::pendingJobs */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+/*
+ *----------------------------------------------------------------------------
+ * Method:    AudioDecoderThreaded::postJob
+ * Purpose:   Queue a job for the worker thread. A job without encoded data
+ *            or silence is a flush request. The decoded samples are
+ *            collected by the capture sink in the worker thread and then
+ *            written to the registered sink from the main thread.
+ * Input:     job - The job to post
+ * Output:    None
+ * Author:    agent
+ * Created:   2026-10-17
+ * Remarks:
+ * Bugs:
+ *----------------------------------------------------------------------------
+ */
+void AudioDecoderThreaded::postJob(std::shared_ptr<Job> job)
+{
+  m_worker->post(
+      [this, job]()
+      {
+        m_capture->job = job;
+        if (job->silence > 0)
+        {
+          job->samples.assign(job->silence, 0.0f);
+        }
+        else if (job->data.empty())
+        {
+          m_dec->flushEncodedSamples();
+        }
+        else
+        {
+          auto start = std::chrono::steady_clock::now();
+          m_dec->writeEncodedSamples(job->data.data(), job->data.size());
+          std::chrono::duration<double> elapsed =
+              std::chrono::steady_clock::now() - start;
+          m_codec_time->observe(elapsed.count());
+        }
+        m_capture->job.reset();
+      },
+      [this, job]()
+      {
+        if (!job->samples.empty())
+        {
+          sinkWriteSamples(job->samples.data(), job->samples.size());
+        }
+        if (job->flush)
+        {
+          sinkFlushSamples();
+        }
+      });
+} /* AudioDecoderThreaded::postJob */
+
+
+
+/*
+ * This file has not been truncated
+ */
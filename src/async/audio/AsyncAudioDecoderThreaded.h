@@ -0,0 +1,222 @@
+/**
+@file	 AsyncAudioDecoderThreaded.h
+@brief   An audio decoder wrapper that decode in a worker thread
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_AUDIO_DECODER_THREADED_INCLUDED
+#define ASYNC_AUDIO_DECODER_THREADED_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <vector>
+#include <memory>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioDecoder.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+class AudioCodecWorker;
+class MetricHistogram;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	An audio decoder wrapper that decode in a worker thread
+@author agent
+@date   2026-10-17
+
+This class wrap another audio decoder and run the actual decoding in a
+separate worker thread. Encoded data written to this object is copied and
+queued for the worker thread. The decoded samples are written to the
+registered sink from the main thread, in the same order as they were
+produced by the wrapped decoder. A flush request is queued behind any
+pending encoded data so that the sink is flushed after the last decoded
+sample has been written.
+
+The wrapped decoder must not be used directly after it has been handed over
+to this class. Use the setOption and printCodecParams functions of this
+class instead. They wait for the worker thread to become idle before
+forwarding the call.
+
+\code
+Async::AudioDecoder *dec = Async::AudioDecoder::create("OPUS");
+dec = new Async::AudioDecoderThreaded(dec);
+\endcode
+*/
+class AudioDecoderThreaded : public AudioDecoder
+{
+  public:
+    /**
+     * @brief 	Constructor
+     * @param 	dec The decoder to wrap. Ownership is taken.
+     */
+    explicit AudioDecoderThreaded(AudioDecoder *dec);
+
+    /**
+     * @brief 	Destructor
+     */
+    virtual ~AudioDecoderThreaded(void);
+
+    /**
+     * @brief   Get the name of the codec
+     * @returns Return the name of the wrapped codec
+     */
+    virtual const char *name(void) const { return m_dec->name(); }
+
+    /**
+     * @brief 	Set an option for the decoder
+     * @param 	name The name of the option
+     * @param 	value The value of the option
+     */
+    virtual void setOption(const std::string &name, const std::string &value);
+
+    /**
+     * @brief Print codec parameter settings
+     */
+    virtual void printCodecParams(void) const;
+
+    /**
+     * @brief 	Write encoded samples into the decoder
+     * @param 	buf  Buffer containing encoded samples
+     * @param 	size The size of the buffer
+     */
+    virtual void writeEncodedSamples(void *buf, int size);
+
+    /**
+     * @brief Call this function when all encoded samples have been received
+     */
+    virtual void flushEncodedSamples(void);
+
+    /**
+     * @brief Write silence in place of encoded samples
+     * @param count The number of zero samples to write to the sink
+     *
+     * The silence is queued behind any pending encoded data.
+     */
+    virtual void writeSilence(unsigned count);
+
+    /**
+     * @brief   Get the number of queued jobs
+     * @return  Returns the number of jobs not yet completed
+     */
+    unsigned pendingJobs(void) const;
+
+  protected:
+
+  private:
+    class Capture;
+
+    struct Job
+    {
+      std::vector<char>   data;
+      std::vector<float>  samples;
+      unsigned            silence = 0;
+      bool                flush = false;
+    };
+
+    AudioDecoder*     m_dec;
+    Capture*          m_capture;
+    AudioCodecWorker* m_worker;
+    MetricHistogram*  m_codec_time;
+
+    AudioDecoderThreaded(const AudioDecoderThreaded&);
+    AudioDecoderThreaded& operator=(const AudioDecoderThreaded&);
+    void postJob(std::shared_ptr<Job> job);
+
+};  /* class AudioDecoderThreaded */
+
+
+} /* namespace */
+
+#endif /* ASYNC_AUDIO_DECODER_THREADED_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -6,7 +6,7 @@
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2010 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -168,12 +168,7 @@ void AudioDelayLine::mute(bool do_mute, int time_ms)
   {
     fade_pos = 0; // Reset fade gain
     fade_dir = 1; // Fade out
-    ptr = (ptr + size - mute_ext) % size;
-    for (int i=0; i<mute_ext; ++i)
-    {
-      ptr = (ptr < size-1) ? ptr+1 : 0;
-      buf[ptr] *= currentFadeGain();
-    }
+    fadeRing(mute_ext);
     is_muted = true;
     mute_cnt = 0;
   }
@@ -206,12 +201,7 @@ void AudioDelayLine::clear(int time_ms)
 
   //fade_pos = 0; // Reset fade gain
   fade_dir = 1; // Fade out
-  ptr = (ptr + size - count) % size;
-  for (int i=0; i<count; ++i)
-  {
-    ptr = (ptr < size-1) ? ptr+1 : 0;
-    buf[ptr] *= currentFadeGain();
-  }
+  fadeRing(count);
 
   if (!is_muted)
   {
@@ -223,31 +213,50 @@ void AudioDelayLine::clear(int time_ms)
 } /* AudioDelayLine::clear */
 
 
+int AudioDelayLine::peek(int count, const float *seg[2], int len[2]) const
+{
+  count = max(0, min(count, size));
+  seg[0] = buf + ptr;
+  len[0] = min(count, size - ptr);
+  seg[1] = buf;
+  len[1] = count - len[0];
+  return (len[1] > 0) ? 2 : 1;
+} /* AudioDelayLine::peek */
+
+
 int AudioDelayLine::writeSamples(const float *samples, int count)
 {
   flush_cnt = 0;
   last_clear = 0;
   
+    // The oldest samples are written to the sink directly from the ring
+    // buffer. The space they occupied is then reused for the new samples.
   count = min(count, size);
-  float output[count];
-  int out_ptr = ptr;
-  for (int i=0; i<count; ++i)
+  const float *seg[2];
+  int len[2];
+  int segs = peek(count, seg, len);
+  int written = sinkWriteSamples(seg[0], len[0]);
+  if ((segs > 1) && (written == len[0]))
   {
-    output[i] = buf[out_ptr];
-    out_ptr = (out_ptr < size-1) ? out_ptr+1 : 0;
+    written += sinkWriteSamples(seg[1], len[1]);
   }
 
-  int written = sinkWriteSamples(output, count);
-
-  for (int i=0; i<written; ++i)
+  int pos = 0;
+  while (pos < written)
   {
-    buf[ptr] = samples[i] * currentFadeGain();
-    if (is_muted && (mute_cnt > 0) && (--mute_cnt == 0))
+      // Stop at the sample where the mute extension ends, if any
+    int cnt = written - pos;
+    if (is_muted && (mute_cnt > 0))
+    {
+      cnt = min(cnt, mute_cnt);
+    }
+    writeToRing(samples + pos, cnt);
+    pos += cnt;
+    if (is_muted && (mute_cnt > 0) && ((mute_cnt -= cnt) == 0))
     {
       fade_dir = -1; // Fade in
       is_muted = false;
     }
-    ptr = (ptr < size-1) ? ptr+1 : 0;
   }
   
   return written;
@@ -306,28 +315,18 @@ void AudioDelayLine::allSamplesFlushed(void)
 
 void AudioDelayLine::writeRemainingSamples(void)
 {
-  float output[512];
   int written = 1; // Set to 1 so that we enter the loop the first time around
 
   while ((written > 0) && (flush_cnt > 0))
   {
-    int count = min(512, flush_cnt);
-    
-    int out_ptr = ptr;
-    for (int i=0; i<count; ++i)
-    {
-      output[i] = buf[out_ptr];
-      out_ptr = (out_ptr < size-1) ? out_ptr+1 : 0;
-    }
-
-    written = sinkWriteSamples(output, count);
-
-    for (int i=0; i<written; ++i)
+    int count = min(size - ptr, flush_cnt);
+    written = sinkWriteSamples(buf + ptr, count);
+    memset(buf + ptr, 0, written * sizeof(*buf));
+    ptr += written;
+    if (ptr == size)
     {
-      buf[ptr] = 0;
-      ptr = (ptr < size-1) ? ptr+1 : 0;
+      ptr = 0;
     }
-
     flush_cnt -= written;
   }
   
@@ -338,6 +337,159 @@ void AudioDelayLine::writeRemainingSamples(void)
 } /* AudioDelayLine::writeRemainingSamples */
 
 
+/*
+ *----------------------------------------------------------------------------
+ * Method:    AudioDelayLine::writeToRing
+ * Purpose:   Write samples into the ring buffer at the current position,
+ *            applying the fade gain. The write is split in at most two
+ *            contiguous segments at the end of the ring buffer.
+ * Input:     samples - The samples to write
+ *            count   - The number of samples to write, at most size
+ * Output:    None
+ * Author:    agent
+ * Created:   2026-10-17
+ * Remarks:   
+ * Bugs:      
+ *----------------------------------------------------------------------------
+ */
+void AudioDelayLine::writeToRing(const float *samples, int count)
+{
+  while (count > 0)
+  {
+    int cnt = min(count, size - ptr);
+    applyFade(buf + ptr, samples, cnt);
+    samples += cnt;
+    count -= cnt;
+    ptr += cnt;
+    if (ptr == size)
+    {
+      ptr = 0;
+    }
+  }
+} /* AudioDelayLine::writeToRing */
+
+
+/*
+ *----------------------------------------------------------------------------
+ * Method:    AudioDelayLine::fadeRing
+ * Purpose:   Apply the fade gain, in place, to the most recently written
+ *            samples in the ring buffer.
+ * Input:     count - The number of samples to apply the fade to
+ * Output:    None
+ * Author:    agent
+ * Created:   2026-10-17
+ * Remarks:   
+ * Bugs:      
+ *----------------------------------------------------------------------------
+ */
+void AudioDelayLine::fadeRing(int count)
+{
+  int pos = (ptr + size - count) % size;
+  while (count > 0)
+  {
+    int cnt = min(count, size - pos);
+    applyFade(buf + pos, buf + pos, cnt);
+    count -= cnt;
+    pos += cnt;
+    if (pos == size)
+    {
+      pos = 0;
+    }
+  }
+} /* AudioDelayLine::fadeRing */
+
+
+/*
+ *----------------------------------------------------------------------------
+ * Method:    AudioDelayLine::applyFade
+ * Purpose:   Copy samples while applying the fade gain. While fading, the
+ *            gain is read straight from the fade table, in increasing
+ *            order when fading out and in decreasing order when fading in.
+ *            When the fade is done the remaining samples get the same gain
+ *            so they are just copied, zeroed or scaled. All loops are
+ *            simple enough to be vectorized by the compiler.
+ * Input:     dest  - Destination buffer. May be the same as src.
+ *            src   - Source buffer
+ *            count - The number of samples to process
+ * Output:    None
+ * Author:    agent
+ * Created:   2026-10-17
+ * Remarks:   
+ * Bugs:      
+ *----------------------------------------------------------------------------
+ */
+void AudioDelayLine::applyFade(float *dest, const float *src, int count)
+{
+  if (fade_gain == 0)
+  {
+    if (dest != src)
+    {
+      memcpy(dest, src, count * sizeof(*dest));
+    }
+    return;
+  }
+
+  int ramp_len = 0;
+  const float *gain = fade_gain + fade_pos;
+  if (fade_dir > 0)
+  {
+    ramp_len = min(count, fade_len - 1 - fade_pos);
+    for (int i=0; i<ramp_len; ++i)
+    {
+      dest[i] = src[i] * gain[i];
+    }
+    fade_pos += ramp_len;
+    if (fade_pos >= fade_len-1)
+    {
+      fade_dir = 0;
+      fade_pos = fade_len-1;
+    }
+  }
+  else if (fade_dir < 0)
+  {
+    ramp_len = min(count, fade_pos);
+    for (int i=0; i<ramp_len; ++i)
+    {
+      dest[i] = src[i] * gain[-i];
+    }
+    fade_pos -= ramp_len;
+    if (fade_pos <= 0)
+    {
+      fade_dir = 0;
+      fade_pos = 0;
+    }
+  }
+
+  dest += ramp_len;
+  src += ramp_len;
+  count -= ramp_len;
+  if (count <= 0)
+  {
+    return;
+  }
+
+  const float g = fade_gain[fade_pos];
+  if (g == 0.0f)
+  {
+    memset(dest, 0, count * sizeof(*dest));
+  }
+  else if (g == 1.0f)
+  {
+    if (dest != src)
+    {
+      memcpy(dest, src, count * sizeof(*dest));
+    }
+  }
+  else
+  {
+    for (int i=0; i<count; ++i)
+    {
+      dest[i] = src[i] * g;
+    }
+  }
+} /* AudioDelayLine::applyFade */
+
+
 
 /*
  * This file has not been truncated
@@ -6,7 +6,7 @@
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2010  Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2022  Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -161,6 +161,23 @@ class AudioDelayLine : public Async::AudioSink, public Async::AudioSource
      * samples will not be flushed. They will be thrown away.
      */
     void clear(int time_ms=-1);
+
+    /**
+     * @brief   Get direct access to the oldest samples in the delay line
+     * @param   count The number of samples to look at
+     * @param   seg   Will be set to point at the samples in the delay line
+     * @param   len   Will be set to the number of samples in each segment
+     * @return  Returns the number of segments, 1 or 2
+     *
+     * The samples in the delay line are stored in a ring buffer so the
+     * requested samples may be split in two contiguous segments. The samples
+     * in seg[0] are the oldest ones, i.e. the ones that will be written to
+     * the sink next. The samples are not removed from the delay line and
+     * the pointers are only valid until the delay line is modified.
+     * This is also how samples are handed over to the connected sink, so no
+     * copying is done when writing samples to the sink.
+     */
+    int peek(int count, const float *seg[2], int len[2]) const;
   
     /**
      * @brief 	Write samples into the delay line
@@ -224,31 +241,9 @@ class AudioDelayLine : public Async::AudioSink, public Async::AudioSource
     AudioDelayLine(const AudioDelayLine&);
     AudioDelayLine& operator=(const AudioDelayLine&);
     void writeRemainingSamples(void);
-
-    inline float currentFadeGain(void)
-    {
-      if (fade_gain == 0)
-      {
-        return 1.0f;
-      }
-      
-      float gain = fade_gain[fade_pos];
-      fade_pos += fade_dir;
-      
-      if ((fade_dir > 0) && (fade_pos >= fade_len-1))
-      {
-        fade_dir = 0;
-        fade_pos = fade_len-1;
-      }
-      else if ((fade_dir < 0) && (fade_pos <= 0))
-      {
-        fade_dir = 0;
-        fade_pos = 0;
-      }
-      
-      return gain;
-      
-    } /* AudioDelayLine::currentFadeGain  */
+    void writeToRing(const float *samples, int count);
+    void fadeRing(int count);
+    void applyFade(float *dest, const float *src, int count);
 
 };  /* class AudioDelayLine */
 
@@ -0,0 +1,473 @@
+//
+// Behaviour test for the AudioDelayLine.
+//
+// The AudioDelayLine is compared sample for sample with a reference, which
+// is the per sample implementation that was used before the block based
+// one. The only difference is that the reference fade the most recently
+// written samples on mute and clear. The old implementation was off by one
+// and faded the oldest sample in the line instead of the newest one.
+//
+// For each seed a delay line of random length is run through a random
+// sequence of writes, mutes and unmutes with and without extension, clears,
+// fade time changes and flushes. The sink only accept a limited number of
+// samples, set for each step, so that partial writes and resumed flushes
+// are exercised. The peek function is checked by comparing the peeked
+// samples with the samples written to the sink by the next write.
+//
+// Usage: AsyncAudioDelayLineTest [seeds] [steps]
+//
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#include "AsyncAudioSink.h"
+#include "AsyncAudioSource.h"
+#include "AsyncAudioDelayLine.h"
+
+using namespace std;
+using namespace Async;
+
+
+namespace {
+
+  // The AudioDelayLine implementation before it was made block based, with
+  // the mute/clear off by one fixed
+class RefDelayLine : public AudioSink, public AudioSource
+{
+  public:
+    explicit RefDelayLine(int length_ms)
+      : size(length_ms * INTERNAL_SAMPLE_RATE / 1000), ptr(0), flush_cnt(0),
+        is_muted(false), mute_cnt(0), last_clear(0), fade_gain(0),
+        fade_len(0), fade_pos(0), fade_dir(0)
+    {
+      buf = new float[size];
+      memset(buf, 0, size * sizeof(*buf));
+      clear();
+      setFadeTime(DEFAULT_FADE_TIME);
+    }
+
+    ~RefDelayLine(void)
+    {
+      delete [] fade_gain;
+      delete [] buf;
+    }
+
+    void setFadeTime(int time_ms)
+    {
+      delete [] fade_gain;
+      fade_gain = 0;
+      if (time_ms <= 0)
+      {
+        fade_len = 0;
+        fade_pos = 0;
+        fade_dir = 0;
+        return;
+      }
+      fade_len = time_ms * INTERNAL_SAMPLE_RATE / 1000;
+      fade_pos = min(fade_pos, fade_len-1);
+      fade_gain = new float[fade_len];
+      for (int i=0; i<fade_len-1; ++i)
+      {
+        fade_gain[i] = pow(2.0f, -15.0f * (static_cast<float>(i) / fade_len));
+      }
+      fade_gain[fade_len-1] = 0;
+    }
+
+    void mute(bool do_mute, int time_ms=0)
+    {
+      int mute_ext = 0;
+      if (time_ms > 0)
+      {
+        mute_ext = min(size, time_ms * INTERNAL_SAMPLE_RATE / 1000);
+      }
+      if (do_mute)
+      {
+        fade_pos = 0;
+        fade_dir = 1;
+        fadeNewest(mute_ext);
+        is_muted = true;
+        mute_cnt = 0;
+      }
+      else if (mute_ext == 0)
+      {
+        fade_dir = -1;
+        is_muted = false;
+      }
+      else
+      {
+        mute_cnt = mute_ext;
+      }
+    }
+
+    void clear(int time_ms=-1)
+    {
+      int count = size;
+      if (time_ms >= 0)
+      {
+        count = min(size, time_ms * INTERNAL_SAMPLE_RATE / 1000);
+      }
+      fade_dir = 1;
+      fadeNewest(count);
+      if (!is_muted)
+      {
+        fade_dir = -1;
+      }
+      last_clear = max(0, count - fade_len);
+    }
+
+    int writeSamples(const float *samples, int count)
+    {
+      flush_cnt = 0;
+      last_clear = 0;
+      count = min(count, size);
+      vector<float> output(count);
+      int out_ptr = ptr;
+      for (int i=0; i<count; ++i)
+      {
+        output[i] = buf[out_ptr];
+        out_ptr = (out_ptr < size-1) ? out_ptr+1 : 0;
+      }
+      int written = sinkWriteSamples(&output[0], count);
+      for (int i=0; i<written; ++i)
+      {
+        buf[ptr] = samples[i] * currentFadeGain();
+        if (is_muted && (mute_cnt > 0) && (--mute_cnt == 0))
+        {
+          fade_dir = -1;
+          is_muted = false;
+        }
+        ptr = (ptr < size-1) ? ptr+1 : 0;
+      }
+      return written;
+    }
+
+    void flushSamples(void)
+    {
+      flush_cnt = size - last_clear;
+      if (flush_cnt > 0)
+      {
+        writeRemainingSamples();
+      }
+      else
+      {
+        sinkFlushSamples();
+      }
+    }
+
+    void resumeOutput(void)
+    {
+      if (flush_cnt > 0)
+      {
+        writeRemainingSamples();
+      }
+      else
+      {
+        sourceResumeOutput();
+      }
+    }
+
+    void allSamplesFlushed(void) { sourceAllSamplesFlushed(); }
+
+  private:
+    static const int DEFAULT_FADE_TIME = 10;
+
+    float *buf;
+    int   size;
+    int   ptr;
+    int   flush_cnt;
+    bool  is_muted;
+    int   mute_cnt;
+    int   last_clear;
+    float *fade_gain;
+    int   fade_len;
+    int   fade_pos;
+    int   fade_dir;
+
+    void fadeNewest(int count)
+    {
+      ptr = (ptr + size - count) % size;
+      for (int i=0; i<count; ++i)
+      {
+        buf[ptr] *= currentFadeGain();
+        ptr = (ptr < size-1) ? ptr+1 : 0;
+      }
+    }
+
+    void writeRemainingSamples(void)
+    {
+      float output[512];
+      int written = 1;
+      while ((written > 0) && (flush_cnt > 0))
+      {
+        int count = min(512, flush_cnt);
+        int out_ptr = ptr;
+        for (int i=0; i<count; ++i)
+        {
+          output[i] = buf[out_ptr];
+          out_ptr = (out_ptr < size-1) ? out_ptr+1 : 0;
+        }
+        written = sinkWriteSamples(output, count);
+        for (int i=0; i<written; ++i)
+        {
+          buf[ptr] = 0;
+          ptr = (ptr < size-1) ? ptr+1 : 0;
+        }
+        flush_cnt -= written;
+      }
+      if (flush_cnt == 0)
+      {
+        sinkFlushSamples();
+      }
+    }
+
+    inline float currentFadeGain(void)
+    {
+      if (fade_gain == 0)
+      {
+        return 1.0f;
+      }
+      float gain = fade_gain[fade_pos];
+      fade_pos += fade_dir;
+      if ((fade_dir > 0) && (fade_pos >= fade_len-1))
+      {
+        fade_dir = 0;
+        fade_pos = fade_len-1;
+      }
+      else if ((fade_dir < 0) && (fade_pos <= 0))
+      {
+        fade_dir = 0;
+        fade_pos = 0;
+      }
+      return gain;
+    }
+};
+
+  // A sink that accept a limited number of samples until the budget is
+  // refilled. A flush is recorded as a NaN in the output.
+class BudgetSink : public AudioSink
+{
+  public:
+    vector<float> out;
+
+    BudgetSink(void) : m_budget(0) {}
+
+    void setBudget(int budget) { m_budget = budget; }
+
+    virtual int writeSamples(const float *samples, int count)
+    {
+      count = min(count, m_budget);
+      out.insert(out.end(), samples, samples + count);
+      m_budget -= count;
+      return count;
+    }
+
+    virtual void flushSamples(void)
+    {
+      out.push_back(NAN);
+      sourceAllSamplesFlushed();
+    }
+
+    void resume(void) { sourceResumeOutput(); }
+
+  private:
+    int m_budget;
+};
+
+class NullSource : public AudioSource
+{
+  public:
+    virtual void resumeOutput(void) {}
+    virtual void allSamplesFlushed(void) {}
+};
+
+bool sameOutput(const vector<float>& a, const vector<float>& b)
+{
+  if (a.size() != b.size())
+  {
+    return false;
+  }
+  for (size_t i=0; i<a.size(); ++i)
+  {
+    if (isnan(a[i]) != isnan(b[i]))
+    {
+      return false;
+    }
+    if (!isnan(a[i]) && (a[i] != b[i]))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool runSeed(unsigned seed, unsigned steps)
+{
+  srand(seed);
+  const int length_ms = 20 + rand() % 500;
+  const int size = length_ms * INTERNAL_SAMPLE_RATE / 1000;
+
+  NullSource ref_src, dut_src;
+  RefDelayLine ref(length_ms);
+  AudioDelayLine dut(length_ms);
+  BudgetSink ref_sink, dut_sink;
+  ref_src.registerSink(&ref);
+  dut_src.registerSink(&dut);
+  ref.registerSink(&ref_sink);
+  dut.registerSink(&dut_sink);
+
+  vector<float> samples(size);
+  for (unsigned step=0; step<steps; ++step)
+  {
+      // Most of the time the sink accept everything
+    const int budget = (rand() % 4 == 0) ? rand() % 600 : size;
+    ref_sink.setBudget(budget);
+    dut_sink.setBudget(budget);
+
+    string op;
+    const int what = rand() % 100;
+    if (what < 70)
+    {
+      const int count = 1 + rand() % min(size, 600);
+      for (int i=0; i<count; ++i)
+      {
+        samples[i] = static_cast<float>(rand()) / RAND_MAX - 0.5f;
+      }
+      const int ref_written = ref.writeSamples(&samples[0], count);
+      const int dut_written = dut.writeSamples(&samples[0], count);
+      op = "write " + to_string(count);
+      if (ref_written != dut_written)
+      {
+        cerr << "*** ERROR: Seed " << seed << " step " << step << ": "
+             << op << " wrote " << dut_written << " samples instead of "
+             << ref_written << endl;
+        return false;
+      }
+    }
+    else if (what < 78)
+    {
+      const int ext = (rand() % 2 == 0) ? 0 : rand() % 300;
+      ref.mute(true, ext);
+      dut.mute(true, ext);
+      op = "mute " + to_string(ext);
+    }
+    else if (what < 86)
+    {
+      const int ext = (rand() % 2 == 0) ? 0 : rand() % 300;
+      ref.mute(false, ext);
+      dut.mute(false, ext);
+      op = "unmute " + to_string(ext);
+    }
+    else if (what < 91)
+    {
+      const int time_ms = (rand() % 3 == 0) ? -1 : rand() % 600;
+      ref.clear(time_ms);
+      dut.clear(time_ms);
+      op = "clear " + to_string(time_ms);
+    }
+    else if (what < 94)
+    {
+      const int time_ms = rand() % 40;
+      ref.setFadeTime(time_ms);
+      dut.setFadeTime(time_ms);
+      op = "fade " + to_string(time_ms);
+    }
+    else if (what < 97)
+    {
+      ref.flushSamples();
+      dut.flushSamples();
+      op = "flush";
+    }
+    else
+    {
+      ref_sink.resume();
+      dut_sink.resume();
+      op = "resume";
+    }
+
+    if (!sameOutput(ref_sink.out, dut_sink.out))
+    {
+      cerr << "*** ERROR: Seed " << seed << " step " << step << ": "
+           << "The output differ from the reference after " << op << endl;
+      return false;
+    }
+    ref_sink.out.clear();
+    dut_sink.out.clear();
+
+      // The samples returned by peek must be the ones that the next write
+      // pass on to the sink
+    const int count = 1 + rand() % size;
+    const float *seg[2];
+    int len[2];
+    const int segs = dut.peek(count, seg, len);
+    vector<float> peeked(seg[0], seg[0] + len[0]);
+    if (segs > 1)
+    {
+      peeked.insert(peeked.end(), seg[1], seg[1] + len[1]);
+    }
+    if (static_cast<int>(peeked.size()) != count)
+    {
+      cerr << "*** ERROR: Seed " << seed << " step " << step << ": "
+           << "peek returned " << peeked.size() << " samples instead of "
+           << count << endl;
+      return false;
+    }
+    for (int i=0; i<count; ++i)
+    {
+      samples[i] = 0.0f;
+    }
+    ref_sink.setBudget(count);
+    dut_sink.setBudget(count);
+    ref.writeSamples(&samples[0], count);
+    dut.writeSamples(&samples[0], count);
+    if ((dut_sink.out.size() != peeked.size()) ||
+        !equal(peeked.begin(), peeked.end(), dut_sink.out.begin()) ||
+        !sameOutput(ref_sink.out, dut_sink.out))
+    {
+      cerr << "*** ERROR: Seed " << seed << " step " << step << ": "
+           << "The peeked samples differ from the written samples" << endl;
+      return false;
+    }
+    ref_sink.out.clear();
+    dut_sink.out.clear();
+  }
+
+  ref.unregisterSink();
+  dut.unregisterSink();
+  ref_src.unregisterSink();
+  dut_src.unregisterSink();
+
+  return true;
+}
+
+} /* anonymous namespace */
+
+
+int main(int argc, char **argv)
+{
+  unsigned seeds = 100;
+  unsigned steps = 2000;
+  if (argc > 1)
+  {
+    seeds = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    steps = atoi(argv[2]);
+  }
+
+  for (unsigned seed=1; seed<=seeds; ++seed)
+  {
+    if (!runSeed(seed, steps))
+    {
+      return 1;
+    }
+  }
+
+  cout << "OK: " << seeds << " seeds with " << steps << " steps each" << endl;
+  return 0;
+}
@@ -55,6 +55,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include "AsyncApplication.h"
 #include "AsyncFdWatch.h"
 #include "AsyncAudioIO.h"
 #include "AsyncAudioDevice.h"
@@ -111,6 +112,7 @@ using namespace Async;
  ****************************************************************************/
 
 map<string, AudioDevice*>  AudioDevice::devices;
+std::mutex                 AudioDevice::devices_mutex;
 int AudioDevice::sample_rate = DEFAULT_SAMPLE_RATE;
 size_t AudioDevice::block_size_hint = DEFAULT_BLOCK_SIZE_HINT;
 size_t AudioDevice::block_count_hint = DEFAULT_BLOCK_COUNT_HINT;
@@ -138,6 +140,9 @@ AudioDevice *AudioDevice::registerAudioIO(const string& dev_designator,
   string dev_type(dev_designator.substr(0, colon_pos));
   string dev_name(dev_designator.substr(colon_pos+1, string::npos));
   
+    // Logic cores running in different threads may create audio devices at
+    // the same time
+  std::lock_guard<std::mutex> lk(devices_mutex);
   AudioDevice *dev = 0;
   if (devices.count(dev_designator) == 0)
   {
@@ -150,9 +155,17 @@ AudioDevice *AudioDevice::registerAudioIO(const string& dev_designator,
       return 0;
     }
 
+    dev->app = &Application::app();
     devices[dev_designator] = dev;
   }
   dev = devices[dev_designator];
+  if (dev->app != &Application::app())
+  {
+    cerr << "*** ERROR: The audio device \"" << dev_designator << "\" is "
+            "already in use by another thread. All users of an audio device "
+            "must run in the same thread.\n";
+    return 0;
+  }
   ++dev->use_count;
   dev->aios.push_back(audio_io);
   return dev;
@@ -168,6 +181,7 @@ void AudioDevice::unregisterAudioIO(AudioIO *audio_io)
     return;
   }
   
+  std::lock_guard<std::mutex> lk(devices_mutex);
   assert(dev->use_count > 0);
   
   list<AudioIO*>::iterator it =
@@ -253,7 +267,7 @@ void AudioDevice::close(void)
 
 
 AudioDevice::AudioDevice(const string& dev_name)
-  : dev_name(dev_name), current_mode(MODE_NONE), use_count(0)
+  : dev_name(dev_name), current_mode(MODE_NONE), use_count(0), app(0)
 {
 } /* AudioDevice::AudioDevice */
 
@@ -41,6 +41,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <string>
 #include <map>
 #include <list>
+#include <mutex>
 
 
 /****************************************************************************
@@ -85,6 +86,7 @@ namespace Async
 
 class AudioIO;
 class FdWatch;
+class Application;
 
 
 /****************************************************************************
@@ -361,10 +363,12 @@ class AudioDevice : public sigc::trackable
     static const size_t DEFAULT_BLOCK_SIZE_HINT = 256; // Samples/channel/block
 
     static std::map<std::string, AudioDevice*>  devices;
+    static std::mutex                           devices_mutex;
 
     Mode      	      	current_mode;
     size_t              use_count;
     std::list<AudioIO*> aios;
+    Application*        app;
 
 };  /* class AudioDevice */
 
@@ -152,6 +152,15 @@ class AudioEncoder : public AudioSink, public sigc::trackable
      * @brief Print codec parameter settings
      */
     virtual void printCodecParams(void) {}
+
+    /**
+     * @brief   Get the number of samples that are encoded into each packet
+     * @returns Returns the number of samples, or 0 if samples are not buffered
+     *
+     * An encoder that collect samples into packets may hold up to this many
+     * samples before any encoded data is emitted.
+     */
+    virtual unsigned packetSampleCount(void) const { return 0; }
     
     /**
      * @brief 	Call this function when all encoded samples have been flushed
@@ -132,6 +132,12 @@ class AudioEncoderGsm : public AudioEncoder
      */
     virtual const char *name(void) const { return "GSM"; }
   
+    /**
+     * @brief   Get the number of samples that are encoded into each packet
+     * @returns Returns the number of samples in each packet
+     */
+    virtual unsigned packetSampleCount(void) const { return GSM_BUF_SIZE; }
+
     /**
      * @brief 	A_brief_member_function_description
      * @param 	param1 Description_of_param1
@@ -36,6 +36,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <cassert>
 #include <cstdlib>
 #include <sstream>
+#include <cstring>
+#include <algorithm>
 
 
 /****************************************************************************
@@ -631,26 +633,44 @@ const char *AudioEncoderOpus::applicationTypeStr(opus_int32 type)
 
 int AudioEncoderOpus::writeSamples(const float *samples, int count)
 {
-  for (int i=0; i<count; ++i)
+  int pos = 0;
+  while (pos < count)
   {
-    sample_buf[buf_len++] = samples[i];
-    
-    if (buf_len == frame_size)
+      // Encode directly from the input buffer when there are no buffered
+      // samples and a whole frame is available. Otherwise copy as many
+      // samples as possible into the frame buffer in one go.
+    const float *frame = 0;
+    if ((buf_len == 0) && (count - pos >= frame_size))
     {
-      buf_len = 0;
-      unsigned char output_buf[4000];
-      opus_int32 nbytes = opus_encode_float(enc, sample_buf, frame_size,
-                                            output_buf, sizeof(output_buf));
-      //cout << "### frame_size=" << frame_size << " nbytes=" << nbytes << endl;
-      if (nbytes > 0)
-      {
-        writeEncodedSamples(output_buf, nbytes);
-      }
-      else if (nbytes < 0)
+      frame = samples + pos;
+      pos += frame_size;
+    }
+    else
+    {
+      int len = min(count - pos, frame_size - buf_len);
+      memcpy(sample_buf + buf_len, samples + pos, len * sizeof(*samples));
+      buf_len += len;
+      pos += len;
+      if (buf_len < frame_size)
       {
-        cerr << "**** ERROR: Opus encoder error: " << opus_strerror(frame_size)
-             << endl;
+        break;
       }
+      frame = sample_buf;
+      buf_len = 0;
+    }
+
+    unsigned char output_buf[4000];
+    opus_int32 nbytes = opus_encode_float(enc, frame, frame_size,
+                                          output_buf, sizeof(output_buf));
+    //cout << "### frame_size=" << frame_size << " nbytes=" << nbytes << endl;
+    if (nbytes > 0)
+    {
+      writeEncodedSamples(output_buf, nbytes);
+    }
+    else if (nbytes < 0)
+    {
+      cerr << "**** ERROR: Opus encoder error: " << opus_strerror(nbytes)
+           << endl;
     }
   }
   
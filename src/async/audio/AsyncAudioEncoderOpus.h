@@ -157,6 +157,12 @@ class AudioEncoderOpus : public AudioEncoder
      */
     virtual void printCodecParams(void);
     
+    /**
+     * @brief   Get the number of samples that are encoded into each packet
+     * @returns Returns the number of samples in each packet
+     */
+    virtual unsigned packetSampleCount(void) const { return frame_size; }
+
     /**
      * @brief   Set the complexity to use
      * @param   new_comp The new complexity value to set (0-10)
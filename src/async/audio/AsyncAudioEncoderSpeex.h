@@ -140,6 +140,15 @@ class AudioEncoderSpeex : public AudioEncoder
      */
     virtual void printCodecParams(void);
     
+    /**
+     * @brief   Get the number of samples that are encoded into each packet
+     * @returns Returns the number of samples in each packet
+     */
+    virtual unsigned packetSampleCount(void) const
+    {
+      return frame_size * frames_per_packet;
+    }
+
     /**
      * @brief 	Set the number of frames that are sent in each packet
      * @param 	fpp Frames per packet
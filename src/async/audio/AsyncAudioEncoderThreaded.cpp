@@ -0,0 +1,272 @@
+/**
+@file	 AsyncAudioEncoderThreaded.cpp
+@brief   An audio encoder wrapper that encode in a worker thread
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cassert>
+#include <chrono>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncAudioEncoderThreaded.h"
+#include "AsyncAudioCodecWorker.h"
+#include "AsyncMetrics.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+AudioEncoderThreaded::AudioEncoderThreaded(AudioEncoder *enc)
+  : m_enc(enc), m_worker(0), m_job(0), m_codec_time(0)
+{
+  assert(m_enc != 0);
+  m_codec_time = &AudioCodecWorker::processingTime(m_enc->name(), "encode");
+  m_enc->writeEncodedSamples.connect(
+      sigc::mem_fun(*this, &AudioEncoderThreaded::onEncodedSamples));
+  m_enc->flushEncodedSamples.connect(
+      sigc::mem_fun(*this, &AudioEncoderThreaded::onFlushEncodedSamples));
+  m_worker = new AudioCodecWorker;
+} /* AudioEncoderThreaded::AudioEncoderThreaded */
+
+
+AudioEncoderThreaded::~AudioEncoderThreaded(void)
+{
+    // The worker thread must be stopped before the encoder is deleted
+  delete m_worker;
+  m_worker = 0;
+  delete m_enc;
+  m_enc = 0;
+} /* AudioEncoderThreaded::~AudioEncoderThreaded */
+
+
+void AudioEncoderThreaded::setOption(const std::string &name,
+                                     const std::string &value)
+{
+  m_worker->sync();
+  m_enc->setOption(name, value);
+} /* AudioEncoderThreaded::setOption */
+
+
+void AudioEncoderThreaded::printCodecParams(void)
+{
+  m_worker->sync();
+  m_enc->printCodecParams();
+} /* AudioEncoderThreaded::printCodecParams */
+
+
+unsigned AudioEncoderThreaded::packetSampleCount(void) const
+{
+  m_worker->sync();
+  return m_enc->packetSampleCount();
+} /* AudioEncoderThreaded::packetSampleCount */
+
+
+int AudioEncoderThreaded::writeSamples(const float *samples, int count)
+{
+  if (count <= 0)
+  {
+    return 0;
+  }
+
+  std::shared_ptr<Job> job = make_shared<Job>();
+  job->samples.assign(samples, samples + count);
+  postJob(job);
+
+  return count;
+} /* AudioEncoderThreaded::writeSamples */
+
+
+void AudioEncoderThreaded::flushSamples(void)
+{
+  postJob(make_shared<Job>());
+} /* AudioEncoderThreaded::flushSamples */
+
+
+unsigned AudioEncoderThreaded::pendingJobs(void) const
+{
+  return m_worker->pending();
+} /* AudioEncoderThreaded::pendingJobs */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void AudioEncoderThreaded::onEncodedSamples(const void *buf, int size)
+{
+    // Called in the worker thread from the wrapped encoder
+  assert(m_job != 0);
+  const char *ptr = reinterpret_cast<const char*>(buf);
+  m_job->frames.emplace_back(ptr, ptr + size);
+} /* AudioEncoderThreaded::onEncodedSamples */
+
+
+void AudioEncoderThreaded::onFlushEncodedSamples(void)
+{
+    // Called in the worker thread from the wrapped encoder
+  assert(m_job != 0);
+  m_job->flush = true;
+} /* AudioEncoderThreaded::onFlushEncodedSamples */
+
+
+/*
+ *----------------------------------------------------------------------------
+ * Method:    AudioEncoderThreaded::postJob
+ * Purpose:   Queue a job for the worker thread. A job without samples is a
+ *            flush request. The m_job member is only used by the worker
+ *            thread to collect the output from the wrapped encoder. The
+ *            collected frames are then emitted from the main thread.
+ * Input:     job - The job to post
+ * Output:    None
+ * Author:    agent
+ * Created:   2026-10-17
+ * Remarks:
+ * Bugs:
+ *----------------------------------------------------------------------------
+ */
+void AudioEncoderThreaded::postJob(std::shared_ptr<Job> job)
+{
+  m_worker->post(
+      [this, job]()
+      {
+        m_job = job.get();
+        if (job->samples.empty())
+        {
+          m_enc->flushSamples();
+        }
+        else
+        {
+          auto start = std::chrono::steady_clock::now();
+          m_enc->writeSamples(job->samples.data(), job->samples.size());
+          std::chrono::duration<double> elapsed =
+              std::chrono::steady_clock::now() - start;
+          m_codec_time->observe(elapsed.count());
+        }
+        m_job = 0;
+      },
+      [this, job]()
+      {
+        for (const auto& frame : job->frames)
+        {
+          writeEncodedSamples(frame.data(), frame.size());
+        }
+        if (job->flush)
+        {
+          flushEncodedSamples();
+        }
+      });
+} /* AudioEncoderThreaded::postJob */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,220 @@
+/**
+@file	 AsyncAudioEncoderThreaded.h
+@brief   An audio encoder wrapper that encode in a worker thread
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_AUDIO_ENCODER_THREADED_INCLUDED
+#define ASYNC_AUDIO_ENCODER_THREADED_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <vector>
+#include <memory>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioEncoder.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+class AudioCodecWorker;
+class MetricHistogram;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	An audio encoder wrapper that encode in a worker thread
+@author agent
+@date   2026-10-17
+
+This class wrap another audio encoder and run the actual encoding in a
+separate worker thread. Samples written to this object are copied and queued
+for the worker thread. Encoded frames are emitted through the
+writeEncodedSamples signal from the main thread, in the same order as they
+were produced by the wrapped encoder. A flush request is queued behind any
+pending samples so that the flushEncodedSamples signal is emitted after the
+last encoded frame.
+
+The wrapped encoder must not be used directly after it has been handed over
+to this class. Use the setOption and printCodecParams functions of this
+class instead. They wait for the worker thread to become idle before
+forwarding the call.
+
+\code
+Async::AudioEncoder *enc = Async::AudioEncoder::create("OPUS");
+enc = new Async::AudioEncoderThreaded(enc);
+\endcode
+*/
+class AudioEncoderThreaded : public AudioEncoder
+{
+  public:
+    /**
+     * @brief 	Constructor
+     * @param 	enc The encoder to wrap. Ownership is taken.
+     */
+    explicit AudioEncoderThreaded(AudioEncoder *enc);
+
+    /**
+     * @brief 	Destructor
+     */
+    ~AudioEncoderThreaded(void);
+
+    /**
+     * @brief   Get the name of the codec
+     * @returns Return the name of the wrapped codec
+     */
+    virtual const char *name(void) const { return m_enc->name(); }
+
+    /**
+     * @brief 	Set an option for the encoder
+     * @param 	name The name of the option
+     * @param 	value The value of the option
+     */
+    virtual void setOption(const std::string &name, const std::string &value);
+
+    /**
+     * @brief Print codec parameter settings
+     */
+    virtual void printCodecParams(void);
+
+    /**
+     * @brief   Get the number of samples that are encoded into each packet
+     * @returns Returns the number of samples in each packet
+     */
+    virtual unsigned packetSampleCount(void) const;
+
+    /**
+     * @brief 	Write samples into this audio sink
+     * @param 	samples The buffer containing the samples
+     * @param 	count The number of samples in the buffer
+     * @return	Returns the number of samples that has been taken care of
+     */
+    virtual int writeSamples(const float *samples, int count);
+
+    /**
+     * @brief 	Tell the sink to flush the previously written samples
+     */
+    virtual void flushSamples(void);
+
+    /**
+     * @brief   Get the number of queued jobs
+     * @return  Returns the number of jobs not yet completed
+     */
+    unsigned pendingJobs(void) const;
+
+  protected:
+
+  private:
+    struct Job
+    {
+      std::vector<float>                  samples;
+      std::vector<std::vector<char> >     frames;
+      bool                                flush = false;
+    };
+
+    AudioEncoder*     m_enc;
+    AudioCodecWorker* m_worker;
+    Job*              m_job;
+    MetricHistogram*  m_codec_time;
+
+    AudioEncoderThreaded(const AudioEncoderThreaded&);
+    AudioEncoderThreaded& operator=(const AudioEncoderThreaded&);
+    void onEncodedSamples(const void *buf, int size);
+    void onFlushEncodedSamples(void);
+    void postJob(std::shared_ptr<Job> job);
+
+};  /* class AudioEncoderThreaded */
+
+
+} /* namespace */
+
+#endif /* ASYNC_AUDIO_ENCODER_THREADED_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
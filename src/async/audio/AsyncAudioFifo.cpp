@@ -54,6 +54,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include "AsyncMetrics.h"
 #include "AsyncAudioFifo.h"
 
 
@@ -241,6 +242,7 @@ int AudioFifo::writeSamples(const float *samples, int count)
   }
   
   int samples_written = 0;
+  unsigned samples_overwritten = 0;
   if (empty() && !prebuf)
   {
     samples_written = sinkWriteSamples(samples, count);
@@ -263,6 +265,7 @@ int AudioFifo::writeSamples(const float *samples, int count)
 	  if (do_overwrite)
 	  {
       	    tail = (tail < fifo_size-1) ? tail + 1 : 0;
+            ++samples_overwritten;
 	  }
 	  else
 	  {
@@ -285,6 +288,14 @@ int AudioFifo::writeSamples(const float *samples, int count)
   }
 
   input_stopped = (samples_written == 0);
+
+  if (samples_overwritten > 0)
+  {
+    static MetricCounter& overrun_cnt = MetricsRegistry::instance().counter(
+        "async_audio_fifo_overrun_samples_total",
+        "Number of samples thrown away due to audio FIFO overruns");
+    overrun_cnt.inc(samples_overwritten);
+  }
   
   return samples_written;
   
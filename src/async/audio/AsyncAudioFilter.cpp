@@ -37,7 +37,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <cstring>
 #include <cstdlib>
 #include <cmath>
-#include <locale>
+#include <clocale>
 
 
 /****************************************************************************
@@ -167,9 +167,12 @@ bool AudioFilter::parseFilterSpec(const std::string &filter_spec)
   strncpy(spec_buf, filter_spec.c_str(), sizeof(spec_buf));
   spec_buf[sizeof(spec_buf) - 1] = 0;
   char *spec = spec_buf;
-  char *old_locale = setlocale(LC_ALL, "C");
+    // Use a thread local locale since other threads may be running
+  locale_t c_locale = newlocale(LC_ALL_MASK, "C", (locale_t)0);
+  locale_t old_locale = uselocale(c_locale);
   char *fferr = fid_parse(sample_rate, &spec, &fv->ff);
-  setlocale(LC_ALL, old_locale);
+  uselocale(old_locale);
+  freelocale(c_locale);
   if (fferr != 0)
   {
     error_str = fferr;
@@ -0,0 +1,394 @@
+/**
+@file	 AsyncAudioFilterBank.cpp
+@brief   Run the same audio filter over many channels in one pass
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <clocale>
+#include <cassert>
+#include <algorithm>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+extern "C" {
+#include "fidlib.h"
+};
+
+#include "AsyncAudioFilterBank.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+AudioFilterBank::AudioFilterBank(const string &filter_spec, int sample_rate)
+  : m_gain(1.0f), m_output_gain(1.0f)
+{
+  char spec_buf[256];
+  strncpy(spec_buf, filter_spec.c_str(), sizeof(spec_buf));
+  spec_buf[sizeof(spec_buf) - 1] = 0;
+  char *spec = spec_buf;
+  FidFilter *ff = 0;
+    // Use a thread local locale since other threads may be running
+  locale_t c_locale = newlocale(LC_ALL_MASK, "C", (locale_t)0);
+  locale_t old_locale = uselocale(c_locale);
+  char *fferr = fid_parse(sample_rate, &spec, &ff);
+  uselocale(old_locale);
+  freelocale(c_locale);
+  if (fferr != 0)
+  {
+    m_error_str = fferr;
+    free(fferr);
+    return;
+  }
+
+    // Pair up the FIR and IIR elements into second order sections. Single
+    // coefficient FIR elements are just gain factors.
+  double gain = 1.0;
+  const FidFilter *num = 0;
+  const FidFilter *den = 0;
+  for (const FidFilter *f=ff; f->typ != 0; f=FFNEXT(f))
+  {
+    if (((f->typ != 'I') && (f->typ != 'F')) || (f->len < 1) || (f->len > 3))
+    {
+      m_error_str = "Unsupported filter element in filter bank";
+      break;
+    }
+    if ((f->typ == 'F') && (f->len == 1))
+    {
+      gain *= f->val[0];
+      continue;
+    }
+    const FidFilter *&slot = (f->typ == 'F') ? num : den;
+    if (slot != 0)
+    {
+      addSection(num ? num->val : 0, num ? num->len : 0,
+                 den ? den->val : 0, den ? den->len : 0);
+      num = den = 0;
+    }
+    slot = f;
+  }
+  if ((num != 0) || (den != 0))
+  {
+    addSection(num ? num->val : 0, num ? num->len : 0,
+               den ? den->val : 0, den ? den->len : 0);
+  }
+  m_gain = gain;
+  free(ff);
+
+  if (!m_error_str.empty())
+  {
+    m_sections.clear();
+  }
+} /* AudioFilterBank::AudioFilterBank */
+
+
+AudioFilterBank::~AudioFilterBank(void)
+{
+} /* AudioFilterBank::~AudioFilterBank */
+
+
+void AudioFilterBank::setOutputGain(float gain_db)
+{
+  m_output_gain = powf(10.0f, gain_db / 20.0f);
+} /* AudioFilterBank::setOutputGain */
+
+
+unsigned AudioFilterBank::addChannel(void)
+{
+  for (unsigned ch=0; ch<m_used.size(); ++ch)
+  {
+    if (!m_used[ch])
+    {
+      m_used[ch] = true;
+      resetChannel(ch);
+      return ch;
+    }
+  }
+
+    // No free slot so the state rows have to be widened
+  const unsigned rows = 2 * m_sections.size();
+  const unsigned lanes = m_used.size();
+  vector<float> state(rows * (lanes + 1), 0.0f);
+  for (unsigned row=0; row<rows; ++row)
+  {
+    memcpy(&state[row * (lanes + 1)], &m_state[row * lanes],
+           lanes * sizeof(float));
+  }
+  m_state.swap(state);
+  m_used.push_back(true);
+  return lanes;
+} /* AudioFilterBank::addChannel */
+
+
+void AudioFilterBank::removeChannel(unsigned ch)
+{
+  assert(ch < m_used.size());
+  m_used[ch] = false;
+  resetChannel(ch);
+} /* AudioFilterBank::removeChannel */
+
+
+void AudioFilterBank::resetChannel(unsigned ch)
+{
+  assert(ch < m_used.size());
+  const unsigned rows = 2 * m_sections.size();
+  const unsigned lanes = m_used.size();
+  for (unsigned row=0; row<rows; ++row)
+  {
+    m_state[row * lanes + ch] = 0.0f;
+  }
+} /* AudioFilterBank::resetChannel */
+
+
+void AudioFilterBank::process(float *dest, const float *src, int count)
+{
+  if (!m_used.empty())
+  {
+    filterFrames(dest, src, count, 0, m_used.size());
+  }
+} /* AudioFilterBank::process */
+
+
+void AudioFilterBank::processChannel(unsigned ch, float *dest,
+                                     const float *src, int count)
+{
+  assert(ch < m_used.size());
+  filterFrames(dest, src, count, ch, 1);
+} /* AudioFilterBank::processChannel */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+/*
+ *----------------------------------------------------------------------------
+ * Method:    AudioFilterBank::filterFrames
+ * Purpose:   Run the filter sections over a range of channels. The source
+ *            and destination buffers contain "lanes" samples per frame,
+ *            which map to the channels first..first+lanes-1. Each section
+ *            is run over the whole block before the next one. The loop over
+ *            the channels is innermost and branch free so that it can be
+ *            vectorized.
+ * Input:     dest  - Destination buffer
+ *            src   - Source buffer
+ *            count - The number of frames to process
+ *            first - The first channel to process
+ *            lanes - The number of channels to process
+ * Output:    None
+ * Author:    agent
+ * Created:   2026-10-17
+ * Remarks:   The sections use the transposed direct form II
+ *              y  = b0*x + s1
+ *              s1 = b1*x - a1*y + s2
+ *              s2 = b2*x - a2*y
+ * Bugs:
+ *----------------------------------------------------------------------------
+ */
+void AudioFilterBank::filterFrames(float *dest, const float *src, int count,
+                                   unsigned first, unsigned lanes)
+{
+  const unsigned stride = m_used.size();
+  const int len = count * lanes;
+  const float gain = m_gain * m_output_gain;
+  for (int i=0; i<len; ++i)
+  {
+    dest[i] = gain * src[i];
+  }
+
+  for (unsigned sec=0; sec<m_sections.size(); ++sec)
+  {
+    const Section &s = m_sections[sec];
+    float *s1 = &m_state[2 * sec * stride + first];
+    float *s2 = s1 + stride;
+    if (lanes == 1)
+    {
+        // Keep the state in registers when processing a single channel
+      float z1 = *s1;
+      float z2 = *s2;
+      for (int n=0; n<count; ++n)
+      {
+        const float x = dest[n];
+        const float y = s.b0 * x + z1;
+        z1 = s.b1 * x - s.a1 * y + z2;
+        z2 = s.b2 * x - s.a2 * y;
+        dest[n] = y;
+      }
+      *s1 = z1;
+      *s2 = z2;
+      continue;
+    }
+
+    for (int n=0; n<count; ++n)
+    {
+      float *io = dest + n * lanes;
+      for (unsigned c=0; c<lanes; ++c)
+      {
+        const float x = io[c];
+        const float y = s.b0 * x + s1[c];
+        s1[c] = s.b1 * x - s.a1 * y + s2[c];
+        s2[c] = s.b2 * x - s.a2 * y;
+        io[c] = y;
+      }
+    }
+  }
+} /* AudioFilterBank::filterFrames */
+
+
+/*
+ *----------------------------------------------------------------------------
+ * Method:    AudioFilterBank::addSection
+ * Purpose:   Add a second order section from a fidlib numerator and
+ *            denominator. Missing coefficients are taken to be zero and a
+ *            missing polynomial is taken to be 1. The denominator is
+ *            normalized so that a0 is one.
+ * Input:     num     - Numerator coefficients, most recent first
+ *            num_len - The number of numerator coefficients
+ *            den     - Denominator coefficients, most recent first
+ *            den_len - The number of denominator coefficients
+ * Output:    None
+ * Author:    agent
+ * Created:   2026-10-17
+ * Remarks:
+ * Bugs:
+ *----------------------------------------------------------------------------
+ */
+void AudioFilterBank::addSection(const double *num, int num_len,
+                                 const double *den, int den_len)
+{
+  double b[3] = { 1.0, 0.0, 0.0 };
+  double a[3] = { 1.0, 0.0, 0.0 };
+  if (num_len > 0)
+  {
+    b[0] = 0.0;
+    copy(num, num + num_len, b);
+  }
+  if (den_len > 0)
+  {
+    copy(den, den + den_len, a);
+  }
+  Section s;
+  s.b0 = b[0] / a[0];
+  s.b1 = b[1] / a[0];
+  s.b2 = b[2] / a[0];
+  s.a1 = a[1] / a[0];
+  s.a2 = a[2] / a[0];
+  m_sections.push_back(s);
+} /* AudioFilterBank::addSection */
+
+
+
+/*
+ * This file has not been truncated
+ */
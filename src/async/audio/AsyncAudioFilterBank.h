@@ -0,0 +1,260 @@
+/**
+@file	 AsyncAudioFilterBank.h
+@brief   Run the same audio filter over many channels in one pass
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_AUDIO_FILTER_BANK_INCLUDED
+#define ASYNC_AUDIO_FILTER_BANK_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <string>
+#include <vector>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	Run the same audio filter over many channels in one pass
+@author agent
+@date   2026-10-17
+
+This class implement the same filter as the AudioFilter class, using the
+same filter specification syntax, but for a number of independent channels
+at once. The filter is run as a cascade of second order sections and the
+state of each section is stored with all channels side by side (structure
+of arrays). When all channels are processed together the inner loop run
+over the channels so that the compiler can use SIMD instructions to process
+many channels with each instruction.
+
+The samples for the process function are stored frame by frame, that is
+sample n for channel c is found at index n * channelCount() + c. A single
+channel can also be processed on its own using the processChannel function.
+
+Arithmetic is done in single precision so the result will differ slightly
+from the AudioFilter class, which use double precision internally. Only
+filters that fidlib describe using elements of at most three coefficients
+are supported, which include all the Butterworth, Chebyshev and Bessel
+designs.
+
+\code
+Async::AudioFilterBank bank("BpBu4/5000-5500", 16000);
+unsigned ch1 = bank.addChannel();
+unsigned ch2 = bank.addChannel();
+bank.process(out, in, frames);
+\endcode
+*/
+class AudioFilterBank
+{
+  public:
+    /**
+     * @brief 	Constuctor
+     * @param 	filter_spec The filter specification
+     * @param 	sample_rate The sampling rate
+     *
+     * Use the initOk function to check if the filter specification could be
+     * parsed.
+     */
+    AudioFilterBank(const std::string &filter_spec,
+                    int sample_rate = INTERNAL_SAMPLE_RATE);
+
+    /**
+     * @brief 	Destructor
+     */
+    ~AudioFilterBank(void);
+
+    /**
+     * @brief   Check if the filter was successfully created
+     * @return  Returns \em true if the filter specification was ok
+     */
+    bool initOk(void) const { return m_error_str.empty(); }
+
+    /**
+     * @brief   Get the filter creation error
+     * @return  Returns an error string if the filter creation failed
+     */
+    const std::string& errorString(void) const { return m_error_str; }
+
+    /**
+     * @brief 	Set the output gain of the filter
+     * @param 	gain_db The gain to set in dB
+     */
+    void setOutputGain(float gain_db);
+
+    /**
+     * @brief   Add a channel to the filter bank
+     * @return  Returns the index of the new channel
+     *
+     * A channel slot freed by removeChannel will be reused, so the returned
+     * index is always smaller than or equal to channelCount() before the
+     * call. The state of the new channel is cleared.
+     */
+    unsigned addChannel(void);
+
+    /**
+     * @brief   Remove a channel from the filter bank
+     * @param   ch The channel index
+     *
+     * The slot for the channel is kept so that the index of the other
+     * channels do not change. Samples given for a free slot are still
+     * processed by the process function but the result should be ignored.
+     */
+    void removeChannel(unsigned ch);
+
+    /**
+     * @brief   Get the number of channel slots
+     * @return  Returns the number of channel slots, used or free
+     */
+    unsigned channelCount(void) const { return m_used.size(); }
+
+    /**
+     * @brief   Clear the filter state for one channel
+     * @param   ch The channel index
+     */
+    void resetChannel(unsigned ch);
+
+    /**
+     * @brief   Process all channels
+     * @param   dest  Destination buffer, count * channelCount() samples
+     * @param   src   Source buffer, count * channelCount() samples
+     * @param   count The number of samples per channel
+     *
+     * The source and destination buffers may be the same.
+     */
+    void process(float *dest, const float *src, int count);
+
+    /**
+     * @brief   Process a single channel
+     * @param   ch    The channel index
+     * @param   dest  Destination buffer, count samples
+     * @param   src   Source buffer, count samples
+     * @param   count The number of samples
+     *
+     * The source and destination buffers may be the same.
+     */
+    void processChannel(unsigned ch, float *dest, const float *src,
+                        int count);
+
+  protected:
+
+  private:
+    struct Section
+    {
+      float b0, b1, b2;
+      float a1, a2;
+    };
+
+    std::vector<Section>  m_sections;
+    std::vector<float>    m_state;
+    std::vector<bool>     m_used;
+    float                 m_gain;
+    float                 m_output_gain;
+    std::string           m_error_str;
+
+    AudioFilterBank(const AudioFilterBank&);
+    AudioFilterBank& operator=(const AudioFilterBank&);
+    void filterFrames(float *dest, const float *src, int count,
+                      unsigned first, unsigned lanes);
+    void addSection(const double *num, int num_len,
+                    const double *den, int den_len);
+
+};  /* class AudioFilterBank */
+
+
+} /* namespace */
+
+#endif /* ASYNC_AUDIO_FILTER_BANK_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
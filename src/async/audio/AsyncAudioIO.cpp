@@ -385,6 +385,21 @@ void AudioIO::close(void)
 } /* AudioIO::close */
 
 
+int AudioIO::samplesToWrite(void) const
+{
+  if ((audio_dev == 0) || (io_mode == MODE_NONE))
+  {
+    return -1;
+  }
+  int dev_samples = audio_dev->samplesToWrite();
+  if (dev_samples < 0)
+  {
+    return -1;
+  }
+  return input_fifo->samplesInFifo(true) + dev_samples;
+} /* AudioIO::samplesToWrite */
+
+
 
 /****************************************************************************
  *
@@ -248,9 +248,10 @@ class AudioIO : public Async::AudioSource, public Async::AudioSink
      * This function can be used to find out how many samples there are
      * in the output buffer at the moment. This can for example be used
      * to find out how long it will take before the output buffer has
-     * been flushed.
+     * been flushed. Both the samples waiting in the internal FIFO and the
+     * samples already written to the audio device are counted.
      */
-    //int samplesToWrite(void) const;
+    int samplesToWrite(void) const;
     
     /*
      * @brief 	Call this method to clear all samples in the buffer
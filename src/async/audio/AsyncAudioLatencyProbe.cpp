@@ -0,0 +1,474 @@
+/**
+@file	 AsyncAudioLatencyProbe.cpp
+@brief   A passthrough audio element used to trace latency in an audio path
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <chrono>
+#include <vector>
+#include <map>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncAudioLatencyProbe.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+  // Collect the events from all probes in one trace and print a report
+  // when a spurt has propagated through all of them. Probes may be used by
+  // logic cores running in different threads.
+class AudioLatencyProbe::Tracer
+{
+  public:
+    typedef chrono::steady_clock Clock;
+
+    static Tracer *attach(AudioLatencyProbe *probe)
+    {
+      Registry &reg = registry();
+      std::lock_guard<std::mutex> lk(reg.mutex);
+      reg.probes.insert(probe);
+      const string owner = ownerOf(probe->name());
+      auto it = reg.traces.find(owner);
+      return tracer(reg, (it != reg.traces.end()) ? it->second : owner);
+    }
+
+    static void detach(AudioLatencyProbe *probe)
+    {
+      Registry &reg = registry();
+      std::lock_guard<std::mutex> lk(reg.mutex);
+      reg.probes.erase(probe);
+    }
+
+    static void assign(const string& owner, const string& trace)
+    {
+      Registry &reg = registry();
+      std::lock_guard<std::mutex> lk(reg.mutex);
+      reg.traces[owner] = trace;
+      Tracer *new_tracer = tracer(reg, trace);
+      for (auto probe : reg.probes)
+      {
+        if ((ownerOf(probe->name()) != owner) ||
+            (probe->m_tracer == new_tracer))
+        {
+          continue;
+        }
+        if (probe->m_active)
+        {
+          probe->m_active = false;
+          probe->m_flushing = false;
+          probe->m_tracer->idle(probe);
+        }
+        probe->m_tracer = new_tracer;
+      }
+    }
+
+    void started(const AudioLatencyProbe *probe)
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+        // A stream that is written to again while flushing is resumed
+      Stage *stage = findStage(probe);
+      if (stage != 0)
+      {
+        stage->flushed = false;
+        return;
+      }
+
+        // If all stages of the current spurt have been flushed, a new spurt
+        // is starting. Report the old one even if some probes are still
+        // waiting for the flush to complete so that a sink that never
+        // complete a flush cannot block the tracing.
+      if (!m_stages.empty() && allFlushed())
+      {
+        report();
+        m_stages.clear();
+        m_active_cnt = 0;
+      }
+
+      Stage new_stage;
+      new_stage.probe = probe;
+      new_stage.name = probe->name();
+      new_stage.start = Clock::now();
+      new_stage.flush = new_stage.start;
+      new_stage.flushed = false;
+      new_stage.out_delay_ms = -1.0;
+      m_stages.push_back(new_stage);
+      m_active_cnt += 1;
+    }
+
+    void outputDelay(const AudioLatencyProbe *probe, double delay_ms)
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      Stage *stage = findStage(probe);
+      if (stage != 0)
+      {
+        stage->out_delay_ms = delay_ms;
+      }
+    }
+
+    void flushed(const AudioLatencyProbe *probe)
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      Stage *stage = findStage(probe);
+      if ((stage != 0) && !stage->flushed)
+      {
+        stage->flush = Clock::now();
+        stage->flushed = true;
+      }
+    }
+
+    void idle(const AudioLatencyProbe *probe)
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      Stage *stage = findStage(probe);
+      if (stage == 0)
+      {
+        return;
+      }
+      if (!stage->flushed)
+      {
+        stage->flush = Clock::now();
+        stage->flushed = true;
+      }
+      stage->probe = 0;
+      if ((m_active_cnt > 0) && (--m_active_cnt == 0))
+      {
+        report();
+        m_stages.clear();
+      }
+    }
+
+  private:
+    struct Stage
+    {
+      const AudioLatencyProbe*  probe;
+      string                    name;
+      Clock::time_point         start;
+      Clock::time_point         flush;
+      bool                      flushed;
+      double                    out_delay_ms;
+    };
+
+    struct Registry
+    {
+      std::mutex                        mutex;
+      map<string, unique_ptr<Tracer>>   tracers;
+      map<string, string>               traces;
+      set<AudioLatencyProbe*>           probes;
+    };
+
+    const string  m_trace;
+    std::mutex    m_mutex;
+    vector<Stage> m_stages;
+    unsigned      m_active_cnt = 0;
+
+    explicit Tracer(const string& trace) : m_trace(trace) {}
+
+    static Registry& registry(void)
+    {
+      static Registry reg;
+      return reg;
+    }
+
+    static Tracer *tracer(Registry& reg, const string& trace)
+    {
+      unique_ptr<Tracer> &tracer = reg.tracers[trace];
+      if (!tracer)
+      {
+        tracer.reset(new Tracer(trace));
+      }
+      return tracer.get();
+    }
+
+    static string ownerOf(const string& name)
+    {
+      return name.substr(0, name.rfind(':'));
+    }
+
+    Stage *findStage(const AudioLatencyProbe *probe)
+    {
+      for (auto it=m_stages.rbegin(); it!=m_stages.rend(); ++it)
+      {
+        if (it->probe == probe)
+        {
+          return &(*it);
+        }
+      }
+      return 0;
+    }
+
+    bool allFlushed(void) const
+    {
+      for (const auto& stage : m_stages)
+      {
+        if (!stage.flushed)
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    static double msBetween(const Clock::time_point& from,
+                            const Clock::time_point& to)
+    {
+      return chrono::duration<double, milli>(to - from).count();
+    }
+
+    void report(void)
+    {
+        // A single stage without an output delay carry no information
+      if (m_stages.empty() ||
+          ((m_stages.size() == 1) && (m_stages.front().out_delay_ms < 0.0)))
+      {
+        return;
+      }
+      ostringstream ss;
+      ss << fixed << setprecision(1) << "Audio latency " << m_trace << ": ";
+      const Stage &first = m_stages.front();
+      Clock::time_point prev = first.start;
+      double extra_ms = 0.0;
+      for (auto it=m_stages.begin(); it!=m_stages.end(); ++it)
+      {
+        if (it != m_stages.begin())
+        {
+          ss << ", ";
+        }
+        ss << it->name << " +" << msBetween(prev, it->start) << "ms";
+        if (it->out_delay_ms >= 0.0)
+        {
+          ss << " (+out " << it->out_delay_ms << "ms)";
+          extra_ms = it->out_delay_ms;
+        }
+        else
+        {
+          extra_ms = 0.0;
+        }
+        prev = it->start;
+      }
+      const Stage &last = m_stages.back();
+      Clock::time_point last_flush = first.flush;
+      for (const auto& stage : m_stages)
+      {
+        if (stage.flush > last_flush)
+        {
+          last_flush = stage.flush;
+        }
+      }
+      ss << " | total " << (msBetween(first.start, last.start) + extra_ms)
+         << "ms, tail " << msBetween(first.flush, last_flush) << "ms";
+
+      if (AudioLatencyProbe::traceReport.empty())
+      {
+        cout << ss.str() << endl;
+      }
+      else
+      {
+        AudioLatencyProbe::traceReport(ss.str());
+      }
+    }
+
+};  /* class AudioLatencyProbe::Tracer */
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+sigc::signal<void, const std::string&> AudioLatencyProbe::traceReport;
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+bool AudioLatencyProbe::enabled = false;
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+void AudioLatencyProbe::setEnabled(bool enable)
+{
+  enabled = enable;
+} /* AudioLatencyProbe::setEnabled */
+
+
+void AudioLatencyProbe::setTrace(const string& owner, const string& trace)
+{
+  Tracer::assign(owner, trace);
+} /* AudioLatencyProbe::setTrace */
+
+
+AudioLatencyProbe::AudioLatencyProbe(const string& name)
+  : m_name(name), m_tracer(0), m_active(false), m_flushing(false),
+    m_delay_sample_rate(INTERNAL_SAMPLE_RATE)
+{
+  m_tracer = Tracer::attach(this);
+} /* AudioLatencyProbe::AudioLatencyProbe */
+
+
+AudioLatencyProbe::~AudioLatencyProbe(void)
+{
+  if (m_active)
+  {
+    m_active = false;
+    m_tracer->idle(this);
+  }
+  Tracer::detach(this);
+} /* AudioLatencyProbe::~AudioLatencyProbe */
+
+
+void AudioLatencyProbe::setOutputDelayFunc(const sigc::slot<int>& delay_func,
+                                           int sample_rate)
+{
+  m_delay_func = delay_func;
+  m_delay_sample_rate = sample_rate;
+} /* AudioLatencyProbe::setOutputDelayFunc */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void AudioLatencyProbe::streamStarted(void)
+{
+  m_active = true;
+  m_flushing = false;
+  m_tracer->started(this);
+} /* AudioLatencyProbe::streamStarted */
+
+
+void AudioLatencyProbe::measureOutputDelay(void)
+{
+  if (!m_active || m_delay_func.empty() || (m_delay_sample_rate <= 0))
+  {
+    return;
+  }
+  int samples = m_delay_func();
+  if (samples >= 0)
+  {
+    m_tracer->outputDelay(this,
+        1000.0 * samples / m_delay_sample_rate);
+  }
+} /* AudioLatencyProbe::measureOutputDelay */
+
+
+void AudioLatencyProbe::streamFlushed(void)
+{
+  m_flushing = true;
+  m_tracer->flushed(this);
+} /* AudioLatencyProbe::streamFlushed */
+
+
+void AudioLatencyProbe::streamIdle(void)
+{
+  m_active = false;
+  m_flushing = false;
+  m_tracer->idle(this);
+} /* AudioLatencyProbe::streamIdle */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,291 @@
+/**
+@file	 AsyncAudioLatencyProbe.h
+@brief   A passthrough audio element used to trace latency in an audio path
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_AUDIO_LATENCY_PROBE_INCLUDED
+#define ASYNC_AUDIO_LATENCY_PROBE_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+
+#include <string>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioPassthrough.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	A passthrough audio element used to trace latency in an audio path
+@author agent
+@date   2026-10-17
+
+Latency probes are placed at interesting points in an audio path, for
+example where audio leave a receiver, enter and leave a logic core and just
+before the audio device of a transmitter. The audio is passed through
+untouched. When tracing is enabled, using the static setEnabled function,
+each probe note the time when a new audio stream (talk spurt) reach it and
+when the end of the stream, the flush, reach it.
+
+Each probe belong to a trace, which is a named audio path, e.g. one logic
+core with its receiver and transmitter. The probes are named
+"<owner>:<point>", e.g. "Rx1:out", and by default the trace is named after
+the owner. Using the static setTrace function, all probes of an owner can be
+put in another trace, e.g. the probes of a receiver in the trace of the logic
+core using it. A trace is tracked on its own so that audio passing through
+different paths at the same time does not interfere.
+
+A spurt start when the first probe in a trace see audio and end when all
+probes that have seen the stream are idle again, that is when the flush has
+propagated through the whole path. If a new stream start when all probes have
+been flushed but some are still waiting for the flush to complete, the spurt
+is ended at that point. The trace then print one line with all probes, in the
+order the stream reached them, and the time it took for the stream to get
+from the previous probe. That is the queueing delay, e.g. FIFO prebuffering,
+jitter buffers, pacing and encoder framing, between the two probes. A probe
+may be given a function that return the number of samples that are queued
+downstream of it, e.g. in the sound card, which is then added as an extra
+stage.
+
+When tracing is disabled, which is the default, the only cost is one test of
+a static flag for each written block.
+
+Streams passing through the same trace that overlap in time will be reported
+as one spurt.
+
+\code
+Async::AudioLatencyProbe::setEnabled(true);
+Async::AudioLatencyProbe::setTrace("Tx1", "SimplexLogic");
+Async::AudioLatencyProbe *probe = new Async::AudioLatencyProbe("Tx1:dev");
+prev_src->registerSink(probe, true);
+prev_src = probe;
+\endcode
+*/
+class AudioLatencyProbe : public AudioPassthrough
+{
+  public:
+    /**
+     * @brief   Enable or disable latency tracing for all probes
+     * @param   enable Set to \em true to enable tracing
+     */
+    static void setEnabled(bool enable);
+
+    /**
+     * @brief   Find out if latency tracing is enabled
+     * @return  Returns \em true if tracing is enabled
+     */
+    static bool isEnabled(void) { return enabled; }
+
+    /**
+     * @brief   Put all probes of an owner in the given trace
+     * @param   owner The owner part of the probe names, e.g. "Rx1"
+     * @param   trace The name of the trace, e.g. "SimplexLogic"
+     *
+     * This apply both to existing probes and to probes created later. A
+     * stream in progress in a moved probe is ended.
+     */
+    static void setTrace(const std::string& owner, const std::string& trace);
+
+    /**
+     * @brief   A signal that is emitted when a spurt has been traced
+     * @param   report The report line
+     *
+     * If nothing is connected to this signal, the report is printed on
+     * stdout.
+     */
+    static sigc::signal<void, const std::string&> traceReport;
+
+    /**
+     * @brief 	Constuctor
+     * @param 	name The name of the probe that is shown in the report
+     *
+     * The name should be on the form "<owner>:<point>". The part before the
+     * last colon is used to select the trace.
+     */
+    explicit AudioLatencyProbe(const std::string& name);
+
+    /**
+     * @brief 	Destructor
+     */
+    virtual ~AudioLatencyProbe(void);
+
+    /**
+     * @brief   Return the name of the probe
+     * @return  Returns the name given to the constructor
+     */
+    const std::string& name(void) const { return m_name; }
+
+    /**
+     * @brief   Set a function that return the downstream queue length
+     * @param   delay_func A function returning the number of queued samples
+     * @param   sample_rate The sample rate of the queued samples
+     *
+     * The function is called just after the first block of a new stream has
+     * been written through the probe. The number of samples returned is
+     * reported as an extra stage after this probe.
+     */
+    void setOutputDelayFunc(const sigc::slot<int>& delay_func,
+                            int sample_rate=INTERNAL_SAMPLE_RATE);
+
+    /**
+     * @brief 	Write samples into this audio sink
+     * @param 	samples The buffer containing the samples
+     * @param 	count 	The number of samples in the buffer
+     * @return	Returns the number of samples that has been taken care of
+     */
+    virtual int writeSamples(const float *samples, int count)
+    {
+      if (enabled && (!m_active || m_flushing))
+      {
+        streamStarted();
+        int ret = AudioPassthrough::writeSamples(samples, count);
+        measureOutputDelay();
+        return ret;
+      }
+      return AudioPassthrough::writeSamples(samples, count);
+    }
+
+    /**
+     * @brief 	Tell the sink to flush the previously written samples
+     */
+    virtual void flushSamples(void)
+    {
+      if (m_active)
+      {
+        streamFlushed();
+      }
+      AudioPassthrough::flushSamples();
+    }
+
+    /**
+     * @brief All samples have been flushed by the sink
+     */
+    virtual void allSamplesFlushed(void)
+    {
+      if (m_active)
+      {
+        streamIdle();
+      }
+      AudioPassthrough::allSamplesFlushed();
+    }
+
+  private:
+    class Tracer;
+
+    static bool       enabled;
+
+    std::string       m_name;
+    Tracer            *m_tracer;
+    bool              m_active;
+    bool              m_flushing;
+    sigc::slot<int>   m_delay_func;
+    int               m_delay_sample_rate;
+
+    AudioLatencyProbe(const AudioLatencyProbe&);
+    AudioLatencyProbe& operator=(const AudioLatencyProbe&);
+    void streamStarted(void);
+    void measureOutputDelay(void);
+    void streamFlushed(void);
+    void streamIdle(void);
+
+};  /* class AudioLatencyProbe */
+
+
+} /* namespace */
+
+#endif /* ASYNC_AUDIO_LATENCY_PROBE_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -33,10 +33,17 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/timerfd.h>
+
+#include <iostream>
 
 #include <algorithm>
 #include <cstring>
 #include <cassert>
+#include <cerrno>
 
 
 /****************************************************************************
@@ -45,6 +52,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <AsyncFdWatch.h>
 #include <AsyncTimer.h>
 
 
@@ -75,6 +83,17 @@ using namespace Async;
  *
  ****************************************************************************/
 
+  // The maximum number of blocks to write in one event loop iteration when
+  // catching up after a stall
+static const int MAX_BURST_BLOCKS = 4;
+
+static const int64_t NSEC_PER_SEC = 1000000000LL;
+static const int64_t NSEC_PER_MSEC = 1000000LL;
+
+  // If we are lagging more than this (ns), restart the timeline instead of
+  // catching up
+static const int64_t MAX_LAG = NSEC_PER_SEC / 2;
+
 
 
 /****************************************************************************
@@ -117,9 +136,50 @@ using namespace Async;
  ****************************************************************************/
 
 
-AudioPacer::AudioPacer(int sample_rate, int block_size, int prebuf_time)
+int64_t AudioPacer::Clock::now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * NSEC_PER_SEC + ts.tv_nsec;
+} /* AudioPacer::Clock::now */
+
+
+AudioPacer::Clock::Clock(void)
+  : fd(-1), watch(0), timer(0)
+{
+  fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (fd < 0)
+  {
+    cerr << "*** WARNING: Could not create a timerfd for audio pacing: "
+         << strerror(errno) << ". Falling back to a millisecond timer."
+         << endl;
+    timer = new Timer(0, Timer::TYPE_ONESHOT, false);
+    timer->expired.connect(
+        mem_fun(*this, &AudioPacer::Clock::onTimerExpired));
+    return;
+  }
+  watch = new FdWatch(fd, FdWatch::FD_WATCH_RD);
+  watch->activity.connect(mem_fun(*this, &AudioPacer::Clock::onFdExpired));
+} /* AudioPacer::Clock::Clock */
+
+
+AudioPacer::Clock::~Clock(void)
+{
+  assert(deadlines.empty());
+  delete timer;
+  delete watch;
+  if (fd >= 0)
+  {
+    close(fd);
+  }
+} /* AudioPacer::Clock::~Clock */
+
+
+AudioPacer::AudioPacer(int sample_rate, int block_size, int prebuf_time,
+                       Clock *clock)
   : sample_rate(sample_rate), buf_size(block_size), prebuf_time(prebuf_time),
-    buf_pos(0), pace_timer(0), do_flush(false), input_stopped(false)
+    buf_pos(0), clock(clock), own_clock(false), is_pacing(false), epoch(0),
+    block_cnt(0), do_flush(false), input_stopped(false)
 {
   assert(sample_rate > 0);
   assert(block_size > 0);
@@ -128,13 +188,15 @@ AudioPacer::AudioPacer(int sample_rate, int block_size, int prebuf_time)
   buf = new float[buf_size];
   prebuf_samples = prebuf_time * sample_rate / 1000;
   
-  pace_timer = new Timer(buf_size * 1000 / sample_rate,
-       	      	      	 Timer::TYPE_PERIODIC);
-  pace_timer->expired.connect(mem_fun(*this, &AudioPacer::outputNextBlock));
-  
-  if (prebuf_samples > 0)
+  if (this->clock == 0)
+  {
+    this->clock = new Clock;
+    own_clock = true;
+  }
+
+  if (prebuf_samples <= 0)
   {
-    pace_timer->setEnable(false);
+    setPacing(true);
   }
   
 } /* AudioPacer::AudioPacer */
@@ -142,7 +204,11 @@ AudioPacer::AudioPacer(int sample_rate, int block_size, int prebuf_time)
 
 AudioPacer::~AudioPacer(void)
 {
-  delete pace_timer;
+  setPacing(false);
+  if (own_clock)
+  {
+    delete clock;
+  }
   delete [] buf;
 } /* AudioPacer::~AudioPacer */
 
@@ -175,7 +241,7 @@ int AudioPacer::writeSamples(const float *samples, int count)
 	samples_written += writeSamples(samples + samples_written,
 	      	      	      	      	samples_left);
       }
-      pace_timer->setEnable(true);
+      setPacing(true);
     }
     else
     {
@@ -192,10 +258,7 @@ int AudioPacer::writeSamples(const float *samples, int count)
     memcpy(buf + buf_pos, samples, samples_written * sizeof(*buf));
     buf_pos += samples_written;
     
-    if (!pace_timer->isEnabled())
-    {
-      pace_timer->setEnable(true);
-    }
+    setPacing(true);
   }
   
   if (samples_written == 0)
@@ -224,7 +287,7 @@ void AudioPacer::resumeOutput(void)
 {
   if (prebuf_samples <= 0)
   {
-    pace_timer->setEnable(true);
+    setPacing(true);
     outputNextBlock();
   }
 } /* AudioPacer::resumeOutput */
@@ -255,11 +318,168 @@ void AudioPacer::allSamplesFlushed(void)
  ****************************************************************************/
 
 
-void AudioPacer::outputNextBlock(Timer *t)
+void AudioPacer::Clock::schedule(AudioPacer *pacer, int64_t deadline)
+{
+  cancel(pacer);
+  DeadlineMap::iterator it = deadlines.insert(make_pair(deadline, pacer));
+  if (it == deadlines.begin())
+  {
+    arm();
+  }
+} /* AudioPacer::Clock::schedule */
+
+
+void AudioPacer::Clock::cancel(AudioPacer *pacer)
+{
+  for (DeadlineMap::iterator it = deadlines.begin(); it != deadlines.end();
+       ++it)
+  {
+    if (it->second == pacer)
+    {
+      deadlines.erase(it);
+      break;
+    }
+  }
+  replace(due.begin(), due.end(), pacer, static_cast<AudioPacer*>(0));
+} /* AudioPacer::Clock::cancel */
+
+
+void AudioPacer::Clock::arm(void)
+{
+  if (timer != 0)
+  {
+    timer->setEnable(false);
+    if (!deadlines.empty())
+    {
+        // Round up so that the deadline has always passed on expiry
+      const int64_t left = max(deadlines.begin()->first - now(), int64_t(0));
+      timer->setTimeout((left + NSEC_PER_MSEC - 1) / NSEC_PER_MSEC);
+      timer->setEnable(true);
+    }
+    return;
+  }
+
+  struct itimerspec its;
+  memset(&its, 0, sizeof(its));
+  if (!deadlines.empty())
+  {
+    const int64_t deadline = deadlines.begin()->first;
+    its.it_value.tv_sec = deadline / NSEC_PER_SEC;
+    its.it_value.tv_nsec = deadline % NSEC_PER_SEC;
+  }
+  if (timerfd_settime(fd, TFD_TIMER_ABSTIME, &its, 0) == -1)
+  {
+    perror("timerfd_settime");
+  }
+} /* AudioPacer::Clock::arm */
+
+
+void AudioPacer::Clock::onFdExpired(FdWatch *w)
+{
+  uint64_t expirations;
+  if ((read(fd, &expirations, sizeof(expirations)) == -1) &&
+      (errno != EAGAIN))
+  {
+    perror("read(timerfd)");
+  }
+  handleDeadlines();
+} /* AudioPacer::Clock::onFdExpired */
+
+
+void AudioPacer::Clock::onTimerExpired(Timer *t)
+{
+  handleDeadlines();
+} /* AudioPacer::Clock::onTimerExpired */
+
+
+void AudioPacer::Clock::handleDeadlines(void)
+{
+
+    // Collect the pacers that are due before calling them. A pacer that is
+    // behind will reschedule itself with a deadline that has already passed.
+    // It should then be called in the next event loop iteration so that
+    // other events get a chance to run in between.
+  const int64_t t = now();
+  while (!deadlines.empty() && (deadlines.begin()->first <= t))
+  {
+    due.push_back(deadlines.begin()->second);
+    deadlines.erase(deadlines.begin());
+  }
+  for (size_t i=0; i<due.size(); ++i)
+  {
+    if (due[i] != 0)
+    {
+      due[i]->clockExpired(t);
+    }
+  }
+  due.clear();
+
+  arm();
+} /* AudioPacer::Clock::handleDeadlines */
+
+
+void AudioPacer::setPacing(bool enable)
+{
+  if (enable && !is_pacing)
+  {
+    is_pacing = true;
+    epoch = Clock::now();
+    block_cnt = 0;
+    clock->schedule(this, blockDeadline(1));
+  }
+  else if (!enable && is_pacing)
+  {
+    is_pacing = false;
+    clock->cancel(this);
+  }
+} /* AudioPacer::setPacing */
+
+
+int64_t AudioPacer::blockDeadline(int64_t block) const
+{
+  return epoch + block * buf_size * NSEC_PER_SEC / sample_rate;
+} /* AudioPacer::blockDeadline */
+
+
+void AudioPacer::clockExpired(int64_t now)
+{
+  int burst = 0;
+  while (is_pacing && (blockDeadline(block_cnt + 1) <= now) &&
+         (burst < MAX_BURST_BLOCKS))
+  {
+    ++block_cnt;
+    ++burst;
+
+      // Move the epoch forward once every buf_size seconds, which is an
+      // exact number of blocks, so that the block counter never overflow
+    if (block_cnt >= sample_rate)
+    {
+      epoch += buf_size * NSEC_PER_SEC;
+      block_cnt -= sample_rate;
+    }
+
+    outputNextBlock();
+  }
+
+  if (!is_pacing)
+  {
+    return;
+  }
+
+  if (now - blockDeadline(block_cnt + 1) > MAX_LAG)
+  {
+    epoch = now;
+    block_cnt = 0;
+  }
+  clock->schedule(this, blockDeadline(block_cnt + 1));
+} /* AudioPacer::clockExpired */
+
+
+void AudioPacer::outputNextBlock(void)
 {
   if (buf_pos < buf_size)
   {
-    pace_timer->setEnable(false);
+    setPacing(false);
     prebuf_samples = prebuf_time * sample_rate / 1000;
   }
   
@@ -291,7 +511,7 @@ void AudioPacer::outputNextBlock(Timer *t)
   
   if (samples_written == 0)
   {
-    pace_timer->setEnable(false);
+    setPacing(false);
   }
   
   if (input_stopped && (buf_pos < buf_size))
@@ -313,4 +533,3 @@ void AudioPacer::outputNextBlock(Timer *t)
 /*
  * This file has not been truncated
  */
-
@@ -37,6 +37,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <sigc++/sigc++.h>
 
+#include <map>
+#include <vector>
+#include <stdint.h>
+
 
 /****************************************************************************
  *
@@ -80,6 +84,7 @@ namespace Async
  *
  ****************************************************************************/
 
+class FdWatch;
 class Timer;
   
 
@@ -111,17 +116,85 @@ class Timer;
 @date   2007-11-17
 
 This class is used in an audio pipe chain to pace audio output.
+
+The output is paced using absolute deadlines derived from the number of
+samples written since pacing started, measured on the monotonic clock. The
+pace will therefore not drift due to event loop jitter or rounding. If the
+event loop is stalled, the pacer will catch up by writing a bounded number
+of blocks in each event loop iteration. If it falls too far behind, it will
+restart its timeline instead of trying to catch up.
+
+Multiple pacers may share one Clock, meaning that they will be driven by the
+same kernel timer.
 */
 class AudioPacer : public AudioSink, public AudioSource, public sigc::trackable
 {
   public:
+    /**
+     * @brief   A pacing clock that may be shared between pacers
+     *
+     * The clock use a timerfd with absolute CLOCK_MONOTONIC deadlines so
+     * timeouts have nanosecond resolution. All pacers using the same clock
+     * share one file descriptor and are woken up by the same timer. If a
+     * timerfd cannot be created the clock fall back to an Async::Timer. The
+     * deadlines are still absolute, so the pace does not drift, but each
+     * block is then only timed to the nearest millisecond.
+     */
+    class Clock
+    {
+      public:
+        /**
+         * @brief   Get the current time of the monotonic clock
+         * @return  Returns the time in nanoseconds
+         */
+        static int64_t now(void);
+
+        /**
+         * @brief   Default constructor
+         */
+        Clock(void);
+
+        /**
+         * @brief   Destructor
+         *
+         * All pacers using the clock must have been deleted before the
+         * clock is deleted.
+         */
+        ~Clock(void);
+
+      private:
+        typedef std::multimap<int64_t, AudioPacer*> DeadlineMap;
+
+        int                       fd;
+        FdWatch                   *watch;
+        Timer                     *timer;
+        DeadlineMap               deadlines;
+        std::vector<AudioPacer*>  due;
+
+        Clock(const Clock&);
+        Clock& operator=(const Clock&);
+        void schedule(AudioPacer *pacer, int64_t deadline);
+        void cancel(AudioPacer *pacer);
+        void arm(void);
+        void onFdExpired(FdWatch *w);
+        void onTimerExpired(Timer *t);
+        void handleDeadlines(void);
+
+        friend class AudioPacer;
+    };
+
     /**
      * @brief 	Constuctor
      * @param 	sample_rate The sample rate of the incoming samples
      * @param 	block_size  The size of the audio blocks
      * @param 	prebuf_time The time (ms) to wait before starting to send audio
+     * @param   clock       A clock to share with other pacers (optional)
+     *
+     * If no clock is given the pacer will create its own. A shared clock
+     * must outlive the pacer.
      */
-    AudioPacer(int sample_rate, int block_size, int prebuf_time);
+    AudioPacer(int sample_rate, int block_size, int prebuf_time,
+               Clock *clock=0);
   
     /**
      * @brief 	Destructor
@@ -180,11 +253,18 @@ class AudioPacer : public AudioSink, public AudioSource, public sigc::trackable
     float     	  *buf;
     int       	  buf_pos;
     int       	  prebuf_samples;
-    Async::Timer  *pace_timer;
+    Clock         *clock;
+    bool          own_clock;
+    bool          is_pacing;
+    int64_t       epoch;
+    int64_t       block_cnt;
     bool      	  do_flush;
     bool      	  input_stopped;
     
-    void outputNextBlock(Async::Timer *t=0);
+    void setPacing(bool enable);
+    int64_t blockDeadline(int64_t block) const;
+    void clockExpired(int64_t now);
+    void outputNextBlock(void);
 
 };  /* class AudioPacer */
 
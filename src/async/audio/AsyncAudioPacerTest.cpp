@@ -0,0 +1,190 @@
+//
+// Drift test for the AudioPacer.
+//
+// A number of pacers, with block sizes that are not a whole number of
+// milliseconds, are fed with as much audio as they will take. The samples
+// written by each pacer are counted and compared to the number of samples
+// that should have been written, going by the monotonic clock. The event
+// loop is stalled once during the run to check that the pacers catch up.
+//
+// The test is run twice, first with all pacers sharing a timerfd based
+// clock and then with a clock that has fallen back to a millisecond timer.
+// The fallback is provoked by lowering the file descriptor limit while the
+// clock is created. The test fail if any pacer deviate more than one block
+// from the expected sample count at the end of a run.
+//
+// Usage: AsyncAudioPacerTest [seconds]
+//
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+#include <cmath>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+
+#include <AsyncCppApplication.h>
+#include <AsyncTimer.h>
+
+#include "AsyncAudioSource.h"
+#include "AsyncAudioSink.h"
+#include "AsyncAudioPacer.h"
+
+using namespace std;
+using namespace Async;
+
+
+namespace {
+
+const int STALL_MS = 300;
+
+  // Write blocks of silence for as long as the sink accept them
+class FeedSource : public AudioSource
+{
+  public:
+    FeedSource(void) : m_buf(64) {}
+    void feed(void)
+    {
+      while ((sink() != 0) &&
+             (sinkWriteSamples(&m_buf[0], m_buf.size()) > 0))
+      {
+      }
+    }
+    virtual void resumeOutput(void) { feed(); }
+    virtual void allSamplesFlushed(void) {}
+  private:
+    vector<float> m_buf;
+};
+
+class CountingSink : public AudioSink
+{
+  public:
+    CountingSink(void) : samples(0) {}
+    virtual int writeSamples(const float *buf, int count)
+    {
+      samples += count;
+      return count;
+    }
+    virtual void flushSamples(void) { sourceAllSamplesFlushed(); }
+    long long samples;
+};
+
+struct Stream
+{
+  int                         sample_rate;
+  int                         block_size;
+  FeedSource                  src;
+  CountingSink                sink;
+  unique_ptr<AudioPacer>      pacer;
+  int64_t                     start;
+
+  Stream(int rate, int block) : sample_rate(rate), block_size(block), start(0)
+  {
+  }
+};
+
+  // Create a clock that can not use a timerfd since no file descriptors
+  // are available
+AudioPacer::Clock *createFallbackClock(void)
+{
+  int fd = open("/dev/null", O_RDONLY);
+  close(fd);
+  struct rlimit old_lim;
+  getrlimit(RLIMIT_NOFILE, &old_lim);
+  struct rlimit lim = old_lim;
+  lim.rlim_cur = fd;
+  setrlimit(RLIMIT_NOFILE, &lim);
+  AudioPacer::Clock *clock = new AudioPacer::Clock;
+  setrlimit(RLIMIT_NOFILE, &old_lim);
+  return clock;
+}
+
+bool run(CppApplication& app, AudioPacer::Clock *clock, const char *name,
+         unsigned seconds)
+{
+  vector<unique_ptr<Stream> > streams;
+  streams.emplace_back(new Stream(16000, 256));
+  streams.emplace_back(new Stream(44100, 441));
+  streams.emplace_back(new Stream(8000, 300));
+  streams.emplace_back(new Stream(16000, 300));
+  for (auto& s : streams)
+  {
+    s->start = AudioPacer::Clock::now();
+    s->pacer.reset(new AudioPacer(s->sample_rate, s->block_size, 0, clock));
+    s->src.registerSink(s->pacer.get());
+    s->pacer->registerSink(&s->sink);
+    s->src.feed();
+  }
+
+  Timer stall_timer(seconds * 1000 / 2);
+  stall_timer.expired.connect([](Timer*) { usleep(STALL_MS * 1000); });
+
+  int64_t end = 0;
+  Timer stop_timer(seconds * 1000);
+  stop_timer.expired.connect([&](Timer*) {
+      end = AudioPacer::Clock::now();
+      app.quit();
+    });
+  app.exec();
+
+  bool ok = true;
+  for (auto& s : streams)
+  {
+    const int64_t elapsed = end - s->start;
+    const long long blocks = elapsed * s->sample_rate / s->block_size /
+                             1000000000LL;
+    const long long expected = blocks * s->block_size;
+    const long long diff = s->sink.samples - expected;
+    cout << setw(9) << name << setw(7) << s->sample_rate
+         << setw(6) << s->block_size << setw(10) << s->sink.samples
+         << setw(10) << expected << setw(7) << diff << endl;
+    if (llabs(diff) > s->block_size)
+    {
+      cerr << "*** ERROR: The " << name << " pacer at " << s->sample_rate
+           << "Hz with block size " << s->block_size << " deviate "
+           << diff << " samples from the expected sample count" << endl;
+      ok = false;
+    }
+    s->src.unregisterSink();
+    s->pacer->unregisterSink();
+  }
+  return ok;
+}
+
+} /* anonymous namespace */
+
+
+int main(int argc, char **argv)
+{
+  unsigned seconds = 5;
+  if (argc > 1)
+  {
+    seconds = atoi(argv[1]);
+  }
+  if (seconds == 0)
+  {
+    cerr << "Usage: AsyncAudioPacerTest [seconds]" << endl;
+    return 1;
+  }
+
+  cout << setw(9) << "clock" << setw(7) << "rate" << setw(6) << "block"
+       << setw(10) << "samples" << setw(10) << "expected" << setw(7)
+       << "diff" << endl;
+
+  bool ok = true;
+  {
+    CppApplication app;
+    AudioPacer::Clock clock;
+    ok = run(app, &clock, "timerfd", seconds) && ok;
+  }
+  {
+    CppApplication app;
+    unique_ptr<AudioPacer::Clock> clock(createFallbackClock());
+    ok = run(app, clock.get(), "fallback", seconds) && ok;
+  }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,600 @@
+/**
+@file	 AsyncAudioRoutingMatrix.cpp
+@brief   Route audio between a number of ports with a connection matrix
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cassert>
+#include <algorithm>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncAudioSource.h"
+#include "AsyncAudioSink.h"
+#include "AsyncAudioRoutingMatrix.h"
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+struct Async::AudioRoutingMatrix::Connection
+{
+  Connection(Input *input, Output *output)
+    : input(input), output(output), buf_pos(0), flush_pending(false) {}
+
+  Input   *input;
+  Output  *output;
+  int     buf_pos;
+  bool    flush_pending;
+};
+
+
+  /*
+   * The input of a port. It is the sink of the port audio source and write
+   * the audio to the outputs of all connected ports. If an output cannot
+   * take all samples, the samples are buffered, like in the AudioSplitter,
+   * and the source is stopped until all outputs have caught up.
+   */
+class Async::AudioRoutingMatrix::Input : public AudioSink
+{
+  public:
+    typedef std::vector<Connection *> ConList;
+
+    explicit Input(const std::string& name)
+      : m_name(name), m_buf_len(0), m_is_stopped(false),
+        m_do_flush(false), m_is_flushing(false), m_flush_cnt(0)
+    {
+    }
+
+    const std::string& name(void) const { return m_name; }
+    const ConList& connections(void) const { return m_cons; }
+
+    void addConnection(Connection *con)
+    {
+      m_cons.push_back(con);
+    }
+
+    void removeConnection(Connection *con)
+    {
+      m_cons.erase(find(m_cons.begin(), m_cons.end(), con));
+      if (con->flush_pending)
+      {
+        connectionFlushed(con);
+      }
+      if (m_buf_len > 0)
+      {
+        writeFromBuffer();
+      }
+    }
+
+    virtual int writeSamples(const float *samples, int count);
+
+    virtual void flushSamples(void)
+    {
+      if (m_buf_len > 0)
+      {
+        m_do_flush = true;
+        return;
+      }
+      flushConnections();
+    }
+
+    void connectionResumeOutput(Connection *con)
+    {
+      if (m_buf_len > 0)
+      {
+        writeFromBuffer();
+      }
+    }
+
+    void connectionFlushed(Connection *con)
+    {
+      if (!con->flush_pending)
+      {
+        return;
+      }
+      con->flush_pending = false;
+      flushDone();
+    }
+
+  private:
+    std::string         m_name;
+    ConList             m_cons;
+    std::vector<float>  m_buf;
+    int                 m_buf_len;
+    bool                m_is_stopped;
+    bool                m_do_flush;
+    bool                m_is_flushing;
+    size_t              m_flush_cnt;
+
+    void writeFromBuffer(void);
+    void flushConnections(void);
+
+    void flushDone(void)
+    {
+      if (m_is_flushing && (--m_flush_cnt == 0))
+      {
+        m_is_flushing = false;
+        sourceAllSamplesFlushed();
+      }
+    }
+
+}; /* class Async::AudioRoutingMatrix::Input */
+
+
+  /*
+   * The output of a port. It is the source of the port audio sink. Like in
+   * the AudioSelector, only the first connected input that start writing is
+   * let through. Samples from other inputs are thrown away until the stream
+   * from the selected input has been flushed.
+   */
+class Async::AudioRoutingMatrix::Output : public AudioSource
+{
+  public:
+    typedef std::vector<Connection *> ConList;
+
+    Output(void) : m_selected(0), m_is_flushing(false) {}
+
+    const ConList& connections(void) const { return m_cons; }
+    const Connection *selected(void) const { return m_selected; }
+
+    void addConnection(Connection *con)
+    {
+      m_cons.push_back(con);
+    }
+
+    void removeConnection(Connection *con)
+    {
+      m_cons.erase(find(m_cons.begin(), m_cons.end(), con));
+      if (con == m_selected)
+      {
+        m_selected = 0;
+        if (!m_is_flushing)
+        {
+          m_is_flushing = true;
+          sinkFlushSamples();
+        }
+      }
+    }
+
+    int connectionWriteSamples(Connection *con, const float *samples,
+                               int count)
+    {
+      if (m_selected == 0)
+      {
+        m_selected = con;
+      }
+      if (con != m_selected)
+      {
+        return count;
+      }
+      m_is_flushing = false;
+      return sinkWriteSamples(samples, count);
+    }
+
+    void connectionFlushSamples(Connection *con)
+    {
+      if (con != m_selected)
+      {
+        con->input->connectionFlushed(con);
+      }
+      else if (!m_is_flushing)
+      {
+        m_is_flushing = true;
+        sinkFlushSamples();
+      }
+    }
+
+    virtual void resumeOutput(void)
+    {
+      if (m_selected != 0)
+      {
+        m_selected->input->connectionResumeOutput(m_selected);
+      }
+    }
+
+    virtual void allSamplesFlushed(void)
+    {
+      if (m_is_flushing)
+      {
+        m_is_flushing = false;
+        Connection *con = m_selected;
+        m_selected = 0;
+        if (con != 0)
+        {
+          con->input->connectionFlushed(con);
+        }
+      }
+    }
+
+  private:
+    ConList     m_cons;
+    Connection  *m_selected;
+    bool        m_is_flushing;
+
+}; /* class Async::AudioRoutingMatrix::Output */
+
+
+int AudioRoutingMatrix::Input::writeSamples(const float *samples, int count)
+{
+  assert(count > 0);
+  m_do_flush = false;
+  m_is_flushing = false;
+
+  if (m_buf_len > 0)
+  {
+    m_is_stopped = true;
+    return 0;
+  }
+
+  bool buffered = false;
+  for (size_t i=0; i<m_cons.size(); ++i)
+  {
+    Connection *con = m_cons[i];
+    con->flush_pending = false;
+    con->buf_pos = con->output->connectionWriteSamples(con, samples, count);
+    if ((con->buf_pos < count) && !buffered)
+    {
+      m_buf.assign(samples, samples + count);
+      buffered = true;
+    }
+  }
+  if (buffered)
+  {
+    m_buf_len = count;
+  }
+
+  return count;
+} /* AudioRoutingMatrix::Input::writeSamples */
+
+
+void AudioRoutingMatrix::Input::writeFromBuffer(void)
+{
+  bool samples_written = true;
+  bool all_written = false;
+  while (samples_written && !all_written)
+  {
+    samples_written = false;
+    all_written = true;
+    for (size_t i=0; i<m_cons.size(); ++i)
+    {
+      Connection *con = m_cons[i];
+      if (con->buf_pos < m_buf_len)
+      {
+        int written = con->output->connectionWriteSamples(con,
+            &m_buf[con->buf_pos], m_buf_len - con->buf_pos);
+        con->buf_pos += written;
+        samples_written |= (written > 0);
+        all_written &= (con->buf_pos == m_buf_len);
+      }
+    }
+  }
+
+  if (all_written)
+  {
+    m_buf_len = 0;
+    if (m_do_flush)
+    {
+      flushConnections();
+    }
+    if (m_is_stopped)
+    {
+      m_is_stopped = false;
+      sourceResumeOutput();
+    }
+  }
+} /* AudioRoutingMatrix::Input::writeFromBuffer */
+
+
+void AudioRoutingMatrix::Input::flushConnections(void)
+{
+  m_do_flush = false;
+  m_is_flushing = true;
+
+    // Count one extra so that the flush is not completed from within
+    // the loop when outputs report that they are flushed right away
+  m_flush_cnt = m_cons.size() + 1;
+  for (size_t i=0; i<m_cons.size(); ++i)
+  {
+    m_cons[i]->flush_pending = true;
+  }
+  ConList cons(m_cons);
+  for (ConList::iterator it=cons.begin(); it!=cons.end(); ++it)
+  {
+    (*it)->output->connectionFlushSamples(*it);
+  }
+  flushDone();
+} /* AudioRoutingMatrix::Input::flushConnections */
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+AudioRoutingMatrix::AudioRoutingMatrix(void)
+  : m_con_cnt(0)
+{
+} /* AudioRoutingMatrix::AudioRoutingMatrix */
+
+
+AudioRoutingMatrix::~AudioRoutingMatrix(void)
+{
+  while (!m_ports.empty())
+  {
+    removePort(m_ports.begin()->first);
+  }
+} /* AudioRoutingMatrix::~AudioRoutingMatrix */
+
+
+bool AudioRoutingMatrix::addPort(const std::string& name, AudioSource *source,
+                                 AudioSink *sink)
+{
+  if (m_ports.find(name) != m_ports.end())
+  {
+    return false;
+  }
+
+  Port port;
+  port.input = new Input(name);
+  if (source != 0)
+  {
+    source->registerSink(port.input);
+  }
+  port.output = new Output;
+  if (sink != 0)
+  {
+    port.output->registerSink(sink);
+  }
+  m_ports[name] = port;
+
+  return true;
+} /* AudioRoutingMatrix::addPort */
+
+
+void AudioRoutingMatrix::removePort(const std::string& name)
+{
+  PortMap::iterator it = m_ports.find(name);
+  if (it == m_ports.end())
+  {
+    return;
+  }
+  Port port = it->second;
+
+  while (!port.input->connections().empty())
+  {
+    removeConnection(port.input->connections().back());
+  }
+  while (!port.output->connections().empty())
+  {
+    removeConnection(port.output->connections().back());
+  }
+  m_ports.erase(it);
+
+  delete port.input;
+  delete port.output;
+} /* AudioRoutingMatrix::removePort */
+
+
+bool AudioRoutingMatrix::hasPort(const std::string& name) const
+{
+  return m_ports.find(name) != m_ports.end();
+} /* AudioRoutingMatrix::hasPort */
+
+
+bool AudioRoutingMatrix::connect(const std::string& src_name,
+                                 const std::string& sink_name)
+{
+  PortMap::const_iterator src_it = m_ports.find(src_name);
+  PortMap::const_iterator sink_it = m_ports.find(sink_name);
+  if ((src_it == m_ports.end()) || (sink_it == m_ports.end()))
+  {
+    return false;
+  }
+  if (findConnection(src_it->second, sink_it->second) == 0)
+  {
+    Connection *con = new Connection(src_it->second.input,
+                                     sink_it->second.output);
+    con->input->addConnection(con);
+    con->output->addConnection(con);
+    ++m_con_cnt;
+  }
+  return true;
+} /* AudioRoutingMatrix::connect */
+
+
+void AudioRoutingMatrix::disconnect(const std::string& src_name,
+                                    const std::string& sink_name)
+{
+  PortMap::const_iterator src_it = m_ports.find(src_name);
+  PortMap::const_iterator sink_it = m_ports.find(sink_name);
+  if ((src_it == m_ports.end()) || (sink_it == m_ports.end()))
+  {
+    return;
+  }
+  Connection *con = findConnection(src_it->second, sink_it->second);
+  if (con != 0)
+  {
+    removeConnection(con);
+  }
+} /* AudioRoutingMatrix::disconnect */
+
+
+bool AudioRoutingMatrix::isConnected(const std::string& src_name,
+                                     const std::string& sink_name) const
+{
+  PortMap::const_iterator src_it = m_ports.find(src_name);
+  PortMap::const_iterator sink_it = m_ports.find(sink_name);
+  return (src_it != m_ports.end()) && (sink_it != m_ports.end()) &&
+         (findConnection(src_it->second, sink_it->second) != 0);
+} /* AudioRoutingMatrix::isConnected */
+
+
+std::vector<std::string> AudioRoutingMatrix::connectedSources(
+    const std::string& sink_name) const
+{
+  std::vector<std::string> names;
+  PortMap::const_iterator it = m_ports.find(sink_name);
+  if (it != m_ports.end())
+  {
+    const Output::ConList& cons = it->second.output->connections();
+    for (Output::ConList::const_iterator cit=cons.begin();
+         cit!=cons.end(); ++cit)
+    {
+      names.push_back((*cit)->input->name());
+    }
+  }
+  return names;
+} /* AudioRoutingMatrix::connectedSources */
+
+
+std::string AudioRoutingMatrix::selectedSource(
+    const std::string& sink_name) const
+{
+  PortMap::const_iterator it = m_ports.find(sink_name);
+  if (it != m_ports.end())
+  {
+    const Connection *con = it->second.output->selected();
+    if (con != 0)
+    {
+      return con->input->name();
+    }
+  }
+  return "";
+} /* AudioRoutingMatrix::selectedSource */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+AudioRoutingMatrix::Connection *AudioRoutingMatrix::findConnection(
+    const Port& src, const Port& sink) const
+{
+  const Input::ConList& cons = src.input->connections();
+  for (Input::ConList::const_iterator it=cons.begin(); it!=cons.end(); ++it)
+  {
+    if ((*it)->output == sink.output)
+    {
+      return *it;
+    }
+  }
+  return 0;
+} /* AudioRoutingMatrix::findConnection */
+
+
+void AudioRoutingMatrix::removeConnection(Connection *con)
+{
+  con->output->removeConnection(con);
+  con->input->removeConnection(con);
+  delete con;
+  --m_con_cnt;
+} /* AudioRoutingMatrix::removeConnection */
+
+
+
+/*
+ * This file has not been truncated
+ */
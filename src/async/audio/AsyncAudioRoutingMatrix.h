@@ -0,0 +1,250 @@
+/**
+@file	 AsyncAudioRoutingMatrix.h
+@brief   Route audio between a number of ports with a connection matrix
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_AUDIO_ROUTING_MATRIX_INCLUDED
+#define ASYNC_AUDIO_ROUTING_MATRIX_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <map>
+#include <string>
+#include <vector>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+class AudioSource;
+class AudioSink;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	Route audio between a number of ports with a connection matrix
+@author agent
+@date   2026-10-17
+
+Each port has an audio source, from which audio is read, and an audio sink,
+to which audio is written. The audio from the source of a port is routed to
+the sinks of all ports it is connected to. A connection is directed so to
+route audio both ways between two ports, two connections are needed.
+
+Each sink work like an AudioSelector with the same priority for all
+connected sources. The first source to start writing is selected and all
+other sources connected to that sink are thrown away until the selected
+stream has been flushed.
+
+Samples from a source are only handed to the sinks it is currently connected
+to, so the cost is proportional to the number of active connections and not
+to the number of ports. Ports that are not connected cost nothing.
+
+\code
+Async::AudioRoutingMatrix matrix;
+matrix.addPort("L1", l1_out, l1_in);
+matrix.addPort("L2", l2_out, l2_in);
+matrix.connect("L1", "L2");
+matrix.connect("L2", "L1");
+\endcode
+*/
+class AudioRoutingMatrix
+{
+  public:
+    /**
+     * @brief 	Default constuctor
+     */
+    AudioRoutingMatrix(void);
+
+    /**
+     * @brief 	Destructor
+     */
+    ~AudioRoutingMatrix(void);
+
+    /**
+     * @brief 	Add a port to the matrix
+     * @param 	name The unique name of the port
+     * @param 	source The audio source to read from, may be 0
+     * @param 	sink The audio sink to write to, may be 0
+     * @return  Returns \em true on success or \em false if the port exist
+     *
+     * The matrix will register itself as the sink of the given source and as
+     * the source of the given sink.
+     */
+    bool addPort(const std::string& name, AudioSource *source, AudioSink *sink);
+
+    /**
+     * @brief 	Remove a port and all its connections from the matrix
+     * @param 	name The name of the port
+     */
+    void removePort(const std::string& name);
+
+    /**
+     * @brief 	Find out if a port exist
+     * @param 	name The name of the port
+     * @return  Returns \em true if the port exist
+     */
+    bool hasPort(const std::string& name) const;
+
+    /**
+     * @brief 	Route audio from one port to another
+     * @param 	src_name The name of the port to read audio from
+     * @param 	sink_name The name of the port to write audio to
+     * @return  Returns \em true on success or \em false if a port is missing
+     */
+    bool connect(const std::string& src_name, const std::string& sink_name);
+
+    /**
+     * @brief 	Stop routing audio from one port to another
+     * @param 	src_name The name of the port audio is read from
+     * @param 	sink_name The name of the port audio is written to
+     *
+     * If the source is currently selected by the sink, the sink is flushed.
+     */
+    void disconnect(const std::string& src_name, const std::string& sink_name);
+
+    /**
+     * @brief 	Find out if audio is routed from one port to another
+     * @param 	src_name The name of the port audio is read from
+     * @param 	sink_name The name of the port audio is written to
+     * @return  Returns \em true if the ports are connected
+     */
+    bool isConnected(const std::string& src_name,
+                     const std::string& sink_name) const;
+
+    /**
+     * @brief 	Get the ports that are routed to the given port
+     * @param 	sink_name The name of the port audio is written to
+     * @return  Returns the names of all source ports connected to the port
+     */
+    std::vector<std::string> connectedSources(
+        const std::string& sink_name) const;
+
+    /**
+     * @brief 	Get the port that currently is writing to the given port
+     * @param 	sink_name The name of the port audio is written to
+     * @return  Returns the selected source port or an empty string if none
+     */
+    std::string selectedSource(const std::string& sink_name) const;
+
+    /**
+     * @brief 	Get the number of active connections
+     * @return  Returns the number of connections in the matrix
+     */
+    size_t connectionCount(void) const { return m_con_cnt; }
+
+  private:
+    class Input;
+    class Output;
+    struct Connection;
+    struct Port
+    {
+      Input  *input;
+      Output *output;
+    };
+    typedef std::map<std::string, Port> PortMap;
+
+    PortMap m_ports;
+    size_t  m_con_cnt;
+
+    AudioRoutingMatrix(const AudioRoutingMatrix&);
+    AudioRoutingMatrix& operator=(const AudioRoutingMatrix&);
+    Connection *findConnection(const Port& src, const Port& sink) const;
+    void removeConnection(Connection *con);
+
+};  /* class AudioRoutingMatrix */
+
+
+} /* namespace */
+
+#endif /* ASYNC_AUDIO_ROUTING_MATRIX_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,348 @@
+//
+// Behaviour test for the AudioRoutingMatrix.
+//
+// Test sources and sinks are connected to a routing matrix and the samples,
+// flushes and flush confirmations passing through it are recorded. The sinks
+// only accept a limited number of samples, set by each test, and confirm a
+// flush when told to so that pending flushes can be exercised. The
+// following is tested:
+//
+//   - A flush reaches the sink exactly once when several sources, that have
+//     written to the same port, are flushed, and all sources get their
+//     flush confirmed
+//   - A flush received while samples are buffered is not passed on until
+//     the buffer has been written
+//   - When a sink resume output after a partial write, the buffered samples
+//     are delivered in order and without duplicates to all connected sinks
+//     and the stopped source is resumed
+//   - Disconnecting the selected source flushes the sink and hands the port
+//     over to the next source that write, without leaving a flush stuck,
+//     both when the sink confirm the flush before and after the next source
+//     start writing and when the disconnected source was flushing
+//
+// Usage: AsyncAudioRoutingMatrixTest
+//
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <algorithm>
+
+#include "AsyncAudioSink.h"
+#include "AsyncAudioSource.h"
+#include "AsyncAudioRoutingMatrix.h"
+
+using namespace std;
+using namespace Async;
+
+
+namespace {
+
+bool failed = false;
+
+  // Write numbered samples and record resumes and flush confirmations
+class TestSource : public AudioSource
+{
+  public:
+    TestSource(void) : resume_cnt(0), flushed_cnt(0), m_next(0) {}
+
+    int write(int count)
+    {
+      vector<float> samples(count);
+      for (int i=0; i<count; ++i)
+      {
+        samples[i] = m_next + i;
+      }
+      int written = sinkWriteSamples(&samples[0], count);
+      m_next += written;
+      return written;
+    }
+
+    void flush(void) { sinkFlushSamples(); }
+
+    virtual void resumeOutput(void) { ++resume_cnt; }
+    virtual void allSamplesFlushed(void) { ++flushed_cnt; }
+
+    int resume_cnt;
+    int flushed_cnt;
+
+  private:
+    int m_next;
+};
+
+
+  // Accept samples up to a budget and confirm flushes on request
+class TestSink : public AudioSink
+{
+  public:
+    TestSink(void) : flush_cnt(0), m_budget(1000000), m_flush_pending(false)
+    {
+    }
+
+    virtual int writeSamples(const float *samples, int count)
+    {
+      int len = min(count, m_budget);
+      m_budget -= len;
+      received.insert(received.end(), samples, samples + len);
+      return len;
+    }
+
+    virtual void flushSamples(void)
+    {
+      ++flush_cnt;
+      m_flush_pending = true;
+    }
+
+    void setBudget(int budget) { m_budget = budget; }
+
+    void resume(int budget)
+    {
+      m_budget = budget;
+      sourceResumeOutput();
+    }
+
+    bool flushPending(void) const { return m_flush_pending; }
+
+    void confirmFlush(void)
+    {
+      m_flush_pending = false;
+      sourceAllSamplesFlushed();
+    }
+
+    vector<float> received;
+    int flush_cnt;
+
+  private:
+    int   m_budget;
+    bool  m_flush_pending;
+};
+
+
+void check(const string& test, const string& what, int value, int expected)
+{
+  if (value != expected)
+  {
+    cerr << "*** ERROR: " << test << ": Expected " << what << " to be "
+         << expected << " but got " << value << endl;
+    failed = true;
+  }
+}
+
+
+void checkSamples(const string& test, const vector<float>& received,
+                  int first, int count)
+{
+  bool ok = (received.size() == size_t(count));
+  for (size_t i=0; ok && (i<received.size()); ++i)
+  {
+    ok = (received[i] == first + int(i));
+  }
+  if (!ok)
+  {
+    ostringstream ss;
+    for (size_t i=0; i<received.size(); ++i)
+    {
+      ss << (i > 0 ? " " : "") << received[i];
+    }
+    cerr << "*** ERROR: " << test << ": Expected samples " << first
+         << " to " << (first + count - 1) << " but got [" << ss.str() << "]"
+         << endl;
+    failed = true;
+  }
+}
+
+
+void testFlushSeveralSources(void)
+{
+  const string test = "Flush with several sources";
+  TestSource src1, src2, src3;
+  TestSink sink;
+  AudioRoutingMatrix matrix;
+  matrix.addPort("S1", &src1, 0);
+  matrix.addPort("S2", &src2, 0);
+  matrix.addPort("S3", &src3, 0);
+  matrix.addPort("OUT", 0, &sink);
+  matrix.connect("S1", "OUT");
+  matrix.connect("S2", "OUT");
+  matrix.connect("S3", "OUT");
+
+    // S1 is selected since it write first. The samples from S2 are thrown
+    // away but accepted.
+  check(test, "samples written by S1", src1.write(10), 10);
+  check(test, "samples written by S2", src2.write(10), 10);
+  checkSamples(test, sink.received, 0, 10);
+  check(test, "selected source", matrix.selectedSource("OUT") == "S1", 1);
+
+  src2.flush();
+  src1.flush();
+  src3.flush();
+  check(test, "sink flushes", sink.flush_cnt, 1);
+  check(test, "S2 flush confirmations", src2.flushed_cnt, 1);
+  check(test, "S3 flush confirmations", src3.flushed_cnt, 1);
+  check(test, "S1 flush confirmations before sink confirm",
+        src1.flushed_cnt, 0);
+
+  sink.confirmFlush();
+  check(test, "S1 flush confirmations", src1.flushed_cnt, 1);
+  check(test, "selected source after flush",
+        matrix.selectedSource("OUT").empty(), 1);
+
+    // A second stream from S2 is now let through
+  sink.received.clear();
+  src2.write(5);
+  checkSamples(test, sink.received, 10, 5);
+  src2.flush();
+  src1.flush();
+  check(test, "sink flushes after second stream", sink.flush_cnt, 2);
+  sink.confirmFlush();
+  check(test, "S1 flush confirmations after second stream",
+        src1.flushed_cnt, 2);
+  check(test, "S2 flush confirmations after second stream",
+        src2.flushed_cnt, 2);
+  check(test, "S3 flush confirmations after second stream",
+        src3.flushed_cnt, 1);
+} /* testFlushSeveralSources */
+
+
+void testResumeAfterPartialWrite(void)
+{
+  const string test = "Resume after partial write";
+  TestSource src;
+  TestSink fast_sink, slow_sink;
+  AudioRoutingMatrix matrix;
+  matrix.addPort("IN", &src, 0);
+  matrix.addPort("FAST", 0, &fast_sink);
+  matrix.addPort("SLOW", 0, &slow_sink);
+  matrix.connect("IN", "FAST");
+  matrix.connect("IN", "SLOW");
+
+    // The slow sink only take part of the block. The rest is buffered in
+    // the matrix and the source is stopped on the next write.
+  slow_sink.setBudget(3);
+  check(test, "samples in first write", src.write(10), 10);
+  check(test, "samples in second write", src.write(10), 0);
+  checkSamples(test, fast_sink.received, 0, 10);
+  checkSamples(test, slow_sink.received, 0, 3);
+
+    // The flush must wait for the buffered samples
+  src.flush();
+  check(test, "fast sink flushes while buffered", fast_sink.flush_cnt, 0);
+  check(test, "slow sink flushes while buffered", slow_sink.flush_cnt, 0);
+
+  slow_sink.resume(4);
+  checkSamples(test, slow_sink.received, 0, 7);
+  check(test, "source resumes while buffered", src.resume_cnt, 0);
+  check(test, "slow sink flushes while buffered", slow_sink.flush_cnt, 0);
+
+  slow_sink.resume(100);
+  checkSamples(test, slow_sink.received, 0, 10);
+  checkSamples(test, fast_sink.received, 0, 10);
+  check(test, "source resumes", src.resume_cnt, 1);
+  check(test, "fast sink flushes", fast_sink.flush_cnt, 1);
+  check(test, "slow sink flushes", slow_sink.flush_cnt, 1);
+
+  fast_sink.confirmFlush();
+  check(test, "flush confirmations before all sinks confirm",
+        src.flushed_cnt, 0);
+  slow_sink.confirmFlush();
+  check(test, "flush confirmations", src.flushed_cnt, 1);
+
+    // The source continue where it was stopped
+  check(test, "samples written after resume", src.write(10), 10);
+  checkSamples(test, fast_sink.received, 0, 20);
+  checkSamples(test, slow_sink.received, 0, 20);
+} /* testResumeAfterPartialWrite */
+
+
+void testDisconnectSelected(void)
+{
+  const string test = "Disconnect selected source";
+  TestSource src1, src2, src3;
+  TestSink sink;
+  AudioRoutingMatrix matrix;
+  matrix.addPort("S1", &src1, 0);
+  matrix.addPort("S2", &src2, 0);
+  matrix.addPort("S3", &src3, 0);
+  matrix.addPort("OUT", 0, &sink);
+  matrix.connect("S1", "OUT");
+  matrix.connect("S2", "OUT");
+  matrix.connect("S3", "OUT");
+
+    // The sink confirm the flush after the next source has started writing
+  src1.write(10);
+  src2.write(10);
+  matrix.disconnect("S1", "OUT");
+  check(test, "sink flushes on disconnect", sink.flush_cnt, 1);
+  check(test, "selected source after disconnect",
+        matrix.selectedSource("OUT").empty(), 1);
+  sink.received.clear();
+  src2.write(5);
+  check(test, "selected source after next write",
+        matrix.selectedSource("OUT") == "S2", 1);
+  checkSamples(test, sink.received, 10, 5);
+  sink.confirmFlush();
+  check(test, "selected source after late flush confirm",
+        matrix.selectedSource("OUT") == "S2", 1);
+  src2.flush();
+  check(test, "sink flushes for next source", sink.flush_cnt, 2);
+  sink.confirmFlush();
+  check(test, "S2 flush confirmations", src2.flushed_cnt, 1);
+  check(test, "S1 flush confirmations", src1.flushed_cnt, 0);
+
+    // The sink confirm the flush before the next source start writing
+  sink.received.clear();
+  src2.write(5);
+  checkSamples(test, sink.received, 15, 5);
+  matrix.disconnect("S2", "OUT");
+  check(test, "sink flushes on second disconnect", sink.flush_cnt, 3);
+  sink.confirmFlush();
+  sink.received.clear();
+  src3.write(5);
+  check(test, "selected source after confirmed flush",
+        matrix.selectedSource("OUT") == "S3", 1);
+  checkSamples(test, sink.received, 0, 5);
+  src3.flush();
+  check(test, "sink flushes for third source", sink.flush_cnt, 4);
+  sink.confirmFlush();
+  check(test, "S3 flush confirmations", src3.flushed_cnt, 1);
+
+    // The selected source is disconnected while its flush is pending. The
+    // source get its flush confirmed and no extra flush reach the sink.
+  matrix.connect("S1", "OUT");
+  src3.write(5);
+  src3.flush();
+  check(test, "sink flushes before flushing disconnect", sink.flush_cnt, 5);
+  matrix.disconnect("S3", "OUT");
+  check(test, "sink flushes after flushing disconnect", sink.flush_cnt, 5);
+  check(test, "S3 flush confirmations after disconnect",
+        src3.flushed_cnt, 2);
+  sink.confirmFlush();
+  check(test, "sink flush pending", sink.flushPending(), 0);
+  sink.received.clear();
+  src1.write(5);
+  checkSamples(test, sink.received, 10, 5);
+  src1.flush();
+  check(test, "sink flushes for reconnected source", sink.flush_cnt, 6);
+  sink.confirmFlush();
+  check(test, "S1 flush confirmations after reconnect",
+        src1.flushed_cnt, 1);
+  check(test, "connections", matrix.connectionCount(), 1);
+} /* testDisconnectSelected */
+
+} /* namespace */
+
+
+int main(int argc, char **argv)
+{
+  testFlushSeveralSources();
+  testResumeAfterPartialWrite();
+  testDisconnectSelected();
+
+  if (failed)
+  {
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
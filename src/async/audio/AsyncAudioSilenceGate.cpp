@@ -0,0 +1,258 @@
+/**
+@file	 AsyncAudioSilenceGate.cpp
+@brief   Keep runs of digital silence away from an audio encoder
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncAudioSilenceGate.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+AudioSilenceGate::AudioSilenceGate(void)
+  : m_enabled(true), m_suspended(false), m_thresh(1.0f / 32768.0f),
+    m_hangtime(INTERNAL_SAMPLE_RATE / 10),
+    m_report_interval(INTERNAL_SAMPLE_RATE / 10), m_silent_run(0),
+    m_unreported(0), m_samples_in(0), m_samples_dropped(0)
+{
+} /* AudioSilenceGate::AudioSilenceGate */
+
+
+void AudioSilenceGate::setEnabled(bool enable)
+{
+  if (!enable)
+  {
+    reportSilence();
+    m_silent_run = 0;
+  }
+  m_enabled = enable;
+} /* AudioSilenceGate::setEnabled */
+
+
+void AudioSilenceGate::setReportInterval(unsigned samples)
+{
+  m_report_interval = max(1U, samples);
+} /* AudioSilenceGate::setReportInterval */
+
+
+void AudioSilenceGate::setSuspended(bool suspend)
+{
+  if (suspend == m_suspended)
+  {
+    return;
+  }
+
+    // Silence dropped before the suspension must reach the receiving end
+    // before whatever message that caused the suspension
+  reportSilence();
+  m_silent_run = 0;
+  m_suspended = suspend;
+} /* AudioSilenceGate::setSuspended */
+
+
+int AudioSilenceGate::writeSamples(const float *samples, int count)
+{
+  if (m_enabled && m_suspended)
+  {
+    m_samples_in += count;
+    m_samples_dropped += count;
+    return count;
+  }
+
+  if (!m_enabled || !isSilent(samples, count))
+  {
+    reportSilence();
+    m_silent_run = 0;
+    int ret = sinkWriteSamples(samples, count);
+    m_samples_in += ret;
+    return ret;
+  }
+
+    // Pass silence through until the hangtime has expired. The rest of the
+    // block is dropped.
+  int pass = 0;
+  if (m_silent_run < m_hangtime)
+  {
+    pass = min(static_cast<unsigned>(count), m_hangtime - m_silent_run);
+    int ret = sinkWriteSamples(samples, pass);
+    m_silent_run += ret;
+    if (ret < pass)
+    {
+      m_samples_in += ret;
+      return ret;
+    }
+  }
+  dropSamples(count - pass);
+  m_samples_in += count;
+  return count;
+} /* AudioSilenceGate::writeSamples */
+
+
+void AudioSilenceGate::flushSamples(void)
+{
+  reportSilence();
+  m_silent_run = 0;
+  AudioPassthrough::flushSamples();
+} /* AudioSilenceGate::flushSamples */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+bool AudioSilenceGate::isSilent(const float *samples, int count) const
+{
+  for (int i=0; i<count; ++i)
+  {
+    if (fabsf(samples[i]) > m_thresh)
+    {
+      return false;
+    }
+  }
+  return true;
+} /* AudioSilenceGate::isSilent */
+
+
+void AudioSilenceGate::dropSamples(unsigned count)
+{
+  if (count == 0)
+  {
+    return;
+  }
+  m_samples_dropped += count;
+  m_unreported += count;
+  if (m_unreported >= m_report_interval)
+  {
+    reportSilence();
+  }
+} /* AudioSilenceGate::dropSamples */
+
+
+void AudioSilenceGate::reportSilence(void)
+{
+  if (m_unreported > 0)
+  {
+    unsigned count = m_unreported;
+    m_unreported = 0;
+    silenceDetected(count);
+  }
+} /* AudioSilenceGate::reportSilence */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,265 @@
+/**
+@file	 AsyncAudioSilenceGate.h
+@brief   Keep runs of digital silence away from an audio encoder
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_AUDIO_SILENCE_GATE_INCLUDED
+#define ASYNC_AUDIO_SILENCE_GATE_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioPassthrough.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	Keep runs of digital silence away from an audio encoder
+@author agent
+@date   2026-10-17
+
+This audio element is placed in front of an audio encoder that feed a
+network connection. Audio is passed through untouched until a block of
+samples where all samples are below the threshold has been seen for the
+hangtime. After that, silent blocks are dropped and counted instead. The
+number of dropped samples is reported through the silenceDetected signal
+each time the report interval has been reached, when a non-silent block
+arrive and when the stream is flushed. The receiving end can then fill in
+the same number of zero samples so that the timing of the stream is kept
+while the encoder and the network link are idle.
+
+The hangtime must be at least as long as the packet length of the encoder,
+see AudioEncoder::packetSampleCount. The samples that are buffered in the
+encoder when the gate close are then silent, so it does not matter that they
+are sent after the report. A shorter hangtime would let audio that was
+written before the silence reach the receiving end after the report.
+
+While the gate is suspended, using the setSuspended function, all samples
+are dropped without being reported, e.g. when the receiving end would throw
+the audio away anyway since the squelch is closed.
+
+\code
+Async::AudioSilenceGate *gate = new Async::AudioSilenceGate;
+gate->silenceDetected.connect(mem_fun(*this, &MyClass::sendSilence));
+prev_src->registerSink(gate, true);
+gate->registerSink(audio_enc);
+\endcode
+*/
+class AudioSilenceGate : public AudioPassthrough
+{
+  public:
+    /**
+     * @brief 	Default constuctor
+     *
+     * The default threshold is just below one LSB of a 16 bit sample, the
+     * default hangtime is 100ms and the default report interval is 100ms.
+     */
+    AudioSilenceGate(void);
+
+    /**
+     * @brief 	Destructor
+     */
+    virtual ~AudioSilenceGate(void) {}
+
+    /**
+     * @brief   Enable or disable the gate
+     * @param   enable Set to \em false to pass all audio through
+     *
+     * A disabled gate pass all audio through, even when suspended.
+     */
+    void setEnabled(bool enable);
+
+    /**
+     * @brief   Find out if the gate is enabled
+     * @return  Returns \em true if the gate is enabled
+     */
+    bool isEnabled(void) const { return m_enabled; }
+
+    /**
+     * @brief   Set the level below which a sample is considered silent
+     * @param   thresh The threshold as a linear amplitude (0 to 1)
+     */
+    void setThreshold(float thresh) { m_thresh = thresh; }
+
+    /**
+     * @brief   Set the length of silence to pass before the gate close
+     * @param   samples The hangtime in samples
+     */
+    void setHangtime(unsigned samples) { m_hangtime = samples; }
+
+    /**
+     * @brief   Get the length of silence to pass before the gate close
+     * @return  Returns the hangtime in samples
+     */
+    unsigned hangtime(void) const { return m_hangtime; }
+
+    /**
+     * @brief   Set how often dropped samples are reported
+     * @param   samples The maximum number of samples in one report
+     */
+    void setReportInterval(unsigned samples);
+
+    /**
+     * @brief   Drop all incoming samples without reporting them
+     * @param   suspend Set to \em true to suspend the audio stream
+     */
+    void setSuspended(bool suspend);
+
+    /**
+     * @brief   Find out if the gate is currently dropping samples
+     * @return  Returns \em true if samples are being dropped
+     */
+    bool isClosed(void) const
+    {
+      return m_enabled && (m_suspended || (m_silent_run >= m_hangtime));
+    }
+
+    /**
+     * @brief   Get the total number of samples written to the gate
+     * @return  Returns the number of samples written since creation
+     */
+    unsigned long long samplesIn(void) const { return m_samples_in; }
+
+    /**
+     * @brief   Get the total number of samples dropped by the gate
+     * @return  Returns the number of samples dropped since creation
+     */
+    unsigned long long samplesDropped(void) const { return m_samples_dropped; }
+
+    /**
+     * @brief 	Write samples into this audio sink
+     * @param 	samples The buffer containing the samples
+     * @param 	count 	The number of samples in the buffer
+     * @return	Returns the number of samples that has been taken care of
+     */
+    virtual int writeSamples(const float *samples, int count);
+
+    /**
+     * @brief 	Tell the sink to flush the previously written samples
+     */
+    virtual void flushSamples(void);
+
+    /**
+     * @brief   A signal that is emitted when silent samples have been dropped
+     * @param   count The number of dropped samples since the last report
+     */
+    sigc::signal<void, unsigned> silenceDetected;
+
+  private:
+    bool                m_enabled;
+    bool                m_suspended;
+    float               m_thresh;
+    unsigned            m_hangtime;
+    unsigned            m_report_interval;
+    unsigned            m_silent_run;
+    unsigned            m_unreported;
+    unsigned long long  m_samples_in;
+    unsigned long long  m_samples_dropped;
+
+    AudioSilenceGate(const AudioSilenceGate&);
+    AudioSilenceGate& operator=(const AudioSilenceGate&);
+    bool isSilent(const float *samples, int count) const;
+    void dropSamples(unsigned count);
+    void reportSilence(void);
+
+};  /* class AudioSilenceGate */
+
+
+} /* namespace */
+
+#endif /* ASYNC_AUDIO_SILENCE_GATE_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
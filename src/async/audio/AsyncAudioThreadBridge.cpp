@@ -0,0 +1,334 @@
+/**
+@file	 AsyncAudioThreadBridge.cpp
+@brief   Pass audio between two threads running their own event loops
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncApplication.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncAudioThreadBridge.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+AudioThreadBridge::AudioThreadBridge(Application& in_app,
+                                     Application& out_app, unsigned size)
+  : m_in_app(in_app), m_out_app(out_app), m_buf(max(size, 1U)), m_head(0),
+    m_tail(0), m_drain_posted(false), m_write_blocked(false),
+    m_alive(make_shared<std::atomic<bool> >(true)), m_flush_seq(0),
+    m_flushing(false), m_flush_pending(false), m_pending_flush_seq(0),
+    m_pending_flush_pos(0), m_sink_flush_seq(0), m_sink_flushing(false),
+    m_sink_blocked(false)
+{
+} /* AudioThreadBridge::AudioThreadBridge */
+
+
+AudioThreadBridge::~AudioThreadBridge(void)
+{
+  *m_alive = false;
+} /* AudioThreadBridge::~AudioThreadBridge */
+
+
+int AudioThreadBridge::writeSamples(const float *samples, int count)
+{
+  m_flushing = false;
+
+  const unsigned long size = m_buf.size();
+  const unsigned long head = m_head.load(memory_order_relaxed);
+  const unsigned long tail = m_tail.load(memory_order_acquire);
+  const unsigned long len =
+    min(static_cast<unsigned long>(count), size - (head - tail));
+  const unsigned long idx = head % size;
+  const unsigned long first = min(len, size - idx);
+  memcpy(&m_buf[idx], samples, first * sizeof(*samples));
+  memcpy(&m_buf[0], samples + first, (len - first) * sizeof(*samples));
+  m_head.store(head + len, memory_order_release);
+
+  if (len > 0)
+  {
+    postDrain();
+  }
+
+  if (len < static_cast<unsigned long>(count))
+  {
+      // The output thread may have made room in the buffer before it could
+      // see that the writer was blocked so check again after setting the flag
+    m_write_blocked = true;
+    if ((head + len - m_tail.load() < size) && m_write_blocked.exchange(false))
+    {
+      postResume();
+    }
+  }
+
+  return len;
+} /* AudioThreadBridge::writeSamples */
+
+
+void AudioThreadBridge::flushSamples(void)
+{
+  const unsigned seq = ++m_flush_seq;
+  const unsigned long pos = m_head.load(memory_order_relaxed);
+  m_flushing = true;
+  AliveFlag alive(m_alive);
+  m_out_app.post([this, alive, seq, pos]()
+      {
+        if (*alive)
+        {
+          flushRequested(seq, pos);
+        }
+      });
+} /* AudioThreadBridge::flushSamples */
+
+
+void AudioThreadBridge::resumeOutput(void)
+{
+  m_sink_blocked = false;
+  drain();
+} /* AudioThreadBridge::resumeOutput */
+
+
+void AudioThreadBridge::allSamplesFlushed(void)
+{
+  if (!m_sink_flushing)
+  {
+    return;
+  }
+  m_sink_flushing = false;
+
+  const unsigned seq = m_sink_flush_seq;
+  AliveFlag alive(m_alive);
+  m_in_app.post([this, alive, seq]()
+      {
+        if (*alive)
+        {
+          flushCompleted(seq);
+        }
+      });
+} /* AudioThreadBridge::allSamplesFlushed */
+
+
+unsigned AudioThreadBridge::samplesInBuffer(void) const
+{
+  return m_head.load() - m_tail.load();
+} /* AudioThreadBridge::samplesInBuffer */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void AudioThreadBridge::postDrain(void)
+{
+    // Only one drain task is queued at a time. The flag is cleared by the
+    // task before it start reading so no written samples can be missed.
+  if (m_drain_posted.exchange(true))
+  {
+    return;
+  }
+  AliveFlag alive(m_alive);
+  m_out_app.post([this, alive]()
+      {
+        if (*alive)
+        {
+          m_drain_posted = false;
+          drain();
+        }
+      });
+} /* AudioThreadBridge::postDrain */
+
+
+void AudioThreadBridge::postResume(void)
+{
+  AliveFlag alive(m_alive);
+  m_in_app.post([this, alive]()
+      {
+        if (*alive)
+        {
+          sourceResumeOutput();
+        }
+      });
+} /* AudioThreadBridge::postResume */
+
+
+void AudioThreadBridge::drain(void)
+{
+  if (m_sink_blocked)
+  {
+    return;
+  }
+
+  const unsigned long size = m_buf.size();
+  unsigned long tail = m_tail.load(memory_order_relaxed);
+  const unsigned long head = m_head.load(memory_order_acquire);
+  bool has_read = false;
+  while (tail != head)
+  {
+    const unsigned long idx = tail % size;
+    const unsigned long len = min(head - tail, size - idx);
+    m_sink_flushing = false;
+    const int written = sinkWriteSamples(&m_buf[idx], len);
+    tail += written;
+    m_tail.store(tail, memory_order_release);
+    has_read = has_read || (written > 0);
+    if (static_cast<unsigned long>(written) < len)
+    {
+      m_sink_blocked = true;
+      break;
+    }
+  }
+
+  if (has_read && m_write_blocked.exchange(false))
+  {
+    postResume();
+  }
+
+    // A flush is forwarded when all samples written before it have been
+    // passed on. If more samples have been written after the flush, the
+    // writer has cancelled it.
+  if (m_flush_pending && (tail >= m_pending_flush_pos))
+  {
+    m_flush_pending = false;
+    if (m_head.load(memory_order_acquire) == m_pending_flush_pos)
+    {
+      m_sink_flush_seq = m_pending_flush_seq;
+      m_sink_flushing = true;
+      sinkFlushSamples();
+    }
+  }
+} /* AudioThreadBridge::drain */
+
+
+void AudioThreadBridge::flushRequested(unsigned seq, unsigned long pos)
+{
+  m_flush_pending = true;
+  m_pending_flush_seq = seq;
+  m_pending_flush_pos = pos;
+  drain();
+} /* AudioThreadBridge::flushRequested */
+
+
+void AudioThreadBridge::flushCompleted(unsigned seq)
+{
+  if (m_flushing && (seq == m_flush_seq))
+  {
+    m_flushing = false;
+    sourceAllSamplesFlushed();
+  }
+} /* AudioThreadBridge::flushCompleted */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,235 @@
+/**
+@file	 AsyncAudioThreadBridge.h
+@brief   Pass audio between two threads running their own event loops
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_AUDIO_THREAD_BRIDGE_INCLUDED
+#define ASYNC_AUDIO_THREAD_BRIDGE_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioSink.h>
+#include <AsyncAudioSource.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+class Application;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	Pass audio between two threads running their own event loops
+@author agent
+@date   2026-10-17
+
+This class is used to connect an audio source running in one thread to an
+audio sink running in another thread. Each thread must run its own
+application object. The sink side of this object, the writeSamples and
+flushSamples functions, must only be used from the input thread. The source
+side must only be used from the output thread.
+
+Samples are passed through a single producer, single consumer ring buffer
+that is lock free. When samples are written, the output thread is woken up
+to write them to the connected sink. Only one wakeup is outstanding at a
+time so writing many small blocks does not flood the output thread with
+tasks. When the buffer is full, the write is only partially accepted and the
+source will be asked to resume output when there is room again, just like
+any other audio sink that cannot take more samples.
+
+Flushes are passed on to the output thread and the allSamplesFlushed
+notification is passed back when the flush is complete, unless new samples
+have been written in the meantime.
+
+Before the object is deleted, it must be disconnected from both the source
+and the sink. The disconnection and deletion must be done while the other
+thread is not running, for example when it is blocked in a call to
+ApplicationThread::call. Tasks that have already been posted for the object
+are ignored after it has been deleted.
+*/
+class AudioThreadBridge : public AudioSink, public AudioSource
+{
+  public:
+    /**
+     * @brief 	Constructor
+     * @param 	in_app  The application of the thread that write samples
+     * @param 	out_app The application of the thread that read samples
+     * @param 	size    The size of the buffer in samples
+     */
+    AudioThreadBridge(Application& in_app, Application& out_app,
+                      unsigned size=INTERNAL_SAMPLE_RATE / 4);
+
+    /**
+     * @brief 	Destructor
+     */
+    ~AudioThreadBridge(void);
+
+    /**
+     * @brief 	Write samples into this audio sink
+     * @param 	samples The buffer containing the samples
+     * @param 	count The number of samples in the buffer
+     * @return	Returns the number of samples that has been taken care of
+     *
+     * This function must only be called from the input thread.
+     */
+    virtual int writeSamples(const float *samples, int count);
+
+    /**
+     * @brief 	Tell the sink to flush the previously written samples
+     *
+     * This function must only be called from the input thread.
+     */
+    virtual void flushSamples(void);
+
+    /**
+     * @brief Resume audio output to the sink
+     *
+     * This function is called from the output thread.
+     */
+    virtual void resumeOutput(void);
+
+    /**
+     * @brief The registered sink has flushed all samples
+     *
+     * This function is called from the output thread.
+     */
+    virtual void allSamplesFlushed(void);
+
+    /**
+     * @brief   Get the number of samples in the buffer
+     * @return  Returns the number of samples not yet read by the output thread
+     */
+    unsigned samplesInBuffer(void) const;
+
+  private:
+    typedef std::shared_ptr<std::atomic<bool> > AliveFlag;
+
+    Application&              m_in_app;
+    Application&              m_out_app;
+    std::vector<float>        m_buf;
+    std::atomic<unsigned long> m_head;
+    std::atomic<unsigned long> m_tail;
+    std::atomic<bool>         m_drain_posted;
+    std::atomic<bool>         m_write_blocked;
+    AliveFlag                 m_alive;
+
+      // Only accessed from the input thread
+    unsigned                  m_flush_seq;
+    bool                      m_flushing;
+
+      // Only accessed from the output thread
+    bool                      m_flush_pending;
+    unsigned                  m_pending_flush_seq;
+    unsigned long             m_pending_flush_pos;
+    unsigned                  m_sink_flush_seq;
+    bool                      m_sink_flushing;
+    bool                      m_sink_blocked;
+
+    AudioThreadBridge(const AudioThreadBridge&);
+    AudioThreadBridge& operator=(const AudioThreadBridge&);
+    void postDrain(void);
+    void postResume(void);
+    void drain(void);
+    void flushRequested(unsigned seq, unsigned long pos);
+    void flushCompleted(unsigned seq);
+
+};  /* class AudioThreadBridge */
+
+
+} /* namespace */
+
+#endif /* ASYNC_AUDIO_THREAD_BRIDGE_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
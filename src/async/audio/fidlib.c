@@ -246,6 +246,7 @@
 #include <string.h>
 #include <ctype.h>
 #include <math.h>
+#include <pthread.h>
 #include "fidlib.h"
 
 #ifndef M_PI
@@ -2142,8 +2143,26 @@ grabWord(char **pp, char *buf, int buflen) {
 //	version of this routine.
 //
 
+//
+//	The filter design code in fidmkf.h use global variables so only one
+//	thread at a time may parse a filter specification.
+//
+
+static pthread_mutex_t fid_parse_mutex= PTHREAD_MUTEX_INITIALIZER;
+
+static char *fid_parse_locked(double rate, char **pp, FidFilter **ffp);
+
 char *
 fid_parse(double rate, char **pp, FidFilter **ffp) {
+   char *rv;
+   pthread_mutex_lock(&fid_parse_mutex);
+   rv= fid_parse_locked(rate, pp, ffp);
+   pthread_mutex_unlock(&fid_parse_mutex);
+   return rv;
+}
+
+static char *
+fid_parse_locked(double rate, char **pp, FidFilter **ffp) {
    char buf[128];
    char *p= *pp, *rew;
 #define INIT_LEN 128
@@ -38,8 +38,12 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <sys/types.h>
 #include <sys/select.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
 
 #include <cassert>
+#include <cstdio>
 #include <algorithm>
 
 
@@ -104,7 +108,7 @@ using namespace Async;
  *
  ****************************************************************************/
 
-Application *Application::app_ptr = 0;
+thread_local Application *Application::app_ptr = 0;
 
 
 /****************************************************************************
@@ -142,6 +146,7 @@ Application &Application::app(void)
  *------------------------------------------------------------------------
  */
 Application::Application(void)
+  : posted_notifier_wr(-1), posted_watch(0)
 {
   assert(app_ptr == 0);
   app_ptr = this;  
@@ -155,6 +160,24 @@ Application::~Application(void)
 {
   delete task_timer;
   task_timer = 0;
+
+  if (posted_watch != 0)
+  {
+    assert(!posted_watch->isEnabled());
+    close(posted_watch->fd());
+    delete posted_watch;
+    posted_watch = 0;
+  }
+  if (posted_notifier_wr >= 0)
+  {
+    close(posted_notifier_wr);
+    posted_notifier_wr = -1;
+  }
+
+  if (app_ptr == this)
+  {
+    app_ptr = 0;
+  }
 } /* Application::~Application */
 
 
@@ -165,6 +188,30 @@ void Application::runTask(sigc::slot<void> task)
 } /* Application::runTask */
 
 
+void Application::post(Task task)
+{
+  int notifier_wr = -1;
+  {
+    std::lock_guard<std::mutex> lk(posted_mutex);
+    if (posted_tasks.empty())
+    {
+      notifier_wr = posted_notifier_wr;
+    }
+    posted_tasks.push_back(std::move(task));
+  }
+
+    // The loop only need to be woken up when the queue goes from empty to
+    // non-empty since all queued tasks are run on each wakeup
+  if (notifier_wr >= 0)
+  {
+    char ch = 0;
+    while ((write(notifier_wr, &ch, 1) == -1) && (errno == EINTR))
+    {
+    }
+  }
+} /* Application::post */
+
+
 
 /****************************************************************************
  *
@@ -172,10 +219,51 @@ void Application::runTask(sigc::slot<void> task)
  *
  ****************************************************************************/
 
+void Application::setupPostedTasks(void)
+{
+  assert(posted_watch == 0);
+
+  int fd[2];
+  if (pipe(fd) == -1)
+  {
+    perror("pipe");
+    exit(1);
+  }
+  fcntl(fd[0], F_SETFL, fcntl(fd[0], F_GETFL) | O_NONBLOCK);
+  fcntl(fd[0], F_SETFD, FD_CLOEXEC);
+  fcntl(fd[1], F_SETFD, FD_CLOEXEC);
+
+  posted_watch = new FdWatch(fd[0], FdWatch::FD_WATCH_RD);
+  posted_watch->activity.connect(
+      mem_fun(*this, &Application::postedTasksNotified));
+
+    // Tasks may have been posted before we got here
+  std::lock_guard<std::mutex> lk(posted_mutex);
+  posted_notifier_wr = fd[1];
+  if (!posted_tasks.empty())
+  {
+    char ch = 0;
+    while ((write(posted_notifier_wr, &ch, 1) == -1) && (errno == EINTR))
+    {
+    }
+  }
+} /* Application::setupPostedTasks */
+
+
 void Application::clearTasks(void)
 {
   task_list.clear();
   task_timer->setEnable(false);
+
+  if (posted_watch != 0)
+  {
+    posted_watch->setEnabled(false);
+  }
+  std::deque<Task> tasks;
+  {
+    std::lock_guard<std::mutex> lk(posted_mutex);
+    tasks.swap(posted_tasks);
+  }
 } /* Application::clearTasks */
 
 
@@ -192,10 +280,33 @@ void Application::taskTimerExpired(void)
   {
     (*it)();
   }
-  clearTasks();
+  task_list.clear();
+  task_timer->setEnable(false);
 } /* Application::taskTimerExpired */
 
 
+void Application::postedTasksNotified(FdWatch *w)
+{
+    // Drain the pipe before looking at the queue so that no wakeup is lost
+  char buf[64];
+  while (read(w->fd(), buf, sizeof(buf)) > 0)
+  {
+  }
+
+  std::deque<Task> tasks;
+  {
+    std::lock_guard<std::mutex> lk(posted_mutex);
+    tasks.swap(posted_tasks);
+  }
+  while (!tasks.empty())
+  {
+    Task task(std::move(tasks.front()));
+    tasks.pop_front();
+    task();
+  }
+} /* Application::postedTasksNotified */
+
+
 
 /*
  * This file has not been truncated
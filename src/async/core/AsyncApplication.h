@@ -40,6 +40,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <sigc++/sigc++.h>
 
 #include <string>
+#include <deque>
+#include <mutex>
+#include <functional>
 
 
 /****************************************************************************
@@ -115,16 +118,23 @@ class DnsLookupWorker;
  * This is the base class for all asynchronous applications. It is an abstract
  * class and so it must be inherited from to create a class that can be
  * instantiated.
- */   
+ *
+ * There can be one application object per thread. Timers, file descriptor
+ * watches and other Async objects are registered with the application object
+ * of the thread that create them so all Async objects must be used from the
+ * thread that created them. The post function can be used to hand over work
+ * to another thread that run its own application object.
+ */
 class Application : public sigc::trackable
 {
   public:
     /**
-     * @brief 	Get the one and only application instance
+     * @brief 	Get the application instance of the calling thread
      *
-     * Use this static member function to get the one and only instance of the
-     * application object. If an application object has not been previously
-     * created, the application will crash with a failed assertion.
+     * Use this static member function to get the instance of the
+     * application object that was created by the calling thread. If an
+     * application object has not been previously created by the thread, the
+     * application will crash with a failed assertion.
      * @return	Returns a reference to the applicaton instance
      */
     static Application &app(void);
@@ -177,10 +187,50 @@ class Application : public sigc::trackable
      * and the second is an integer.
      */
     void runTask(sigc::slot<void> task);
-    
+
+    /**
+     * @brief   The type of the tasks that can be posted from other threads
+     */
+    typedef std::function<void(void)> Task;
+
+    /**
+     * @brief   Run a task from the main loop of this application
+     * @param   task The task to run
+     *
+     * This function is thread safe. It is used to hand over work to the
+     * thread running this application object from another thread. The tasks
+     * are run in the order they were posted. Tasks that have not been run
+     * when the application object is destroyed are thrown away.
+     *
+     * A std::function is used instead of a sigc++ slot since sigc++ slots
+     * must not be copied between threads.
+     */
+    void post(Task task);
+
+    /**
+     * @brief   Check if this application object belong to the calling thread
+     * @return  Returns \em true if the calling thread created this object
+     */
+    bool isCurrentThread(void) const { return app_ptr == this; }
+
   protected:
+    /**
+     * @brief   Make it possible to post tasks to this application
+     *
+     * This function must be called from the constructor of the inheriting
+     * class since the notification file descriptor watch cannot be set up
+     * before the inheriting class have been constructed.
+     */
+    void setupPostedTasks(void);
+
+    /**
+     * @brief   Remove all pending tasks
+     *
+     * This function must be called from the destructor of the inheriting
+     * class.
+     */
     void clearTasks(void);
-    
+
   private:
     friend class FdWatch;
     friend class Timer;
@@ -188,12 +238,17 @@ class Application : public sigc::trackable
     
     typedef std::list<sigc::slot<void> > SlotList;
 
-    static Application *app_ptr;
+    static thread_local Application *app_ptr;
     
-    SlotList task_list;
-    Timer    *task_timer;
+    SlotList          task_list;
+    Timer             *task_timer;
+    std::mutex        posted_mutex;
+    std::deque<Task>  posted_tasks;
+    int               posted_notifier_wr;
+    FdWatch           *posted_watch;
 
     void taskTimerExpired(void);
+    void postedTasksNotified(FdWatch *w);
     virtual void addFdWatch(FdWatch *fd_watch) = 0;
     virtual void delFdWatch(FdWatch *fd_watch) = 0;
     virtual void addTimer(Timer *timer) = 0;
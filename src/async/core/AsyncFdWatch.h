@@ -125,7 +125,8 @@ class FdWatch : public sigc::trackable
     typedef enum
     { 
       FD_WATCH_RD,  ///< File descriptor watch for incoming data
-      FD_WATCH_WR   ///< File descriptor watch for outgoing data
+      FD_WATCH_WR,  ///< File descriptor watch for outgoing data
+      FD_WATCH_PRI  ///< File descriptor watch for exceptional conditions
     } FdWatchType;
     
     /**
@@ -140,8 +141,10 @@ class FdWatch : public sigc::trackable
      * @brief Constructor
      *
      * Add the given file descriptor to the watch list and watch it for
-     * incoming data (FD_WATCH_RD) or write buffer space available
-     * (FD_WATCH_WR).
+     * incoming data (FD_WATCH_RD), write buffer space available
+     * (FD_WATCH_WR) or exceptional conditions (FD_WATCH_PRI). The latter
+     * correspond to POLLPRI and is for example used by the Linux kernel
+     * to notify a change in a sysfs attribute, like a GPIO edge.
      * @param fd    The file descriptor to watch
      * @param type  The type of watch to create (see @ref FdWatchType)
      */
@@ -34,6 +34,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <cstring>
 #include <cerrno>
+#include <cassert>
 
 
 /****************************************************************************
@@ -51,6 +52,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include "AsyncFramedTcpConnection.h"
+#include "AsyncSlabPool.h"
 
 
 
@@ -87,6 +89,8 @@ using namespace Async;
  *
  ****************************************************************************/
 
+static SlabPool& connectionPool(void);
+static std::vector<char>& txFrameBuf(void);
 
 
 /****************************************************************************
@@ -112,6 +116,29 @@ using namespace Async;
  *
  ****************************************************************************/
 
+void *FramedTcpConnection::operator new(size_t size)
+{
+  if (size == sizeof(FramedTcpConnection))
+  {
+    return connectionPool().allocate();
+  }
+  return ::operator new(size);
+} /* FramedTcpConnection::operator new */
+
+
+void FramedTcpConnection::operator delete(void *ptr, size_t size)
+{
+  if (size == sizeof(FramedTcpConnection))
+  {
+    connectionPool().deallocate(ptr);
+  }
+  else
+  {
+    ::operator delete(ptr);
+  }
+} /* FramedTcpConnection::operator delete */
+
+
 FramedTcpConnection::FramedTcpConnection(size_t recv_buf_len)
   : TcpConnection(recv_buf_len), m_max_frame_size(DEFAULT_MAX_FRAME_SIZE),
     m_size_received(false)
@@ -182,33 +209,35 @@ int FramedTcpConnection::write(const void *buf, int count)
     return -1;
   }
 
-  QueueItem *qi = new QueueItem(buf, count);
+    // The frame is built in a buffer that is reused for all writes. A
+    // queue item is only created for the part that could not be sent
+    // right away.
+  std::vector<char>& frame = txFrameBuf();
+  frame.resize(4+count);
+  char *ptr = &frame[0];
+  *ptr++ = static_cast<uint32_t>(count) >> 24;
+  *ptr++ = (static_cast<uint32_t>(count) >> 16) & 0xff;
+  *ptr++ = (static_cast<uint32_t>(count) >> 8) & 0xff;
+  *ptr++ = (static_cast<uint32_t>(count)) & 0xff;
+  std::memcpy(ptr, buf, count);
+
+  int pos = 0;
   if (m_txq.empty())
   {
-    int ret = TcpConnection::write(qi->m_buf, qi->m_size);
-    //cout << "###   count=" << (qi->m_size-qi->m_pos) << " ret=" << ret << endl;
+    int ret = TcpConnection::write(&frame[0], frame.size());
+    //cout << "###   count=" << frame.size() << " ret=" << ret << endl;
     if (ret < 0)
     {
-      delete qi;
-      qi = 0;
       return -1;
     }
-    if (ret >= qi->m_size)
-    {
-      delete qi;
-      qi = 0;
-    }
-    else
-    {
-      //cout << "### Not all bytes were sent: count=" << count
-      //     << " ret=" << ret << endl;
-      qi->m_pos += ret;
-    }
+    pos = ret;
   }
 
-  if (qi != 0)
+  if (pos < static_cast<int>(frame.size()))
   {
-    m_txq.push_back(qi);
+    //cout << "### Not all bytes were sent: count=" << count
+    //     << " pos=" << pos << endl;
+    m_txq.push_back(new QueueItem(&frame[pos], frame.size()-pos));
   }
 
   return count;
@@ -317,6 +346,63 @@ void FramedTcpConnection::onSendBufferFull(bool is_full)
 } /* FramedTcpConnection::onSendBufferFull */
 
 
+FramedTcpConnection::QueueItem::QueueItem(const char* frame, int size)
+  : m_buf(0), m_size(size), m_pos(0)
+{
+  if (size <= POOLED_FRAME_SIZE)
+  {
+    m_buf = static_cast<char*>(bufPool().allocate());
+  }
+  else
+  {
+    m_buf = new char[size];
+  }
+  std::memcpy(m_buf, frame, size);
+} /* FramedTcpConnection::QueueItem::QueueItem */
+
+
+FramedTcpConnection::QueueItem::~QueueItem(void)
+{
+  if (m_size <= POOLED_FRAME_SIZE)
+  {
+    bufPool().deallocate(m_buf);
+  }
+  else
+  {
+    delete [] m_buf;
+  }
+} /* FramedTcpConnection::QueueItem::~QueueItem */
+
+
+void *FramedTcpConnection::QueueItem::operator new(size_t size)
+{
+  assert(size == sizeof(QueueItem));
+  return itemPool().allocate();
+} /* FramedTcpConnection::QueueItem::operator new */
+
+
+void FramedTcpConnection::QueueItem::operator delete(void *ptr, size_t size)
+{
+  itemPool().deallocate(ptr);
+} /* FramedTcpConnection::QueueItem::operator delete */
+
+
+  // The pools are never destroyed, and are per thread, for the same reasons
+  // as the connection pool
+SlabPool& FramedTcpConnection::QueueItem::itemPool(void)
+{
+  static thread_local SlabPool *pool = new SlabPool(sizeof(QueueItem), 64);
+  return *pool;
+} /* FramedTcpConnection::QueueItem::itemPool */
+
+
+SlabPool& FramedTcpConnection::QueueItem::bufPool(void)
+{
+  static thread_local SlabPool *pool = new SlabPool(POOLED_FRAME_SIZE, 64);
+  return *pool;
+} /* FramedTcpConnection::QueueItem::bufPool */
+
+
 void FramedTcpConnection::disconnectCleanup(void)
 {
   for (TxQueue::iterator it = m_txq.begin(); it != m_txq.end(); ++it)
@@ -327,6 +413,32 @@ void FramedTcpConnection::disconnectCleanup(void)
 } /* FramedTcpConnection::disconnectCleanup */
 
 
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+  // The pools are never destroyed since connections may be deleted during
+  // static destruction. Each thread has its own pools since connections are
+  // created and deleted in the thread running their event loop.
+static SlabPool& connectionPool(void)
+{
+  static thread_local SlabPool *pool =
+    new SlabPool(sizeof(FramedTcpConnection), 64);
+  return *pool;
+} /* connectionPool */
+
+
+static std::vector<char>& txFrameBuf(void)
+{
+  static thread_local std::vector<char> *buf = new std::vector<char>;
+  return *buf;
+} /* txFrameBuf */
+
+
+
 /*
  * This file has not been truncated
  */
@@ -90,6 +90,7 @@ namespace Async
  *
  ****************************************************************************/
 
+class SlabPool;
 
 
 /****************************************************************************
@@ -131,6 +132,26 @@ that only want to see completely transfered messages at the other end.
 class FramedTcpConnection : public TcpConnection
 {
   public:
+    /**
+     * @brief   Allocate memory for a connection object
+     * @param   size The size of the object
+     * @return  Returns a pointer to the allocated memory
+     *
+     * Plain connection objects, like the ones created by a TcpServer, are
+     * allocated from a pool so that a server with many clients that connect
+     * and disconnect does not fragment the heap. Each thread has its own
+     * pool so a connection must be deleted in the thread that created it.
+     * Objects of derived classes are allocated from the heap.
+     */
+    static void *operator new(size_t size);
+
+    /**
+     * @brief   Free the memory for a connection object
+     * @param   ptr Pointer to the memory to free
+     * @param   size The size of the object
+     */
+    static void operator delete(void *ptr, size_t size);
+
     /**
      * @brief 	Constructor
      * @param 	recv_buf_len  The length of the receiver buffer to use
@@ -255,24 +276,22 @@ class FramedTcpConnection : public TcpConnection
   private:
     static const uint32_t DEFAULT_MAX_FRAME_SIZE = 1024 * 1024; // 1MB
 
+    static const int POOLED_FRAME_SIZE = 256;
+
+      // A frame, including the size header, waiting to be sent. Items and
+      // small frame buffers are allocated from pools.
     struct QueueItem
     {
       char* m_buf;
       int   m_size;
       int   m_pos;
 
-      QueueItem(const void* buf, int count)
-        : m_buf(0), m_size(4+count), m_pos(0)
-      {
-        m_buf = new char[4+count];
-        char *ptr = m_buf;
-        *ptr++ = static_cast<uint32_t>(count) >> 24;
-        *ptr++ = (static_cast<uint32_t>(count) >> 16) & 0xff;
-        *ptr++ = (static_cast<uint32_t>(count) >> 8) & 0xff;
-        *ptr++ = (static_cast<uint32_t>(count)) & 0xff;
-        std::memcpy(ptr, buf, count);
-      }
-      ~QueueItem(void) { delete [] m_buf; }
+      QueueItem(const char* frame, int size);
+      ~QueueItem(void);
+      static void *operator new(size_t size);
+      static void operator delete(void *ptr, size_t size);
+      static SlabPool& itemPool(void);
+      static SlabPool& bufPool(void);
     };
     typedef std::deque<QueueItem*> TxQueue;
 
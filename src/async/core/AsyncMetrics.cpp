@@ -0,0 +1,403 @@
+/**
+@file	 AsyncMetrics.cpp
+@brief   Counters, gauges and histograms for runtime statistics
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncMetrics.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+static void writeValue(std::ostream& os, double value);
+static void appendLabel(std::string& labels, const std::string& name,
+                        const std::string& value);
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+const char *MetricsRegistry::CONTENT_TYPE = "text/plain; version=0.0.4";
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+void MetricCounter::write(std::ostream& os, const std::string& name,
+                          const std::string& labels) const
+{
+  if (m_scale == 1.0)
+  {
+    os << name;
+    if (!labels.empty())
+    {
+      os << "{" << labels << "}";
+    }
+    os << " " << value() << "\n";
+  }
+  else
+  {
+    writeSample(os, name, labels, m_scale * value());
+  }
+} /* MetricCounter::write */
+
+
+void MetricGauge::add(double delta)
+{
+  uint64_t old_bits = m_bits.load(std::memory_order_relaxed);
+  while (!m_bits.compare_exchange_weak(old_bits,
+                                       toBits(fromBits(old_bits) + delta),
+                                       std::memory_order_relaxed))
+  {
+  }
+} /* MetricGauge::add */
+
+
+void MetricGauge::write(std::ostream& os, const std::string& name,
+                        const std::string& labels) const
+{
+  writeSample(os, name, labels, value());
+} /* MetricGauge::write */
+
+
+MetricHistogram::MetricHistogram(const std::vector<double>& bounds)
+  : m_bounds(bounds),
+    m_buckets(new std::atomic<uint64_t>[bounds.size() + 1])
+{
+  for (size_t i=0; i<=m_bounds.size(); ++i)
+  {
+    m_buckets[i] = 0;
+  }
+} /* MetricHistogram::MetricHistogram */
+
+
+uint64_t MetricHistogram::count(void) const
+{
+  uint64_t cnt = 0;
+  for (size_t i=0; i<=m_bounds.size(); ++i)
+  {
+    cnt += m_buckets[i].load(std::memory_order_relaxed);
+  }
+  return cnt;
+} /* MetricHistogram::count */
+
+
+void MetricHistogram::write(std::ostream& os, const std::string& name,
+                            const std::string& labels) const
+{
+  uint64_t cnt = 0;
+  for (size_t i=0; i<=m_bounds.size(); ++i)
+  {
+    cnt += m_buckets[i].load(std::memory_order_relaxed);
+    std::string le_labels(labels);
+    std::ostringstream le;
+    if (i < m_bounds.size())
+    {
+      writeValue(le, m_bounds[i]);
+    }
+    else
+    {
+      le << "+Inf";
+    }
+    appendLabel(le_labels, "le", le.str());
+    os << name << "_bucket{" << le_labels << "} " << cnt << "\n";
+  }
+  writeSample(os, name + "_sum", labels, sum());
+  writeSample(os, name + "_count", labels, cnt);
+} /* MetricHistogram::write */
+
+
+MetricsRegistry& MetricsRegistry::instance(void)
+{
+  static MetricsRegistry registry;
+  return registry;
+} /* MetricsRegistry::instance */
+
+
+MetricCounter& MetricsRegistry::counter(const std::string& name,
+                                        const std::string& help,
+                                        const Labels& labels, double scale)
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  Family& fam = family(name, "counter", help);
+  std::unique_ptr<Metric>& metric = fam.metrics[formatLabels(labels)];
+  if (metric == nullptr)
+  {
+    metric.reset(new MetricCounter(scale));
+  }
+  MetricCounter *counter = dynamic_cast<MetricCounter*>(metric.get());
+  assert(counter != 0);
+  return *counter;
+} /* MetricsRegistry::counter */
+
+
+MetricGauge& MetricsRegistry::gauge(const std::string& name,
+                                    const std::string& help,
+                                    const Labels& labels)
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  Family& fam = family(name, "gauge", help);
+  std::unique_ptr<Metric>& metric = fam.metrics[formatLabels(labels)];
+  if (metric == nullptr)
+  {
+    metric.reset(new MetricGauge);
+  }
+  MetricGauge *gauge = dynamic_cast<MetricGauge*>(metric.get());
+  assert(gauge != 0);
+  return *gauge;
+} /* MetricsRegistry::gauge */
+
+
+MetricHistogram& MetricsRegistry::histogram(const std::string& name,
+                                            const std::string& help,
+                                            const std::vector<double>& bounds,
+                                            const Labels& labels)
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  Family& fam = family(name, "histogram", help);
+  std::unique_ptr<Metric>& metric = fam.metrics[formatLabels(labels)];
+  if (metric == nullptr)
+  {
+    metric.reset(new MetricHistogram(bounds));
+  }
+  MetricHistogram *histogram = dynamic_cast<MetricHistogram*>(metric.get());
+  assert(histogram != 0);
+  return *histogram;
+} /* MetricsRegistry::histogram */
+
+
+std::string MetricsRegistry::render(void)
+{
+  collect();
+
+  std::ostringstream os;
+  std::lock_guard<std::mutex> lk(m_mutex);
+  for (const auto& fam_entry : m_families)
+  {
+    const std::string& name = fam_entry.first;
+    const Family& fam = fam_entry.second;
+    os << "# HELP " << name << " " << fam.help << "\n";
+    os << "# TYPE " << name << " " << fam.type << "\n";
+    for (const auto& metric_entry : fam.metrics)
+    {
+      metric_entry.second->write(os, name, metric_entry.first);
+    }
+  }
+  return os.str();
+} /* MetricsRegistry::render */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+void Metric::writeSample(std::ostream& os, const std::string& name,
+                         const std::string& labels, double value)
+{
+  os << name;
+  if (!labels.empty())
+  {
+    os << "{" << labels << "}";
+  }
+  os << " ";
+  writeValue(os, value);
+  os << "\n";
+} /* Metric::writeSample */
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+MetricsRegistry::Family& MetricsRegistry::family(const std::string& name,
+                                                 const std::string& type,
+                                                 const std::string& help)
+{
+  Family& fam = m_families[name];
+  if (fam.type.empty())
+  {
+    fam.type = type;
+    fam.help = help;
+  }
+  else if (fam.type != type)
+  {
+    std::cerr << "*** ERROR: Metric " << name << " registered as "
+              << fam.type << " and " << type << std::endl;
+    assert(fam.type == type);
+  }
+  return fam;
+} /* MetricsRegistry::family */
+
+
+std::string MetricsRegistry::formatLabels(const Labels& labels)
+{
+  std::string str;
+  for (const auto& label : labels)
+  {
+    appendLabel(str, label.first, label.second);
+  }
+  return str;
+} /* MetricsRegistry::formatLabels */
+
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+static void writeValue(std::ostream& os, double value)
+{
+  if (std::isnan(value))
+  {
+    os << "NaN";
+  }
+  else if (std::isinf(value))
+  {
+    os << (value > 0.0 ? "+Inf" : "-Inf");
+  }
+  else
+  {
+    std::ostringstream ss;
+    ss.precision(15);
+    ss << value;
+    os << ss.str();
+  }
+} /* writeValue */
+
+
+static void appendLabel(std::string& labels, const std::string& name,
+                        const std::string& value)
+{
+  if (!labels.empty())
+  {
+    labels += ",";
+  }
+  labels += name + "=\"";
+  for (char ch : value)
+  {
+    switch (ch)
+    {
+      case '\\':
+        labels += "\\\\";
+        break;
+      case '"':
+        labels += "\\\"";
+        break;
+      case '\n':
+        labels += "\\n";
+        break;
+      default:
+        labels += ch;
+        break;
+    }
+  }
+  labels += "\"";
+} /* appendLabel */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,469 @@
+/**
+@file	 AsyncMetrics.h
+@brief   Counters, gauges and histograms for runtime statistics
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_METRICS_INCLUDED
+#define ASYNC_METRICS_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+class MetricsRegistry;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	The base class for all metrics
+@author agent
+@date   2026-10-17
+
+Metrics are created through the MetricsRegistry and live as long as the
+registry so pointers and references to them may be kept by the user.
+*/
+class Metric
+{
+  public:
+    /**
+     * @brief 	Destructor
+     */
+    virtual ~Metric(void) {}
+
+    /**
+     * @brief   Write the metric in the Prometheus text format
+     * @param   os The stream to write to
+     * @param   name The name of the metric family
+     * @param   labels The formatted labels, without braces
+     */
+    virtual void write(std::ostream& os, const std::string& name,
+                       const std::string& labels) const = 0;
+
+  protected:
+    Metric(void) {}
+
+    static void writeSample(std::ostream& os, const std::string& name,
+                            const std::string& labels, double value);
+
+  private:
+    Metric(const Metric&);
+    Metric& operator=(const Metric&);
+
+};  /* class Metric */
+
+
+/**
+@brief	A monotonically increasing counter
+@author agent
+@date   2026-10-17
+
+Incrementing a counter is a single relaxed atomic add so it may be used on
+hot paths and from any thread. The counter count integer units. A scale
+factor, given when the counter is registered, is applied when the value is
+exported. That make it possible to count e.g. microseconds and export
+seconds.
+*/
+class MetricCounter : public Metric
+{
+  public:
+    /**
+     * @brief 	Constructor
+     * @param   scale The scale factor to apply when exporting the value
+     */
+    explicit MetricCounter(double scale=1.0) : m_value(0), m_scale(scale) {}
+
+    /**
+     * @brief   Increment the counter
+     * @param   n The value to add
+     */
+    void inc(uint64_t n=1)
+    {
+      m_value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief   Get the current counter value
+     * @return  Returns the unscaled counter value
+     */
+    uint64_t value(void) const
+    {
+      return m_value.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief   Write the metric in the Prometheus text format
+     * @param   os The stream to write to
+     * @param   name The name of the metric family
+     * @param   labels The formatted labels, without braces
+     */
+    virtual void write(std::ostream& os, const std::string& name,
+                       const std::string& labels) const;
+
+  private:
+    std::atomic<uint64_t> m_value;
+    const double          m_scale;
+
+};  /* class MetricCounter */
+
+
+/**
+@brief	A value that can go up and down
+@author agent
+@date   2026-10-17
+
+Setting a gauge is a single relaxed atomic store. Adding to it use a
+compare and swap loop which is also lock free.
+*/
+class MetricGauge : public Metric
+{
+  public:
+    /**
+     * @brief 	Default constructor
+     */
+    MetricGauge(void) : m_bits(0) {}
+
+    /**
+     * @brief   Set the gauge value
+     * @param   value The new value
+     */
+    void set(double value)
+    {
+      m_bits.store(toBits(value), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief   Add to the gauge value
+     * @param   delta The value to add, may be negative
+     */
+    void add(double delta);
+
+    /**
+     * @brief   Get the current gauge value
+     * @return  Returns the current value
+     */
+    double value(void) const
+    {
+      return fromBits(m_bits.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief   Write the metric in the Prometheus text format
+     * @param   os The stream to write to
+     * @param   name The name of the metric family
+     * @param   labels The formatted labels, without braces
+     */
+    virtual void write(std::ostream& os, const std::string& name,
+                       const std::string& labels) const;
+
+  private:
+    std::atomic<uint64_t> m_bits;
+
+    static uint64_t toBits(double value)
+    {
+      uint64_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      return bits;
+    }
+
+    static double fromBits(uint64_t bits)
+    {
+      double value;
+      std::memcpy(&value, &bits, sizeof(value));
+      return value;
+    }
+
+};  /* class MetricGauge */
+
+
+/**
+@brief	A histogram with fixed bucket boundaries
+@author agent
+@date   2026-10-17
+
+The bucket boundaries are given when the histogram is registered. An
+observation is a short linear search through the boundaries followed by
+relaxed atomic updates of the bucket count and the sum, so it is lock free.
+*/
+class MetricHistogram : public Metric
+{
+  public:
+    /**
+     * @brief 	Constructor
+     * @param   bounds The upper bounds of the buckets in increasing order
+     */
+    explicit MetricHistogram(const std::vector<double>& bounds);
+
+    /**
+     * @brief   Add an observation
+     * @param   value The observed value
+     */
+    void observe(double value)
+    {
+      size_t idx = 0;
+      while ((idx < m_bounds.size()) && (value > m_bounds[idx]))
+      {
+        ++idx;
+      }
+      m_buckets[idx].fetch_add(1, std::memory_order_relaxed);
+      m_sum.add(value);
+    }
+
+    /**
+     * @brief   Get the number of observations
+     * @return  Returns the total number of observations
+     */
+    uint64_t count(void) const;
+
+    /**
+     * @brief   Get the sum of all observations
+     * @return  Returns the sum of all observed values
+     */
+    double sum(void) const { return m_sum.value(); }
+
+    /**
+     * @brief   Write the metric in the Prometheus text format
+     * @param   os The stream to write to
+     * @param   name The name of the metric family
+     * @param   labels The formatted labels, without braces
+     */
+    virtual void write(std::ostream& os, const std::string& name,
+                       const std::string& labels) const;
+
+  private:
+    const std::vector<double>                   m_bounds;
+    std::unique_ptr<std::atomic<uint64_t>[]>    m_buckets;
+    MetricGauge                                 m_sum;
+
+};  /* class MetricHistogram */
+
+
+/**
+@brief	A registry for all metrics in the application
+@author agent
+@date   2026-10-17
+
+All metrics are registered in this registry. A metric is identified by its
+name and its labels. Registering a metric that already exist return the
+existing metric so the same metric may be looked up from many places.
+
+Registration and export are protected by a mutex but the metrics themselves
+are lock free so updating them is cheap. Look the metric up once and keep a
+pointer to it when it is used on a hot path.
+
+\code
+Async::MetricCounter& packets = Async::MetricsRegistry::instance().counter(
+    "svxreflector_udp_packets_received_total",
+    "Number of received UDP packets", {{"tg", "91"}});
+packets.inc();
+std::cout << Async::MetricsRegistry::instance().render();
+\endcode
+*/
+class MetricsRegistry
+{
+  public:
+    /**
+     * @brief   A list of label name and value pairs
+     */
+    typedef std::vector<std::pair<std::string, std::string> > Labels;
+
+    /**
+     * @brief   The content type of the exported metrics
+     */
+    static const char *CONTENT_TYPE;
+
+    /**
+     * @brief   Get the application wide registry
+     * @return  Returns the registry
+     */
+    static MetricsRegistry& instance(void);
+
+    /**
+     * @brief 	Default constructor
+     */
+    MetricsRegistry(void) {}
+
+    /**
+     * @brief 	Destructor
+     */
+    ~MetricsRegistry(void) {}
+
+    /**
+     * @brief   Find or create a counter
+     * @param   name The name of the counter, should end in _total
+     * @param   help A description of the counter
+     * @param   labels The labels of this counter
+     * @param   scale The scale factor to apply when exporting the value
+     * @return  Returns a reference to the counter
+     */
+    MetricCounter& counter(const std::string& name, const std::string& help,
+                           const Labels& labels=Labels(), double scale=1.0);
+
+    /**
+     * @brief   Find or create a gauge
+     * @param   name The name of the gauge
+     * @param   help A description of the gauge
+     * @param   labels The labels of this gauge
+     * @return  Returns a reference to the gauge
+     */
+    MetricGauge& gauge(const std::string& name, const std::string& help,
+                       const Labels& labels=Labels());
+
+    /**
+     * @brief   Find or create a histogram
+     * @param   name The name of the histogram
+     * @param   help A description of the histogram
+     * @param   bounds The upper bounds of the buckets in increasing order
+     * @param   labels The labels of this histogram
+     * @return  Returns a reference to the histogram
+     *
+     * The bucket boundaries are only used when the histogram is created.
+     */
+    MetricHistogram& histogram(const std::string& name,
+                               const std::string& help,
+                               const std::vector<double>& bounds,
+                               const Labels& labels=Labels());
+
+    /**
+     * @brief   Render all metrics in the Prometheus text format
+     * @return  Returns the text to send to the metrics collector
+     *
+     * The collect signal is emitted before the metrics are rendered.
+     */
+    std::string render(void);
+
+    /**
+     * @brief   A signal that is emitted just before the metrics are rendered
+     *
+     * Connect to this signal to update gauges that are cheaper to compute
+     * when the metrics are exported than on each change.
+     */
+    sigc::signal<void> collect;
+
+  private:
+    struct Family
+    {
+      std::string                                         type;
+      std::string                                         help;
+      std::map<std::string, std::unique_ptr<Metric> >     metrics;
+    };
+
+    std::mutex                      m_mutex;
+    std::map<std::string, Family>   m_families;
+
+    MetricsRegistry(const MetricsRegistry&);
+    MetricsRegistry& operator=(const MetricsRegistry&);
+    Family& family(const std::string& name, const std::string& type,
+                   const std::string& help);
+    static std::string formatLabels(const Labels& labels);
+
+};  /* class MetricsRegistry */
+
+
+} /* namespace */
+
+#endif /* ASYNC_METRICS_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
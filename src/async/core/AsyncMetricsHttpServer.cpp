@@ -0,0 +1,196 @@
+/**
+@file	 AsyncMetricsHttpServer.cpp
+@brief   Serve application metrics over HTTP
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncMetrics.h"
+#include "AsyncMetricsHttpServer.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+const char *MetricsHttpServer::METRICS_PATH = "/metrics";
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+bool MetricsHttpServer::handleRequest(HttpServerConnection *con,
+                                      HttpServerConnection::Request& req,
+                                      MetricsRegistry& registry)
+{
+  if (req.target != METRICS_PATH)
+  {
+    return false;
+  }
+
+  HttpServerConnection::Response res;
+  if ((req.method != "GET") && (req.method != "HEAD"))
+  {
+    res.setCode(501);
+    res.setContent("text/plain", req.method + ": Method not implemented\n");
+    con->write(res);
+    return true;
+  }
+
+  res.setContent(MetricsRegistry::CONTENT_TYPE, registry.render());
+  if (req.method == "HEAD")
+  {
+    res.setSendContent(false);
+  }
+  res.setCode(200);
+  con->write(res);
+  return true;
+} /* MetricsHttpServer::handleRequest */
+
+
+MetricsHttpServer::MetricsHttpServer(const std::string& port_str,
+                                     MetricsRegistry* registry)
+  : m_server(port_str),
+    m_registry(registry != 0 ? *registry : MetricsRegistry::instance())
+{
+  m_server.clientConnected.connect(
+      sigc::mem_fun(*this, &MetricsHttpServer::clientConnected));
+} /* MetricsHttpServer::MetricsHttpServer */
+
+
+MetricsHttpServer::~MetricsHttpServer(void)
+{
+} /* MetricsHttpServer::~MetricsHttpServer */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void MetricsHttpServer::clientConnected(HttpServerConnection *con)
+{
+  con->requestReceived.connect(
+      sigc::mem_fun(*this, &MetricsHttpServer::requestReceived));
+} /* MetricsHttpServer::clientConnected */
+
+
+void MetricsHttpServer::requestReceived(HttpServerConnection *con,
+                                        HttpServerConnection::Request& req)
+{
+  if (!handleRequest(con, req, m_registry))
+  {
+    HttpServerConnection::Response res;
+    res.setCode(404);
+    res.setContent("text/plain", "Not found\n");
+    con->write(res);
+  }
+} /* MetricsHttpServer::requestReceived */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,179 @@
+/**
+@file	 AsyncMetricsHttpServer.h
+@brief   Serve application metrics over HTTP
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_METRICS_HTTP_SERVER_INCLUDED
+#define ASYNC_METRICS_HTTP_SERVER_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+
+#include <string>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncTcpServer.h>
+#include <AsyncHttpServerConnection.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+class MetricsRegistry;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	A HTTP server exporting metrics in the Prometheus text format
+@author agent
+@date   2026-10-17
+
+This class listen for HTTP connections and answer GET requests for
+/metrics with the metrics in a MetricsRegistry. Applications that already
+have a HTTP server may instead call the static handleRequest function from
+their own request handler.
+
+\code
+Async::MetricsHttpServer *srv = new Async::MetricsHttpServer("9100");
+\endcode
+*/
+class MetricsHttpServer : public sigc::trackable
+{
+  public:
+    /**
+     * @brief   The path that the metrics are served on
+     */
+    static const char *METRICS_PATH;
+
+    /**
+     * @brief   Answer a metrics request
+     * @param   con The connection the request was received on
+     * @param   req The received request
+     * @param   registry The registry to export
+     * @return  Returns \em true if the request was for the metrics path
+     *
+     * If the request is not for the metrics path, nothing is sent and
+     * \em false is returned so that the caller may handle the request.
+     */
+    static bool handleRequest(HttpServerConnection *con,
+                              HttpServerConnection::Request& req,
+                              MetricsRegistry& registry);
+
+    /**
+     * @brief 	Constuctor
+     * @param 	port_str The TCP port or service name to listen to
+     * @param   registry The registry to export
+     */
+    explicit MetricsHttpServer(const std::string& port_str,
+                               MetricsRegistry* registry=0);
+
+    /**
+     * @brief 	Destructor
+     */
+    ~MetricsHttpServer(void);
+
+  private:
+    TcpServer<HttpServerConnection>   m_server;
+    MetricsRegistry&                  m_registry;
+
+    MetricsHttpServer(const MetricsHttpServer&);
+    MetricsHttpServer& operator=(const MetricsHttpServer&);
+    void clientConnected(HttpServerConnection *con);
+    void requestReceived(HttpServerConnection *con,
+                         HttpServerConnection::Request& req);
+
+};  /* class MetricsHttpServer */
+
+
+} /* namespace */
+
+#endif /* ASYNC_METRICS_HTTP_SERVER_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
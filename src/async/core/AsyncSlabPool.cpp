@@ -0,0 +1,177 @@
+/**
+@file	 AsyncSlabPool.cpp
+@brief   A pool of fixed size memory blocks allocated in slabs
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cassert>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncSlabPool.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+SlabPool::SlabPool(size_t block_size, size_t blocks_per_slab)
+  : m_block_size(alignedSize(block_size)),
+    m_blocks_per_slab(blocks_per_slab), m_free_list(0), m_blocks_in_use(0)
+{
+  assert(m_blocks_per_slab > 0);
+} /* SlabPool::SlabPool */
+
+
+SlabPool::~SlabPool(void)
+{
+  assert(m_blocks_in_use == 0);
+  for (auto slab : m_slabs)
+  {
+    delete [] slab;
+  }
+  m_slabs.clear();
+  m_free_list = 0;
+} /* SlabPool::~SlabPool */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void SlabPool::addSlab(void)
+{
+    // Memory from new[] is aligned for any fundamental type and the block
+    // size is a multiple of that alignment
+  char *slab = new char[m_block_size * m_blocks_per_slab];
+  m_slabs.push_back(slab);
+  for (size_t i=m_blocks_per_slab; i>0; --i)
+  {
+    FreeBlock *block = reinterpret_cast<FreeBlock*>(slab + (i-1)*m_block_size);
+    block->next = m_free_list;
+    m_free_list = block;
+  }
+} /* SlabPool::addSlab */
+
+
+size_t SlabPool::alignedSize(size_t size)
+{
+    // Round the block size up so that all blocks in a slab stay aligned
+  const size_t align = alignof(std::max_align_t);
+  if (size < sizeof(FreeBlock))
+  {
+    size = sizeof(FreeBlock);
+  }
+  return (size + align - 1) / align * align;
+} /* SlabPool::alignedSize */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,236 @@
+/**
+@file	 AsyncSlabPool.h
+@brief   A pool of fixed size memory blocks allocated in slabs
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_SLAB_POOL_INCLUDED
+#define ASYNC_SLAB_POOL_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cstddef>
+#include <vector>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	A pool of fixed size memory blocks allocated in slabs
+@author agent
+@date   2026-10-17
+
+This class hand out memory blocks of one fixed size. Memory is requested
+from the system in slabs holding many blocks. Freed blocks are put on a free
+list and are reused by the next allocation so objects that are created and
+destroyed over and over again, like the objects handling a network
+connection, do not cause allocator churn and fragmentation of the heap.
+
+Slabs are never returned to the system so the memory use of the pool will
+stay at the peak number of blocks used. The pool is not thread safe. Code
+that may run in more than one thread should use one pool per thread, e.g.
+by making the pool thread_local, and free blocks in the thread that
+allocated them.
+
+A common use is to give a class its own operator new and operator delete.
+
+\code
+void *MyClass::operator new(size_t size)
+{
+  assert(size == sizeof(MyClass));
+  return pool().allocate();
+}
+
+void MyClass::operator delete(void *ptr)
+{
+  pool().deallocate(ptr);
+}
+\endcode
+*/
+class SlabPool
+{
+  public:
+    /**
+     * @brief 	Constructor
+     * @param 	block_size The size in bytes of each block
+     * @param 	blocks_per_slab The number of blocks to allocate at a time
+     */
+    SlabPool(size_t block_size, size_t blocks_per_slab);
+
+    /**
+     * @brief 	Destructor
+     *
+     * All slabs are freed so no block may be in use when the pool is
+     * destroyed.
+     */
+    ~SlabPool(void);
+
+    /**
+     * @brief   Allocate a block
+     * @return  Returns a pointer to a block of blockSize() bytes
+     *
+     * A new slab is allocated if there are no free blocks left. The returned
+     * block is suitably aligned for any object type.
+     */
+    void *allocate(void)
+    {
+      if (m_free_list == 0)
+      {
+        addSlab();
+      }
+      FreeBlock *block = m_free_list;
+      m_free_list = block->next;
+      m_blocks_in_use += 1;
+      return block;
+    }
+
+    /**
+     * @brief   Return a block to the pool
+     * @param   ptr A block previously returned by allocate, may be null
+     */
+    void deallocate(void *ptr)
+    {
+      if (ptr == 0)
+      {
+        return;
+      }
+      FreeBlock *block = static_cast<FreeBlock*>(ptr);
+      block->next = m_free_list;
+      m_free_list = block;
+      m_blocks_in_use -= 1;
+    }
+
+    /**
+     * @brief   Get the size of the blocks in this pool
+     * @return  Returns the block size in bytes
+     */
+    size_t blockSize(void) const { return m_block_size; }
+
+    /**
+     * @brief   Get the number of blocks that are currently allocated
+     * @return  Returns the number of blocks in use
+     */
+    size_t blocksInUse(void) const { return m_blocks_in_use; }
+
+    /**
+     * @brief   Get the number of slabs allocated from the system
+     * @return  Returns the number of slabs
+     */
+    size_t slabCount(void) const { return m_slabs.size(); }
+
+  private:
+    struct FreeBlock
+    {
+      FreeBlock *next;
+    };
+
+    const size_t        m_block_size;
+    const size_t        m_blocks_per_slab;
+    std::vector<char*>  m_slabs;
+    FreeBlock*          m_free_list;
+    size_t              m_blocks_in_use;
+
+    SlabPool(const SlabPool&);
+    SlabPool& operator=(const SlabPool&);
+    void addSlab(void);
+    static size_t alignedSize(size_t size);
+
+};  /* class SlabPool */
+
+
+} /* namespace */
+
+#endif /* ASYNC_SLAB_POOL_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -61,6 +61,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "AsyncFdWatch.h"
 #include "AsyncDnsLookup.h"
 #include "AsyncTcpConnection.h"
+#include "AsyncSlabPool.h"
 
 
 
@@ -97,6 +98,9 @@ using namespace Async;
  *
  ****************************************************************************/
 
+static SlabPool& recvBufPool(void);
+static char *allocRecvBuf(size_t len);
+static void freeRecvBuf(char *buf, size_t len);
 
 
 /****************************************************************************
@@ -180,7 +184,7 @@ TcpConnection::TcpConnection(int sock, const IpAddress& remote_addr,
     recv_buf_len(recv_buf_len), sock(sock),
     recv_buf(0), recv_buf_cnt(0)
 {
-  recv_buf = new char[recv_buf_len];
+  recv_buf = allocRecvBuf(recv_buf_len);
   rd_watch.activity.connect(mem_fun(*this, &TcpConnection::recvHandler));
   wr_watch.activity.connect(mem_fun(*this, &TcpConnection::writeHandler));
   setSocket(sock);
@@ -190,7 +194,7 @@ TcpConnection::TcpConnection(int sock, const IpAddress& remote_addr,
 TcpConnection::~TcpConnection(void)
 {
   closeConnection();
-  delete [] recv_buf;
+  freeRecvBuf(recv_buf, recv_buf_len);
   recv_buf = 0;
   recv_buf_cnt = recv_buf_len = 0;
 } /* TcpConnection::~TcpConnection */
@@ -213,13 +217,13 @@ TcpConnection& TcpConnection::operator=(TcpConnection&& other)
 
   wr_watch = std::move(other.wr_watch);
 
-  delete [] recv_buf;
+  freeRecvBuf(recv_buf, recv_buf_len);
   recv_buf_len = other.recv_buf_len;
   recv_buf = other.recv_buf;
   recv_buf_cnt = other.recv_buf_cnt;
 
   other.recv_buf_len = DEFAULT_RECV_BUF_LEN;
-  other.recv_buf = new char[other.recv_buf_len];
+  other.recv_buf = allocRecvBuf(other.recv_buf_len);
   other.recv_buf_cnt = 0;
 
   return *this;
@@ -233,10 +237,10 @@ void TcpConnection::setRecvBufLen(size_t recv_buf_len)
       // This will on next reception cause an overflow error disconnection
     recv_buf_cnt = recv_buf_len;
   }
-  char *new_recv_buf = new char[recv_buf_len];
+  char *new_recv_buf = allocRecvBuf(recv_buf_len);
   memcpy(new_recv_buf, recv_buf, recv_buf_cnt);
+  freeRecvBuf(recv_buf, this->recv_buf_len);
   this->recv_buf_len = recv_buf_len;
-  delete [] recv_buf;
   recv_buf = new_recv_buf;
 } /* TcpConnection::setRecvBufLen */
 
@@ -421,6 +425,49 @@ void TcpConnection::writeHandler(FdWatch *watch)
 
 
 
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+  // Receive buffers of the default size are taken from a pool so that a
+  // server with many clients that come and go does not fragment the heap.
+  // The pool is never destroyed since connections may be deleted during
+  // static destruction. Each thread has its own pool since connections are
+  // only used by the thread that created them.
+static SlabPool& recvBufPool(void)
+{
+  static thread_local SlabPool *pool =
+    new SlabPool(TcpConnection::DEFAULT_RECV_BUF_LEN, 64);
+  return *pool;
+} /* recvBufPool */
+
+
+static char *allocRecvBuf(size_t len)
+{
+  if (len == TcpConnection::DEFAULT_RECV_BUF_LEN)
+  {
+    return static_cast<char*>(recvBufPool().allocate());
+  }
+  return new char[len];
+} /* allocRecvBuf */
+
+
+static void freeRecvBuf(char *buf, size_t len)
+{
+  if (len == TcpConnection::DEFAULT_RECV_BUF_LEN)
+  {
+    recvBufPool().deallocate(buf);
+  }
+  else
+  {
+    delete [] buf;
+  }
+} /* freeRecvBuf */
+
+
+
 /*
  * This file has not been truncated
  */
@@ -0,0 +1,246 @@
+/**
+@file	 AsyncApplicationThread.cpp
+@brief   Run an application event loop in a separate thread
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <pthread.h>
+#include <signal.h>
+
+#include <cassert>
+#include <iostream>
+#include <system_error>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncCppApplication.h"
+#include "AsyncApplicationThread.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+ApplicationThread::ApplicationThread(const std::string& name)
+  : m_name(name)
+{
+} /* ApplicationThread::ApplicationThread */
+
+
+ApplicationThread::~ApplicationThread(void)
+{
+  stop();
+} /* ApplicationThread::~ApplicationThread */
+
+
+bool ApplicationThread::start(void)
+{
+  assert(!m_thread.joinable());
+
+    // Block all signals while starting the thread so that the new thread
+    // inherit a signal mask where all signals are blocked. Signals will then
+    // be delivered to the main thread.
+  sigset_t all_signals;
+  sigset_t old_signals;
+  sigfillset(&all_signals);
+  pthread_sigmask(SIG_SETMASK, &all_signals, &old_signals);
+  try
+  {
+    m_thread = std::thread(&ApplicationThread::threadFunc, this);
+  }
+  catch (const std::system_error& e)
+  {
+    cerr << "*** ERROR: Could not start thread \"" << m_name << "\": "
+         << e.what() << endl;
+  }
+  pthread_sigmask(SIG_SETMASK, &old_signals, NULL);
+  if (!m_thread.joinable())
+  {
+    return false;
+  }
+
+  std::unique_lock<std::mutex> lk(m_mutex);
+  m_cond.wait(lk, [this]{ return m_app != 0; });
+  return true;
+} /* ApplicationThread::start */
+
+
+void ApplicationThread::stop(void)
+{
+  if (!m_thread.joinable())
+  {
+    return;
+  }
+  CppApplication *app = m_app;
+  app->post([app]{ app->quit(); });
+  m_thread.join();
+  m_app = 0;
+} /* ApplicationThread::stop */
+
+
+void ApplicationThread::post(Task task)
+{
+  assert(m_app != 0);
+  m_app->post(std::move(task));
+} /* ApplicationThread::post */
+
+
+void ApplicationThread::call(Task task)
+{
+  assert(m_app != 0);
+  if (m_app->isCurrentThread())
+  {
+    task();
+    return;
+  }
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  bool done = false;
+  m_app->post([&]()
+      {
+        task();
+        std::lock_guard<std::mutex> lk(mutex);
+        done = true;
+        cond.notify_one();
+      });
+  std::unique_lock<std::mutex> lk(mutex);
+  cond.wait(lk, [&]{ return done; });
+} /* ApplicationThread::call */
+
+
+Application& ApplicationThread::app(void)
+{
+  assert(m_app != 0);
+  return *m_app;
+} /* ApplicationThread::app */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void ApplicationThread::threadFunc(void)
+{
+  pthread_setname_np(pthread_self(), m_name.substr(0, 15).c_str());
+
+  CppApplication app(m_name);
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_app = &app;
+  }
+  m_cond.notify_all();
+
+  app.exec();
+} /* ApplicationThread::threadFunc */
+
+
+
+/*
+ * This file has not been truncated
+ */
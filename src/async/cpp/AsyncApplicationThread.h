@@ -0,0 +1,228 @@
+/**
+@file	 AsyncApplicationThread.h
+@brief   Run an application event loop in a separate thread
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_APPLICATION_THREAD_INCLUDED
+#define ASYNC_APPLICATION_THREAD_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncApplication.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+class CppApplication;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	Run an application event loop in a separate thread
+@author agent
+@date   2026-10-17
+
+This class start a thread that create its own CppApplication object and run
+its event loop. Async objects created by the thread, like timers and file
+descriptor watches, are handled by that event loop. Work is handed over to the
+thread using the post and call functions. The typical use is to create an
+object in the thread using call and then to only access the object through
+posted tasks.
+
+UNIX signals are blocked in the thread so that they are always delivered to
+the main thread.
+
+All objects created in the thread must be deleted in the thread, using call,
+before the thread is stopped.
+*/
+class ApplicationThread
+{
+  public:
+    /**
+     * @brief   The type of the tasks to run in the thread
+     */
+    typedef Application::Task Task;
+
+    /**
+     * @brief 	Constructor
+     * @param 	name The name of the thread
+     *
+     * The name is used as the name of the operating system thread, truncated
+     * to 15 characters, and to label the event loop metrics.
+     */
+    explicit ApplicationThread(const std::string& name);
+
+    /**
+     * @brief 	Destructor
+     *
+     * The thread is stopped if it is running.
+     */
+    ~ApplicationThread(void);
+
+    /**
+     * @brief   Get the name of the thread
+     * @return  Returns the name given to the constructor
+     */
+    const std::string& name(void) const { return m_name; }
+
+    /**
+     * @brief   Start the thread
+     * @return  Returns \em true on success or \em false on failure
+     *
+     * The function return when the application object of the thread has been
+     * created so tasks can be posted directly afterwards.
+     */
+    bool start(void);
+
+    /**
+     * @brief   Check if the thread is running
+     * @return  Returns \em true if the thread has been started
+     */
+    bool isRunning(void) const { return m_thread.joinable(); }
+
+    /**
+     * @brief   Stop the thread
+     *
+     * The event loop of the thread is stopped and the thread is joined.
+     * Tasks that have not been run are thrown away.
+     */
+    void stop(void);
+
+    /**
+     * @brief   Run a task in the thread
+     * @param   task The task to run
+     *
+     * This function return directly without waiting for the task to run.
+     */
+    void post(Task task);
+
+    /**
+     * @brief   Run a task in the thread and wait for it to finish
+     * @param   task The task to run
+     *
+     * The calling thread is blocked until the task has been run. If called
+     * from the thread itself, the task is run directly. The task must not
+     * wait for the calling thread since that would cause a deadlock.
+     */
+    void call(Task task);
+
+    /**
+     * @brief   Get the application object of the thread
+     * @return  Returns the application object running in the thread
+     *
+     * This function must only be called while the thread is running.
+     */
+    Application& app(void);
+
+  private:
+    std::string             m_name;
+    std::thread             m_thread;
+    std::mutex              m_mutex;
+    std::condition_variable m_cond;
+    CppApplication*         m_app = 0;
+
+    ApplicationThread(const ApplicationThread&);
+    ApplicationThread& operator=(const ApplicationThread&);
+    void threadFunc(void);
+
+};  /* class ApplicationThread */
+
+
+} /* namespace */
+
+#endif /* ASYNC_APPLICATION_THREAD_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
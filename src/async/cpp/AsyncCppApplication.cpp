@@ -45,6 +45,7 @@
 #include <cerrno>
 #include <cassert>
 #include <algorithm>
+#include <iostream>
 
 
 /****************************************************************************
@@ -64,6 +65,7 @@
 #include "AsyncCppDnsLookupWorker.h"
 #include "AsyncFdWatch.h"
 #include "AsyncTimer.h"
+#include "AsyncMetrics.h"
 #include "AsyncCppApplication.h"
 
 
@@ -106,6 +108,10 @@ using namespace Async;
     }                                                                         \
   } while (0)
 
+# define clock_timerdiff_us(a, b)                                             \
+  (((a)->tv_sec - (b)->tv_sec) * 1000000LL                                    \
+   + ((a)->tv_nsec - (b)->tv_nsec) / 1000)
+
 
 
 
@@ -139,7 +145,8 @@ using namespace Async;
  *
  ****************************************************************************/
 
-int CppApplication::sighandler_pipe[2];
+int CppApplication::sighandler_pipe[2] = {-1, -1};
+std::atomic<CppApplication*> CppApplication::signal_app(0);
 
 
 /****************************************************************************
@@ -166,28 +173,46 @@ CppApplication::CppApplication(void)
 {
   FD_ZERO(&rd_set);
   FD_ZERO(&wr_set);
-  sighandler_pipe[0] = sighandler_pipe[1] = -1;
+  FD_ZERO(&ex_set);
+  CppApplication *no_app = 0;
+  signal_app.compare_exchange_strong(no_app, this);
+  setupPostedTasks();
+} /* CppApplication::CppApplication */
+
+
+CppApplication::CppApplication(const std::string& loop_name)
+  : CppApplication()
+{
+  this->loop_name = loop_name;
 } /* CppApplication::CppApplication */
 
 
 CppApplication::~CppApplication(void)
 {
   clearTasks();
+  CppApplication *this_app = this;
+  signal_app.compare_exchange_strong(this_app, 0);
 } /* CppApplication::~CppApplication */
 
 
 void CppApplication::exec(void)
 {
-  if (pipe(sighandler_pipe) == -1)
+    // Only the first application object handle UNIX signals. Application
+    // objects running in other threads share the signal handlers with it.
+  const bool handle_signals = (signal_app == this);
+  FdWatch watch;
+  if (handle_signals)
   {
-    perror("pipe");
-    exit(1);
+    if (pipe(sighandler_pipe) == -1)
+    {
+      perror("pipe");
+      exit(1);
+    }
+    watch = FdWatch(sighandler_pipe[0], FdWatch::FD_WATCH_RD);
+    watch.activity.connect(
+        hide(mem_fun(*this, &CppApplication::handleUnixSignal)));
   }
 
-  FdWatch watch(sighandler_pipe[0], FdWatch::FD_WATCH_RD);
-  watch.activity.connect(
-      hide(mem_fun(*this, &CppApplication::handleUnixSignal)));
-
   for (UnixSignalMap::const_iterator it = unix_signals.begin();
        it != unix_signals.end();
        ++it)
@@ -203,6 +228,28 @@ void CppApplication::exec(void)
     }
   }
   
+    // Measure how much of the time that is spent handling events, as
+    // opposed to waiting for them, to find out how loaded the loop is
+  MetricsRegistry& metrics = MetricsRegistry::instance();
+  MetricsRegistry::Labels labels;
+  if (!loop_name.empty())
+  {
+    labels.push_back(make_pair("loop", loop_name));
+  }
+  MetricCounter& busy_cnt = metrics.counter(
+      "async_event_loop_busy_seconds_total",
+      "Time spent handling events in the main event loop",
+      labels, 1.0e-6);
+  MetricCounter& wait_cnt = metrics.counter(
+      "async_event_loop_wait_seconds_total",
+      "Time spent waiting for events in the main event loop",
+      labels, 1.0e-6);
+  MetricCounter& wakeup_cnt = metrics.counter(
+      "async_event_loop_wakeups_total",
+      "Number of main event loop iterations", labels);
+  struct timespec busy_start;
+  clock_gettime(CLOCK_MONOTONIC, &busy_start);
+
   while (!do_quit)
   {
     struct timespec *timeout_ptr = 0;
@@ -232,8 +279,15 @@ void CppApplication::exec(void)
     
     fd_set local_rd_set = rd_set;
     fd_set local_wr_set = wr_set;
-    int dcnt = pselect(max_desc, &local_rd_set, &local_wr_set, NULL,
+    fd_set local_ex_set = ex_set;
+    struct timespec wait_start;
+    clock_gettime(CLOCK_MONOTONIC, &wait_start);
+    busy_cnt.inc(clock_timerdiff_us(&wait_start, &busy_start));
+    int dcnt = pselect(max_desc, &local_rd_set, &local_wr_set, &local_ex_set,
 	timeout_ptr, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &busy_start);
+    wait_cnt.inc(clock_timerdiff_us(&busy_start, &wait_start));
+    wakeup_cnt.inc();
     if (dcnt == -1)
     {
       if ((errno == EINTR) || (errno == EAGAIN))
@@ -306,6 +360,27 @@ void CppApplication::exec(void)
       witer = next_witer;
     }
     
+      /* Check for exceptional conditions on the watched file descriptors */
+    witer=ex_watch_map.begin();
+    while ((dcnt > 0) && (witer != ex_watch_map.end()))
+    {
+      next_witer = witer;
+      ++next_witer;
+      if (FD_ISSET(witer->first, &local_ex_set))
+      {
+	if (witer->second != 0)
+	{
+	  witer->second->activity(witer->second);
+	}
+	else
+	{
+	  ex_watch_map.erase(witer);
+	}
+	--dcnt;
+      }
+      witer = next_witer;
+    }
+    
     assert(dcnt == 0);
   }
 
@@ -320,9 +395,13 @@ void CppApplication::exec(void)
     }
   }
 
-  close(sighandler_pipe[1]);
-  close(sighandler_pipe[0]);
-  sighandler_pipe[0] = sighandler_pipe[1] = -1;
+  if (handle_signals)
+  {
+    watch.setEnabled(false);
+    close(sighandler_pipe[1]);
+    close(sighandler_pipe[0]);
+    sighandler_pipe[0] = sighandler_pipe[1] = -1;
+  }
 } /* CppApplication::exec */
 
 
@@ -334,6 +413,13 @@ void CppApplication::quit(void)
 
 void CppApplication::catchUnixSignal(int signum)
 {
+  if (signal_app != this)
+  {
+    cerr << "*** WARNING: UNIX signal " << signum << " can only be caught "
+            "by the first application object" << endl;
+    return;
+  }
+
   UnixSignalMap::iterator it = unix_signals.find(signum);
   if (it != unix_signals.end())
   {
@@ -434,6 +520,11 @@ void CppApplication::addFdWatch(FdWatch *fd_watch)
       FD_SET(fd, &wr_set);
       watch_map = &wr_watch_map;
       break;
+
+    case FdWatch::FD_WATCH_PRI:
+      FD_SET(fd, &ex_set);
+      watch_map = &ex_watch_map;
+      break;
   }
   assert(watch_map != 0);
 
@@ -465,6 +556,11 @@ void CppApplication::delFdWatch(FdWatch *fd_watch)
       FD_CLR(fd, &wr_set);
       watch_map = &wr_watch_map;
       break;
+
+    case FdWatch::FD_WATCH_PRI:
+      FD_CLR(fd, &ex_set);
+      watch_map = &ex_watch_map;
+      break;
   }
   assert(watch_map != 0);
   
@@ -495,6 +591,15 @@ void CppApplication::delFdWatch(FdWatch *fd_watch)
       }
     }
     
+    for (riter = ex_watch_map.rbegin(); riter != ex_watch_map.rend(); ++riter)
+    {
+      if ((riter->second != 0) && (riter->first > max_desc))
+      {
+        max_desc = riter->first;
+        break;
+      }
+    }
+    
     ++max_desc;
   }
 } /* CppApplication::delFdWatch */
@@ -46,6 +46,8 @@
 
 #include <map>
 #include <utility>
+#include <string>
+#include <atomic>
 
 
 /****************************************************************************
@@ -132,6 +134,11 @@ namespace Async
 
 /**
 * @brief An application class for writing non GUI applications.
+*
+* More than one CppApplication object can be created if they are created in
+* different threads, one per thread. UNIX signals can only be caught by the
+* first application object that is created. That is normally the one created
+* by the main thread.
 */
 class CppApplication : public Application
 {
@@ -141,6 +148,15 @@ class CppApplication : public Application
      */
     CppApplication(void);
 
+    /**
+     * @brief Constructor
+     * @param loop_name The name of the event loop
+     *
+     * The name is used to label the event loop metrics so that the load of
+     * the loops in different threads can be told apart.
+     */
+    explicit CppApplication(const std::string& loop_name);
+
     /**
      * @brief Destructor
      */
@@ -149,6 +165,9 @@ class CppApplication : public Application
     /**
      * @brief   Catch the specified UNIX signal
      * @param   signum The signal number to catch
+     *
+     * Only the first application object that was created can catch UNIX
+     * signals.
      */
     void catchUnixSignal(int signum);
 
@@ -200,14 +219,19 @@ class CppApplication : public Application
     typedef std::multimap<struct timespec, Timer *, lttimespec> TimerMap;
     typedef std::map<int, struct sigaction>                     UnixSignalMap;
     
-    static int          sighandler_pipe[2];
+    static int                            sighandler_pipe[2];
+    static std::atomic<CppApplication*>   signal_app;
+
+    std::string         loop_name;
 
     bool      	      	do_quit;
     int       	      	max_desc;
     fd_set    	      	rd_set;
     fd_set    	      	wr_set;
+    fd_set    	      	ex_set;
     WatchMap  	      	rd_watch_map;
     WatchMap  	      	wr_watch_map;
+    WatchMap  	      	ex_watch_map;
     TimerMap  	      	timer_map;
     UnixSignalMap       unix_signals;
     int                 unix_signal_recv;
@@ -0,0 +1,275 @@
+//
+// Latency versus throughput benchmark for the threaded audio codec wrappers.
+//
+// A number of simulated audio streams are run through an encoder/decoder
+// pair each. Every 20ms a block of audio is written to each stream. This is
+// done once with the codecs running inline in the event loop and once with
+// the codecs running in worker threads (AudioEncoderThreaded and
+// AudioDecoderThreaded). For each number of streams the following is
+// printed:
+//
+//   mode      - inline or threaded
+//   streams   - The number of concurrent streams
+//   blk/s     - The number of decoded blocks per second (throughput)
+//   lat_avg   - Average time in ms from write to decoded output
+//   lat_max   - Maximum time in ms from write to decoded output
+//   loop_max  - Maximum event loop timer lateness in ms, i.e. how long
+//               other callbacks could have been delayed
+//
+// Usage: AsyncAudioCodecWorker_demo [codec] [max streams] [seconds/step]
+//
+//   AsyncAudioCodecWorker_demo OPUS 32 2
+//
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+#include <AsyncCppApplication.h>
+#include <AsyncTimer.h>
+#include <AsyncAudioEncoder.h>
+#include <AsyncAudioDecoder.h>
+#include <AsyncAudioEncoderThreaded.h>
+#include <AsyncAudioDecoderThreaded.h>
+
+using namespace std;
+using namespace Async;
+
+typedef std::chrono::steady_clock Clock;
+
+static const int BLOCK_SIZE = INTERNAL_SAMPLE_RATE / 50;   // 20ms
+static const int BLOCK_INTERVAL = 20;                      // ms
+
+
+class Stream : public AudioSink
+{
+  public:
+    Stream(const string& codec, bool threaded)
+      : m_written(0), m_received(0), m_lat_sum(0.0), m_lat_max(0.0),
+        m_blocks(0)
+    {
+      m_enc = AudioEncoder::create(codec);
+      m_dec = AudioDecoder::create(codec);
+      if ((m_enc == 0) || (m_dec == 0))
+      {
+        cerr << "*** ERROR: Codec " << codec << " not available" << endl;
+        exit(1);
+      }
+      if (threaded)
+      {
+        m_enc = new AudioEncoderThreaded(m_enc);
+        m_dec = new AudioDecoderThreaded(m_dec);
+      }
+      m_enc->writeEncodedSamples.connect(
+          sigc::mem_fun(*this, &Stream::onEncoded));
+      m_dec->registerSink(this);
+    }
+
+    ~Stream(void)
+    {
+      m_dec->unregisterSink();
+      delete m_enc;
+      delete m_dec;
+    }
+
+    void writeBlock(const float *samples)
+    {
+      m_written += BLOCK_SIZE;
+      m_pending.push_back(make_pair(m_written, Clock::now()));
+      m_enc->writeSamples(samples, BLOCK_SIZE);
+    }
+
+    virtual int writeSamples(const float *samples, int count)
+    {
+      m_received += count;
+      Clock::time_point now = Clock::now();
+      while (!m_pending.empty() && (m_pending.front().first <= m_received))
+      {
+        double lat = std::chrono::duration<double, std::milli>(
+            now - m_pending.front().second).count();
+        m_lat_sum += lat;
+        m_lat_max = max(m_lat_max, lat);
+        ++m_blocks;
+        m_pending.pop_front();
+      }
+      return count;
+    }
+
+    virtual void flushSamples(void) { sourceAllSamplesFlushed(); }
+
+    unsigned blocks(void) const { return m_blocks; }
+    double latSum(void) const { return m_lat_sum; }
+    double latMax(void) const { return m_lat_max; }
+
+  private:
+    typedef deque<pair<uint64_t, Clock::time_point> > PendingQueue;
+
+    AudioEncoder* m_enc;
+    AudioDecoder* m_dec;
+    PendingQueue  m_pending;
+    uint64_t      m_written;
+    uint64_t      m_received;
+    double        m_lat_sum;
+    double        m_lat_max;
+    unsigned      m_blocks;
+
+    void onEncoded(const void *buf, int size)
+    {
+      m_dec->writeEncodedSamples(const_cast<void*>(buf), size);
+    }
+};
+
+
+class Bench : public sigc::trackable
+{
+  public:
+    Bench(const string& codec, unsigned max_streams, unsigned step_time)
+      : m_codec(codec), m_max_streams(max_streams), m_step_time(step_time),
+        m_threaded(false), m_streams(1), m_ticks(0), m_loop_max(0.0),
+        m_timer(BLOCK_INTERVAL, Timer::TYPE_PERIODIC, false)
+    {
+      m_block.resize(BLOCK_SIZE);
+      for (int i=0; i<BLOCK_SIZE; ++i)
+      {
+        m_block[i] = 0.5f * sin(2.0 * M_PI * 440.0 * i / INTERNAL_SAMPLE_RATE);
+      }
+      m_timer.expired.connect(mem_fun(*this, &Bench::onTick));
+      cout << setw(10) << left << "mode" << right
+           << setw(8) << "streams" << setw(10) << "blk/s"
+           << setw(10) << "lat_avg" << setw(10) << "lat_max"
+           << setw(10) << "loop_max" << endl;
+      startStep();
+    }
+
+    ~Bench(void)
+    {
+      clearStreams();
+    }
+
+  private:
+    string            m_codec;
+    unsigned          m_max_streams;
+    unsigned          m_step_time;
+    bool              m_threaded;
+    unsigned          m_streams;
+    unsigned          m_ticks;
+    double            m_loop_max;
+    Timer             m_timer;
+    vector<Stream*>   m_stream_list;
+    vector<float>     m_block;
+    Clock::time_point m_start;
+
+    void clearStreams(void)
+    {
+      for (auto stream : m_stream_list)
+      {
+        delete stream;
+      }
+      m_stream_list.clear();
+    }
+
+    void startStep(void)
+    {
+      clearStreams();
+      for (unsigned i=0; i<m_streams; ++i)
+      {
+        m_stream_list.push_back(new Stream(m_codec, m_threaded));
+      }
+      m_ticks = 0;
+      m_loop_max = 0.0;
+      m_start = Clock::now();
+      m_timer.setEnable(true);
+    }
+
+    void onTick(Timer *t)
+    {
+      Clock::time_point now = Clock::now();
+      double expected = static_cast<double>(m_ticks) * BLOCK_INTERVAL;
+      double elapsed = std::chrono::duration<double, std::milli>(
+          now - m_start).count();
+      m_loop_max = max(m_loop_max, elapsed - expected - BLOCK_INTERVAL);
+      ++m_ticks;
+
+      for (auto stream : m_stream_list)
+      {
+        stream->writeBlock(&m_block[0]);
+      }
+
+      if (m_ticks * BLOCK_INTERVAL >= m_step_time * 1000)
+      {
+        m_timer.setEnable(false);
+        report(elapsed);
+        if (m_streams < m_max_streams)
+        {
+          m_streams *= 2;
+        }
+        else if (!m_threaded)
+        {
+          m_threaded = true;
+          m_streams = 1;
+        }
+        else
+        {
+          Application::app().quit();
+          return;
+        }
+        startStep();
+      }
+    }
+
+    void report(double elapsed)
+    {
+      unsigned blocks = 0;
+      double lat_sum = 0.0;
+      double lat_max = 0.0;
+      for (auto stream : m_stream_list)
+      {
+        blocks += stream->blocks();
+        lat_sum += stream->latSum();
+        lat_max = max(lat_max, stream->latMax());
+      }
+      cout << setw(10) << left << (m_threaded ? "threaded" : "inline")
+           << right << fixed << setprecision(1)
+           << setw(8) << m_streams
+           << setw(10) << (1000.0 * blocks / elapsed)
+           << setw(10) << (blocks > 0 ? lat_sum / blocks : 0.0)
+           << setw(10) << lat_max
+           << setw(10) << max(m_loop_max, 0.0) << endl;
+    }
+};
+
+
+int main(int argc, const char **argv)
+{
+  string codec("OPUS");
+  unsigned max_streams = 16;
+  unsigned step_time = 2;
+  if (argc > 1)
+  {
+    codec = argv[1];
+  }
+  if (argc > 2)
+  {
+    max_streams = atoi(argv[2]);
+  }
+  if (argc > 3)
+  {
+    step_time = atoi(argv[3]);
+  }
+  if (!AudioEncoder::isAvailable(codec) || !AudioDecoder::isAvailable(codec))
+  {
+    cerr << "*** ERROR: Codec " << codec << " not available" << endl;
+    exit(1);
+  }
+
+  CppApplication app;
+  Bench bench(codec, max_streams, step_time);
+  app.exec();
+
+  return 0;
+}
@@ -0,0 +1,272 @@
+//
+// Benchmark for routing audio between a number of linked logic cores.
+//
+// The audio graph that the SvxLink LinkManager used to build, one
+// AudioSplitter and one AudioSelector per logic and one AudioPassthrough
+// connector for each pair of logics, is compared to the AudioRoutingMatrix.
+// For each number of logics, two link setups are run:
+//
+//   all   - All logics are connected to each other in one link
+//   pairs - The logics are connected two and two
+//
+// In both cases all logics are talking at the same time. One line is printed
+// per run with the following columns:
+//
+//   graph      - "chain" for splitter/selector chains or "matrix"
+//   links      - The link setup, "all" or "pairs"
+//   logics     - The number of logics
+//   objects    - The number of audio graph objects created for the routing
+//   cons       - The number of enabled logic to logic connections
+//   ns/block   - CPU time per written audio block, per talking logic
+//
+// Usage: AsyncAudioRoutingBench [max logics] [blocks]
+//
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <ctime>
+
+#include <AsyncAudioSource.h>
+#include <AsyncAudioSink.h>
+#include <AsyncAudioSplitter.h>
+#include <AsyncAudioSelector.h>
+#include <AsyncAudioPassthrough.h>
+#include <AsyncAudioRoutingMatrix.h>
+
+using namespace std;
+using namespace Async;
+
+
+namespace {
+
+const int BLOCK_SIZE = INTERNAL_SAMPLE_RATE / 50;        // 20ms
+
+class BlockSource : public AudioSource
+{
+  public:
+    void write(const float *samples, int count)
+    {
+      sinkWriteSamples(samples, count);
+    }
+    void flush(void) { sinkFlushSamples(); }
+    virtual void resumeOutput(void) {}
+    virtual void allSamplesFlushed(void) {}
+};
+
+class CountingSink : public AudioSink
+{
+  public:
+    CountingSink(void) : samples(0) {}
+    virtual int writeSamples(const float *buf, int count)
+    {
+      samples += count;
+      return count;
+    }
+    virtual void flushSamples(void) { sourceAllSamplesFlushed(); }
+    unsigned long samples;
+};
+
+double cpuTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+bool isLinked(bool pairs, unsigned src, unsigned sink)
+{
+  return (src != sink) && (!pairs || (src / 2 == sink / 2));
+}
+
+struct Result
+{
+  size_t objects;
+  size_t cons;
+  double ns_per_block;
+};
+
+template <class Graph>
+Result run(unsigned logics, bool pairs, unsigned blocks)
+{
+  vector<BlockSource> sources(logics);
+  vector<CountingSink> sinks(logics);
+  Result result;
+  {
+    Graph graph(sources, sinks, pairs);
+    result.objects = graph.objects();
+    result.cons = graph.connections();
+
+    vector<float> samples(BLOCK_SIZE, 0.1f);
+    const double start = cpuTime();
+    for (unsigned b=0; b<blocks; ++b)
+    {
+      for (unsigned i=0; i<logics; ++i)
+      {
+        sources[i].write(&samples[0], BLOCK_SIZE);
+      }
+    }
+    const double elapsed = cpuTime() - start;
+    result.ns_per_block = 1e9 * elapsed / (blocks * logics);
+
+    for (unsigned i=0; i<logics; ++i)
+    {
+      sources[i].flush();
+    }
+  }
+  return result;
+}
+
+  // The graph that LinkManager used to set up
+class ChainGraph
+{
+  public:
+    ChainGraph(vector<BlockSource>& sources, vector<CountingSink>& sinks,
+               bool pairs)
+      : m_cons(0)
+    {
+      const unsigned logics = sources.size();
+      for (unsigned i=0; i<logics; ++i)
+      {
+        AudioSplitter *splitter = new AudioSplitter;
+        sources[i].registerSink(splitter);
+        m_splitters.push_back(splitter);
+        AudioSelector *selector = new AudioSelector;
+        selector->registerSink(&sinks[i]);
+        m_selectors.push_back(selector);
+      }
+      for (unsigned src=0; src<logics; ++src)
+      {
+        for (unsigned sink=0; sink<logics; ++sink)
+        {
+          AudioPassthrough *connector = new AudioPassthrough;
+          m_splitters[src]->addSink(connector, true);
+          m_selectors[sink]->addSource(connector);
+          if (isLinked(pairs, src, sink))
+          {
+            m_selectors[sink]->enableAutoSelect(connector, 0);
+            ++m_cons;
+          }
+        }
+      }
+    }
+
+    ~ChainGraph(void)
+    {
+      for (size_t i=0; i<m_splitters.size(); ++i)
+      {
+        delete m_splitters[i];
+      }
+      for (size_t i=0; i<m_selectors.size(); ++i)
+      {
+        delete m_selectors[i];
+      }
+    }
+
+    size_t objects(void) const
+    {
+        // Splitters, selectors and connectors plus one splitter branch and
+        // one selector branch per connector
+      const size_t n = m_splitters.size();
+      return 2 * n + 3 * n * n;
+    }
+
+    size_t connections(void) const { return m_cons; }
+
+  private:
+    vector<AudioSplitter*>  m_splitters;
+    vector<AudioSelector*>  m_selectors;
+    size_t                  m_cons;
+};
+
+class MatrixGraph
+{
+  public:
+    MatrixGraph(vector<BlockSource>& sources, vector<CountingSink>& sinks,
+                bool pairs)
+      : m_logics(sources.size())
+    {
+      for (unsigned i=0; i<m_logics; ++i)
+      {
+        m_matrix.addPort(portName(i), &sources[i], &sinks[i]);
+      }
+      for (unsigned src=0; src<m_logics; ++src)
+      {
+        for (unsigned sink=0; sink<m_logics; ++sink)
+        {
+          if (isLinked(pairs, src, sink))
+          {
+            m_matrix.connect(portName(src), portName(sink));
+          }
+        }
+      }
+    }
+
+    size_t objects(void) const
+    {
+        // One input and one output per port plus the connections
+      return 2 * m_logics + m_matrix.connectionCount();
+    }
+
+    size_t connections(void) const { return m_matrix.connectionCount(); }
+
+  private:
+    AudioRoutingMatrix  m_matrix;
+    unsigned            m_logics;
+
+    static string portName(unsigned i)
+    {
+      return string("Logic") + to_string(i);
+    }
+};
+
+void printResult(const char *graph, bool pairs, unsigned logics,
+                 const Result& result)
+{
+  cout << setw(8) << graph << setw(7) << (pairs ? "pairs" : "all")
+       << setw(8) << logics << setw(9) << result.objects
+       << setw(7) << result.cons
+       << setw(11) << fixed << setprecision(0) << result.ns_per_block
+       << endl;
+}
+
+} /* anonymous namespace */
+
+
+int main(int argc, char **argv)
+{
+  unsigned max_logics = 32;
+  unsigned blocks = 2000;
+  if (argc > 1)
+  {
+    max_logics = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    blocks = atoi(argv[2]);
+  }
+  if ((max_logics < 2) || (blocks == 0))
+  {
+    cerr << "Usage: AsyncAudioRoutingBench [max logics] [blocks]" << endl;
+    return 1;
+  }
+
+  cout << setw(8) << "graph" << setw(7) << "links" << setw(8) << "logics"
+       << setw(9) << "objects" << setw(7) << "cons" << setw(11) << "ns/block"
+       << endl;
+  for (int p=0; p<2; ++p)
+  {
+    const bool pairs = (p == 1);
+    for (unsigned logics=2; logics<=max_logics; logics*=2)
+    {
+      printResult("chain", pairs, logics,
+                  run<ChainGraph>(logics, pairs, blocks));
+      printResult("matrix", pairs, logics,
+                  run<MatrixGraph>(logics, pairs, blocks));
+    }
+  }
+
+  return 0;
+}
@@ -143,7 +143,7 @@ using namespace Async;
 QtApplication::QtApplication(int &argc, char **argv)
   : QApplication(argc, argv)
 {
-  
+  setupPostedTasks();
 } /* QtApplication::QtApplication */
 
 
@@ -229,6 +229,14 @@ void QtApplication::addFdWatch(FdWatch *fd_watch)
       QObject::connect(notifier, SIGNAL(activated(int)),
                        this, SLOT(wrFdActivity(int)));
       break;
+
+    case FdWatch::FD_WATCH_PRI:
+      notifier = new QSocketNotifier(fd_watch->fd(),
+                                     QSocketNotifier::Exception);
+      ex_watch_map[fd_watch->fd()] = FdWatchMapItem(fd_watch, notifier);
+      QObject::connect(notifier, SIGNAL(activated(int)),
+                       this, SLOT(exFdActivity(int)));
+      break;
   }  
 } /* QtApplication::addFdWatch */
 
@@ -252,6 +260,13 @@ void QtApplication::delFdWatch(FdWatch *fd_watch)
       delete iter->second.second;
       wr_watch_map.erase(fd_watch->fd());
       break;
+
+    case FdWatch::FD_WATCH_PRI:
+      iter = ex_watch_map.find(fd_watch->fd());
+      assert(iter != ex_watch_map.end());
+      delete iter->second.second;
+      ex_watch_map.erase(fd_watch->fd());
+      break;
   }
   
 
@@ -276,6 +291,15 @@ void QtApplication::wrFdActivity(int socket)
 } /* QtApplication::wrFdActivity */
 
 
+void QtApplication::exFdActivity(int socket)
+{
+  FdWatchMap::iterator iter;
+  iter = ex_watch_map.find(socket);
+  assert(iter != ex_watch_map.end());
+  iter->second.first->activity(iter->second.first);
+} /* QtApplication::exFdActivity */
+
+
 void QtApplication::addTimer(Timer *timer)
 {
   AsyncQtTimer *t = new AsyncQtTimer(timer);
@@ -200,6 +200,7 @@ class QtApplication : public QApplication, public Application
     
     FdWatchMap  rd_watch_map;
     FdWatchMap  wr_watch_map;
+    FdWatchMap  ex_watch_map;
     TimerMap  	timer_map;
     
     void addFdWatch(FdWatch *fd_watch);
@@ -211,6 +212,7 @@ class QtApplication : public QApplication, public Application
   private slots:
     void rdFdActivity(int socket);
     void wrFdActivity(int socket);
+    void exFdActivity(int socket);
     
 };  /* class QtApplication */
 
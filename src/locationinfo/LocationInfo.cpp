@@ -199,6 +199,12 @@ bool LocationInfo::initialize(const Async::Config &cfg, const std::string &cfg_n
 
 void LocationInfo::updateDirectoryStatus(StationData::Status status)
 {
+  if (!app.isCurrentThread())
+  {
+    app.post([=]() { updateDirectoryStatus(status); });
+    return;
+  }
+
   ClientList::const_iterator it;
   for (it = clients.begin(); it != clients.end(); it++)
   {
@@ -210,6 +216,13 @@ void LocationInfo::updateDirectoryStatus(StationData::Status status)
 void LocationInfo::updateQsoStatus(int action, const string& call,
                                    const string& info, list<string>& call_list)
 {
+  if (!app.isCurrentThread())
+  {
+    list<string> calls(call_list);
+    app.post([=]() mutable { updateQsoStatus(action, call, info, calls); });
+    return;
+  }
+
   ClientList::const_iterator it;
   for (it = clients.begin(); it != clients.end(); it++)
   {
@@ -220,6 +233,12 @@ void LocationInfo::updateQsoStatus(int action, const string& call,
 
 void LocationInfo::update3rdState(const string& call, const string& info)
 {
+  if (!app.isCurrentThread())
+  {
+    app.post([=]() { update3rdState(call, info); });
+    return;
+  }
+
   ClientList::const_iterator it;
   for (it = clients.begin(); it != clients.end(); it++)
   {
@@ -230,6 +249,12 @@ void LocationInfo::update3rdState(const string& call, const string& info)
 
 void LocationInfo::igateMessage(const std::string& info)
 {
+  if (!app.isCurrentThread())
+  {
+    app.post([=]() { igateMessage(info); });
+    return;
+  }
+
   ClientList::const_iterator it;
   for (it = clients.begin(); it != clients.end(); it++)
   {
@@ -253,6 +278,12 @@ bool LocationInfo::getTransmitting(const std::string &name)
 void LocationInfo::setTransmitting(const std::string &name, struct timeval tv,
                                      bool state)
 {
+   if (!app.isCurrentThread())
+   {
+      app.post([=]() { setTransmitting(name, tv, state); });
+      return;
+   }
+
    aprs_stats[name].tx_on = state;
    if (state)
    {
@@ -271,6 +302,12 @@ void LocationInfo::setTransmitting(const std::string &name, struct timeval tv,
 void LocationInfo::setReceiving(const std::string &name, struct timeval tv,
                                  bool state)
 {
+   if (!app.isCurrentThread())
+   {
+      app.post([=]() { setReceiving(name, tv, state); });
+      return;
+   }
+
    aprs_stats[name].squelch_on = state;
    if (state)
    {
@@ -285,6 +322,32 @@ void LocationInfo::setReceiving(const std::string &name, struct timeval tv,
    }
 } /* LocationInfo::isReceiving */
 
+
+void LocationInfo::rxSignalLevelUpdated(const std::string &rx_name,
+                                        float siglev)
+{
+  if (!app.isCurrentThread())
+  {
+    app.post([=]() { rxSignalLevelUpdated(rx_name, siglev); });
+    return;
+  }
+
+  rx_telemetry[rx_name].addSignalLevel(siglev);
+} /* LocationInfo::rxSignalLevelUpdated */
+
+
+void LocationInfo::rxSquelchOpen(const std::string &rx_name,
+                                 struct timeval tv, bool is_open)
+{
+  if (!app.isCurrentThread())
+  {
+    app.post([=]() { rxSquelchOpen(rx_name, tv, is_open); });
+    return;
+  }
+
+  rx_telemetry[rx_name].setSquelchOpen(tv, is_open);
+} /* LocationInfo::rxSquelchOpen */
+
 /****************************************************************************
  *
  * Protected member functions
@@ -615,7 +678,7 @@ void LocationInfo::sendAprsStatistics(Timer *t)
 {
   char info[255];
   info[0] ='\0';
-  string head ="UNIT.RX Erlang,TX Erlang,RXcount/10m,TXcount/10m,none1,STxxxxxx,logic";
+  string head ="UNIT.RX Erlang,TX Erlang,RXcount/10m,TXcount/10m,Siglev,STxxxxxx,logic";
 
   sprintf(info, "E%s-%s>RXTLM-1,TCPIP,qAR,%s::E%s-%-6s:%s\n",
        loc_cfg.prefix.c_str(), loc_cfg.mycall.c_str(), loc_cfg.mycall.c_str(),
@@ -680,9 +743,45 @@ void LocationInfo::sendAprsStatistics(Timer *t)
       sequence = 0;
     }
   }
+
+  sendRxTelemetry(tv);
 } /* LocationInfo::sendAprsStatistics */
 
 
+void LocationInfo::sendRxTelemetry(const struct timeval &tv)
+{
+  if (rx_telemetry.empty())
+  {
+    return;
+  }
+
+    // One telemetry line per receiver using the same channels as for the
+    // logics. The squelch duty cycle goes into the RX Erlang channel, the
+    // number of squelch openings into the RX count channel and the median
+    // signal level into the Siglev channel.
+  RxTelemetryMap::iterator it;
+  for (it = rx_telemetry.begin(); it != rx_telemetry.end(); ++it)
+  {
+    const RxTelemetry::Summary &sum = (*it).second.closeWindow(tv);
+
+    char info[255];
+    snprintf(info, sizeof(info),
+     "E%s-%s>RXTLM-1,TCPIP,qAR,%s:T#%03d,%3.2f,0.00,%u,0,%3.1f,%d0000000,%s\n",
+      loc_cfg.prefix.c_str(), loc_cfg.mycall.c_str(), loc_cfg.mycall.c_str(),
+      sequence, sum.duty_cycle, sum.sql_openings, sum.siglev_p50,
+      (sum.sql_open ? 1 : 0), (*it).first.c_str());
+    igateMessage(info);
+
+    if (++sequence > 999)
+    {
+      sequence = 0;
+    }
+  }
+
+  rxTelemetryUpdated();
+} /* LocationInfo::sendRxTelemetry */
+
+
 void LocationInfo::initExtPty(std::string ptydevice)
 {
   AprsPty *aprspty = new AprsPty();
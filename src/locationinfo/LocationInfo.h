@@ -38,7 +38,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <string>
 #include <vector>
 #include <list>
+#include <map>
 #include <sys/time.h>
+#include <sigc++/sigc++.h>
 
 
 /****************************************************************************
@@ -48,6 +50,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <AsyncConfig.h>
+#include <AsyncApplication.h>
 #include <EchoLinkStationData.h>
 
 
@@ -58,6 +61,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include "AprsPty.h"
+#include "RxTelemetry.h"
 
 
 /****************************************************************************
@@ -196,6 +200,10 @@ class LocationInfo
 
     static bool initialize(const Async::Config &cfg, const std::string &cfg_name);
 
+      // The functions below may be called from logic cores running in other
+      // threads. The calls are then passed on to the thread that initialized
+      // the LocationInfo object.
+
     void updateDirectoryStatus(EchoLink::StationData::Status new_status);
     void igateMessage(const std::string& info);
     void update3rdState(const std::string& call, const std::string& info);
@@ -206,19 +214,55 @@ class LocationInfo
     void setTransmitting(const std::string &name, struct timeval tv, bool state);
     void setReceiving(const std::string &name, struct timeval tv, bool state);
 
+    typedef std::map<std::string, RxTelemetry> RxTelemetryMap;
+
+    /**
+     * @brief   Feed a signal level update for a receiver
+     * @param   rx_name The name of the receiver
+     * @param   siglev The signal level
+     */
+    void rxSignalLevelUpdated(const std::string &rx_name, float siglev);
+
+    /**
+     * @brief   Feed a squelch state change for a receiver
+     * @param   rx_name The name of the receiver
+     * @param   tv The time of the squelch state change
+     * @param   is_open \em true if the squelch is open
+     */
+    void rxSquelchOpen(const std::string &rx_name, struct timeval tv,
+                       bool is_open);
+
+    /**
+     * @brief   Get the telemetry aggregators for all receivers
+     * @return  Returns a map from receiver name to aggregator
+     */
+    const RxTelemetryMap& rxTelemetry(void) const { return rx_telemetry; }
+
+    /**
+     * @brief   A signal that is emitted when a telemetry window is closed
+     *
+     * The summaries of the closed window is available through the
+     * lastSummary function of each aggregator returned by rxTelemetry.
+     */
+    sigc::signal<void> rxTelemetryUpdated;
+
   private:
     static LocationInfo* _instance;
-    LocationInfo() : sequence(0), aprs_stats_timer(0), sinterval(0) {}
+    LocationInfo()
+      : app(Async::Application::app()), sequence(0), aprs_stats_timer(0),
+        sinterval(0) {}
     LocationInfo(const LocationInfo&);
     ~LocationInfo(void) { delete aprs_stats_timer; };
 
     typedef std::list<AprsClient*> ClientList;
 
+    Async::Application& app;
     Cfg         loc_cfg; // weshalb?
     ClientList  clients;
     int         sequence;
     Async::Timer *aprs_stats_timer;
     unsigned int sinterval;
+    RxTelemetryMap rx_telemetry;
 
     bool parsePosition(const Async::Config &cfg, const std::string &name);
     bool parseLatitude(Coordinate &pos, const std::string &value);
@@ -232,6 +276,7 @@ class LocationInfo
     bool parseClients(const Async::Config &cfg, const std::string &name);
     void startStatisticsTimer(int interval);
     void sendAprsStatistics(Async::Timer *t);
+    void sendRxTelemetry(const struct timeval &tv);
     void initExtPty(std::string ptydevice);
     void mesReceived(std::string message);
 
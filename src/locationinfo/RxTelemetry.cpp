@@ -0,0 +1,276 @@
+/**
+@file	 RxTelemetry.cpp
+@brief   Streaming signal level and squelch statistics for a receiver
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "RxTelemetry.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+static double timeDiff(const struct timeval &end, const struct timeval &start);
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+RxTelemetry::RxTelemetry(void)
+  : m_sql_open(false)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  m_sql_open_tv = tv;
+  resetWindow(tv);
+} /* RxTelemetry::RxTelemetry */
+
+
+void RxTelemetry::addSignalLevel(float siglev)
+{
+  if (m_samples == 0)
+  {
+    m_siglev_min = m_siglev_max = siglev;
+  }
+  else
+  {
+    m_siglev_min = min(m_siglev_min, siglev);
+    m_siglev_max = max(m_siglev_max, siglev);
+  }
+  ++m_samples;
+  m_siglev_sum += siglev;
+
+  const float bin = roundf(siglev);
+  unsigned idx = 0;
+  if (bin >= SIGLEV_BINS - 1)
+  {
+    idx = SIGLEV_BINS - 1;
+  }
+  else if (bin > 0.0f)
+  {
+    idx = static_cast<unsigned>(bin);
+  }
+  ++m_hist[idx];
+} /* RxTelemetry::addSignalLevel */
+
+
+void RxTelemetry::setSquelchOpen(const struct timeval &tv, bool is_open)
+{
+  if (is_open == m_sql_open)
+  {
+    return;
+  }
+  m_sql_open = is_open;
+  if (is_open)
+  {
+    ++m_sql_openings;
+    m_sql_open_tv = tv;
+  }
+  else
+  {
+    m_sql_open_sec += timeDiff(tv, m_sql_open_tv);
+  }
+} /* RxTelemetry::setSquelchOpen */
+
+
+void RxTelemetry::summarize(const struct timeval &tv, Summary &summary) const
+{
+  summary = Summary();
+  summary.window_sec = timeDiff(tv, m_window_start);
+  summary.samples = m_samples;
+  if (m_samples > 0)
+  {
+    summary.siglev_min = m_siglev_min;
+    summary.siglev_mean = m_siglev_sum / m_samples;
+    summary.siglev_p10 = percentile(0.1f);
+    summary.siglev_p50 = percentile(0.5f);
+    summary.siglev_p90 = percentile(0.9f);
+    summary.siglev_max = m_siglev_max;
+  }
+  summary.sql_openings = m_sql_openings;
+  summary.sql_open_sec = m_sql_open_sec;
+  if (m_sql_open)
+  {
+    summary.sql_open_sec += timeDiff(tv, m_sql_open_tv);
+  }
+  if (summary.window_sec > 0.0f)
+  {
+    summary.duty_cycle = min(1.0f, summary.sql_open_sec / summary.window_sec);
+  }
+  summary.sql_open = m_sql_open;
+} /* RxTelemetry::summarize */
+
+
+const RxTelemetry::Summary& RxTelemetry::closeWindow(const struct timeval &tv)
+{
+  summarize(tv, m_last);
+  resetWindow(tv);
+
+    // An open squelch is counted as an opening in the new window too
+  if (m_sql_open)
+  {
+    m_sql_openings = 1;
+    m_sql_open_tv = tv;
+  }
+  return m_last;
+} /* RxTelemetry::closeWindow */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+float RxTelemetry::percentile(float p) const
+{
+  const double rank = p * m_samples;
+  unsigned long cnt = 0;
+  for (unsigned i=0; i<SIGLEV_BINS; ++i)
+  {
+    cnt += m_hist[i];
+    if ((cnt > 0) && (cnt >= rank))
+    {
+        // The outer bins also hold the levels out of range so use the
+        // exact extreme values for them
+      return min(max(static_cast<float>(i), m_siglev_min), m_siglev_max);
+    }
+  }
+  return m_siglev_max;
+} /* RxTelemetry::percentile */
+
+
+void RxTelemetry::resetWindow(const struct timeval &tv)
+{
+  memset(m_hist, 0, sizeof(m_hist));
+  m_samples = 0;
+  m_siglev_sum = 0.0;
+  m_siglev_min = 0.0f;
+  m_siglev_max = 0.0f;
+  m_sql_openings = 0;
+  m_sql_open_sec = 0.0;
+  m_window_start = tv;
+} /* RxTelemetry::resetWindow */
+
+
+
+/****************************************************************************
+ *
+ * Private local functions
+ *
+ ****************************************************************************/
+
+static double timeDiff(const struct timeval &end, const struct timeval &start)
+{
+  return (end.tv_sec - start.tv_sec) +
+         (end.tv_usec - start.tv_usec) / 1000000.0;
+} /* timeDiff */
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,211 @@
+/**
+@file	 RxTelemetry.h
+@brief   Streaming signal level and squelch statistics for a receiver
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+#ifndef RX_TELEMETRY_INCLUDED
+#define RX_TELEMETRY_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sys/time.h>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	Streaming signal level and squelch statistics for a receiver
+@author agent
+@date   2026-10-17
+
+Signal level updates and squelch changes for one receiver are aggregated
+over a time window. Signal levels are counted in a histogram with one bin
+per signal level unit in the range 0 to 100, so the memory use is constant no
+matter how many samples that are added and percentiles are exact to within
+one unit. Levels outside of the range are counted in the first or last bin.
+
+When a window is closed, a summary of it is saved and a new window is
+started. The squelch state is carried over to the new window.
+*/
+class RxTelemetry
+{
+  public:
+    static const unsigned SIGLEV_BINS = 101;
+
+    /**
+     * @brief A summary of the statistics for a time window
+     */
+    struct Summary
+    {
+      float         window_sec;     ///< The length of the window in seconds
+      unsigned long samples;        ///< The number of signal level samples
+      float         siglev_min;     ///< The lowest signal level
+      float         siglev_mean;    ///< The mean signal level
+      float         siglev_p10;     ///< The 10th signal level percentile
+      float         siglev_p50;     ///< The median signal level
+      float         siglev_p90;     ///< The 90th signal level percentile
+      float         siglev_max;     ///< The highest signal level
+      unsigned      sql_openings;   ///< The number of squelch openings
+      float         sql_open_sec;   ///< The time the squelch was open
+      float         duty_cycle;     ///< Squelch open time / window length
+      bool          sql_open;       ///< The squelch state at the window end
+
+      Summary(void)
+        : window_sec(0.0f), samples(0), siglev_min(0.0f), siglev_mean(0.0f),
+          siglev_p10(0.0f), siglev_p50(0.0f), siglev_p90(0.0f),
+          siglev_max(0.0f), sql_openings(0), sql_open_sec(0.0f),
+          duty_cycle(0.0f), sql_open(false) {}
+    };
+
+    /**
+     * @brief 	Default constuctor
+     *
+     * The first window is started at the current time.
+     */
+    RxTelemetry(void);
+
+    /**
+     * @brief 	Add a signal level sample
+     * @param 	siglev The signal level
+     */
+    void addSignalLevel(float siglev);
+
+    /**
+     * @brief 	Update the squelch state
+     * @param 	tv The time of the squelch state change
+     * @param 	is_open \em true if the squelch is open
+     */
+    void setSquelchOpen(const struct timeval &tv, bool is_open);
+
+    /**
+     * @brief 	Get a summary of the current window
+     * @param 	tv The time to summarize the window up to
+     * @param 	summary The summary is returned in this argument
+     */
+    void summarize(const struct timeval &tv, Summary &summary) const;
+
+    /**
+     * @brief 	Close the current window and start a new one
+     * @param 	tv The time of the window change
+     * @return	Returns the summary of the closed window
+     */
+    const Summary& closeWindow(const struct timeval &tv);
+
+    /**
+     * @brief 	Get the summary of the last closed window
+     * @return	Returns the summary saved by the last call to closeWindow
+     */
+    const Summary& lastSummary(void) const { return m_last; }
+
+  private:
+    unsigned        m_hist[SIGLEV_BINS];
+    unsigned long   m_samples;
+    double          m_siglev_sum;
+    float           m_siglev_min;
+    float           m_siglev_max;
+    unsigned        m_sql_openings;
+    double          m_sql_open_sec;
+    bool            m_sql_open;
+    struct timeval  m_sql_open_tv;
+    struct timeval  m_window_start;
+    Summary         m_last;
+
+    float percentile(float p) const;
+    void resetWindow(const struct timeval &tv);
+
+};  /* class RxTelemetry */
+
+
+#endif /* RX_TELEMETRY_INCLUDED */
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,631 @@
+//
+// Soak benchmark for svxserver with a number of simulated clients.
+//
+// The server is run in a child process so that its CPU usage can be measured
+// separately from the simulated clients. The clients are real TCP
+// connections to the server, running in the parent process. They are
+// connected a few at a time, since the server uses a short listen backlog,
+// authenticate, send a heartbeat every five seconds and take turns talking.
+// The talking client sends one audio frame every 20ms and a flush at the end
+// of each talk period, which makes the server pick a new master. The talking
+// client sends S16 audio.
+//
+// At the start of each talk period a stalled client is also connected. It
+// asks for RAW audio, which makes the server transcode into a relay group of
+// its own, and then never reads from its socket. The server disconnects it
+// when the TCP send buffer overflows, in the middle of relaying audio, which
+// deletes the relay group and its encoder. At the start of the next talk
+// period the stalled client drains its socket to see if it was dropped. If
+// the server process dies, the benchmark is stopped with an error.
+//
+// Every second the following is printed:
+//
+//   time     - Seconds since the start
+//   ready    - Number of authenticated clients
+//   sent/s   - Audio frames sent to the server per second
+//   recv/s   - Audio frames received from the server per second, all clients
+//   cpu_ms/s - Server CPU time in milliseconds per second
+//   us/frame - Server CPU time in microseconds per sent audio frame
+//   rss_MB   - Server resident set size in megabytes
+//   stalled  - Number of stalled clients dropped by the server so far
+//
+// When done, the steady state averages, measured after all clients have
+// been connected and one talk period has passed, are printed.
+//
+// Usage: SvxServerSoakBench [clients] [seconds] [talk period ms]
+//                           [listen port]
+//
+
+#include <unistd.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <AsyncCppApplication.h>
+#include <AsyncConfig.h>
+#include <AsyncTimer.h>
+#include <AsyncTcpClient.h>
+
+#include "NetTrxMsg.h"
+#include "server.h"
+
+using namespace std;
+using namespace Async;
+using namespace NetTrxMsg;
+
+
+static const char *AUTH_KEY = "SoakBenchKey";
+static const unsigned FRAME_INTERVAL = 20;
+static const unsigned FRAME_SIZE = 320;
+static const unsigned HEARTBEAT_INTERVAL = 5000;
+static const unsigned CONNECT_BATCH = 2;
+static const int STALLED_RCVBUF = 4096;
+static const int SERVER_SNDBUF = 8192;
+static const unsigned STALLED_DRAIN_FRAMES = 50;
+
+
+static bool readProcStat(pid_t pid, double &cpu_s, double &rss_mb)
+{
+  ostringstream path;
+  path << "/proc/" << pid << "/stat";
+  ifstream stat(path.str().c_str());
+  string line;
+  if (!getline(stat, line))
+  {
+    return false;
+  }
+
+    // Skip past the command name, which may contain spaces
+  istringstream ss(line.substr(line.rfind(')') + 2));
+  string field;
+  unsigned long utime = 0;
+  unsigned long stime = 0;
+  long rss = 0;
+  for (int i=3; i<=24; ++i)
+  {
+    if (i == 14)
+    {
+      ss >> utime;
+    }
+    else if (i == 15)
+    {
+      ss >> stime;
+    }
+    else if (i == 24)
+    {
+      ss >> rss;
+    }
+    else
+    {
+      ss >> field;
+    }
+  }
+  cpu_s = static_cast<double>(utime + stime) / sysconf(_SC_CLK_TCK);
+  rss_mb = rss * sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+  return true;
+}
+
+
+  // Set a fixed send buffer size on all listening sockets. The size is
+  // inherited by the accepted client sockets, which turns off send buffer
+  // auto tuning so that a stalled client overflows the buffer within
+  // seconds.
+static void limitSendBuffers(void)
+{
+  for (int fd=0; fd<getdtablesize(); ++fd)
+  {
+    int listening = 0;
+    socklen_t len = sizeof(listening);
+    if ((getsockopt(fd, SOL_SOCKET, SO_ACCEPTCONN, &listening, &len) == 0) &&
+        listening)
+    {
+      int sndbuf = SERVER_SNDBUF;
+      setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+    }
+  }
+}
+
+
+class SimClient : public sigc::trackable
+{
+  public:
+    SimClient(const string &host, uint16_t port)
+      : ready(false), audio_recv(0), m_con(host, port, 16384), m_recv_cnt(0)
+    {
+      m_con.dataReceived.connect(mem_fun(*this, &SimClient::onDataReceived));
+      m_con.connect();
+    }
+
+    void send(const Msg &msg)
+    {
+      if (ready && m_con.isConnected())
+      {
+        m_con.write(&msg, msg.size());
+      }
+    }
+
+    bool              ready;
+    unsigned long     audio_recv;
+
+  private:
+    TcpClient<>       m_con;
+    char              m_recv_buf[sizeof(MsgAudio)];
+    unsigned          m_recv_cnt;
+
+    int onDataReceived(TcpConnection *con, void *data, int size)
+    {
+      int orig_size = size;
+      char *buf = static_cast<char*>(data);
+      while (size > 0)
+      {
+        unsigned exp = sizeof(Msg);
+        if (m_recv_cnt >= sizeof(Msg))
+        {
+          exp = reinterpret_cast<Msg*>(m_recv_buf)->size();
+        }
+        unsigned cnt = min(static_cast<unsigned>(size), exp - m_recv_cnt);
+        memcpy(m_recv_buf + m_recv_cnt, buf, cnt);
+        m_recv_cnt += cnt;
+        buf += cnt;
+        size -= cnt;
+        const Msg *msg = reinterpret_cast<Msg*>(m_recv_buf);
+        if ((m_recv_cnt >= sizeof(Msg)) && (m_recv_cnt == msg->size()))
+        {
+          handleMsg(msg);
+          m_recv_cnt = 0;
+        }
+      }
+      return orig_size;
+    }
+
+    void handleMsg(const Msg *msg)
+    {
+      switch (msg->type())
+      {
+        case MsgAuthChallenge::TYPE:
+        {
+          const MsgAuthChallenge *challenge_msg =
+            reinterpret_cast<const MsgAuthChallenge*>(msg);
+          MsgAuthResponse resp(AUTH_KEY, challenge_msg->challenge());
+          m_con.write(&resp, resp.size());
+          break;
+        }
+        case MsgAuthOk::TYPE:
+        {
+          MsgTxAudioCodecSelect codec_msg("S16");
+          m_con.write(&codec_msg, codec_msg.size());
+          ready = true;
+          break;
+        }
+        case MsgAudio::TYPE:
+          ++audio_recv;
+          break;
+        default:
+          break;
+      }
+    }
+};
+
+
+class StalledClient
+{
+  public:
+    StalledClient(void) : drain_frames(0), m_sock(-1) {}
+
+    ~StalledClient(void)
+    {
+      if (m_sock >= 0)
+      {
+        close(m_sock);
+      }
+    }
+
+    bool connect(uint16_t port, unsigned id)
+    {
+      m_sock = socket(AF_INET, SOCK_STREAM, 0);
+      if (m_sock < 0)
+      {
+        return false;
+      }
+
+        // Keep the receive buffer small so that the server send buffer
+        // overflows quickly
+      int rcvbuf = STALLED_RCVBUF;
+      setsockopt(m_sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+      struct timeval tv = { 2, 0 };
+      setsockopt(m_sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+      struct sockaddr_in addr;
+      memset(&addr, 0, sizeof(addr));
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons(port);
+      addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      if (::connect(m_sock, reinterpret_cast<struct sockaddr *>(&addr),
+                    sizeof(addr)) < 0)
+      {
+        return false;
+      }
+
+        // Authenticate and select a codec of our own so that the server
+        // creates a relay group, with an encoder, just for this client
+      char buf[sizeof(MsgAudio)];
+      const Msg *msg = reinterpret_cast<Msg*>(buf);
+      do
+      {
+        if (!recvAll(buf, sizeof(Msg)) || (msg->size() > sizeof(buf)) ||
+            (msg->size() < sizeof(Msg)) ||
+            !recvAll(buf + sizeof(Msg), msg->size() - sizeof(Msg)))
+        {
+          return false;
+        }
+      } while (msg->type() != MsgAuthChallenge::TYPE);
+      const MsgAuthChallenge *challenge_msg =
+        reinterpret_cast<const MsgAuthChallenge*>(msg);
+      MsgAuthResponse resp(AUTH_KEY, challenge_msg->challenge());
+      MsgRxAudioCodecSelect codec_msg("RAW");
+      ostringstream ss;
+      ss << id;
+      codec_msg.addOption("STALL_ID", ss.str());
+      return send(resp) && send(codec_msg);
+    }
+
+    bool send(const Msg &msg)
+    {
+      return ::send(m_sock, &msg, msg.size(), MSG_DONTWAIT | MSG_NOSIGNAL) ==
+             static_cast<ssize_t>(msg.size());
+    }
+
+      // Read everything that is buffered. Returns true if the server has
+      // closed the connection.
+    bool drain(void)
+    {
+      char buf[4096];
+      for (;;)
+      {
+        ssize_t ret = recv(m_sock, buf, sizeof(buf), MSG_DONTWAIT);
+        if (ret > 0)
+        {
+          continue;
+        }
+        return (ret == 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK));
+      }
+    }
+
+    unsigned  drain_frames;
+
+  private:
+    int       m_sock;
+
+    bool recvAll(char *buf, size_t len)
+    {
+      while (len > 0)
+      {
+        ssize_t ret = recv(m_sock, buf, len, 0);
+        if (ret <= 0)
+        {
+          return false;
+        }
+        buf += ret;
+        len -= ret;
+      }
+      return true;
+    }
+};
+
+
+class Bench : public sigc::trackable
+{
+  public:
+    Bench(pid_t server_pid, uint16_t port, unsigned clients,
+          unsigned seconds, unsigned talk_period)
+      : m_server_pid(server_pid), m_port(port), m_client_cnt(clients),
+        m_seconds(seconds),
+        m_talk_frames(talk_period / FRAME_INTERVAL), m_talker(0),
+        m_frame_cnt(0), m_sent(0), m_heartbeat_cnt(0),
+        m_frame_timer(FRAME_INTERVAL, Timer::TYPE_PERIODIC),
+        m_tick_timer(1000, Timer::TYPE_PERIODIC), m_time(0), m_last_sent(0),
+        m_last_recv(0), m_last_cpu(0.0), m_steady_time(0), m_steady_sent(0),
+        m_steady_recv(0), m_steady_cpu(0.0), m_stalled(0), m_stalled_cnt(0),
+        m_stalled_drops(0), m_server_died(false)
+    {
+      vector<char> audio(FRAME_SIZE, 0);
+      m_audio_msg = new MsgAudio(&audio[0], audio.size());
+      m_frame_timer.expired.connect(mem_fun(*this, &Bench::onFrame));
+      m_tick_timer.expired.connect(mem_fun(*this, &Bench::onTick));
+      double rss;
+      readProcStat(m_server_pid, m_last_cpu, rss);
+
+      const unsigned connect_time =
+        clients / CONNECT_BATCH * FRAME_INTERVAL / 1000;
+      m_steady_time = connect_time + talk_period / 1000 + 1;
+      if (m_steady_time >= m_seconds)
+      {
+        m_steady_time = 0;
+      }
+
+      cout << setw(6) << "time" << setw(8) << "ready" << setw(9) << "sent/s"
+           << setw(10) << "recv/s" << setw(10) << "cpu_ms/s" << setw(10)
+           << "us/frame" << setw(9) << "rss_MB" << setw(9) << "stalled"
+           << endl;
+    }
+
+    ~Bench(void)
+    {
+      for (size_t i=0; i<m_clients.size(); ++i)
+      {
+        delete m_clients[i];
+      }
+      delete m_stalled;
+      for (size_t i=0; i<m_draining.size(); ++i)
+      {
+        delete m_draining[i];
+      }
+      delete m_audio_msg;
+    }
+
+    bool serverDied(void) const { return m_server_died; }
+
+  private:
+    pid_t               m_server_pid;
+    uint16_t            m_port;
+    unsigned            m_client_cnt;
+    vector<SimClient*>  m_clients;
+    MsgAudio*           m_audio_msg;
+    unsigned            m_seconds;
+    unsigned            m_talk_frames;
+    unsigned            m_talker;
+    unsigned            m_frame_cnt;
+    unsigned long       m_sent;
+    unsigned            m_heartbeat_cnt;
+    Timer               m_frame_timer;
+    Timer               m_tick_timer;
+    unsigned            m_time;
+    unsigned long       m_last_sent;
+    unsigned long       m_last_recv;
+    double              m_last_cpu;
+    unsigned            m_steady_time;
+    unsigned long       m_steady_sent;
+    unsigned long       m_steady_recv;
+    double              m_steady_cpu;
+    StalledClient*      m_stalled;
+    vector<StalledClient*> m_draining;
+    unsigned            m_stalled_cnt;
+    unsigned            m_stalled_drops;
+    bool                m_server_died;
+
+    unsigned long audioReceived(void) const
+    {
+      unsigned long recv = 0;
+      for (size_t i=0; i<m_clients.size(); ++i)
+      {
+        recv += m_clients[i]->audio_recv;
+      }
+      return recv;
+    }
+
+    void onFrame(Timer *t)
+    {
+      for (unsigned i=0; (i<CONNECT_BATCH) && (m_clients.size()<m_client_cnt);
+           ++i)
+      {
+        m_clients.push_back(new SimClient("127.0.0.1", m_port));
+      }
+
+      SimClient *talker = 0;
+      if (m_talker < m_clients.size())
+      {
+        talker = m_clients[m_talker];
+      }
+      if ((talker != 0) && talker->ready)
+      {
+        talker->send(*m_audio_msg);
+        ++m_sent;
+        if (++m_frame_cnt >= m_talk_frames)
+        {
+          talker->send(MsgFlush());
+          m_frame_cnt = 0;
+          m_talker = (m_talker + 1) % m_client_cnt;
+          newStalledClient();
+        }
+      }
+
+      for (size_t i=0; i<m_draining.size(); )
+      {
+        StalledClient *stalled = m_draining[i];
+        const bool dropped = stalled->drain();
+        if (dropped || (++stalled->drain_frames >= STALLED_DRAIN_FRAMES))
+        {
+          m_stalled_drops += dropped ? 1 : 0;
+          delete stalled;
+          m_draining.erase(m_draining.begin() + i);
+        }
+        else
+        {
+          ++i;
+        }
+      }
+
+      m_heartbeat_cnt += FRAME_INTERVAL;
+      if (m_heartbeat_cnt >= HEARTBEAT_INTERVAL)
+      {
+        m_heartbeat_cnt = 0;
+        for (size_t i=0; i<m_clients.size(); ++i)
+        {
+          m_clients[i]->send(MsgHeartbeat());
+        }
+        if (m_stalled != 0)
+        {
+          m_stalled->send(MsgHeartbeat());
+        }
+      }
+    }
+
+    void newStalledClient(void)
+    {
+      if (m_stalled != 0)
+      {
+        m_draining.push_back(m_stalled);
+      }
+      m_stalled = new StalledClient;
+      if (!m_stalled->connect(m_port, ++m_stalled_cnt))
+      {
+        cerr << "*** ERROR: Could not connect a stalled client" << endl;
+        delete m_stalled;
+        m_stalled = 0;
+      }
+    }
+
+    void onTick(Timer *t)
+    {
+      if (waitpid(m_server_pid, 0, WNOHANG) == m_server_pid)
+      {
+        cerr << "*** ERROR: The server died after " << m_time << " s" << endl;
+        m_server_died = true;
+        Application::app().quit();
+        return;
+      }
+
+      ++m_time;
+      double cpu = 0.0;
+      double rss = 0.0;
+      readProcStat(m_server_pid, cpu, rss);
+      unsigned ready = 0;
+      for (size_t i=0; i<m_clients.size(); ++i)
+      {
+        ready += m_clients[i]->ready ? 1 : 0;
+      }
+      const unsigned long recv = audioReceived();
+      const unsigned long sent = m_sent - m_last_sent;
+      const double cpu_ms = 1000.0 * (cpu - m_last_cpu);
+      cout << fixed << setw(6) << m_time << setw(8) << ready
+           << setw(9) << sent << setw(10) << (recv - m_last_recv)
+           << setw(10) << setprecision(0) << cpu_ms
+           << setw(10) << setprecision(1)
+           << (sent > 0 ? 1000.0 * cpu_ms / sent : 0.0)
+           << setw(9) << rss << setw(9) << m_stalled_drops << endl;
+      m_last_sent = m_sent;
+      m_last_recv = recv;
+      m_last_cpu = cpu;
+
+      if (m_time == m_steady_time)
+      {
+        m_steady_sent = m_sent;
+        m_steady_recv = recv;
+        m_steady_cpu = cpu;
+      }
+
+      if (m_time >= m_seconds)
+      {
+        const double secs = m_time - m_steady_time;
+        const unsigned long steady_sent = m_sent - m_steady_sent;
+        const double steady_cpu = cpu - m_steady_cpu;
+        cout << endl << "clients:            " << m_client_cnt << endl
+             << "steady state from:  " << m_steady_time << " s" << endl
+             << "frames sent/s:      " << setprecision(1)
+             << (steady_sent / secs) << endl
+             << "frames recv/s:      " << ((recv - m_steady_recv) / secs)
+             << endl
+             << "ready clients:      " << ready << endl
+             << "server cpu:         " << (100.0 * steady_cpu / secs)
+             << " %" << endl
+             << "server us/frame:    "
+             << (steady_sent > 0 ? 1e6 * steady_cpu / steady_sent : 0.0)
+             << endl
+             << "server rss:         " << rss << " MB" << endl
+             << "stalled dropped:    " << m_stalled_drops << " of "
+             << m_stalled_cnt << endl;
+        Application::app().quit();
+      }
+    }
+};
+
+
+int main(int argc, const char **argv)
+{
+  unsigned clients = 200;
+  unsigned seconds = 30;
+  unsigned talk_period = 5000;
+  string listen_port = "15210";
+  if (argc > 1)
+  {
+    clients = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    seconds = atoi(argv[2]);
+  }
+  if (argc > 3)
+  {
+    talk_period = atoi(argv[3]);
+  }
+  if (argc > 4)
+  {
+    listen_port = argv[4];
+  }
+  if ((clients < 2) || (seconds == 0) || (talk_period < FRAME_INTERVAL))
+  {
+    cerr << "Usage: SvxServerSoakBench [clients] [seconds] "
+            "[talk period ms] [listen port]" << endl;
+    return 1;
+  }
+
+  pid_t server_pid = fork();
+  if (server_pid < 0)
+  {
+    cerr << "*** ERROR: fork failed: " << strerror(errno) << endl;
+    return 1;
+  }
+
+  if (server_pid == 0)
+  {
+      // Silence the server log messages
+    ofstream null_stream;
+    cout.rdbuf(null_stream.rdbuf());
+
+    CppApplication app;
+    Config cfg;
+    cfg.setValue("GLOBAL", "LISTEN_PORT", listen_port);
+    cfg.setValue("GLOBAL", "AUTH_KEY", AUTH_KEY);
+    cfg.setValue("GLOBAL", "SQL_TIMEOUT", "3600");
+    cfg.setValue("GLOBAL", "SQL_RESET_TIMEOUT", "3600");
+    SvxServer server(cfg);
+    limitSendBuffers();
+    app.exec();
+    return 0;
+  }
+
+    // Give the server some time to start listening
+  usleep(200000);
+
+  bool server_died = false;
+  {
+    CppApplication app;
+    Bench bench(server_pid, atoi(listen_port.c_str()), clients, seconds,
+                talk_period);
+    app.exec();
+    server_died = bench.serverDied();
+  }
+
+  if (server_died)
+  {
+    return 1;
+  }
+
+  kill(server_pid, SIGTERM);
+  waitpid(server_pid, 0, 0);
+
+  return 0;
+}
@@ -42,6 +42,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <cstring>
 #include <cstdlib>
 #include <map>
+#include <vector>
+#include <algorithm>
 
 
 /****************************************************************************
@@ -55,6 +57,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncTimer.h>
 #include <AsyncTcpServer.h>
 #include <AsyncTcpConnection.h>
+#include <AsyncAudioEncoder.h>
+#include <AsyncAudioDecoder.h>
+#include <AsyncAudioSplitter.h>
 #include <common.h>
 
 
@@ -88,6 +93,8 @@ using namespace NetTrxMsg;
 
 
 SvxServer::SvxServer(Async::Config &cfg)
+  : master_slot(NO_SLOT), client_cnt(0), iterating(0), relay_dec(0),
+    relay_splitter(0)
 {
   string port = "5210";
   if (!cfg.getValue("GLOBAL", "LISTEN_PORT", port))
@@ -162,14 +169,30 @@ SvxServer::SvxServer(Async::Config &cfg)
   audio_timer->setEnable(false);
 
   master = 0;
+
+    // Decoded audio from the master is split to the relay group encoders
+  relay_splitter = new AudioSplitter;
 } /* SvxServer::SvxServer */
 
 
 SvxServer::~SvxServer(void)
 {
+  delete relay_dec;
+  for (RelayGroups::iterator it=relay_groups.begin();
+       it!=relay_groups.end(); ++it)
+  {
+    if ((*it).second->enc != 0)
+    {
+      relay_splitter->removeSink((*it).second->enc);
+      delete (*it).second->enc;
+    }
+    delete (*it).second;
+  }
+  relay_groups.clear();
+  delete relay_splitter;
   clients.clear();
+  client_index.clear();
   delete server;
-  delete master;
   delete heartbeat_timer;
 }
 
@@ -179,12 +202,25 @@ void SvxServer::clientConnected(Async::TcpConnection *con)
   cout << "--- Client connected: " << con->remoteHost() << ":"
        << con->remotePort() << endl;
 
-  con->dataReceived.connect(mem_fun(*this, &SvxServer::tcpDataReceived));
+  unsigned slot;
+  if (!free_slots.empty())
+  {
+    slot = free_slots.back();
+    free_slots.pop_back();
+  }
+  else
+  {
+    slot = clients.size();
+    clients.push_back(Cons());
+    clients[slot].gen = 0;
+  }
 
-  pair<const string, uint16_t> key(con->remoteHost().toString(),
-                                   con->remotePort());
-  Cons clpair;
+  Cons &clpair = clients[slot];
+  const unsigned gen = clpair.gen;
+  clpair = Cons();
   clpair.con = con;
+  clpair.slot = slot;
+  clpair.gen = gen;
   clpair.state = STATE_VER_WAIT;
   clpair.sql_open = false;  // set SQL close as default
   clpair.blocked = false;   // node is not blocked as default
@@ -192,27 +228,32 @@ void SvxServer::clientConnected(Async::TcpConnection *con)
   clpair.recv_cnt = 0;
   gettimeofday(&clpair.last_msg, NULL);
   gettimeofday(&clpair.sent_msg, NULL);
+  client_index[con] = slot;
+  ++client_cnt;
+
+  ClientHandle handle;
+  handle.slot = slot;
+  handle.gen = gen;
+  con->dataReceived.connect(
+      sigc::bind(mem_fun(*this, &SvxServer::tcpDataReceived), handle));
 
-  clients[key] = clpair;
+    // Until the client select a codec, audio is passed through untouched
+  joinRelayGroup(slot, "", "", MsgAudioCodecSelect::Opts());
+  heartbeat_timer->setEnable(true);
 
-  MsgProtoVer *ver_msg = new MsgProtoVer;
-  sendMsg(con, ver_msg);
+  MsgProtoVer ver_msg;
+  sendMsg(con, &ver_msg);
 
   if (auth_key.empty())
   {
-    MsgAuthOk *auth_ok = new MsgAuthOk;
-    sendMsg(con, auth_ok);
-    clpair.state = STATE_VER_WAIT;
+    MsgAuthOk auth_ok;
+    sendMsg(con, &auth_ok);
   }
   else
   {
-    sendMsg(con, auth_msg);
     clpair.state = STATE_AUTH_WAIT;
+    sendMsg(con, auth_msg);
   }
-
-  clients[key] = clpair;
-  heartbeat_timer->setEnable(true);
-
 } /* SvxServer::clientConnected */
 
 
@@ -222,58 +263,59 @@ void SvxServer::clientDisconnected(Async::TcpConnection *con,
   cout << "--- Client disconnected: " << con->remoteHost() << ":"
        << con->remotePort() << endl;
 
-  if (clients.size() < 1)
+  ClientIndex::iterator it = client_index.find(con);
+  if (it == client_index.end())
   {
-    heartbeat_timer->setEnable(false);
-    heartbeat_timer->reset();
+    return;
   }
-  resetMaster(con);
+  const unsigned slot = (*it).second;
+  client_index.erase(it);
 
-  Clients::iterator it;
-  for (it=clients.begin(); it!=clients.end(); it++)
+    // If a station lost network connection it can't be
+    // master anymore, send a SQL close command to all
+    // connected stations
+  if (isMaster(con))
   {
-    if ((*it).second.con == con)
-    {
-      (*it).second.state = STATE_DISC;
-      (*it).second.sql_open = false;
+    resetMaster(con);
+    MsgSquelch ms(false, 0.0, 1, "");
+    sendExcept(con, &ms);
+  }
 
-        // If a station lost network connection it can't be
-        // master anymore, send a SQL close command to all
-        // connected stations
-      if (isMaster(con))
-      {
-        MsgSquelch *ms = new MsgSquelch(false, 0.0, 1);
-        sendMsg(con, ms);
-      }
-      break;
-    }
+  cout << "-X- removing client " << con->remoteHost() << ":"
+       << con->remotePort()  << " from client list" << endl;
+  Cons &cl = clients[slot];
+  cl.con = 0;
+  cl.state = STATE_DISC;
+  cl.sql_open = false;
+  --client_cnt;
+
+    // The slot is not reused while someone is iterating over the clients
+  if (iterating > 0)
+  {
+    released_slots.push_back(slot);
+  }
+  else
+  {
+    releaseSlot(slot);
   }
 
-  if (it != clients.end())
+  if (client_cnt == 0)
   {
-    cout << "-X- removing client " << con->remoteHost() << ":"
-         << con->remotePort()  << " from client list" << endl;
-    clients.erase(it);
+    heartbeat_timer->setEnable(false);
+    heartbeat_timer->reset();
   }
 } /* SvxServer::clientDisconnected */
 
 
-int SvxServer::tcpDataReceived(Async::TcpConnection *con, void *data, int size)
+int SvxServer::tcpDataReceived(Async::TcpConnection *con, void *data, int size,
+                               ClientHandle handle)
 {
 
 //  cout << "tcpDataReceived: " << con->remoteHost() << ":"
 //       << con->remotePort() << endl;
 
-  Clients::iterator it;
-  for (it=clients.begin(); it!=clients.end(); it++)
-  {
-    if (((*it).second).con == con)
-    {
-      break;
-    }
-  }
-
-  if (it == clients.end())
+  Cons *cl = lookupClient(handle);
+  if ((cl == 0) || (cl->con != con))
   {
     cout << "--- tcp data received from station out of my list "
          << con->remoteHost() << ":" << con->remotePort() << endl;
@@ -282,11 +324,11 @@ int SvxServer::tcpDataReceived(Async::TcpConnection *con, void *data, int size)
 
   int orig_size = size;
   char *buf = static_cast<char*>(data);
-  while (size > 0)
+  while ((size > 0) && (cl->con != 0))
   {
-    unsigned read_cnt = min(static_cast<unsigned>(size), (*it).second.recv_exp
-                                                      - (*it).second.recv_cnt);
-    if ((*it).second.recv_cnt + read_cnt > sizeof((*it).second.recv_buf))
+    unsigned read_cnt = min(static_cast<unsigned>(size),
+                            cl->recv_exp - cl->recv_cnt);
+    if (cl->recv_cnt + read_cnt > sizeof(cl->recv_buf))
     {
       cerr << "*** ERROR: TCP receive buffer overflow " <<
               "in svxserver. Disconnecting...\n";
@@ -294,25 +336,25 @@ int SvxServer::tcpDataReceived(Async::TcpConnection *con, void *data, int size)
       clientDisconnected(con, TcpConnection::DR_ORDERED_DISCONNECT);
       return orig_size;
     }
-    memcpy((*it).second.recv_buf+(*it).second.recv_cnt, buf, read_cnt);
+    memcpy(cl->recv_buf+cl->recv_cnt, buf, read_cnt);
     size -= read_cnt;
-    (*it).second.recv_cnt += read_cnt;
+    cl->recv_cnt += read_cnt;
     buf += read_cnt;
 
-    if ((*it).second.recv_cnt == (*it).second.recv_exp)
+    if (cl->recv_cnt == cl->recv_exp)
     {
-      if ((*it).second.recv_exp == sizeof(Msg))
+      if (cl->recv_exp == sizeof(Msg))
       {
-        Msg *msg = reinterpret_cast<Msg*>((*it).second.recv_buf);
+        Msg *msg = reinterpret_cast<Msg*>(cl->recv_buf);
         if (msg->size() == sizeof(Msg))
         {
-          handleMsg(con, msg);
-          (*it).second.recv_cnt = 0;
-          (*it).second.recv_exp = sizeof(Msg);
+          handleMsg(*cl, msg);
+          cl->recv_cnt = 0;
+          cl->recv_exp = sizeof(Msg);
         }
         else if (msg->size() > sizeof(Msg))
         {
-          (*it).second.recv_exp = msg->size();
+          cl->recv_exp = msg->size();
         }
         else
         {
@@ -325,10 +367,10 @@ int SvxServer::tcpDataReceived(Async::TcpConnection *con, void *data, int size)
       }
       else
       {
-        Msg *msg = reinterpret_cast<Msg*>((*it).second.recv_buf);
-        handleMsg(con, msg);
-        (*it).second.recv_cnt = 0;
-        (*it).second.recv_exp = sizeof(Msg);
+        Msg *msg = reinterpret_cast<Msg*>(cl->recv_buf);
+        handleMsg(*cl, msg);
+        cl->recv_cnt = 0;
+        cl->recv_exp = sizeof(Msg);
       }
     }
   }
@@ -338,32 +380,55 @@ int SvxServer::tcpDataReceived(Async::TcpConnection *con, void *data, int size)
 } /* SvxServer::tcpDataReceived */
 
 
-void SvxServer::handleMsg(Async::TcpConnection *con, Msg *msg)
+SvxServer::Cons *SvxServer::lookupClient(const ClientHandle &handle)
 {
+  if ((handle.slot >= clients.size()) || (clients[handle.slot].con == 0) ||
+      (clients[handle.slot].gen != handle.gen))
+  {
+    return 0;
+  }
+  return &clients[handle.slot];
+} /* SvxServer::lookupClient */
 
-//  cout << "message <---------- " << con->remoteHost() << ":" 
-//       << con->remotePort() << ", type=" << msg->type() << " received\n";
 
-  int state = STATE_READY;
-  Clients::iterator it;
-  Clients t_clients;
+void SvxServer::beginIteration(void)
+{
+  ++iterating;
+} /* SvxServer::beginIteration */
+
 
-  for (it=clients.begin(); it!=clients.end(); it++)
+void SvxServer::endIteration(void)
+{
+  assert(iterating > 0);
+  if (--iterating == 0)
   {
-    if ( ((*it).second).con == con)
+    while (!released_slots.empty())
     {
-      state = (*it).second.state;
-      gettimeofday(&((*it).second).last_msg, NULL);
-      break;
+      const unsigned slot = released_slots.back();
+      released_slots.pop_back();
+      releaseSlot(slot);
     }
   }
+} /* SvxServer::endIteration */
+
+
+void SvxServer::releaseSlot(unsigned slot)
+{
+  leaveRelayGroup(slot);
+  ++clients[slot].gen;
+  free_slots.push_back(slot);
+} /* SvxServer::releaseSlot */
 
-  if (it == clients.end())
-  {
-    cout << "-- message received from ip out of my list "
-         << con->remoteHost() << ":" << con->remotePort() << endl;
-    return;
-  }
+
+void SvxServer::handleMsg(Cons &cl, Msg *msg)
+{
+  Async::TcpConnection *con = cl.con;
+
+//  cout << "message <---------- " << con->remoteHost() << ":" 
+//       << con->remotePort() << ", type=" << msg->type() << " received\n";
+
+  int state = cl.state;
+  gettimeofday(&cl.last_msg, NULL);
 
   switch (state)
   {
@@ -382,26 +447,26 @@ void SvxServer::handleMsg(Async::TcpConnection *con, Msg *msg)
         {
           cerr << "*** ERROR: Authentication error in svxserver.\n";
           con->disconnect();
-          ((*it).second).state = STATE_DISC;
+          cl.state = STATE_DISC;
           clientDisconnected(con, TcpConnection::DR_ORDERED_DISCONNECT);
           return;
         }
         else
         {
-          MsgAuthOk *ok_msg = new MsgAuthOk;
-          sendMsg(con, ok_msg);
-          ((*it).second).state = STATE_READY;
+          MsgAuthOk ok_msg;
+          sendMsg(con, &ok_msg);
+          cl.state = STATE_READY;
 
           // sending SQL close to connected node just to be sure that it 
           // isn't still open from former connects
-          MsgTransmitterStateChange *txcl = new MsgTransmitterStateChange(false);
-          sendMsg(con, txcl);
+          MsgTransmitterStateChange txcl(false);
+          sendMsg(con, &txcl);
         }
       }
       else
       {
         cerr << "*** ERROR: Protocol error in svxserver.\n";
-        ((*it).second).state = STATE_DISC;
+        cl.state = STATE_DISC;
         con->disconnect();
         clientDisconnected(con, TcpConnection::DR_ORDERED_DISCONNECT);
       }
@@ -419,8 +484,8 @@ void SvxServer::handleMsg(Async::TcpConnection *con, Msg *msg)
       // is heartbeat, send a heartbeat back to client
     case MsgHeartbeat::TYPE:
     {
-      MsgHeartbeat *m = new MsgHeartbeat;
-      sendMsg(con, m);
+      MsgHeartbeat m;
+      sendMsg(con, &m);
       return;
     }
 
@@ -429,7 +494,7 @@ void SvxServer::handleMsg(Async::TcpConnection *con, Msg *msg)
     case MsgRemoteCall::TYPE:
     {
       MsgRemoteCall *n = reinterpret_cast<MsgRemoteCall *>(msg);
-      (*it).second.callsign = n->getCall();
+      cl.callsign = n->getCall();
       return;
     }
 #endif
@@ -455,14 +520,14 @@ void SvxServer::handleMsg(Async::TcpConnection *con, Msg *msg)
     case MsgRxAudioCodecSelect::TYPE:
     {
       MsgRxAudioCodecSelect *n = reinterpret_cast<MsgRxAudioCodecSelect *>(msg);
-      ((*it).second).rxcodec = n->name();
+      selectRxCodec(cl, n);
       return;
     }
 
     case MsgTxAudioCodecSelect::TYPE:
     {
       MsgTxAudioCodecSelect *n = reinterpret_cast<MsgTxAudioCodecSelect *>(msg);
-      ((*it).second).rxcodec = n->name();
+      selectTxCodec(cl, n);
       return;
     }
 
@@ -475,28 +540,28 @@ void SvxServer::handleMsg(Async::TcpConnection *con, Msg *msg)
       if (!hasMaster())
       {
         audio_timer->setEnable(true);
-        setMaster(con);
-        MsgSquelch *ms = new MsgSquelch(true, 1.0, 1);
-        sendExcept(con, ms);
-        (*it).second.sql_open = true;
+        setMaster(cl);
+        MsgSquelch ms(true, 1.0, 1, "");
+        sendExcept(con, &ms);
+        cl.sql_open = true;
 
         // sends the audiostream to all connected clients without the
         // source client
-        if ((*it).second.tx_mode != Tx::TX_AUTO)
+        if (cl.tx_mode != Tx::TX_AUTO)
         {
-          (*it).second.tx_mode = Tx::TX_AUTO;
-          MsgSetTxCtrlMode *n = new MsgSetTxCtrlMode(Tx::TX_AUTO);
-          sendExcept(con, n);
-          sendMsg(con, n);
+          cl.tx_mode = Tx::TX_AUTO;
+          MsgSetTxCtrlMode n(Tx::TX_AUTO);
+          sendExcept(con, &n);
+          sendMsg(con, &n);
         }
       }
 
       if (isMaster(con))
       {
         // sends the audiostream to all connected clients without the
-        // source client if the source client is Master
-        cmsg = reinterpret_cast<MsgAudio *>(msg);
-        sendExcept(con, cmsg);
+        // source client if the source client is Master. The audio is
+        // transcoded for clients using another codec.
+        relayAudio(cl, reinterpret_cast<MsgAudio *>(msg));
         audio_timer->reset();
       }
       return;
@@ -508,16 +573,16 @@ void SvxServer::handleMsg(Async::TcpConnection *con, Msg *msg)
       if (isMaster(con))
       {
         resetMaster(con);
-        MsgSquelch  *ms = new MsgSquelch(false, 0.0, 1);
-        sendExcept(con, ms);
-        sendMsg(con, ms);
+        MsgSquelch ms(false, 0.0, 1, "");
+        sendExcept(con, &ms);
+        sendMsg(con, &ms);
 
-        (*it).second.sql_open = false;
+        cl.sql_open = false;
 
-        MsgAllSamplesFlushed *o = new MsgAllSamplesFlushed;
-        sendMsg(con, o);
-        cmsg = o;
-        break;
+        MsgAllSamplesFlushed o;
+        sendMsg(con, &o);
+        sendExcept(con, &o);
+        return;
       }
       else
       {
@@ -546,15 +611,15 @@ void SvxServer::handleMsg(Async::TcpConnection *con, Msg *msg)
       if (s->mode() == 1)
       {
         // the station with 1st SQL opening becomes a master
-        setMaster(con);
+        setMaster(cl);
 
-        MsgTransmitterStateChange *n = new MsgTransmitterStateChange(true);
-        sendMsg(con, n);
-        sendExcept(con, n);
+        MsgTransmitterStateChange n(true);
+        sendMsg(con, &n);
+        sendExcept(con, &n);
 
-        MsgSquelch  *ms = new MsgSquelch(true, 1.0, 1);
-        sendExcept(con, ms);
-        (*it).second.sql_open = true;
+        MsgSquelch ms(true, 1.0, 1, "");
+        sendExcept(con, &ms);
+        cl.sql_open = true;
         audio_timer->reset();
         audio_timer->setEnable(true);
       }
@@ -563,15 +628,15 @@ void SvxServer::handleMsg(Async::TcpConnection *con, Msg *msg)
       if (s->mode() == 2)
       {
         resetMaster(con);
-        (*it).second.sql_open = false;
+        cl.sql_open = false;
 
-        (*it).second.tx_mode = Tx::TX_AUTO;
-        MsgSetTxCtrlMode *n = new MsgSetTxCtrlMode(Tx::TX_AUTO);
-        sendExcept(con, n);
+        cl.tx_mode = Tx::TX_AUTO;
+        MsgSetTxCtrlMode n(Tx::TX_AUTO);
+        sendExcept(con, &n);
 
-        MsgTransmitterStateChange *m = new MsgTransmitterStateChange(false);
-        sendExcept(con, m);
-        sendMsg(con, m);
+        MsgTransmitterStateChange m(false);
+        sendExcept(con, &m);
+        sendMsg(con, &m);
       }
 
       cmsg = s;
@@ -584,7 +649,10 @@ void SvxServer::handleMsg(Async::TcpConnection *con, Msg *msg)
       return;
   }
 
-  sendExcept(con, cmsg);
+  if (cmsg != 0)
+  {
+    sendExcept(con, cmsg);
+  }
 
 } /* SvxServer::handleMsg */
 
@@ -602,22 +670,16 @@ void SvxServer::audiotimeout(Timer *t)
 
 void SvxServer::sqltimeout(Timer *t)
 {
-  Clients::iterator it;
-  Clients t_clients;
-
   // find the connection handler that has a problem with
   // the SQL -> revoke the AUTH grant
-  for (it=clients.begin(); it!=clients.end(); it++)
+  if (hasMaster())
   {
-    if ( (*it).second.con == master)
-    {
-      (*it).second.state = STATE_DISC;
-      (*it).second.blocked = true;
-      cout << "*** WARNING: SQL on " << master->remoteHost() 
-           << " has been open too long, blocking station." << endl;
-      gettimeofday(&((*it).second).last_msg, NULL);
-      break;
-    }
+    Cons &cl = clients[master_slot];
+    cl.state = STATE_DISC;
+    cl.blocked = true;
+    cout << "*** WARNING: SQL on " << master->remoteHost()
+         << " has been open too long, blocking station." << endl;
+    gettimeofday(&cl.last_msg, NULL);
   }
 
   resetAll();
@@ -632,27 +694,24 @@ void SvxServer::sqlresettimeout(Timer *t)
 
 void SvxServer::resetAll(void)
 {
-  MsgSquelch *ms = new MsgSquelch(false, 0.0, 1);
-  sendExcept(master, ms);
-  sendMsg(master, ms);
-
-  Clients::iterator it;
-  Clients t_clients;
-
-  for (it=clients.begin(); it!=clients.end(); it++)
+  if (!hasMaster())
   {
-    if ( (*it).second.con == master)
-    {
-      (*it).second.sql_open = false;
-      gettimeofday(&(*it).second.last_msg, NULL);
-      break;
-    }
+    return;
   }
 
-  MsgAllSamplesFlushed *o = new MsgAllSamplesFlushed;
-  sendMsg(master, o);
-  sendExcept(master, o);
-  resetMaster(master);
+  TcpConnection *con = master;
+  Cons &cl = clients[master_slot];
+  cl.sql_open = false;
+  gettimeofday(&cl.last_msg, NULL);
+  resetMaster(con);
+
+  MsgSquelch ms(false, 0.0, 1, "");
+  sendExcept(con, &ms);
+  sendMsg(con, &ms);
+
+  MsgAllSamplesFlushed o;
+  sendMsg(con, &o);
+  sendExcept(con, &o);
 } /* SvxServer::resetAll */
 
 
@@ -662,40 +721,39 @@ void SvxServer::hbtimeout(Timer *t)
   struct timeval t_diff;
   int diff_ms;
 
-  Clients::iterator it;
-  Clients t_clients;
-  MsgHeartbeat *m = new MsgHeartbeat;
+  MsgHeartbeat m;
 
-  for (it=clients.begin(); it!=clients.end(); it++)
+  gettimeofday(&t_time, NULL);
+  beginIteration();
+  for (unsigned slot=0; slot<clients.size(); ++slot)
   {
-    gettimeofday(&t_time, NULL);
-    timersub(&t_time, &(*it).second.last_msg, &t_diff );
+    Cons &cl = clients[slot];
+    if (cl.con == 0)
+    {
+      continue;
+    }
+
+    timersub(&t_time, &cl.last_msg, &t_diff );
     diff_ms = int(t_diff.tv_sec * 1000 +  t_diff.tv_usec/1000);
 
-      // if the difference more then 2*timeout, put the client
-      // into the "disconnect pool"
+      // if the difference more then 2*timeout, disconnect the client
     if (diff_ms > 2 * hbto)
     {
       cerr << "**** ERROR: Heartbeat timeout, lost connection to "
-           << (*it).second.con->remoteHost() << ":"
-           << (*it).second.con->remotePort() << endl;
-      t_clients.insert(*it); // storing clients to be removed later
-      (*it).second.state = STATE_DISC;
+           << cl.con->remoteHost() << ":" << cl.con->remotePort() << endl;
+      cout << "-X- disconnect client " << cl.con->remoteHost() << ":"
+           << cl.con->remotePort() << endl;
+      TcpConnection *con = cl.con;
+      cl.state = STATE_DISC;
+      con->disconnect();
+      clientDisconnected(con, TcpConnection::DR_ORDERED_DISCONNECT);
     }
-    else 
+    else
     {
-      sendMsg((*it).second.con, m);
+      sendMsg(cl.con, &m);
     }
   }
-
-  // removing client connection from connection pool
-  for (it = t_clients.begin(); it != t_clients.end(); it++)
-  {
-    cout << "-X- disconnect client " << (*it).second.con->remoteHost() << ":"
-         << (*it).second.con->remotePort() << endl;
-    (*it).second.con->disconnect();
-    clientDisconnected((*it).second.con, TcpConnection::DR_ORDERED_DISCONNECT);
-  }
+  endIteration();
 
   t->reset();
 
@@ -704,28 +762,26 @@ void SvxServer::hbtimeout(Timer *t)
 
 void SvxServer::sendExcept(Async::TcpConnection *con, Msg *msg)
 {
-
-    // copy map to prevent a segfault by erasing a connection
-    // that exists anymore
-  Clients t_clients = clients;
-  Clients::iterator it;
-
-    // sending data to connected clients without the source client
-  for (it = t_clients.begin(); it != t_clients.end(); it++)
+    // The same message buffer is written to all clients. Clients that are
+    // disconnected on a send error are skipped and their slots are released
+    // when the iteration is done.
+  beginIteration();
+  for (unsigned slot=0; slot<clients.size(); ++slot)
   {
-    if ((*it).second.con != con)
+    TcpConnection *cl_con = clients[slot].con;
+    if ((cl_con != 0) && (cl_con != con))
     {
-      sendMsg((*it).second.con, msg);
+      sendMsg(cl_con, msg);
     }
   }
+  endIteration();
 } /* SvxServer::sendExcept */
 
 
 void SvxServer::sendMsg(Async::TcpConnection *con, Msg *msg)
 {
-
-  assert(con->isConnected());
-  if (clients.size() < 1)
+    // The client may have been disconnected by an earlier send error
+  if (!con->isConnected())
   {
     return;
   }
@@ -755,11 +811,12 @@ bool SvxServer::isMaster(Async::TcpConnection *con)
 } /* SvxServer::isMaster */
 
 
-void SvxServer::setMaster(Async::TcpConnection *con)
+void SvxServer::setMaster(Cons &cl)
 {
   if (master == 0) {
-    cout << "IS Master " << con->remoteHost() << endl;
-    master = con;
+    cout << "IS Master " << cl.con->remoteHost() << endl;
+    master = cl.con;
+    master_slot = cl.slot;
     sql_timer->reset();
     sql_timer->setEnable(true);
   }
@@ -768,15 +825,246 @@ void SvxServer::setMaster(Async::TcpConnection *con)
 
 void SvxServer::resetMaster(Async::TcpConnection *con)
 {
-  if (master == con)
+  if ((master != 0) && (master == con))
   {
     cout << "NO Master " << con->remoteHost() << endl;
+
+      // Send the audio that is left in the transcoders before the squelch
+      // is closed on the other clients
+    if (relay_dec != 0)
+    {
+      beginIteration();
+      relay_dec->flushEncodedSamples();
+      endIteration();
+    }
+
     master = 0;
+    master_slot = NO_SLOT;
     sql_timer->setEnable(false);
   }
 } /* SvxServer::resetMaster */
 
 
+void SvxServer::selectRxCodec(Cons &cl, MsgRxAudioCodecSelect *codec_msg)
+{
+  MsgRxAudioCodecSelect::Opts opts;
+  codec_msg->options(opts);
+  string key(codec_msg->name());
+  MsgRxAudioCodecSelect::Opts::const_iterator it;
+  for (it=opts.begin(); it!=opts.end(); ++it)
+  {
+    key += " " + (*it).first + "=" + (*it).second;
+  }
+  cl.rxcodec = codec_msg->name();
+  cl.rxcodec_key = key;
+  joinRelayGroup(cl.slot, key, codec_msg->name(), opts);
+} /* SvxServer::selectRxCodec */
+
+
+void SvxServer::selectTxCodec(Cons &cl, MsgTxAudioCodecSelect *codec_msg)
+{
+  cl.txcodec_opts.clear();
+  codec_msg->options(cl.txcodec_opts);
+  string key(codec_msg->name());
+  MsgTxAudioCodecSelect::Opts::const_iterator it;
+  for (it=cl.txcodec_opts.begin(); it!=cl.txcodec_opts.end(); ++it)
+  {
+    key += " " + (*it).first + "=" + (*it).second;
+  }
+  cl.txcodec = codec_msg->name();
+  cl.txcodec_key = key;
+} /* SvxServer::selectTxCodec */
+
+
+void SvxServer::joinRelayGroup(unsigned slot, const string &key,
+                               const string &codec_name,
+                               const MsgAudioCodecSelect::Opts &opts)
+{
+  leaveRelayGroup(slot);
+
+  RelayGroup *group = 0;
+  RelayGroups::iterator grp_it = relay_groups.find(key);
+  if (grp_it != relay_groups.end())
+  {
+    group = (*grp_it).second;
+  }
+  else
+  {
+    group = new RelayGroup;
+    group->key = key;
+    group->enc = 0;
+    if (!codec_name.empty())
+    {
+      group->enc = AudioEncoder::create(codec_name);
+      if (group->enc == 0)
+      {
+        cerr << "*** ERROR: Unknown audio codec (" << codec_name
+             << ") requested by " << clients[slot].con->remoteHost() << ":"
+             << clients[slot].con->remotePort()
+             << ". Audio will be passed through.\n";
+      }
+      else
+      {
+        MsgAudioCodecSelect::Opts::const_iterator it;
+        for (it=opts.begin(); it!=opts.end(); ++it)
+        {
+          group->enc->setOption((*it).first, (*it).second);
+        }
+        group->enc->writeEncodedSamples.connect(
+            sigc::bind(mem_fun(*this, &SvxServer::writeRelayAudio), group));
+        group->enc->flushEncodedSamples.connect(
+            mem_fun(*group->enc, &AudioEncoder::allEncodedSamplesFlushed));
+        relay_splitter->addSink(group->enc);
+        relay_splitter->enableSink(group->enc, false);
+      }
+    }
+    relay_groups[key] = group;
+    cout << "--- New relay group for codec \""
+         << (key.empty() ? "passthrough" : key) << "\"" << endl;
+  }
+  group->members.push_back(slot);
+} /* SvxServer::joinRelayGroup */
+
+
+void SvxServer::leaveRelayGroup(unsigned slot)
+{
+  for (RelayGroups::iterator it=relay_groups.begin();
+       it!=relay_groups.end(); ++it)
+  {
+    RelayGroup *group = (*it).second;
+    vector<unsigned>::iterator mit =
+      find(group->members.begin(), group->members.end(), slot);
+    if (mit != group->members.end())
+    {
+      group->members.erase(mit);
+      if (group->members.empty())
+      {
+        if (group->enc != 0)
+        {
+          relay_splitter->removeSink(group->enc);
+          delete group->enc;
+        }
+        delete group;
+        relay_groups.erase(it);
+      }
+      return;
+    }
+  }
+} /* SvxServer::leaveRelayGroup */
+
+
+void SvxServer::relayAudio(const Cons &cl, MsgAudio *msg)
+{
+  if ((relay_dec == 0) || (cl.txcodec_key != relay_dec_key))
+  {
+    setupRelayDecoder(cl);
+  }
+
+    // Pass the audio through to groups using the same codec as the master
+    // and mark the other groups for transcoding. Only groups with other
+    // members than the master need any audio. Clients disconnected on a
+    // send error are released when the whole relay is done, since releasing
+    // a slot may delete its group, and the group encoder, while in use.
+  beginIteration();
+  bool transcode = false;
+  for (RelayGroups::iterator it=relay_groups.begin();
+       it!=relay_groups.end(); ++it)
+  {
+    RelayGroup *group = (*it).second;
+    const bool has_listeners = (group->members.size() > 1) ||
+                               (group->members.front() != cl.slot);
+    const bool passthrough = (relay_dec == 0) || (group->enc == 0) ||
+                             (group->key == cl.txcodec_key);
+    if (group->enc != 0)
+    {
+      relay_splitter->enableSink(group->enc, !passthrough && has_listeners);
+    }
+    if (has_listeners)
+    {
+      if (passthrough)
+      {
+        sendToGroup(group, cl.con, msg);
+      }
+      else
+      {
+        transcode = true;
+      }
+    }
+  }
+
+  if (transcode)
+  {
+    relay_dec->writeEncodedSamples(msg->buf(), msg->size());
+  }
+  endIteration();
+} /* SvxServer::relayAudio */
+
+
+void SvxServer::setupRelayDecoder(const Cons &cl)
+{
+  delete relay_dec;
+  relay_dec = 0;
+  relay_dec_key = cl.txcodec_key;
+  if (cl.txcodec.empty())
+  {
+    return;
+  }
+
+  relay_dec = AudioDecoder::create(cl.txcodec);
+  if (relay_dec == 0)
+  {
+    cerr << "*** ERROR: Unknown audio codec (" << cl.txcodec
+         << ") used by " << cl.con->remoteHost() << ":"
+         << cl.con->remotePort() << ". Audio will be passed through.\n";
+    return;
+  }
+  MsgAudioCodecSelect::Opts::const_iterator it;
+  for (it=cl.txcodec_opts.begin(); it!=cl.txcodec_opts.end(); ++it)
+  {
+    relay_dec->setOption((*it).first, (*it).second);
+  }
+  relay_dec->registerSink(relay_splitter);
+  cout << "--- Decoding \"" << relay_dec_key << "\" audio for transcoding"
+       << endl;
+} /* SvxServer::setupRelayDecoder */
+
+
+void SvxServer::writeRelayAudio(const void *buf, int size, RelayGroup *group)
+{
+    // Always called from within an iteration, in relayAudio or resetMaster,
+    // so the group and its encoder stay alive until the encoder returns
+  assert(iterating > 0);
+  const char *ptr = reinterpret_cast<const char *>(buf);
+  while (size > 0)
+  {
+    const int bufsize = MsgAudio::BUFSIZE;
+    int len = min(size, bufsize);
+    MsgAudio msg(ptr, len);
+    sendToGroup(group, master, &msg);
+    size -= len;
+    ptr += len;
+  }
+} /* SvxServer::writeRelayAudio */
+
+
+void SvxServer::sendToGroup(RelayGroup *group, Async::TcpConnection *except,
+                            Msg *msg)
+{
+    // A client that is disconnected on a send error stay in the group,
+    // with no connection, until the iteration is done
+  beginIteration();
+  for (size_t i=0; i<group->members.size(); ++i)
+  {
+    TcpConnection *con = clients[group->members[i]].con;
+    if ((con != 0) && (con != except))
+    {
+      sendMsg(con, msg);
+    }
+  }
+  endIteration();
+} /* SvxServer::sendToGroup */
+
+
 /*
  * This file has not been truncated
  */
@@ -46,6 +46,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncTcpServer.h>
 #include <Tx.h>
 
+#include <map>
+#include <string>
+#include <vector>
+
 
 /****************************************************************************
  *
@@ -62,6 +66,13 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+namespace Async
+{
+  class AudioEncoder;
+  class AudioDecoder;
+  class AudioSplitter;
+}
+
 
 /****************************************************************************
  *
@@ -107,6 +118,20 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 @brief	 SvxLinkServer app
 @author	 Adi Bier / DL1HRC
 @date	 2015-08-13
+
+Audio from the master is relayed to the other clients through relay groups.
+Clients are grouped by the codec, including codec options, that they have
+asked to receive audio in. Groups using the same codec as the master get the
+audio frames passed through untouched. For the other groups, the audio from
+the master is decoded once and then encoded once per group. Clients that
+have not selected a codec get the audio passed through.
+
+Clients are kept in a table of slots. The TCP connection of a client is
+bound to a handle, a slot index and the generation of the slot, so that
+received data is routed to the client without a search. A slot is not reused
+while the client table is being iterated. The release of a disconnected
+client is deferred until the iteration is done, which make it safe for a send
+error to disconnect a client in the middle of a broadcast.
 */
 
 class SvxServer : public sigc::trackable
@@ -136,6 +161,7 @@ class SvxServer : public sigc::trackable
     Async::Timer * sql_resettimer;
     Async::Timer * audio_timer;
     Async::TcpConnection *master;
+    unsigned master_slot;
 
     typedef enum
     {
@@ -145,6 +171,8 @@ class SvxServer : public sigc::trackable
     struct Cons
     {
       Async::TcpConnection *con;
+      unsigned slot;
+      unsigned gen;
       State   state;
       std::string  callsign;
       struct timeval last_msg;
@@ -155,14 +183,43 @@ class SvxServer : public sigc::trackable
       int  tg;
       std::string   rxcodec;
       std::string   txcodec;
+      std::string   rxcodec_key;
+      std::string   txcodec_key;
+      NetTrxMsg::MsgAudioCodecSelect::Opts txcodec_opts;
       char      recv_buf[4096];
       unsigned  recv_cnt;
       unsigned  recv_exp;
       bool  blocked;
     };
 
-    typedef std::map<std::pair<const std::string, uint16_t>, Cons> Clients;
+    struct ClientHandle
+    {
+      unsigned slot;
+      unsigned gen;
+    };
+
+    static const unsigned NO_SLOT = ~0U;
+
+    typedef std::vector<Cons> Clients;
+    typedef std::map<Async::TcpConnection*, unsigned> ClientIndex;
     Clients clients;
+    ClientIndex client_index;
+    std::vector<unsigned> free_slots;
+    std::vector<unsigned> released_slots;
+    unsigned client_cnt;
+    unsigned iterating;
+
+    struct RelayGroup
+    {
+      std::string             key;
+      Async::AudioEncoder     *enc;
+      std::vector<unsigned>   members;
+    };
+    typedef std::map<std::string, RelayGroup*> RelayGroups;
+    RelayGroups relay_groups;
+    Async::AudioDecoder *relay_dec;
+    std::string relay_dec_key;
+    Async::AudioSplitter *relay_splitter;
 
     std::string     auth_key;
     NetTrxMsg::MsgAuthChallenge *auth_msg;
@@ -177,8 +234,13 @@ class SvxServer : public sigc::trackable
     void clientConnected(Async::TcpConnection *incoming_con);
     void clientDisconnected(Async::TcpConnection *con,
       	      	      	Async::TcpConnection::DisconnectReason reason);
-    int tcpDataReceived(Async::TcpConnection *con, void *data, int size);
-    void handleMsg(Async::TcpConnection *con, NetTrxMsg::Msg *msg);
+    int tcpDataReceived(Async::TcpConnection *con, void *data, int size,
+                        ClientHandle handle);
+    void handleMsg(Cons &cl, NetTrxMsg::Msg *msg);
+    Cons *lookupClient(const ClientHandle &handle);
+    void beginIteration(void);
+    void endIteration(void);
+    void releaseSlot(unsigned slot);
     void sendMsg(Async::TcpConnection *con, NetTrxMsg::Msg *msg);
     void hbtimeout(Async::Timer *t);
     void sqltimeout(Async::Timer *t);
@@ -186,9 +248,20 @@ class SvxServer : public sigc::trackable
     void audiotimeout(Async::Timer *t);
     void resetAll(void);
     bool isMaster(Async::TcpConnection *con);
-    void setMaster(Async::TcpConnection *con);
+    void setMaster(Cons &cl);
     void resetMaster(Async::TcpConnection *con);
     bool hasMaster(void);
+    void selectRxCodec(Cons &cl, NetTrxMsg::MsgRxAudioCodecSelect *codec_msg);
+    void selectTxCodec(Cons &cl, NetTrxMsg::MsgTxAudioCodecSelect *codec_msg);
+    void joinRelayGroup(unsigned slot, const std::string &key,
+                        const std::string &codec_name,
+                        const NetTrxMsg::MsgAudioCodecSelect::Opts &opts);
+    void leaveRelayGroup(unsigned slot);
+    void relayAudio(const Cons &cl, NetTrxMsg::MsgAudio *msg);
+    void setupRelayDecoder(const Cons &cl);
+    void writeRelayAudio(const void *buf, int size, RelayGroup *group);
+    void sendToGroup(RelayGroup *group, Async::TcpConnection *except,
+                     NetTrxMsg::Msg *msg);
 
     SvxServer(const SvxServer&);
     SvxServer& operator=(const SvxServer&);
@@ -44,6 +44,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncTcpServer.h>
 #include <AsyncUdpSocket.h>
 #include <AsyncApplication.h>
+#include <AsyncMetrics.h>
+#include <AsyncMetricsHttpServer.h>
 #include <common.h>
 
 
@@ -123,8 +125,23 @@ namespace {
 
 Reflector::Reflector(void)
   : m_srv(0), m_udp_sock(0), m_tg_for_v1_clients(1), m_random_qsy_lo(0),
-    m_random_qsy_hi(0), m_random_qsy_tg(0), m_http_server(0)
+    m_random_qsy_hi(0), m_random_qsy_tg(0), m_http_server(0),
+    m_udp_lost_cnt(0), m_udp_out_of_seq_cnt(0),
+    m_tick_timer(1000, Timer::TYPE_PERIODIC)
 {
+  m_other_tg_metrics.udp_rx = 0;
+  m_other_tg_metrics.udp_tx = 0;
+  m_tick_timer.expired.connect(mem_fun(*this, &Reflector::onTick));
+
+  Async::MetricsRegistry& metrics = Async::MetricsRegistry::instance();
+  m_udp_lost_cnt = &metrics.counter(
+      "svxreflector_udp_frames_lost_total",
+      "Number of UDP frames lost from the nodes, detected by sequence number");
+  m_udp_out_of_seq_cnt = &metrics.counter(
+      "svxreflector_udp_frames_out_of_sequence_total",
+      "Number of UDP frames from the nodes dropped due to wrong order");
+  metrics.collect.connect(mem_fun(*this, &Reflector::collectMetrics));
+
   TGHandler::instance()->talkerUpdated.connect(
       mem_fun(*this, &Reflector::onTalkerUpdated));
   TGHandler::instance()->requestAutoQsy.connect(
@@ -270,6 +287,7 @@ void Reflector::broadcastMsg(const ReflectorMsg& msg,
 bool Reflector::sendUdpDatagram(ReflectorClient *client, const void *buf,
                                 size_t count)
 {
+  tgMetrics(client->currentTG()).udp_tx->inc();
   return m_udp_sock->write(client->remoteHost(), client->remoteUdpPort(), buf,
                            count);
 } /* Reflector::sendUdpDatagram */
@@ -416,10 +434,13 @@ void Reflector::udpDatagramReceived(const IpAddress& addr, uint16_t port,
     return;
   }
 
+  tgMetrics(TGHandler::instance()->TGForClient(client)).udp_rx->inc();
+
     // Check sequence number
   uint16_t udp_rx_seq_diff = header.sequenceNum() - client->nextUdpRxSeq();
   if (udp_rx_seq_diff > 0x7fff) // Frame out of sequence (ignore)
   {
+    m_udp_out_of_seq_cnt->inc();
     cout << client->callsign()
          << ": Dropping out of sequence frame with seq="
          << header.sequenceNum() << ". Expected seq="
@@ -428,6 +449,7 @@ void Reflector::udpDatagramReceived(const IpAddress& addr, uint16_t port,
   }
   else if (udp_rx_seq_diff > 0) // Frame(s) lost
   {
+    m_udp_lost_cnt->inc(udp_rx_seq_diff);
     cout << client->callsign()
          << ": UDP frame(s) lost. Expected seq=" << client->nextUdpRxSeq()
          << ". Received seq=" << header.sequenceNum() << endl;
@@ -621,6 +643,12 @@ void Reflector::httpRequestReceived(Async::HttpServerConnection *con,
 {
   //std::cout << "### " << req.method << " " << req.target << std::endl;
 
+  if (Async::MetricsHttpServer::handleRequest(con, req,
+        Async::MetricsRegistry::instance()))
+  {
+    return;
+  }
+
   Async::HttpServerConnection::Response res;
   if ((req.method != "GET") && (req.method != "HEAD"))
   {
@@ -797,6 +825,67 @@ uint32_t Reflector::nextRandomQsyTg(void)
 } /* Reflector::nextRandomQsyTg */
 
 
+Reflector::TgMetrics& Reflector::tgMetrics(uint32_t tg)
+{
+  TgMetricsMap::iterator it = m_tg_metrics.find(tg);
+  if (it == m_tg_metrics.end())
+  {
+      // Any client may select any talk group so the number of series is
+      // capped. Talk groups seen after that are counted as "other".
+    const bool is_other = (m_tg_metrics.size() >= MAX_TG_METRICS);
+    if (is_other && (m_other_tg_metrics.udp_rx != 0))
+    {
+      return m_other_tg_metrics;
+    }
+    Async::MetricsRegistry& metrics = Async::MetricsRegistry::instance();
+    const Async::MetricsRegistry::Labels labels =
+        {{"tg", is_other ? "other" : to_string(tg)}};
+    TgMetrics tg_metrics;
+    tg_metrics.udp_rx = &metrics.counter(
+        "svxreflector_udp_packets_received_total",
+        "Number of UDP packets received from nodes on a talk group", labels);
+    tg_metrics.udp_tx = &metrics.counter(
+        "svxreflector_udp_packets_sent_total",
+        "Number of UDP packets sent to nodes on a talk group", labels);
+    if (is_other)
+    {
+      m_other_tg_metrics = tg_metrics;
+      return m_other_tg_metrics;
+    }
+    it = m_tg_metrics.insert(std::make_pair(tg, tg_metrics)).first;
+  }
+  return it->second;
+} /* Reflector::tgMetrics */
+
+
+void Reflector::onTick(Async::Timer *t)
+{
+    // A client may be removed from the map while it is handled, e.g. on a
+    // heartbeat timeout, so look the clients up one by one. The id vector
+    // keep its capacity between ticks.
+  m_tick_client_ids.clear();
+  for (const auto& item : m_client_map)
+  {
+    m_tick_client_ids.push_back(item.first);
+  }
+  for (uint32_t client_id : m_tick_client_ids)
+  {
+    ReflectorClientMap::iterator it = m_client_map.find(client_id);
+    if (it != m_client_map.end())
+    {
+      it->second->tick();
+    }
+  }
+} /* Reflector::onTick */
+
+
+void Reflector::collectMetrics(void)
+{
+  Async::MetricsRegistry::instance().gauge("svxreflector_clients",
+      "Number of connected nodes").set(m_client_map.size());
+} /* Reflector::collectMetrics */
+
+
 /*
  * This file has not been truncated
  */
@@ -72,6 +72,7 @@ namespace Async
 {
   class UdpSocket;
   class Config;
+  class MetricCounter;
 };
 
 class ReflectorMsg;
@@ -186,6 +187,14 @@ class Reflector : public sigc::trackable
     typedef std::map<Async::FramedTcpConnection*,
                      ReflectorClient*> ReflectorClientConMap;
     typedef Async::TcpServer<Async::FramedTcpConnection> FramedTcpServer;
+    struct TgMetrics
+    {
+      Async::MetricCounter* udp_rx;
+      Async::MetricCounter* udp_tx;
+    };
+    typedef std::map<uint32_t, TgMetrics> TgMetricsMap;
+
+    static const size_t MAX_TG_METRICS = 100;
 
     FramedTcpServer*                                m_srv;
     Async::UdpSocket*                               m_udp_sock;
@@ -197,6 +206,12 @@ class Reflector : public sigc::trackable
     uint32_t                                        m_random_qsy_hi;
     uint32_t                                        m_random_qsy_tg;
     Async::TcpServer<Async::HttpServerConnection>*  m_http_server;
+    TgMetricsMap                                    m_tg_metrics;
+    TgMetrics                                       m_other_tg_metrics;
+    Async::MetricCounter*                           m_udp_lost_cnt;
+    Async::MetricCounter*                           m_udp_out_of_seq_cnt;
+    Async::Timer                                    m_tick_timer;
+    std::vector<uint32_t>                           m_tick_client_ids;
 
     Reflector(const Reflector&);
     Reflector& operator=(const Reflector&);
@@ -214,6 +229,9 @@ class Reflector : public sigc::trackable
         Async::HttpServerConnection::DisconnectReason reason);
     void onRequestAutoQsy(uint32_t from_tg);
     uint32_t nextRandomQsyTg(void);
+    TgMetrics& tgMetrics(uint32_t tg);
+    void onTick(Async::Timer *t);
+    void collectMetrics(void);
 
 };  /* class Reflector */
 
@@ -44,7 +44,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
-#include <AsyncTimer.h>
+#include <AsyncSlabPool.h>
 #include <AsyncAudioEncoder.h>
 #include <AsyncAudioDecoder.h>
 #include <common.h>
@@ -94,6 +94,7 @@ using namespace Async;
  *
  ****************************************************************************/
 
+static SlabPool& clientPool(void);
 
 
 /****************************************************************************
@@ -120,6 +121,19 @@ uint32_t ReflectorClient::next_client_id = 0;
  *
  ****************************************************************************/
 
+void *ReflectorClient::operator new(size_t size)
+{
+  assert(size == sizeof(ReflectorClient));
+  return clientPool().allocate();
+} /* ReflectorClient::operator new */
+
+
+void ReflectorClient::operator delete(void *ptr)
+{
+  clientPool().deallocate(ptr);
+} /* ReflectorClient::operator delete */
+
+
 bool ReflectorClient::TgFilter::operator()(ReflectorClient* client) const
 {
   //cout << "m_tg=" << m_tg << "  client_tg="
@@ -131,10 +145,9 @@ bool ReflectorClient::TgFilter::operator()(ReflectorClient* client) const
 ReflectorClient::ReflectorClient(Reflector *ref, Async::FramedTcpConnection *con,
                                  Async::Config *cfg)
   : m_con(con), m_con_state(STATE_EXPECT_PROTO_VER),
-    m_disc_timer(10000, Timer::TYPE_ONESHOT, false),
+    m_disc_timeout_cnt(0),
     m_client_id(next_client_id++), m_remote_udp_port(0), m_cfg(cfg),
     m_next_udp_tx_seq(0), m_next_udp_rx_seq(0),
-    m_heartbeat_timer(1000, Timer::TYPE_PERIODIC),
     m_heartbeat_tx_cnt(HEARTBEAT_TX_CNT_RESET),
     m_heartbeat_rx_cnt(HEARTBEAT_RX_CNT_RESET),
     m_udp_heartbeat_tx_cnt(UDP_HEARTBEAT_TX_CNT_RESET),
@@ -145,10 +158,6 @@ ReflectorClient::ReflectorClient(Reflector *ref, Async::FramedTcpConnection *con
   m_con->setMaxFrameSize(ReflectorMsg::MAX_PREAUTH_FRAME_SIZE);
   m_con->frameReceived.connect(
       mem_fun(*this, &ReflectorClient::onFrameReceived));
-  m_disc_timer.expired.connect(
-      mem_fun(*this, &ReflectorClient::onDiscTimeout));
-  m_heartbeat_timer.expired.connect(
-      mem_fun(*this, &ReflectorClient::handleHeartbeat));
 
   string codecs;
   if (m_cfg->getValue("GLOBAL", "CODECS", codecs))
@@ -206,7 +215,8 @@ int ReflectorClient::sendMsg(const ReflectorMsg& msg)
     errno = EBADMSG;
     return -1;
   }
-  return m_con->write(ss.str().data(), ss.str().size());
+  const string buf(ss.str());
+  return m_con->write(buf.data(), buf.size());
 } /* ReflectorClient::sendMsg */
 
 
@@ -235,7 +245,8 @@ void ReflectorClient::sendUdpMsg(const ReflectorUdpMsg &msg)
   ReflectorUdpMsg header(msg.type(), clientId(), nextUdpTxSeq());
   ostringstream ss;
   assert(header.pack(ss) && msg.pack(ss));
-  (void)m_reflector->sendUdpDatagram(this, ss.str().data(), ss.str().size());
+  const string buf(ss.str());
+  (void)m_reflector->sendUdpDatagram(this, buf.data(), buf.size());
 } /* ReflectorClient::sendUdpMsg */
 
 
@@ -246,6 +257,25 @@ void ReflectorClient::setBlock(unsigned blocktime)
 } /* ReflectorClient::setBlock */
 
 
+void ReflectorClient::tick(void)
+{
+  switch (m_con_state)
+  {
+    case STATE_DISCONNECTED:
+      break;
+    case STATE_EXPECT_DISCONNECT:
+      if (--m_disc_timeout_cnt == 0)
+      {
+        disconnect();
+      }
+      break;
+    default:
+      handleHeartbeat();
+      break;
+  }
+} /* ReflectorClient::tick */
+
+
 /****************************************************************************
  *
  * Protected member functions
@@ -761,23 +791,14 @@ void ReflectorClient::handleMsgError(std::istream& is)
 void ReflectorClient::sendError(const std::string& msg)
 {
   sendMsg(MsgError(msg));
-  m_heartbeat_timer.setEnable(false);
   m_remote_udp_port = 0;
-  m_disc_timer.setEnable(true);
+  m_disc_timeout_cnt = DISC_TIMEOUT_CNT;
   m_con_state = STATE_EXPECT_DISCONNECT;
 } /* ReflectorClient::sendError */
 
 
-void ReflectorClient::onDiscTimeout(Timer *t)
-{
-  assert(m_con_state == STATE_EXPECT_DISCONNECT);
-  disconnect();
-} /* ReflectorClient::onDiscTimeout */
-
-
 void ReflectorClient::disconnect(void)
 {
-  m_heartbeat_timer.setEnable(false);
   m_remote_udp_port = 0;
   m_con->disconnect();
   m_con_state = STATE_DISCONNECTED;
@@ -785,7 +806,7 @@ void ReflectorClient::disconnect(void)
 } /* ReflectorClient::disconnect */
 
 
-void ReflectorClient::handleHeartbeat(Async::Timer *t)
+void ReflectorClient::handleHeartbeat(void)
 {
   if (--m_heartbeat_tx_cnt == 0)
   {
@@ -862,6 +883,23 @@ std::string ReflectorClient::lookupUserKey(const std::string& callsign)
 } /* ReflectorClient::lookupUserKey */
 
 
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+  // The pool is never destroyed since clients are deleted from tasks that
+  // may run after static destruction has begun
+static SlabPool& clientPool(void)
+{
+  static SlabPool *pool = new SlabPool(sizeof(ReflectorClient), 64);
+  return *pool;
+} /* clientPool */
+
+
+
 /*
  * This file has not been truncated
  */
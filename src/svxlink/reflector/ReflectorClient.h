@@ -45,7 +45,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <AsyncFramedTcpConnection.h>
-#include <AsyncTimer.h>
 #include <AsyncConfig.h>
 
 
@@ -235,6 +234,22 @@ class ReflectorClient
       return OrFilter<F1, F2>(f1, f2);
     }
 
+    /**
+     * @brief   Allocate memory for a client object
+     * @param   size The size of the object
+     * @return  Returns a pointer to the allocated memory
+     *
+     * Client objects are allocated from a pool so that a reflector with many
+     * clients that connect and disconnect does not fragment the heap.
+     */
+    static void *operator new(size_t size);
+
+    /**
+     * @brief   Free the memory for a client object
+     * @param   ptr Pointer to the memory to free
+     */
+    static void operator delete(void *ptr);
+
     /**
      * @brief 	Constructor
      * @param   ref The associated Reflector object
@@ -349,6 +364,16 @@ class ReflectorClient
      */
     bool isBlocked(void) const { return (m_remaining_blocktime > 0); }
 
+    /**
+     * @brief   Handle timers for this client
+     *
+     * This function is called by the Reflector once every second. It handle
+     * heartbeats, blocking and the disconnect timeout. Using one timer in
+     * the Reflector for all clients is cheaper than having timers in each
+     * client when there are many clients.
+     */
+    void tick(void);
+
     /**
      * @brief   Get the state of the connection
      * @return  Returns the state of the connection
@@ -420,18 +445,18 @@ class ReflectorClient
     static const unsigned HEARTBEAT_RX_CNT_RESET      = 15;
     static const unsigned UDP_HEARTBEAT_TX_CNT_RESET  = 15;
     static const unsigned UDP_HEARTBEAT_RX_CNT_RESET  = 120;
+    static const unsigned DISC_TIMEOUT_CNT            = 10;
 
     Async::FramedTcpConnection* m_con;
     unsigned char               m_auth_challenge[MsgAuthChallenge::CHALLENGE_LEN];
     ConState                    m_con_state;
-    Async::Timer                m_disc_timer;
+    unsigned                    m_disc_timeout_cnt;
     std::string                 m_callsign;
     uint32_t                    m_client_id;
     uint16_t                    m_remote_udp_port;
     Async::Config*              m_cfg;
     uint16_t                    m_next_udp_tx_seq;
     uint16_t                    m_next_udp_rx_seq;
-    Async::Timer                m_heartbeat_timer;
     unsigned                    m_heartbeat_tx_cnt;
     unsigned                    m_heartbeat_rx_cnt;
     unsigned                    m_udp_heartbeat_tx_cnt;
@@ -462,9 +487,8 @@ class ReflectorClient
     void handleStateEvent(std::istream& is);
     void handleMsgError(std::istream& is);
     void sendError(const std::string& msg);
-    void onDiscTimeout(Async::Timer *t);
     void disconnect(void);
-    void handleHeartbeat(Async::Timer *t);
+    void handleHeartbeat(void);
     std::string lookupUserKey(const std::string& callsign);
 
 };  /* class ReflectorClient */
@@ -0,0 +1,322 @@
+//
+// Benchmark for the memory use of the reflector under reconnect storms.
+//
+// A number of simulated clients are connected to a reflector. Each client is
+// a real FramedTcpConnection and ReflectorClient pair but without a socket,
+// since the event loop cannot watch thousands of file descriptors. On connect
+// the client send a protocol version message, which make the reflector
+// answer with an authentication challenge, and then a heartbeat now and
+// then. The clients are disconnected and connected again round robin so
+// that each client reconnect once every reconnect period. Client timers are
+// handled by a one second tick, like in the reflector.
+//
+// Every second the following is printed:
+//
+//   time     - Seconds since the start
+//   recon/s  - Reconnects per second
+//   alloc/s  - Heap allocations per second
+//   kB/s     - Allocated kilobytes per second
+//   alloc/rc - Heap allocations per reconnect
+//   rss_MB   - Resident set size in megabytes
+//
+// When done, the steady state RSS and allocation rate, measured after the
+// first two reconnect periods, is printed.
+//
+// Usage: ReflectorReconnectBench [clients] [seconds] [reconnect period ms]
+//                                [listen port]
+//
+
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <vector>
+
+#include <AsyncCppApplication.h>
+#include <AsyncConfig.h>
+#include <AsyncTimer.h>
+#include <AsyncFramedTcpConnection.h>
+
+#include "Reflector.h"
+#include "ReflectorClient.h"
+#include "ReflectorMsg.h"
+#include "TGHandler.h"
+
+using namespace std;
+using namespace Async;
+
+
+static const unsigned CHURN_INTERVAL = 100;
+
+static std::atomic<uint64_t> alloc_cnt(0);
+static std::atomic<uint64_t> alloc_bytes(0);
+
+
+void *operator new(size_t size)
+{
+  alloc_cnt.fetch_add(1, std::memory_order_relaxed);
+  alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+  void *ptr = malloc(size > 0 ? size : 1);
+  if (ptr == 0)
+  {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+
+void operator delete(void *ptr) noexcept
+{
+  free(ptr);
+}
+
+
+void operator delete(void *ptr, size_t) noexcept
+{
+  free(ptr);
+}
+
+
+static double rssMb(void)
+{
+  ifstream statm("/proc/self/statm");
+  unsigned long size = 0;
+  unsigned long resident = 0;
+  statm >> size >> resident;
+  return resident * sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+}
+
+
+static vector<uint8_t> packFrame(const ReflectorMsg& msg)
+{
+  ReflectorMsg header(msg.type());
+  ostringstream ss;
+  header.pack(ss);
+  msg.pack(ss);
+  const string str(ss.str());
+  return vector<uint8_t>(str.begin(), str.end());
+}
+
+
+class Bench : public sigc::trackable
+{
+  public:
+    Bench(ostream& out, Reflector *ref, Config *cfg, unsigned clients,
+          unsigned seconds, unsigned period)
+      : m_out(out), m_ref(ref), m_cfg(cfg), m_slots(clients),
+        m_seconds(seconds), m_period(period), m_next_slot(0), m_reconnects(0),
+        m_churn_timer(CHURN_INTERVAL, Timer::TYPE_PERIODIC),
+        m_tick_timer(1000, Timer::TYPE_PERIODIC), m_time(0),
+        m_last_reconnects(0), m_last_alloc_cnt(0), m_last_alloc_bytes(0),
+        m_steady_time(0), m_steady_rss(0.0), m_steady_reconnects(0),
+        m_steady_alloc_cnt(0), m_steady_alloc_bytes(0)
+    {
+      m_proto_ver_frame = packFrame(MsgProtoVer());
+      m_heartbeat_frame = packFrame(MsgHeartbeat());
+      for (unsigned i=0; i<m_slots.size(); ++i)
+      {
+        connectSlot(i);
+      }
+      m_churn_timer.expired.connect(mem_fun(*this, &Bench::onChurn));
+      m_tick_timer.expired.connect(mem_fun(*this, &Bench::onTick));
+      m_last_alloc_cnt = alloc_cnt;
+      m_last_alloc_bytes = alloc_bytes;
+
+      m_steady_time = 2 * m_period / 1000 + 1;
+      if (m_steady_time >= m_seconds)
+      {
+        m_steady_time = 0;
+      }
+
+      m_out << setw(6) << "time" << setw(10) << "recon/s" << setw(10)
+            << "alloc/s" << setw(10) << "kB/s" << setw(10) << "alloc/rc"
+            << setw(10) << "rss_MB" << endl;
+    }
+
+    ~Bench(void)
+    {
+      for (unsigned i=0; i<m_slots.size(); ++i)
+      {
+        disconnectSlot(i);
+      }
+    }
+
+  private:
+    struct Slot
+    {
+      FramedTcpConnection*  con = 0;
+      ReflectorClient*      client = 0;
+      unsigned              heartbeat_cnt = 0;
+    };
+
+    ostream&          m_out;
+    Reflector*        m_ref;
+    Config*           m_cfg;
+    vector<Slot>      m_slots;
+    unsigned          m_seconds;
+    unsigned          m_period;
+    unsigned          m_next_slot;
+    uint64_t          m_reconnects;
+    Timer             m_churn_timer;
+    Timer             m_tick_timer;
+    unsigned          m_time;
+    uint64_t          m_last_reconnects;
+    uint64_t          m_last_alloc_cnt;
+    uint64_t          m_last_alloc_bytes;
+    unsigned          m_steady_time;
+    double            m_steady_rss;
+    uint64_t          m_steady_reconnects;
+    uint64_t          m_steady_alloc_cnt;
+    uint64_t          m_steady_alloc_bytes;
+    vector<uint8_t>   m_proto_ver_frame;
+    vector<uint8_t>   m_heartbeat_frame;
+
+    void connectSlot(unsigned i)
+    {
+      Slot& slot = m_slots[i];
+      slot.con = new FramedTcpConnection(-1, IpAddress("127.0.0.1"),
+                                         10000 + i % 50000);
+      slot.client = new ReflectorClient(m_ref, slot.con, m_cfg);
+      slot.heartbeat_cnt = i % 10;
+      slot.con->frameReceived(slot.con, m_proto_ver_frame);
+    }
+
+    void disconnectSlot(unsigned i)
+    {
+      Slot& slot = m_slots[i];
+      delete slot.client;
+      slot.client = 0;
+      delete slot.con;
+      slot.con = 0;
+    }
+
+    void onChurn(Timer *t)
+    {
+      unsigned cnt = m_slots.size() * CHURN_INTERVAL / m_period;
+      for (unsigned n=0; n<cnt; ++n)
+      {
+        disconnectSlot(m_next_slot);
+        connectSlot(m_next_slot);
+        m_next_slot = (m_next_slot + 1) % m_slots.size();
+        ++m_reconnects;
+      }
+    }
+
+    void onTick(Timer *t)
+    {
+      for (auto& slot : m_slots)
+      {
+        slot.client->tick();
+        if (++slot.heartbeat_cnt == 10)
+        {
+          slot.heartbeat_cnt = 0;
+          slot.con->frameReceived(slot.con, m_heartbeat_frame);
+        }
+      }
+
+      ++m_time;
+      const uint64_t reconnects = m_reconnects - m_last_reconnects;
+      const uint64_t allocs = alloc_cnt - m_last_alloc_cnt;
+      const uint64_t bytes = alloc_bytes - m_last_alloc_bytes;
+      const double allocs_per_reconnect =
+        (reconnects > 0) ? static_cast<double>(allocs) / reconnects : 0.0;
+      const double rss = rssMb();
+      m_out << fixed << setw(6) << m_time << setw(10) << reconnects
+            << setw(10) << allocs
+            << setw(10) << setprecision(0) << (bytes / 1024.0)
+            << setw(10) << setprecision(1) << allocs_per_reconnect
+            << setw(10) << rss << endl;
+      m_last_reconnects = m_reconnects;
+      m_last_alloc_cnt = alloc_cnt;
+      m_last_alloc_bytes = alloc_bytes;
+
+      if (m_time == m_steady_time)
+      {
+        m_steady_rss = rss;
+        m_steady_reconnects = m_reconnects;
+        m_steady_alloc_cnt = alloc_cnt;
+        m_steady_alloc_bytes = alloc_bytes;
+      }
+
+      if (m_time >= m_seconds)
+      {
+        const double secs = m_time - m_steady_time;
+        const uint64_t steady_reconnects = m_reconnects - m_steady_reconnects;
+        const uint64_t steady_allocs = alloc_cnt - m_steady_alloc_cnt;
+        m_out << endl << "clients:            " << m_slots.size() << endl
+              << "steady state from:  " << m_steady_time << " s" << endl
+              << "rss:                " << setprecision(1) << m_steady_rss
+              << " -> " << rss << " MB" << endl
+              << "reconnects/s:       " << setprecision(0)
+              << (steady_reconnects / secs) << endl
+              << "allocations/s:      " << (steady_allocs / secs) << endl
+              << "allocated kB/s:     "
+              << ((alloc_bytes - m_steady_alloc_bytes) / 1024.0 / secs)
+              << endl
+              << "allocs/reconnect:   " << setprecision(1)
+              << (steady_reconnects > 0 ?
+                  static_cast<double>(steady_allocs) / steady_reconnects : 0.0)
+              << endl;
+        Application::app().quit();
+      }
+    }
+};
+
+
+int main(int argc, const char **argv)
+{
+  unsigned clients = 5000;
+  unsigned seconds = 30;
+  unsigned period = 5000;
+  string listen_port = "15300";
+  if (argc > 1)
+  {
+    clients = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    seconds = atoi(argv[2]);
+  }
+  if (argc > 3)
+  {
+    period = atoi(argv[3]);
+  }
+  if (argc > 4)
+  {
+    listen_port = argv[4];
+  }
+  if ((clients == 0) || (seconds == 0) || (period < CHURN_INTERVAL))
+  {
+    cerr << "Usage: ReflectorReconnectBench [clients] [seconds] "
+            "[reconnect period ms] [listen port]" << endl;
+    return 1;
+  }
+
+  CppApplication app;
+
+  Config cfg;
+  cfg.setValue("GLOBAL", "LISTEN_PORT", listen_port);
+  Reflector ref;
+  if (!ref.initialize(cfg))
+  {
+    cerr << "*** ERROR: Could not initialize the reflector" << endl;
+    return 1;
+  }
+
+    // Silence the client log messages
+  ostream out(cout.rdbuf());
+  ofstream null_stream;
+  streambuf *cout_buf = cout.rdbuf(null_stream.rdbuf());
+  {
+    Bench bench(out, &ref, &cfg, clients, seconds, period);
+    app.exec();
+  }
+  cout.rdbuf(cout_buf);
+
+  return 0;
+}
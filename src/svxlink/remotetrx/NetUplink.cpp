@@ -52,6 +52,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncAudioSplitter.h>
 #include <AsyncAudioSelector.h>
 #include <AsyncAudioPassthrough.h>
+#include <AsyncAudioLatencyProbe.h>
+#include <AsyncAudioSilenceGate.h>
 
 
 /****************************************************************************
@@ -125,10 +127,10 @@ using namespace NetTrxMsg;
 
 NetUplink::NetUplink(Config &cfg, const string &name, Rx *rx, Tx *tx,
       	      	     const string& port_str)
-  : server(0), con(0), recv_cnt(0), recv_exp(0), rx(rx), tx(tx), fifo(0),
-    cfg(cfg), name(name), last_msg_timestamp(), heartbeat_timer(0),
-    audio_enc(0), audio_dec(0), loopback_con(0), rx_splitter(0),
-    tx_selector(0), state(STATE_DISC), mute_tx_timer(0), tx_muted(false),
+  : server(0), tx_ctrl_client(0), max_clients(1), rx(rx), tx(tx), fifo(0),
+    cfg(cfg), name(name), heartbeat_timer(0), loopback_con(0),
+    rx_splitter(0), rx_gate(0), enc_splitter(0), tx_selector(0),
+    mute_tx_timer(0), tx_muted(false),
     fallback_enabled(false), tx_ctrl_mode(Tx::TX_OFF)
 {
   heartbeat_timer = new Timer(10000);
@@ -146,11 +148,19 @@ NetUplink::NetUplink(Config &cfg, const string &name, Rx *rx, Tx *tx,
 
 NetUplink::~NetUplink(void)
 {
-  delete audio_enc;
-  delete audio_dec;
+  for (ClientList::iterator it=clients.begin(); it!=clients.end(); ++it)
+  {
+    Client *client = *it;
+    unsubscribe(client);
+    delete client->audio_dec;
+    delete client;
+  }
+  clients.clear();
   delete fifo;
   delete tx_selector;
   delete rx_splitter;
+  delete rx_gate;
+  delete enc_splitter;
   delete loopback_con;
   delete server;
   delete heartbeat_timer;
@@ -193,7 +203,24 @@ bool NetUplink::initialize(void)
   
   cfg.getValue(name, "FALLBACK_REPEATER", fallback_enabled, true);
   cfg.getValue(name, "AUTH_KEY", auth_key, true);
+  if (!cfg.getValue(name, "MAX_CLIENTS", 1U, 100U, max_clients, true))
+  {
+    cerr << "*** ERROR: Illegal value for config variable " << name
+         << "/MAX_CLIENTS. Valid range is 1 to 100.\n";
+    return false;
+  }
   
+  bool silence_gate = true;
+  cfg.getValue(name, "SILENCE_GATE", silence_gate, true);
+  unsigned silence_hangtime = 100;
+  if (!cfg.getValue(name, "SILENCE_HANGTIME", 0U, 10000U, silence_hangtime,
+                    true))
+  {
+    cerr << "*** ERROR: Illegal value for config variable " << name
+         << "/SILENCE_HANGTIME. Valid range is 0 to 10000.\n";
+    return false;
+  }
+
   int mute_tx_on_rx = -1;
   cfg.getValue(name, "MUTE_TX_ON_RX", mute_tx_on_rx, true);
   if (mute_tx_on_rx >= 0)
@@ -227,6 +254,18 @@ bool NetUplink::initialize(void)
   
   rx_splitter->addSink(loopback_con);
 
+    // The RX audio encoders are fed through a silence gate. Runs of digital
+    // silence are sent as MsgSilence instead of being encoded and nothing
+    // at all is encoded while the squelch is closed.
+  rx_gate = new AudioSilenceGate;
+  rx_gate->setEnabled(silence_gate);
+  rx_gate->setHangtime(silence_hangtime * INTERNAL_SAMPLE_RATE / 1000);
+  rx_gate->setSuspended(!rx->squelchIsOpen());
+  rx_gate->silenceDetected.connect(mem_fun(*this, &NetUplink::writeSilence));
+  rx_splitter->addSink(rx_gate);
+  enc_splitter = new AudioSplitter;
+  rx_gate->registerSink(enc_splitter);
+
   tx_selector = new AudioSelector;
   tx_selector->addSource(loopback_con);
 
@@ -234,7 +273,11 @@ bool NetUplink::initialize(void)
   tx_selector->addSource(fifo);
   tx_selector->selectSource(fifo);
 
-  tx_selector->registerSink(tx);
+    // Mark the point where audio from the network leave the jitter buffer
+    // when tracing latency
+  AudioLatencyProbe *tx_latency_probe = new AudioLatencyProbe(name + ":tx");
+  tx_selector->registerSink(tx_latency_probe, true);
+  tx_latency_probe->registerSink(tx);
   
   if (fallback_enabled)
   {
@@ -268,47 +311,39 @@ bool NetUplink::initialize(void)
 
 void NetUplink::handleIncomingConnection(TcpConnection *incoming_con)
 {
-  assert(con == 0);
-  rx->reset();
-  if (fallback_enabled) // Deactivate fallback repeater mode
+  if (clients.empty())
   {
-    setFallbackActive(false);
-  }
-  
-  if (audio_enc != 0)
-  {
-    rx_splitter->removeSink(audio_enc);
-    delete audio_enc;
-    audio_enc = 0;
+    rx->reset();
+    if (fallback_enabled) // Deactivate fallback repeater mode
+    {
+      setFallbackActive(false);
+    }
+    heartbeat_timer->setEnable(true);
   }
-  
-  delete audio_dec;
-  audio_dec = 0;
-  
-  con = incoming_con;
-  con->dataReceived.connect(mem_fun(*this, &NetUplink::tcpDataReceived));
-  recv_exp = sizeof(Msg);
-  recv_cnt = 0;
-  heartbeat_timer->setEnable(true);
-  gettimeofday(&last_msg_timestamp, NULL);
-  
-  setState(STATE_CON_SETUP);
+
+  Client *client = new Client(incoming_con);
+  clients.push_back(client);
+  incoming_con->dataReceived.connect(
+      sigc::bind(mem_fun(*this, &NetUplink::tcpDataReceived), client));
+  client->recv_exp = sizeof(Msg);
+  client->recv_cnt = 0;
+  gettimeofday(&client->last_msg_timestamp, NULL);
 
   MsgProtoVer *ver_msg = new MsgProtoVer;
-  sendMsg(ver_msg);
+  sendMsg(client, ver_msg);
   
   if (auth_key.empty())
   {
     MsgAuthOk *auth_msg = new MsgAuthOk;
-    sendMsg(auth_msg);
-    setState(STATE_READY);
+    sendMsg(client, auth_msg);
+    clientReady(client);
   }
   else
   {
     MsgAuthChallenge *auth_msg = new MsgAuthChallenge;
-    memcpy(auth_challenge, auth_msg->challenge(),
+    memcpy(client->auth_challenge, auth_msg->challenge(),
            MsgAuthChallenge::CHALLENGE_LEN);
-    sendMsg(auth_msg);
+    sendMsg(client, auth_msg);
   }
 } /* NetUplink::handleIncomingConnection */
 
@@ -317,54 +352,155 @@ void NetUplink::clientConnected(TcpConnection *incoming_con)
 {
   cout << name << ": Client connected: " << incoming_con->remoteHost() << ":"
        << incoming_con->remotePort() << endl;
-  
-  switch (state)
+
+    // Clients still being cleaned up are counted too
+  if (clients.size() >= max_clients)
   {
-    case STATE_DISC:
-      handleIncomingConnection(incoming_con);
-      break;
-    case STATE_CON_SETUP:
-    case STATE_READY:
+    if (max_clients == 1)
+    {
       cout << name << ": Only one client allowed. Disconnecting...\n";
-      // Fall through
-    case STATE_DISC_CLEANUP:
-      incoming_con->disconnect();
-      break;
+    }
+    else
+    {
+      cout << name << ": Only " << max_clients << " clients allowed. "
+           << "Disconnecting...\n";
+    }
+    incoming_con->disconnect();
+    return;
   }
+
+  handleIncomingConnection(incoming_con);
 } /* NetUplink::clientConnected */
 
 
-void NetUplink::disconnectCleanup(void)
+void NetUplink::clientReady(Client *client)
 {
-  con = 0;
-  recv_exp = 0;
-  setState(STATE_DISC);
+    // The client may have been disconnected on a write error
+  if (client->state != STATE_CON_SETUP)
+  {
+    return;
+  }
+  client->state = STATE_READY;
+  if (tx_ctrl_client == 0)
+  {
+    setTxCtrlClient(client);
+  }
+  else
+  {
+    cout << name << ": Client " << client->con->remoteHost() << ":"
+         << client->con->remotePort() << " is receive only since "
+         << tx_ctrl_client->con->remoteHost() << ":"
+         << tx_ctrl_client->con->remotePort()
+         << " control the transmitter\n";
+  }
+} /* NetUplink::clientReady */
 
-  rx->reset();
-  tx->enableCtcss(false);
-  fifo->clear();
-  if (audio_dec != 0)
+
+/*
+ *----------------------------------------------------------------------------
+ * Method:    NetUplink::setTxCtrlClient
+ * Purpose:   Hand over control of the transmitter and the receiver settings
+ *            to the given client. The TX and RX settings last requested by
+ *            the client are applied, including a pending receiver reset,
+ *            since they may have been sent while another client was in
+ *            control.
+ * Input:     client - The client to hand over control to
+ * Output:    None
+ * Author:    agent
+ * Created:   2026-10-17
+ * Remarks:
+ * Bugs:
+ *----------------------------------------------------------------------------
+ */
+void NetUplink::setTxCtrlClient(Client *client)
+{
+  cout << name << ": Client " << client->con->remoteHost() << ":"
+       << client->con->remotePort() << " now control the transmitter\n";
+  tx_ctrl_client = client;
+  if (client->audio_dec != 0)
   {
-    audio_dec->flushEncodedSamples();
+    client->audio_dec->registerSink(fifo);
   }
-  tx->setTxCtrlMode(Tx::TX_OFF);
-  heartbeat_timer->setEnable(false);
+  if (client->rx_reset_pending)
+  {
+    client->rx_reset_pending = false;
+    rx->reset();
+  }
+  if (client->rx_fq != 0)
+  {
+    cout << rx->name() << ": SetRxFq(" << client->rx_fq << ")\n";
+    rx->setFq(client->rx_fq);
+  }
+  if (client->rx_mod != Modulation::MOD_UNKNOWN)
+  {
+    cout << rx->name() << ": SetRxModulation("
+         << Modulation::toString(client->rx_mod) << ")\n";
+    rx->setModulation(client->rx_mod);
+  }
+  rx->setMuteState(client->rx_mute_state);
+  tx->enableCtcss(client->ctcss_enabled);
+  tx_ctrl_mode = client->tx_ctrl_mode;
+  if (!tx_muted)
+  {
+    tx->setTxCtrlMode(tx_ctrl_mode);
+  }
+} /* NetUplink::setTxCtrlClient */
 
-  if (mute_tx_timer != 0)
+
+void NetUplink::disconnectCleanup(Client *client)
+{
+  clients.remove(client);
+  unsubscribe(client);
+
+  if (client == tx_ctrl_client)
   {
-    mute_tx_timer->setEnable(false);
+    tx_ctrl_client = 0;
+    tx->enableCtcss(false);
+    fifo->clear();
+    if (client->audio_dec != 0)
+    {
+      client->audio_dec->flushEncodedSamples();
+    }
+    tx->setTxCtrlMode(Tx::TX_OFF);
+
+    if (mute_tx_timer != 0)
+    {
+      mute_tx_timer->setEnable(false);
+    }
+
+    tx_muted = false;
+    tx_ctrl_mode = Tx::TX_OFF;
   }
+  delete client->audio_dec;
+  delete client;
 
-  tx_muted = false;
-  tx_ctrl_mode = Tx::TX_OFF;
-    
-  if (fallback_enabled)
+  if (clients.empty())
   {
-    setFallbackActive(true);
+    rx->reset();
+    heartbeat_timer->setEnable(false);
+
+    if (fallback_enabled)
+    {
+      setFallbackActive(true);
+    }
+    else
+    {
+      rx->setMuteState(Rx::MUTE_CONTENT);
+    }
+    return;
   }
-  else
+
+  if (tx_ctrl_client == 0)
   {
-    rx->setMuteState(Rx::MUTE_CONTENT);
+      // Hand over control to the client that has been connected the longest
+    for (ClientList::iterator it=clients.begin(); it!=clients.end(); ++it)
+    {
+      if ((*it)->state == STATE_READY)
+      {
+        setTxCtrlClient(*it);
+        break;
+      }
+    }
   }
 } /* NetUplink::disconnectCleanup */
 
@@ -372,15 +508,28 @@ void NetUplink::disconnectCleanup(void)
 void NetUplink::clientDisconnected(TcpConnection *the_con,
                                    TcpConnection::DisconnectReason reason)
 {
+  ClientList::iterator it = clients.begin();
+  while ((it != clients.end()) && ((*it)->con != the_con))
+  {
+    ++it;
+  }
+  if (it == clients.end())
+  {
+    return;
+  }
+
   cout << name << ": Client disconnected: " << the_con->remoteHost() << ":"
        << the_con->remotePort() << endl;
-  con = 0;
-  setState(STATE_DISC_CLEANUP);
-  Application::app().runTask(mem_fun(*this, &NetUplink::disconnectCleanup));
+  Client *client = *it;
+  client->con = 0;
+  client->state = STATE_DISC_CLEANUP;
+  Application::app().runTask(
+      sigc::bind(mem_fun(*this, &NetUplink::disconnectCleanup), client));
 } /* NetUplink::clientDisconnected */
 
 
-int NetUplink::tcpDataReceived(TcpConnection *con, void *data, int size)
+int NetUplink::tcpDataReceived(TcpConnection *con, void *data, int size,
+                               Client *client)
 {
   //cout << "NetRx::tcpDataReceived: size=" << size << endl;
   
@@ -389,12 +538,12 @@ int NetUplink::tcpDataReceived(TcpConnection *con, void *data, int size)
   //     << " and size " << msg->size() << endl;
   
     // Discard data if we are not in one of the "connected" states
-  if ((state != STATE_CON_SETUP) && (state != STATE_READY))
+  if ((client->state != STATE_CON_SETUP) && (client->state != STATE_READY))
   {
     return size;
   }
 
-  if (recv_exp == 0)
+  if (client->recv_exp == 0)
   {
     cerr << "*** ERROR: Unexpected TCP data received in NetUplink "
          << name << ". Throwing it away...\n";
@@ -406,49 +555,53 @@ int NetUplink::tcpDataReceived(TcpConnection *con, void *data, int size)
   char *buf = static_cast<char*>(data);
   while (size > 0)
   {
-    unsigned read_cnt = min(static_cast<unsigned>(size), recv_exp-recv_cnt);
-    if (recv_cnt+read_cnt > sizeof(recv_buf))
+    unsigned read_cnt = min(static_cast<unsigned>(size),
+                            client->recv_exp - client->recv_cnt);
+    if (client->recv_cnt+read_cnt > sizeof(client->recv_buf))
     {
       cerr << "*** ERROR: TCP receive buffer overflow in NetUplink "
            << name << ". Disconnecting...\n";
-      forceDisconnect();
+      forceDisconnect(client);
       return orig_size;
     }
-    memcpy(recv_buf+recv_cnt, buf, read_cnt);
+    memcpy(client->recv_buf+client->recv_cnt, buf, read_cnt);
     size -= read_cnt;
-    recv_cnt += read_cnt;
+    client->recv_cnt += read_cnt;
     buf += read_cnt;
     
-    if (recv_cnt == recv_exp)
+    if (client->recv_cnt == client->recv_exp)
     {
-      if (recv_exp == sizeof(Msg))
+      Msg *msg = reinterpret_cast<Msg*>(client->recv_buf);
+      if (client->recv_exp == sizeof(Msg))
       {
-      	Msg *msg = reinterpret_cast<Msg*>(recv_buf);
 	if (msg->size() == sizeof(Msg))
 	{
-	  handleMsg(msg);
-	  recv_cnt = 0;
-	  recv_exp = sizeof(Msg);
+	  client->recv_cnt = 0;
+	  client->recv_exp = sizeof(Msg);
+	  handleMsg(client, msg);
 	}
 	else if (msg->size() > sizeof(Msg))
 	{
-      	  recv_exp = msg->size();
+      	  client->recv_exp = msg->size();
 	}
 	else
 	{
 	  cerr << "*** ERROR: Illegal message header received in NetUplink "
                << name << ". Header length too small (" << msg->size()
                << ")\n";
-          forceDisconnect();
+          forceDisconnect(client);
 	  return orig_size;
 	}
       }
       else
       {
-      	Msg *msg = reinterpret_cast<Msg*>(recv_buf);
-      	handleMsg(msg);
-	recv_cnt = 0;
-	recv_exp = sizeof(Msg);
+	client->recv_cnt = 0;
+	client->recv_exp = sizeof(Msg);
+      	handleMsg(client, msg);
+      }
+      if (client->state == STATE_DISC_CLEANUP)
+      {
+        return orig_size;
       }
     }
   }
@@ -458,11 +611,10 @@ int NetUplink::tcpDataReceived(TcpConnection *con, void *data, int size)
 } /* NetUplink::tcpDataReceived */
 
 
-void NetUplink::handleMsg(Msg *msg)
+void NetUplink::handleMsg(Client *client, Msg *msg)
 {
-  switch (state)
+  switch (client->state)
   {
-    case STATE_DISC:
     case STATE_DISC_CLEANUP:
       return;
       
@@ -471,24 +623,24 @@ void NetUplink::handleMsg(Msg *msg)
           msg->size() == sizeof(MsgAuthResponse))
       {
         MsgAuthResponse *resp_msg = reinterpret_cast<MsgAuthResponse *>(msg);
-        if (!resp_msg->verify(auth_key, auth_challenge))
+        if (!resp_msg->verify(auth_key, client->auth_challenge))
         {
           cerr << "*** ERROR: Authentication error in NetUplink "
                << name << ".\n";
-          forceDisconnect();
+          forceDisconnect(client);
           return;
         }
         else
         {
           MsgAuthOk *ok_msg = new MsgAuthOk;
-          sendMsg(ok_msg);
+          sendMsg(client, ok_msg);
         }
-        setState(STATE_READY);
+        clientReady(client);
       }
       else
       {
         cerr << "*** ERROR: Protocol error in NetUplink " << name << ".\n";
-        forceDisconnect();
+        forceDisconnect(client);
       }
       return;
     
@@ -496,7 +648,12 @@ void NetUplink::handleMsg(Msg *msg)
       break;
   }
   
-  gettimeofday(&last_msg_timestamp, NULL);
+  gettimeofday(&client->last_msg_timestamp, NULL);
+
+    // Only the client in control may change the transmitter and receiver
+    // settings. Settings that are kept per client are applied if the client
+    // take over control.
+  const bool is_ctrl = (client == tx_ctrl_client);
   
   switch (msg->type())
   {
@@ -507,34 +664,54 @@ void NetUplink::handleMsg(Msg *msg)
     
     case MsgReset::TYPE:
     {
-      rx->reset();
+      if (is_ctrl)
+      {
+        rx->reset();
+      }
+      else
+      {
+        client->rx_reset_pending = true;
+      }
       break;
     }
     
     case MsgSetRxFq::TYPE:
     {
       MsgSetRxFq *fq_msg = reinterpret_cast<MsgSetRxFq*>(msg);
-      cout << rx->name() << ": SetRxFq(" << fq_msg->fq() << ")\n";
-      rx->setFq(fq_msg->fq());
+      client->rx_fq = fq_msg->fq();
+      if (is_ctrl)
+      {
+        cout << rx->name() << ": SetRxFq(" << fq_msg->fq() << ")\n";
+        rx->setFq(fq_msg->fq());
+      }
       break;
     }
 
     case MsgSetRxModulation::TYPE:
     {
-      MsgSetRxModulation *mod_msg = reinterpret_cast<MsgSetRxModulation*>(msg);
-      cout << rx->name() << ": SetRxModulation("
-           << Modulation::toString(mod_msg->modulation()) << ")\n";
-      rx->setModulation(mod_msg->modulation());
+      MsgSetRxModulation *mod_msg =
+        reinterpret_cast<MsgSetRxModulation*>(msg);
+      client->rx_mod = mod_msg->modulation();
+      if (is_ctrl)
+      {
+        cout << rx->name() << ": SetRxModulation("
+             << Modulation::toString(mod_msg->modulation()) << ")\n";
+        rx->setModulation(mod_msg->modulation());
+      }
       break;
     }
 
     case MsgSetMuteState::TYPE:
     {
       MsgSetMuteState *mute_msg = reinterpret_cast<MsgSetMuteState*>(msg);
-      cout << rx->name() << ": SetMuteState("
-           << Rx::muteStateToString(mute_msg->muteState())
-      	   << ")\n";
-      rx->setMuteState(mute_msg->muteState());
+      client->rx_mute_state = mute_msg->muteState();
+      if (is_ctrl)
+      {
+        cout << rx->name() << ": SetMuteState("
+             << Rx::muteStateToString(mute_msg->muteState())
+             << ")\n";
+        rx->setMuteState(mute_msg->muteState());
+      }
       break;
     }
     
@@ -552,10 +729,14 @@ void NetUplink::handleMsg(Msg *msg)
     case MsgSetTxCtrlMode::TYPE:
     {
       MsgSetTxCtrlMode *mode_msg = reinterpret_cast<MsgSetTxCtrlMode *>(msg);
-      tx_ctrl_mode = mode_msg->mode();
-      if (!tx_muted)
+      client->tx_ctrl_mode = mode_msg->mode();
+      if (is_ctrl)
       {
-	tx->setTxCtrlMode(tx_ctrl_mode);
+        tx_ctrl_mode = mode_msg->mode();
+        if (!tx_muted)
+        {
+          tx->setTxCtrlMode(tx_ctrl_mode);
+        }
       }
       break;
     }
@@ -563,129 +744,107 @@ void NetUplink::handleMsg(Msg *msg)
     case MsgEnableCtcss::TYPE:
     {
       MsgEnableCtcss *ctcss_msg = reinterpret_cast<MsgEnableCtcss *>(msg);
-      tx->enableCtcss(ctcss_msg->enable());
+      client->ctcss_enabled = ctcss_msg->enable();
+      if (is_ctrl)
+      {
+        tx->enableCtcss(ctcss_msg->enable());
+      }
       break;
     }
      
     case MsgSendDtmf::TYPE:
     {
-      MsgSendDtmf *dtmf_msg = reinterpret_cast<MsgSendDtmf *>(msg);
-      tx->sendDtmf(dtmf_msg->digits(), dtmf_msg->duration());
+      if (is_ctrl)
+      {
+        MsgSendDtmf *dtmf_msg = reinterpret_cast<MsgSendDtmf *>(msg);
+        tx->sendDtmf(dtmf_msg->digits(), dtmf_msg->duration());
+      }
       break;
     }
     
     case MsgRxAudioCodecSelect::TYPE:
     {
-      MsgRxAudioCodecSelect *codec_msg = 
-          reinterpret_cast<MsgRxAudioCodecSelect *>(msg);
-      if (audio_enc != 0)
-      {
-	rx_splitter->removeSink(audio_enc);
-	delete audio_enc;
-      }
-      audio_enc = AudioEncoder::create(codec_msg->name());
-      if (audio_enc != 0)
-      {
-        audio_enc->writeEncodedSamples.connect(
-                mem_fun(*this, &NetUplink::writeEncodedSamples));
-        audio_enc->flushEncodedSamples.connect(
-                mem_fun(*audio_enc, &AudioEncoder::allEncodedSamplesFlushed));
-        //audio_enc->registerSource(rx);
-	rx_splitter->addSink(audio_enc);
-        cout << name << ": Using CODEC \"" << audio_enc->name()
-             << "\" to encode RX audio\n";
-	
-	MsgRxAudioCodecSelect::Opts opts;
-	codec_msg->options(opts);
-	MsgRxAudioCodecSelect::Opts::const_iterator it;
-	for (it=opts.begin(); it!=opts.end(); ++it)
-	{
-	  audio_enc->setOption((*it).first, (*it).second);
-	}
-	audio_enc->printCodecParams();
-      }
-      else
-      {
-        cerr << "*** ERROR: Received request for unknown RX audio codec ("
-             << codec_msg->name() << ") in NetUplink " << name << "\n";
-      }
+      selectRxCodec(client, reinterpret_cast<MsgRxAudioCodecSelect *>(msg));
       break;
     }
     
     case MsgTxAudioCodecSelect::TYPE:
     {
-      MsgTxAudioCodecSelect *codec_msg = 
-          reinterpret_cast<MsgTxAudioCodecSelect *>(msg);
-      delete audio_dec;
-      audio_dec = AudioDecoder::create(codec_msg->name());
-      if (audio_dec != 0)
-      {
-        audio_dec->registerSink(fifo);
-        audio_dec->allEncodedSamplesFlushed.connect(
-            mem_fun(*this, &NetUplink::allEncodedSamplesFlushed));
-        cout << name << ": Using CODEC \"" << audio_dec->name()
-             << "\" to decode TX audio\n";
-	
-	MsgRxAudioCodecSelect::Opts opts;
-	codec_msg->options(opts);
-	MsgTxAudioCodecSelect::Opts::const_iterator it;
-	for (it=opts.begin(); it!=opts.end(); ++it)
-	{
-	  audio_dec->setOption((*it).first, (*it).second);
-	}
-	audio_dec->printCodecParams();
-      }
-      else
-      {
-        cerr << "*** ERROR: Received request for unknown TX audio codec ("
-             << codec_msg->name() << ") in NetUplink " << name << "\n";
-      }
+      selectTxCodec(client, reinterpret_cast<MsgTxAudioCodecSelect *>(msg));
       break;
     }
     
     case MsgAudio::TYPE:
     {
       //cout << "NetUplink [MsgAudio]\n";
-      if (!tx_muted && (audio_dec != 0))
+      if (is_ctrl && !tx_muted && (client->audio_dec != 0))
       {
         MsgAudio *audio_msg = reinterpret_cast<MsgAudio*>(msg);
-        audio_dec->writeEncodedSamples(audio_msg->buf(), audio_msg->size());
+        client->audio_dec->writeEncodedSamples(audio_msg->buf(),
+                                               audio_msg->size());
+      }
+      break;
+    }
+    
+    case MsgSilence::TYPE:
+    {
+      if (is_ctrl && !tx_muted && (client->audio_dec != 0))
+      {
+        MsgSilence *silence_msg = reinterpret_cast<MsgSilence*>(msg);
+        client->audio_dec->writeSilence(silence_msg->count());
       }
       break;
     }
     
     case MsgFlush::TYPE:
     {
-      if (audio_dec != 0)
+      if (!is_ctrl)
+      {
+          // Audio from a client not in control is thrown away so it is
+          // flushed right away
+        MsgAllSamplesFlushed *flushed_msg = new MsgAllSamplesFlushed;
+        sendMsg(client, flushed_msg);
+      }
+      else if (client->audio_dec != 0)
       {
-        audio_dec->flushEncodedSamples();
+        client->audio_dec->flushEncodedSamples();
       }
       break;
     } 
 
     case MsgTransmittedSignalStrength::TYPE:
     {
-      MsgTransmittedSignalStrength *siglev_msg =
-        reinterpret_cast<MsgTransmittedSignalStrength *>(msg);
-      tx->setTransmittedSignalStrength(siglev_msg->sqlRxId(),
-                                       siglev_msg->signalStrength());
+      if (is_ctrl)
+      {
+        MsgTransmittedSignalStrength *siglev_msg =
+          reinterpret_cast<MsgTransmittedSignalStrength *>(msg);
+        tx->setTransmittedSignalStrength(siglev_msg->sqlRxId(),
+                                         siglev_msg->signalStrength());
+      }
       break;
     }
     
     case MsgSetTxFq::TYPE:
     {
-      MsgSetTxFq *fq_msg = reinterpret_cast<MsgSetTxFq*>(msg);
-      cout << tx->name() << ": SetTxFq(" << fq_msg->fq() << ")\n";
-      tx->setFq(fq_msg->fq());
+      if (is_ctrl)
+      {
+        MsgSetTxFq *fq_msg = reinterpret_cast<MsgSetTxFq*>(msg);
+        cout << tx->name() << ": SetTxFq(" << fq_msg->fq() << ")\n";
+        tx->setFq(fq_msg->fq());
+      }
       break;
     }
 
     case MsgSetTxModulation::TYPE:
     {
-      MsgSetTxModulation *mod_msg = reinterpret_cast<MsgSetTxModulation*>(msg);
-      cout << tx->name() << ": SetTxModulation("
-           << Modulation::toString(mod_msg->modulation()) << ")\n";
-      tx->setModulation(mod_msg->modulation());
+      if (is_ctrl)
+      {
+        MsgSetTxModulation *mod_msg =
+          reinterpret_cast<MsgSetTxModulation*>(msg);
+        cout << tx->name() << ": SetTxModulation("
+             << Modulation::toString(mod_msg->modulation()) << ")\n";
+        tx->setModulation(mod_msg->modulation());
+      }
       break;
     }
 
@@ -699,28 +858,194 @@ void NetUplink::handleMsg(Msg *msg)
 } /* NetUplink::handleMsg */
 
 
-void NetUplink::sendMsg(Msg *msg)
+bool NetUplink::writeMsg(Client *client, const Msg *msg)
+{
+  if ((client->state != STATE_CON_SETUP) && (client->state != STATE_READY))
+  {
+    return false;
+  }
+
+  int written = client->con->write(msg, msg->size());
+  if (written == -1)
+  {
+    cerr << "*** ERROR: TCP transmit error in NetUplink \"" << name
+         << "\": " << strerror(errno) << ".\n";
+    forceDisconnect(client);
+    return false;
+  }
+  else if (written != static_cast<int>(msg->size()))
+  {
+    cerr << "*** ERROR: TCP transmit buffer overflow in NetUplink "
+         << name << ".\n";
+    forceDisconnect(client);
+    return false;
+  }
+  return true;
+} /* NetUplink::writeMsg */
+
+
+void NetUplink::sendMsg(Client *client, Msg *msg)
 {
-  if ((state == STATE_CON_SETUP) || (state == STATE_READY))
+  writeMsg(client, msg);
+  delete msg;
+} /* NetUplink::sendMsg */
+
+
+void NetUplink::broadcastMsg(Msg *msg)
+{
+  for (ClientList::iterator it=clients.begin(); it!=clients.end(); ++it)
   {
-    int written = con->write(msg, msg->size());
-    if (written == -1)
+    if ((*it)->state == STATE_READY)
+    {
+      writeMsg(*it, msg);
+    }
+  }
+  delete msg;
+} /* NetUplink::broadcastMsg */
+
+
+/*
+ *----------------------------------------------------------------------------
+ * Method:    NetUplink::selectRxCodec
+ * Purpose:   Select the codec used to encode RX audio for a client. Clients
+ *            asking for the same codec, with the same options, share one
+ *            encoder so that the audio is only encoded once.
+ * Input:     client    - The client that sent the request
+ *            codec_msg - The codec select message
+ * Output:    None
+ * Author:    agent
+ * Created:   2026-10-17
+ * Remarks:
+ * Bugs:
+ *----------------------------------------------------------------------------
+ */
+void NetUplink::selectRxCodec(Client *client,
+                              MsgRxAudioCodecSelect *codec_msg)
+{
+  unsubscribe(client);
+
+  MsgAudioCodecSelect::Opts opts;
+  string key;
+  codecOptions(codec_msg, opts, &key);
+
+  Encoder *encoder = 0;
+  EncoderMap::iterator enc_it = encoders.find(key);
+  if (enc_it != encoders.end())
+  {
+    encoder = (*enc_it).second;
+    cout << name << ": Sharing CODEC \"" << encoder->enc->name()
+         << "\" to encode RX audio\n";
+  }
+  else
+  {
+    AudioEncoder *audio_enc = AudioEncoder::create(codec_msg->name());
+    if (audio_enc == 0)
+    {
+      cerr << "*** ERROR: Received request for unknown RX audio codec ("
+           << codec_msg->name() << ") in NetUplink " << name << "\n";
+      return;
+    }
+    encoder = new Encoder;
+    encoder->key = key;
+    encoder->enc = audio_enc;
+    audio_enc->writeEncodedSamples.connect(
+        sigc::bind(mem_fun(*this, &NetUplink::writeEncodedSamples), encoder));
+    audio_enc->flushEncodedSamples.connect(
+        mem_fun(*audio_enc, &AudioEncoder::allEncodedSamplesFlushed));
+    enc_splitter->addSink(audio_enc);
+    cout << name << ": Using CODEC \"" << audio_enc->name()
+         << "\" to encode RX audio\n";
+
+    MsgAudioCodecSelect::Opts::const_iterator it;
+    for (it=opts.begin(); it!=opts.end(); ++it)
     {
-      cerr << "*** ERROR: TCP transmit error in NetUplink \"" << name
-           << "\": " << strerror(errno) << ".\n";
-      forceDisconnect();
+      audio_enc->setOption((*it).first, (*it).second);
     }
-    else if (written != static_cast<int>(msg->size()))
+    audio_enc->printCodecParams();
+    encoders[key] = encoder;
+
+      // The silence gate must not close while there may be audio left in
+      // the encoder
+    if (audio_enc->packetSampleCount() > rx_gate->hangtime())
     {
-      cerr << "*** ERROR: TCP transmit buffer overflow in NetUplink "
-           << name << ".\n";
-      forceDisconnect();
+      rx_gate->setHangtime(audio_enc->packetSampleCount());
     }
   }
-  
-  delete msg;
-  
-} /* NetUplink::sendMsg */
+
+  encoder->subscribers.push_back(client);
+  client->encoder = encoder;
+} /* NetUplink::selectRxCodec */
+
+
+void NetUplink::selectTxCodec(Client *client,
+                              MsgTxAudioCodecSelect *codec_msg)
+{
+  delete client->audio_dec;
+  client->audio_dec = AudioDecoder::create(codec_msg->name());
+  if (client->audio_dec == 0)
+  {
+    cerr << "*** ERROR: Received request for unknown TX audio codec ("
+         << codec_msg->name() << ") in NetUplink " << name << "\n";
+    return;
+  }
+
+  AudioDecoder *audio_dec = client->audio_dec;
+  if (client == tx_ctrl_client)
+  {
+    audio_dec->registerSink(fifo);
+  }
+  audio_dec->allEncodedSamplesFlushed.connect(
+      mem_fun(*this, &NetUplink::allEncodedSamplesFlushed));
+  cout << name << ": Using CODEC \"" << audio_dec->name()
+       << "\" to decode TX audio\n";
+
+  MsgAudioCodecSelect::Opts opts;
+  codecOptions(codec_msg, opts);
+  MsgAudioCodecSelect::Opts::const_iterator it;
+  for (it=opts.begin(); it!=opts.end(); ++it)
+  {
+    audio_dec->setOption((*it).first, (*it).second);
+  }
+  audio_dec->printCodecParams();
+} /* NetUplink::selectTxCodec */
+
+
+  // Get the options of a codec select message. The key, identifying the codec
+  // and its options, is used to share one encoder between clients.
+void NetUplink::codecOptions(MsgAudioCodecSelect *codec_msg,
+                             MsgAudioCodecSelect::Opts &opts, string *key)
+{
+  codec_msg->options(opts);
+  if (key == 0)
+  {
+    return;
+  }
+  *key = codec_msg->name();
+  MsgAudioCodecSelect::Opts::const_iterator it;
+  for (it=opts.begin(); it!=opts.end(); ++it)
+  {
+    *key += " " + (*it).first + "=" + (*it).second;
+  }
+} /* NetUplink::codecOptions */
+
+
+void NetUplink::unsubscribe(Client *client)
+{
+  Encoder *encoder = client->encoder;
+  if (encoder == 0)
+  {
+    return;
+  }
+  client->encoder = 0;
+  encoder->subscribers.remove(client);
+  if (encoder->subscribers.empty())
+  {
+    encoders.erase(encoder->key);
+    enc_splitter->removeSink(encoder->enc);
+    delete encoder->enc;
+    delete encoder;
+  }
+} /* NetUplink::unsubscribe */
 
 
 void NetUplink::squelchOpen(bool is_open)
@@ -738,9 +1063,12 @@ void NetUplink::squelchOpen(bool is_open)
     }
   }
 
+    // Any pending silence report is sent before the squelch message
+  rx_gate->setSuspended(!is_open);
+
   MsgSquelch *msg = new MsgSquelch(is_open, rx->signalStrength(),
                                    rx->sqlRxId(), rx->squelchActivityInfo());
-  sendMsg(msg);
+  broadcastMsg(msg);
 } /* NetUplink::squelchOpen */
 
 
@@ -749,7 +1077,7 @@ void NetUplink::dtmfDigitDetected(char digit, int duration)
   cout << name << ": DTMF digit detected: " << digit << " with duration " << duration
        << " milliseconds" << endl;
   MsgDtmf *msg = new MsgDtmf(digit, duration);
-  sendMsg(msg);
+  broadcastMsg(msg);
 } /* NetUplink::dtmfDigitDetected */
 
 
@@ -757,7 +1085,7 @@ void NetUplink::toneDetected(float tone_fq)
 {
   cout << name << ": Tone detected: " << tone_fq << endl;
   MsgTone *msg = new MsgTone(tone_fq);
-  sendMsg(msg);
+  broadcastMsg(msg);
 } /* NetUplink::toneDetected */
 
 
@@ -765,11 +1093,12 @@ void NetUplink::selcallSequenceDetected(std::string sequence)
 {
   // cout "Sel5 sequence detected: " << sequence << endl;
   MsgSel5 *msg = new MsgSel5(sequence);
-  sendMsg(msg);
+  broadcastMsg(msg);
 } /* NetUplink::selcallSequenceDetected */
 
 
-void NetUplink::writeEncodedSamples(const void *buf, int size)
+void NetUplink::writeEncodedSamples(const void *buf, int size,
+                                    Encoder *encoder)
 {
   //cout << "NetUplink::writeEncodedSamples: size=" << size << endl;
   const char *ptr = reinterpret_cast<const char *>(buf);
@@ -777,51 +1106,88 @@ void NetUplink::writeEncodedSamples(const void *buf, int size)
   {
     const int bufsize = MsgAudio::BUFSIZE;
     int len = min(size, bufsize);
-    MsgAudio *msg = new MsgAudio(ptr, len);
-    sendMsg(msg);
+    MsgAudio msg(ptr, len);
+    list<Client*>::const_iterator it;
+    for (it=encoder->subscribers.begin(); it!=encoder->subscribers.end(); ++it)
+    {
+      if ((*it)->state == STATE_READY)
+      {
+        writeMsg(*it, &msg);
+      }
+    }
     size -= len;
     ptr += len;
   }
 } /* NetUplink::writeEncodedSamples */
 
 
+void NetUplink::writeSilence(unsigned count)
+{
+  MsgSilence msg(count);
+  for (ClientList::iterator it=clients.begin(); it!=clients.end(); ++it)
+  {
+    if (((*it)->state == STATE_READY) && ((*it)->encoder != 0))
+    {
+      writeMsg(*it, &msg);
+    }
+  }
+} /* NetUplink::writeSilence */
+
+
 void NetUplink::txTimeout(void)
 {
-  MsgTxTimeout *msg = new MsgTxTimeout;
-  sendMsg(msg);
+  if (tx_ctrl_client != 0)
+  {
+    MsgTxTimeout *msg = new MsgTxTimeout;
+    sendMsg(tx_ctrl_client, msg);
+  }
 } /* NetUplink::txTimeout */
 
 
 void NetUplink::transmitterStateChange(bool is_transmitting)
 {
-  MsgTransmitterStateChange *msg =
-      new MsgTransmitterStateChange(is_transmitting);
-  sendMsg(msg);
+  if (tx_ctrl_client != 0)
+  {
+    MsgTransmitterStateChange *msg =
+        new MsgTransmitterStateChange(is_transmitting);
+    sendMsg(tx_ctrl_client, msg);
+  }
 } /* NetUplink::transmitterStateChange */
 
 
 void NetUplink::allEncodedSamplesFlushed(void)
 {
-  MsgAllSamplesFlushed *msg = new MsgAllSamplesFlushed;
-  sendMsg(msg);
+  if (tx_ctrl_client != 0)
+  {
+    MsgAllSamplesFlushed *msg = new MsgAllSamplesFlushed;
+    sendMsg(tx_ctrl_client, msg);
+  }
 } /* NetUplink::allEncodedSamplesFlushed */
 
 
 void NetUplink::heartbeat(Timer *t)
 {
-  MsgHeartbeat *msg = new MsgHeartbeat;
-  sendMsg(msg);
-  
-  struct timeval diff_tv;
   struct timeval now;
   gettimeofday(&now, NULL);
-  timersub(&now, &last_msg_timestamp, &diff_tv);
-  int diff_ms = diff_tv.tv_sec * 1000 + diff_tv.tv_usec / 1000;
-  
-  if (diff_ms > 15000)
+  for (ClientList::iterator it=clients.begin(); it!=clients.end(); ++it)
   {
-    cerr << "*** ERROR: Heartbeat timeout in NetUplink " << name << "\n";
-    forceDisconnect();
+    Client *client = *it;
+    MsgHeartbeat *msg = new MsgHeartbeat;
+    sendMsg(client, msg);
+    if (client->state == STATE_DISC_CLEANUP)
+    {
+      continue;
+    }
+
+    struct timeval diff_tv;
+    timersub(&now, &client->last_msg_timestamp, &diff_tv);
+    int diff_ms = diff_tv.tv_sec * 1000 + diff_tv.tv_usec / 1000;
+
+    if (diff_ms > 15000)
+    {
+      cerr << "*** ERROR: Heartbeat timeout in NetUplink " << name << "\n";
+      forceDisconnect(client);
+    }
   }
   
   t->reset();
@@ -868,14 +1234,18 @@ void NetUplink::signalLevelUpdated(float siglev)
 {
   MsgSiglevUpdate *msg = new MsgSiglevUpdate(rx->signalStrength(),
 					     rx->sqlRxId());
-  sendMsg(msg);  
+  broadcastMsg(msg);
 } /* NetUplink::signalLevelUpdated */
 
 
-void NetUplink::forceDisconnect(void)
+void NetUplink::forceDisconnect(Client *client)
 {
-  con->disconnect();
-  clientDisconnected(con, TcpConnection::DR_ORDERED_DISCONNECT);
+  TcpConnection *con = client->con;
+  if (con != 0)
+  {
+    con->disconnect();
+    clientDisconnected(con, TcpConnection::DR_ORDERED_DISCONNECT);
+  }
 } /* NetUplink::forceDisconnect */
 
 
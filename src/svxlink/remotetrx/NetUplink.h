@@ -38,6 +38,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <sys/time.h>
 
 #include <string>
+#include <list>
+#include <map>
 
 
 /****************************************************************************
@@ -77,6 +79,7 @@ namespace Async
   class AudioSplitter;
   class AudioSelector;
   class AudioPassthrough;
+  class AudioSilenceGate;
 };
 
 namespace NetTrxMsg
@@ -130,6 +133,20 @@ namespace NetTrxMsg
 @date   2006-04-14
 
 This class implements a remote transceiver uplink via an IP network.
+
+More than one client, e.g. a primary and a standby SvxLink server or a
+SvxLink server and a logger, may be connected at the same time. The maximum
+number of clients is set using the MAX_CLIENTS configuration variable. Each
+client select its own RX audio codec but the audio is only encoded once for
+each distinct codec configuration. The encoded audio is then sent to all
+clients that selected that codec.
+
+Only one of the clients control the transmitter and the receiver settings,
+like frequency and mute state. That is the first client to connect. When it
+disconnects, control is handed over to the client that has been connected the
+longest. The settings requested by the other clients are stored and applied
+when a client take over control. All clients receive squelch, signal level, DTMF and tone detector
+events.
 */
 class NetUplink : public Uplink
 {
@@ -162,29 +179,67 @@ class NetUplink : public Uplink
   private:
     typedef enum
     {
-      STATE_DISC, STATE_CON_SETUP, STATE_READY, STATE_DISC_CLEANUP
+      STATE_CON_SETUP, STATE_READY, STATE_DISC_CLEANUP
     } State;
-    
+
+    struct Encoder;
+
+    struct Client
+    {
+      Client(Async::TcpConnection *con)
+        : con(con), state(STATE_CON_SETUP), recv_cnt(0), recv_exp(0),
+          last_msg_timestamp(), encoder(0), audio_dec(0),
+          rx_mute_state(Rx::MUTE_CONTENT), tx_ctrl_mode(Tx::TX_OFF),
+          ctcss_enabled(false), rx_fq(0), rx_mod(Modulation::MOD_UNKNOWN),
+          rx_reset_pending(false)
+      {
+      }
+
+      Async::TcpConnection  *con;
+      State                 state;
+      char                  recv_buf[4096];
+      unsigned              recv_cnt;
+      unsigned              recv_exp;
+      struct timeval        last_msg_timestamp;
+      unsigned char         auth_challenge[
+                              NetTrxMsg::MsgAuthChallenge::CHALLENGE_LEN];
+      Encoder               *encoder;
+      Async::AudioDecoder   *audio_dec;
+      Rx::MuteState         rx_mute_state;
+      Tx::TxCtrlMode        tx_ctrl_mode;
+      bool                  ctcss_enabled;
+      unsigned              rx_fq;
+      Modulation::Type      rx_mod;
+      bool                  rx_reset_pending;
+    };
+
+    struct Encoder
+    {
+      std::string           key;
+      Async::AudioEncoder   *enc;
+      std::list<Client*>    subscribers;
+    };
+
+    typedef std::list<Client*>                ClientList;
+    typedef std::map<std::string, Encoder*>   EncoderMap;
+
     Async::TcpServer<Async::TcpConnection>*  server;
-    Async::TcpConnection    *con;
-    char      	      	    recv_buf[4096];
-    unsigned       	    recv_cnt;
-    unsigned       	    recv_exp;
+    ClientList              clients;
+    Client                  *tx_ctrl_client;
+    unsigned                max_clients;
+    EncoderMap              encoders;
     Rx	      	      	    *rx;
     Tx	      	      	    *tx;
     Async::AudioFifo  	    *fifo;
     Async::Config     	    &cfg;
     std::string       	    name;
-    struct timeval    	    last_msg_timestamp;
     Async::Timer      	    *heartbeat_timer;
-    Async::AudioEncoder     *audio_enc;
-    Async::AudioDecoder     *audio_dec;
     Async::AudioPassthrough *loopback_con;
     Async::AudioSplitter    *rx_splitter;
+    Async::AudioSilenceGate *rx_gate;
+    Async::AudioSplitter    *enc_splitter;
     Async::AudioSelector    *tx_selector;
-    State                   state;
     std::string             auth_key;
-    unsigned char           auth_challenge[NetTrxMsg::MsgAuthChallenge::CHALLENGE_LEN];
     //Async::Timer      	    *siglev_check_timer;
     Async::Timer	    *mute_tx_timer;
     bool		    tx_muted;
@@ -195,12 +250,25 @@ class NetUplink : public Uplink
     NetUplink& operator=(const NetUplink&);
     void handleIncomingConnection(Async::TcpConnection *incoming_con);
     void clientConnected(Async::TcpConnection *con);
-    void disconnectCleanup(void);
+    void clientReady(Client *client);
+    void setTxCtrlClient(Client *client);
+    void disconnectCleanup(Client *client);
     void clientDisconnected(Async::TcpConnection *con,
       	      	      	    Async::TcpConnection::DisconnectReason reason);
-    int tcpDataReceived(Async::TcpConnection *con, void *data, int size);
-    void handleMsg(NetTrxMsg::Msg *msg);
-    void sendMsg(NetTrxMsg::Msg *msg);
+    int tcpDataReceived(Async::TcpConnection *con, void *data, int size,
+                        Client *client);
+    void handleMsg(Client *client, NetTrxMsg::Msg *msg);
+    bool writeMsg(Client *client, const NetTrxMsg::Msg *msg);
+    void sendMsg(Client *client, NetTrxMsg::Msg *msg);
+    void broadcastMsg(NetTrxMsg::Msg *msg);
+    void selectRxCodec(Client *client,
+                       NetTrxMsg::MsgRxAudioCodecSelect *codec_msg);
+    void selectTxCodec(Client *client,
+                       NetTrxMsg::MsgTxAudioCodecSelect *codec_msg);
+    static void codecOptions(NetTrxMsg::MsgAudioCodecSelect *codec_msg,
+                             NetTrxMsg::MsgAudioCodecSelect::Opts &opts,
+                             std::string *key=0);
+    void unsubscribe(Client *client);
 
     /**
      * @brief 	Set squelch state to open/closed
@@ -227,7 +295,8 @@ class NetUplink : public Uplink
     void selcallSequenceDetected(std::string sequence);
 
 
-    void writeEncodedSamples(const void *buf, int size);
+    void writeEncodedSamples(const void *buf, int size, Encoder *encoder);
+    void writeSilence(unsigned count);
     void txTimeout(void);
     void transmitterStateChange(bool is_transmitting);
     void allEncodedSamplesFlushed(void);
@@ -236,8 +305,7 @@ class NetUplink : public Uplink
     void unmuteTx(Async::Timer *t);
     void setFallbackActive(bool activate);
     void signalLevelUpdated(float siglev);
-    void forceDisconnect(void);
-    void setState(State new_state) { state = new_state; }
+    void forceDisconnect(Client *client);
 
 };  /* class NetUplink */
 
@@ -42,6 +42,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <AsyncAudioLatencyProbe.h>
 
 
 /****************************************************************************
@@ -146,6 +147,11 @@ bool TrxHandler::initialize(void)
     return false;
   }
 
+    // Trace the latency through the receiver, the uplink and the
+    // transmitter as one audio path
+  AudioLatencyProbe::setTrace(rx_name, m_name);
+  AudioLatencyProbe::setTrace(tx_name, m_name);
+
   cout << "RX: " << rx_name << endl;
   m_rx = RxFactory::createNamedRx(m_cfg, rx_name);
   if ((m_rx == 0) || !m_rx->initialize())
@@ -66,6 +66,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncConfig.h>
 #include <AsyncFdWatch.h>
 #include <AsyncAudioIO.h>
+#include <AsyncAudioLatencyProbe.h>
 #include <Rx.h>
 #include <Tx.h>
 #include <common.h>
@@ -522,6 +523,14 @@ int main(int argc, char **argv)
   cfg.getValue("GLOBAL", "CARD_CHANNELS", card_channels);
   AudioIO::setChannels(card_channels);
 
+  bool audio_latency_trace = false;
+  cfg.getValue("GLOBAL", "AUDIO_LATENCY_TRACE", audio_latency_trace);
+  if (audio_latency_trace)
+  {
+    AudioLatencyProbe::setEnabled(true);
+    cout << "--- Audio latency tracing enabled\n";
+  }
+
   struct termios org_termios = {0};
   if (logfile_name == 0)
   {
@@ -33,6 +33,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <cassert>
+#include <iostream>
 
 
 /****************************************************************************
@@ -112,21 +113,56 @@ using namespace std;
 
 CmdParser::~CmdParser(void)
 {
-  CmdMap cmds_copy = cmds;
-  CmdMap::iterator it;
-  for (it = cmds_copy.begin(); it != cmds_copy.end(); ++it)
+  vector<Command *> cmds;
+  for (Nodes::const_iterator it = nodes.begin(); it != nodes.end(); ++it)
   {
-    delete (*it).second;
+    if ((*it).cmd != 0)
+    {
+      cmds.push_back((*it).cmd);
+    }
+  }
+  for (vector<Command *>::iterator it = cmds.begin(); it != cmds.end(); ++it)
+  {
+    delete *it;
   }
 } /* CmdParser::~CmdParser */
 
 
 bool CmdParser::addCmd(Command *cmd)
 {
-  bool cmd_undefined = (cmds.count(cmd->cmdStr()) == 0);
+  const string& cmd_str = cmd->cmdStr();
+  if (cmd_str.empty())
+  {
+    cerr << "*** WARNING: Empty DTMF command ignored\n";
+    return false;
+  }
+  for (string::const_iterator it = cmd_str.begin(); it != cmd_str.end(); ++it)
+  {
+    if (digitIndex(*it) < 0)
+    {
+      cerr << "*** WARNING: The DTMF command \"" << cmd_str
+           << "\" contain the character '" << *it << "' which is not a "
+              "DTMF digit (0-9, A-D, *, #). Command ignored.\n";
+      return false;
+    }
+  }
+
+  unsigned node = 0;
+  for (string::const_iterator it = cmd_str.begin(); it != cmd_str.end(); ++it)
+  {
+    const int idx = digitIndex(*it);
+    if (nodes[node].next[idx] == 0)
+    {
+      nodes[node].next[idx] = nodes.size();
+      nodes.push_back(Node());
+    }
+    node = nodes[node].next[idx];
+  }
+
+  bool cmd_undefined = (nodes[node].cmd == 0);
   if (cmd_undefined)
   {
-    cmds[cmd->cmdStr()] = cmd;
+    nodes[node].cmd = cmd;
   }
   return cmd_undefined;
 } /* CmdParser::addCmd */
@@ -134,11 +170,25 @@ bool CmdParser::addCmd(Command *cmd)
 
 bool CmdParser::removeCmd(Command *cmd)
 {
-  CmdMap::iterator cmd_it = cmds.find(cmd->cmdStr());
-  bool cmd_exist = (cmd_it != cmds.end());
+  const string& cmd_str = cmd->cmdStr();
+  unsigned node = 0;
+  for (string::const_iterator it = cmd_str.begin(); it != cmd_str.end(); ++it)
+  {
+    const int idx = digitIndex(*it);
+    if ((idx < 0) || (nodes[node].next[idx] == 0))
+    {
+      return false;
+    }
+    node = nodes[node].next[idx];
+  }
+
+    // Only remove the command if it is the one stored in the trie. A command
+    // that failed to be added must not remove the command it collided with.
+    // Empty nodes are left in the trie to be reused.
+  bool cmd_exist = (node != 0) && (nodes[node].cmd == cmd);
   if (cmd_exist)
   {
-    cmds.erase(cmd_it);
+    nodes[node].cmd = 0;
   }
   return cmd_exist;
 } /* CmdParser::removeCmd */
@@ -146,21 +196,45 @@ bool CmdParser::removeCmd(Command *cmd)
 
 bool CmdParser::processCmd(const string& cmd_str)
 {
-  int len = cmd_str.size();
-  while (len > 0)
+  size_t len = 0;
+  Command *cmd = findCmd(cmd_str, &len);
+  if (cmd == 0)
   {
-    if (cmds.count(cmd_str.substr(0, len)) > 0)
-    {
-      Command *cmd = cmds[cmd_str.substr(0, len)];
-      (*cmd)(cmd_str.substr(len, cmd_str.size()-len));
-      return true;
-    }
-    --len;
+    return false;
   }
 
-  return false;
+  (*cmd)(cmd_str.substr(len));
+  return true;
   
 } /* CmdParser::processCmd */
+
+
+Command *CmdParser::findCmd(const string& cmd_str, size_t *cmd_len) const
+{
+  Command *cmd = 0;
+  size_t len = 0;
+  unsigned node = 0;
+  for (size_t i=0; i<cmd_str.size(); ++i)
+  {
+    const int idx = digitIndex(cmd_str[i]);
+    if ((idx < 0) || (nodes[node].next[idx] == 0))
+    {
+      break;
+    }
+    node = nodes[node].next[idx];
+    if (nodes[node].cmd != 0)
+    {
+      cmd = nodes[node].cmd;
+      len = i + 1;
+    }
+  }
+
+  if (cmd_len != 0)
+  {
+    *cmd_len = len;
+  }
+  return cmd;
+} /* CmdParser::findCmd */
     
 
 
@@ -196,6 +270,25 @@ bool CmdParser::processCmd(const string& cmd_str)
  *
  ****************************************************************************/
 
+int CmdParser::digitIndex(char digit)
+{
+  if ((digit >= '0') && (digit <= '9'))
+  {
+    return digit - '0';
+  }
+  switch (digit)
+  {
+    case 'A': return 10;
+    case 'B': return 11;
+    case 'C': return 12;
+    case 'D': return 13;
+    case '*': return 14;
+    case '#': return 15;
+    default:  return -1;
+  }
+} /* CmdParser::digitIndex */
+
+
 
 /*
  *----------------------------------------------------------------------------
@@ -36,8 +36,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <sigc++/sigc++.h>
 
-#include <map>
 #include <string>
+#include <vector>
 #include <cassert>
 
 
@@ -113,6 +113,12 @@ class Command;
 
 This is the DTMF command parser engine implementation. Add commands based on
 the Command class.
+
+The commands are stored in a digit trie, one node per DTMF digit, so finding
+the command for a received digit string take one step per digit no matter how
+many commands, module ids and link commands have been set up. The longest
+command that is a prefix of the digit string is chosen and the rest of the
+digit string is given to the command as its sub command.
 */
 class CmdParser
 {
@@ -120,7 +126,7 @@ class CmdParser
     /**
      * @brief 	Default constuctor
      */
-    CmdParser(void) {}
+    CmdParser(void) : nodes(1) {}
   
     /**
      * @brief 	Destructor
@@ -147,13 +153,42 @@ class CmdParser
      * @return	Returns \em true if the command was found or else \em false
      */
     bool processCmd(const std::string& cmd_str);
+
+    /**
+     * @brief	Find the command matching a command string
+     * @param	cmd_str The command string to look up
+     * @param	cmd_len Set to the length of the matched command, may be 0
+     * @return	Returns the command or 0 if no command matched
+     *
+     * The longest command that is a prefix of the given command string is
+     * returned. The rest of the command string is the sub command.
+     */
+    Command *findCmd(const std::string& cmd_str, size_t *cmd_len=0) const;
     
     
   protected:
     
   private:
-    typedef std::map<std::string, Command *> CmdMap;
-    CmdMap cmds;
+    static const unsigned DIGIT_CNT = 16;
+
+    struct Node
+    {
+      Command   *cmd;
+      unsigned  next[DIGIT_CNT];
+
+      Node(void) : cmd(0)
+      {
+        for (unsigned i=0; i<DIGIT_CNT; ++i)
+        {
+          next[i] = 0;
+        }
+      }
+    };
+    typedef std::vector<Node> Nodes;
+
+    Nodes nodes;
+    
+    static int digitIndex(char digit);
     
 };  /* class CmdParser */
 
@@ -0,0 +1,219 @@
+//
+// Test for the DTMF command lookup in CmdParser.
+//
+// A number of commands are added to a parser and digit strings are processed
+// to check which command is executed and what sub command it is given. The
+// following is tested:
+//
+//   - The longest command that is a prefix of the digit string is chosen
+//   - Commands that share a prefix, which is not a command in itself, are
+//     told apart and the shared prefix alone select no command
+//   - Removing one of two commands that share a prefix leaves the other one
+//     working, and a command that failed to be added does not remove the
+//     command it collided with
+//   - Commands containing characters that are not DTMF digits are rejected
+//
+// Usage: CmdParserTest
+//
+
+#include <iostream>
+#include <string>
+
+#include "CmdParser.h"
+
+using namespace std;
+
+
+class CmdParserTest : public sigc::trackable
+{
+  public:
+    bool failed;
+
+    CmdParserTest(void) : failed(false) {}
+
+    void run(void)
+    {
+      testLongestPrefix();
+      testOverlappingPrefixes();
+      testRemoveSharedPrefix();
+      testNonDtmfRejected();
+    }
+
+  private:
+    string last_cmd;
+    string last_subcmd;
+
+    Command *addCmd(CmdParser& parser, const string& cmd_str)
+    {
+      Command *cmd = new Command(&parser, cmd_str);
+      cmd->handleCmd.connect(mem_fun(*this, &CmdParserTest::cmdHandler));
+      if (!cmd->addToParser())
+      {
+        cout << "*** Could not add command \"" << cmd_str << "\"" << endl;
+        failed = true;
+      }
+      return cmd;
+    }
+
+    void cmdHandler(Command *cmd, const string& subcmd)
+    {
+      last_cmd = cmd->cmdStr();
+      last_subcmd = subcmd;
+    }
+
+    void expect(CmdParser& parser, const string& digits,
+                const string& cmd, const string& subcmd)
+    {
+      last_cmd = "";
+      last_subcmd = "";
+      if (!parser.processCmd(digits))
+      {
+        cout << "*** \"" << digits << "\": Expected command \"" << cmd
+             << "\" but no command was found" << endl;
+        failed = true;
+      }
+      else if ((last_cmd != cmd) || (last_subcmd != subcmd))
+      {
+        cout << "*** \"" << digits << "\": Expected command \"" << cmd
+             << "\" with sub command \"" << subcmd << "\" but got \""
+             << last_cmd << "\" with sub command \"" << last_subcmd << "\""
+             << endl;
+        failed = true;
+      }
+    }
+
+    void expectNoCmd(CmdParser& parser, const string& digits)
+    {
+      last_cmd = "";
+      if (parser.processCmd(digits) || !last_cmd.empty())
+      {
+        cout << "*** \"" << digits << "\": Expected no command but got \""
+             << last_cmd << "\"" << endl;
+        failed = true;
+      }
+    }
+
+    void testLongestPrefix(void)
+    {
+      CmdParser parser;
+      addCmd(parser, "1");
+      addCmd(parser, "12");
+      addCmd(parser, "123");
+      addCmd(parser, "9*");
+
+      expect(parser, "1", "1", "");
+      expect(parser, "19", "1", "9");
+      expect(parser, "12", "12", "");
+      expect(parser, "129", "12", "9");
+      expect(parser, "123", "123", "");
+      expect(parser, "1234", "123", "4");
+      expect(parser, "9*#", "9*", "#");
+      expectNoCmd(parser, "");
+      expectNoCmd(parser, "2");
+      expectNoCmd(parser, "9");
+      expectNoCmd(parser, "91");
+    }
+
+    void testOverlappingPrefixes(void)
+    {
+      CmdParser parser;
+      addCmd(parser, "120");
+      addCmd(parser, "121");
+      addCmd(parser, "13");
+
+      expect(parser, "120", "120", "");
+      expect(parser, "1215", "121", "5");
+      expect(parser, "13", "13", "");
+      expect(parser, "1312", "13", "12");
+      expectNoCmd(parser, "1");
+      expectNoCmd(parser, "12");
+      expectNoCmd(parser, "122");
+    }
+
+    void testRemoveSharedPrefix(void)
+    {
+      CmdParser parser;
+      Command *short_cmd = addCmd(parser, "12");
+      Command *long_cmd = addCmd(parser, "123");
+
+        // Removing the longer command makes the shorter one match again
+      if (!long_cmd->removeFromParser())
+      {
+        cout << "*** Could not remove command \"123\"" << endl;
+        failed = true;
+      }
+      expect(parser, "1234", "12", "34");
+      if (long_cmd->removeFromParser())
+      {
+        cout << "*** Command \"123\" removed twice" << endl;
+        failed = true;
+      }
+      if (!long_cmd->addToParser())
+      {
+        cout << "*** Could not add command \"123\" again" << endl;
+        failed = true;
+      }
+      expect(parser, "1234", "123", "4");
+
+        // Removing the shorter command leaves the longer one in place
+      delete short_cmd;
+      expectNoCmd(parser, "12");
+      expectNoCmd(parser, "129");
+      expect(parser, "1234", "123", "4");
+
+        // A duplicate command is not added and must not remove the command
+        // it collided with when deleted
+      Command *dup_cmd = new Command(&parser, "123");
+      if (dup_cmd->addToParser())
+      {
+        cout << "*** Duplicate command \"123\" was added" << endl;
+        failed = true;
+      }
+      delete dup_cmd;
+      expect(parser, "1234", "123", "4");
+    }
+
+    void testNonDtmfRejected(void)
+    {
+      CmdParser parser;
+      addCmd(parser, "0123456789ABCD*#");
+
+      const char *bad_cmds[] = { "1E", "a", "12 ", "x#", "5-" };
+      for (size_t i=0; i<sizeof(bad_cmds)/sizeof(*bad_cmds); ++i)
+      {
+        Command *cmd = new Command(&parser, bad_cmds[i]);
+        if (cmd->addToParser())
+        {
+          cout << "*** Command \"" << bad_cmds[i]
+               << "\" containing a non-DTMF character was added" << endl;
+          failed = true;
+        }
+        delete cmd;
+      }
+      Command *empty_cmd = new Command(&parser);
+      if (empty_cmd->addToParser())
+      {
+        cout << "*** Empty command was added" << endl;
+        failed = true;
+      }
+      delete empty_cmd;
+
+      expect(parser, "0123456789ABCD*#", "0123456789ABCD*#", "");
+      expectNoCmd(parser, "1E");
+      expectNoCmd(parser, "a");
+    }
+};
+
+
+int main(int argc, const char **argv)
+{
+  CmdParserTest test;
+  test.run();
+
+  if (test.failed)
+  {
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
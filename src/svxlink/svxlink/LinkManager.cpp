@@ -53,9 +53,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <common.h>
 #include <AsyncAudioSource.h>
 #include <AsyncAudioSink.h>
-#include <AsyncAudioSplitter.h>
-#include <AsyncAudioSelector.h>
-#include <AsyncAudioPassthrough.h>
+#include <AsyncAudioRoutingMatrix.h>
+#include <AsyncAudioThreadBridge.h>
 
 
 /****************************************************************************
@@ -271,46 +270,28 @@ void LinkManager::addLogic(LogicBase *logic)
   assert(logic->logicConOut() != 0);
   assert(logic->logicConIn() != 0);
 
-    // Create a splitter to split the source audio from the logic being added
-    // to all other logics.
-  AudioSplitter *splitter = new AudioSplitter;
-  logic->logicConOut()->registerSink(splitter);
-
-    // Register the new logic source
-  sources[logic->name()].source = logic->logicConOut();
-  sources[logic->name()].splitter = splitter;
-
-    // Create a selector for the logic being added to receive audio from all
-    // other sinks.
-  AudioSelector *selector = new AudioSelector;
-  selector->registerSink(logic->logicConIn());
-
-    // Register the new logic sink
-  sinks[logic->name()].sink = logic->logicConIn();
-  sinks[logic->name()].selector = selector;
+    // Create new object containing metadata for this logic core
+  LogicInfo logic_info(logic);
+  logic_info.is_idle = logic->isIdle();
 
-    // Now create a connection from the new logic source to each sink.
-  for (SinkMap::iterator it=sinks.begin(); it != sinks.end(); ++it)
+    // Add a port to the routing matrix for the new logic. Audio is routed
+    // from the logic output to the input of the logics that it is connected
+    // to when a link is activated. Audio to and from a logic core running in
+    // another thread is passed through thread bridges.
+  if (&logic->app() != &app)
   {
-    AudioPassthrough *connector = new AudioPassthrough;
-    splitter->addSink(connector, true);
-    AudioSelector *other_selector = (*it).second.selector;
-    other_selector->addSource(connector);
-    (*it).second.connectors[logic->name()] = connector;
+    logic_info.bridge_out = new AudioThreadBridge(logic->app(), app);
+    logic->logicConOut()->registerSink(logic_info.bridge_out);
+    logic_info.bridge_in = new AudioThreadBridge(app, logic->app());
+    logic_info.bridge_in->registerSink(logic->logicConIn());
+    matrix.addPort(logic->name(), logic_info.bridge_out,
+                   logic_info.bridge_in);
   }
-
-    // Now create a connection from each existing logic source to the new sink.
-  for (SourceMap::iterator it=sources.begin(); it!=sources.end(); ++it)
+  else
   {
-    AudioPassthrough *connector = new AudioPassthrough;
-    (*it).second.splitter->addSink(connector, true);
-    selector->addSource(connector);
-    sinks[logic->name()].connectors[(*it).first] = connector;
+    matrix.addPort(logic->name(), logic->logicConOut(), logic->logicConIn());
   }
 
-    // Create new object containing metadata for this logic core
-  LogicInfo logic_info(logic);
-
     // Keep track of the newly added logics idle state so that we can start
     // and stop timeout timers.
   logic_info.idle_state_changed_con = logic->idleStateChanged.connect(
@@ -365,8 +346,7 @@ void LinkManager::deleteLogic(LogicBase *logic)
 
   LogicInfo &logic_info = (*lmit).second;
   assert(logic_info.logic == logic);
-  assert(sources.find(logic->name()) != sources.end());
-  assert(sinks.find(logic->name()) != sinks.end());
+  assert(matrix.hasPort(logic->name()));
 
     // Disconnect the sigc signals that was connected when the
     // logic was first registered.
@@ -377,35 +357,17 @@ void LinkManager::deleteLogic(LogicBase *logic)
   assert(logic_info.received_publish_state_event_con.connected());
   logic_info.received_publish_state_event_con.disconnect();
 
-    // Delete the logic source splitter and all connections associated with it
-  AudioSplitter *splitter = sources[logic->name()].splitter;
-  for (SinkMap::iterator smit=sinks.begin(); smit!=sinks.end(); ++smit)
-  {
-    SinkInfo &sink_info = (*smit).second;
-    ConMap::iterator cmit = sink_info.connectors.find(logic->name());
-    assert(cmit != sink_info.connectors.end());
-    AudioPassthrough *connector = (*cmit).second;
-    sink_info.selector->removeSource(connector);
-    sink_info.connectors.erase(logic->name());
-    splitter->removeSink(connector);
-    //delete connector;
-  }
-  delete splitter;
-  sources.erase(logic->name());
-  
-    // Delete the logic sink and all connections associated with it
-  AudioSelector *selector = sinks[logic->name()].selector;
-  ConMap &cons = sinks[logic->name()].connectors;
-  for (ConMap::iterator cmit = cons.begin(); cmit != cons.end(); ++cmit)
-  {
-    AudioPassthrough *connector = (*cmit).second;
-    selector->removeSource(connector);
-    const string &source_name = (*cmit).first;
-    sources[source_name].splitter->removeSink(connector);
-    //delete connector;
-  }
-  delete selector;
-  sinks.erase(logic->name());
+    // Remove the logic port and all connections to and from it
+  matrix.removePort(logic->name());
+
+    // Remove the thread bridges if the logic core run in another thread
+  if (logic_info.bridge_out != 0)
+  {
+    logic->logicConOut()->unregisterSink();
+    delete logic_info.bridge_out;
+    logic_info.bridge_in->unregisterSink();
+    delete logic_info.bridge_in;
+  }
 
     // Finally remove the logic from the logic_map
   logic_map.erase(logic->name());
@@ -450,9 +412,22 @@ void LinkManager::allLogicsStarted(void)
 } /* LinkManager::allLogicsStarted */
 
 
-string LinkManager::cmdReceived(LinkRef link, LogicBase *logic,
-                                const string &subcmd)
+void LinkManager::cmdReceived(LinkRef link, Logic *logic,
+                              const string &subcmd)
 {
+  if (!app.isCurrentThread())
+  {
+    Link *lnk = &link;
+    app.post([=]()
+        {
+          if (isRegistered(logic))
+          {
+            cmdReceived(*lnk, logic, subcmd);
+          }
+        });
+    return;
+  }
+
   /* cout << "### LinkManager::cmdReceived: link=" << link.name
        << " logic=" << logic->name()
        << " subcmd=" << subcmd << endl;
@@ -495,22 +470,21 @@ string LinkManager::cmdReceived(LinkRef link, LogicBase *logic,
   //{
   //  ss << "unknown_command " << logic_props.cmd << subcmd;
   //}
-  return ss.str();
+
+  const string event(ss.str());
+  if (!event.empty())
+  {
+    logic->runInLogicThread([=]() { logic->processEvent(event); });
+  }
 } /* LinkManager::cmdReceived */
 
 
 LogicBase *LinkManager::currentTalkerFor(const std::string& logic_name)
 {
-  AudioSelector *selector = sinks[logic_name].selector;
-  AudioSource *selected = selector->selectedSource();
-  const ConMap& con_map = sinks[logic_name].connectors;
-  for (ConMap::const_iterator it = con_map.begin(); it != con_map.end(); ++it)
+  const std::string talker(matrix.selectedSource(logic_name));
+  if (!talker.empty())
   {
-    if (it->second == selected)
-    {
-      //cout << "### Selected source: " << it->first << endl;
-      return logic_map.at(it->first).logic;
-    }
+    return logic_map.at(talker).logic;
   }
   return 0;
 } /* LinkManager::currentTalkerFor */
@@ -518,6 +492,18 @@ LogicBase *LinkManager::currentTalkerFor(const std::string& logic_name)
 
 void LinkManager::setLogicMute(const LogicBase *logic, bool mute)
 {
+  if (!app.isCurrentThread())
+  {
+    app.post([=]()
+        {
+          if (isRegistered(logic))
+          {
+            setLogicMute(logic, mute);
+          }
+        });
+    return;
+  }
+
   LogicInfo &info = logic_map.at(logic->name());
   if (mute != info.is_muted)
   {
@@ -533,16 +519,26 @@ void LinkManager::setLogicMute(const LogicBase *logic, bool mute)
 
 void LinkManager::playFile(LogicBase *src_logic, const std::string& path)
 {
-  const Async::AudioSelector *selector = sinks[src_logic->name()].selector;
-  const ConMap& con_map = sinks[src_logic->name()].connectors;
-  for (ConMap::const_iterator it = con_map.begin(); it != con_map.end(); ++it)
-  {
-    const std::string& logic_name = it->first;
-    const Async::AudioSource *con = it->second;
-    LogicBase *logic = logic_map.at(logic_name).logic;
-    if ((logic != src_logic) && (selector->autoSelectEnabled(con)))
+  if (!app.isCurrentThread())
+  {
+    app.post([=]()
+        {
+          if (isRegistered(src_logic))
+          {
+            playFile(src_logic, path);
+          }
+        });
+    return;
+  }
+
+  const vector<string> logic_names(matrix.connectedSources(src_logic->name()));
+  for (vector<string>::const_iterator it = logic_names.begin();
+       it != logic_names.end(); ++it)
+  {
+    LogicBase *logic = logic_map.at(*it).logic;
+    if (logic != src_logic)
     {
-      logic->playFile(path);
+      logic->runInLogicThread([=]() { logic->playFile(path); });
     }
   }
 } /* LinkManager::playFile */
@@ -550,16 +546,26 @@ void LinkManager::playFile(LogicBase *src_logic, const std::string& path)
 
 void LinkManager::playSilence(LogicBase *src_logic, int length)
 {
-  const Async::AudioSelector *selector = sinks[src_logic->name()].selector;
-  const ConMap& con_map = sinks[src_logic->name()].connectors;
-  for (ConMap::const_iterator it = con_map.begin(); it != con_map.end(); ++it)
-  {
-    const std::string& logic_name = it->first;
-    const Async::AudioSource *con = it->second;
-    LogicBase *logic = logic_map.at(logic_name).logic;
-    if ((logic != src_logic) && (selector->autoSelectEnabled(con)))
+  if (!app.isCurrentThread())
+  {
+    app.post([=]()
+        {
+          if (isRegistered(src_logic))
+          {
+            playSilence(src_logic, length);
+          }
+        });
+    return;
+  }
+
+  const vector<string> logic_names(matrix.connectedSources(src_logic->name()));
+  for (vector<string>::const_iterator it = logic_names.begin();
+       it != logic_names.end(); ++it)
+  {
+    LogicBase *logic = logic_map.at(*it).logic;
+    if (logic != src_logic)
     {
-      logic->playSilence(length);
+      logic->runInLogicThread([=]() { logic->playSilence(length); });
     }
   }
 } /* LinkManager::playSilence */
@@ -567,16 +573,26 @@ void LinkManager::playSilence(LogicBase *src_logic, int length)
 
 void LinkManager::playTone(LogicBase *src_logic, int fq, int amp, int len)
 {
-  const Async::AudioSelector *selector = sinks[src_logic->name()].selector;
-  const ConMap& con_map = sinks[src_logic->name()].connectors;
-  for (ConMap::const_iterator it = con_map.begin(); it != con_map.end(); ++it)
-  {
-    const std::string& logic_name = it->first;
-    const Async::AudioSource *con = it->second;
-    LogicBase *logic = logic_map.at(logic_name).logic;
-    if ((logic != src_logic) && (selector->autoSelectEnabled(con)))
+  if (!app.isCurrentThread())
+  {
+    app.post([=]()
+        {
+          if (isRegistered(src_logic))
+          {
+            playTone(src_logic, fq, amp, len);
+          }
+        });
+    return;
+  }
+
+  const vector<string> logic_names(matrix.connectedSources(src_logic->name()));
+  for (vector<string>::const_iterator it = logic_names.begin();
+       it != logic_names.end(); ++it)
+  {
+    LogicBase *logic = logic_map.at(*it).logic;
+    if (logic != src_logic)
     {
-      logic->playTone(fq, amp, len);
+      logic->runInLogicThread([=]() { logic->playTone(fq, amp, len); });
     }
   }
 } /* LinkManager::playTone */
@@ -584,16 +600,26 @@ void LinkManager::playTone(LogicBase *src_logic, int fq, int amp, int len)
 
 void LinkManager::playDtmf(LogicBase *src_logic, const std::string& digits, int amp, int len)
 {
-  const Async::AudioSelector *selector = sinks[src_logic->name()].selector;
-  const ConMap& con_map = sinks[src_logic->name()].connectors;
-  for (ConMap::const_iterator it = con_map.begin(); it != con_map.end(); ++it)
-  {
-    const std::string& logic_name = it->first;
-    const Async::AudioSource *con = it->second;
-    LogicBase *logic = logic_map.at(logic_name).logic;
-    if ((logic != src_logic) && (selector->autoSelectEnabled(con)))
+  if (!app.isCurrentThread())
+  {
+    app.post([=]()
+        {
+          if (isRegistered(src_logic))
+          {
+            playDtmf(src_logic, digits, amp, len);
+          }
+        });
+    return;
+  }
+
+  const vector<string> logic_names(matrix.connectedSources(src_logic->name()));
+  for (vector<string>::const_iterator it = logic_names.begin();
+       it != logic_names.end(); ++it)
+  {
+    LogicBase *logic = logic_map.at(*it).logic;
+    if (logic != src_logic)
     {
-      logic->playDtmf(digits, amp, len);
+      logic->runInLogicThread([=]() { logic->playDtmf(digits, amp, len); });
     }
   }
 } /* LinkManager::playDtmf */
@@ -737,10 +763,9 @@ void LinkManager::updateConnections(void)
   {
     const string &src_name = it->first;
     const string &sink_name = it->second;
-    SinkInfo &sink = sinks.at(sink_name);
 
       // Disconnect the audio path from source logic to sink logic
-    sink.selector->disableAutoSelect(sink.connectors.at(src_name));
+    matrix.disconnect(src_name, sink_name);
 
       // Delete the link connect information
     current_cons.erase(*it);
@@ -760,8 +785,7 @@ void LinkManager::updateConnections(void)
   {
     const string &src_name = it->first;
     const string &sink_name = it->second;
-    SinkInfo &sink = sinks.at(sink_name);
-    sink.selector->enableAutoSelect(sink.connectors.at(src_name), 0);
+    matrix.connect(src_name, sink_name);
 
       // Store all connections in "current_cons" (current connections)
     current_cons.insert(*it);
@@ -802,7 +826,9 @@ void LinkManager::sendCmdToLogics(Link& link, LogicBase* src_logic,
     const LogicInfo &logic_info = logic_map.at(logic_name);
     if ((logic_info.logic != src_logic) && !logic_info.is_muted)
     {
-      logic_info.logic->remoteCmdReceived(src_logic, cmd);
+      LogicBase *logic = logic_info.logic;
+      logic->runInLogicThread(
+          [=]() { logic->remoteCmdReceived(src_logic, cmd); });
     }
   }
 } /* LinkManager::sendCmdToLogics */
@@ -812,13 +838,9 @@ void LinkManager::sendCmdToLogics(Link& link, LogicBase* src_logic,
 bool LinkManager::isConnected(const string& source_name,
       	                      const string& sink_name)
 {
-  assert(sources.count(source_name) == 1);
-  assert(sinks.count(sink_name) == 1);
-  assert(sinks[sink_name].connectors.count(source_name) == 1);
-
-  AudioPassthrough *connector = sinks[sink_name].connectors[source_name];
-  AudioSelector *selector = sinks[sink_name].selector;
-  return selector->autoSelectEnabled(connector);
+  assert(matrix.hasPort(source_name));
+  assert(matrix.hasPort(sink_name));
+  return matrix.isConnected(source_name, sink_name);
 } /* LinkManager::isConnected */
 #endif
 
@@ -863,6 +885,20 @@ void LinkManager::logicIdleStateChanged(bool is_idle, const LogicBase *logic)
        << endl;
   */
 
+  if (!app.isCurrentThread())
+  {
+    app.post([=]()
+        {
+          if (isRegistered(logic))
+          {
+            logicIdleStateChanged(is_idle, logic);
+          }
+        });
+    return;
+  }
+
+  logic_map.at(logic->name()).is_idle = is_idle;
+
   if (!all_logics_started)
   {
     return;
@@ -916,7 +952,7 @@ void LinkManager::checkTimeoutTimer(Link &link)
   {
     const std::string &logic_name = prop.first;
     const LogicInfo &logic_info = logic_map.at(logic_name);
-    all_logics_idle &= logic_info.is_muted || logic_info.logic->isIdle();
+    all_logics_idle &= logic_info.is_muted || logic_info.is_idle;
   }
 
   link.timeout_timer->setEnable(
@@ -928,16 +964,27 @@ void LinkManager::onReceivedTgUpdated(LogicBase *src_logic, uint32_t tg)
 {
   //cout << "### LinkManager::onReceivedTgUpdated: logic=" << src_logic->name()
   //     << "  tg=" << tg << endl;
-  const Async::AudioSelector *selector = sinks[src_logic->name()].selector;
-  const ConMap& con_map = sinks[src_logic->name()].connectors;
-  for (ConMap::const_iterator it = con_map.begin(); it != con_map.end(); ++it)
-  {
-    const std::string& logic_name = it->first;
-    const Async::AudioSource *con = it->second;
-    LogicBase *logic = logic_map.at(logic_name).logic;
-    if ((logic != src_logic) && (selector->autoSelectEnabled(con)))
+  if (!app.isCurrentThread())
+  {
+    app.post([=]()
+        {
+          if (isRegistered(src_logic))
+          {
+            onReceivedTgUpdated(src_logic, tg);
+          }
+        });
+    return;
+  }
+
+  const vector<string> logic_names(matrix.connectedSources(src_logic->name()));
+  for (vector<string>::const_iterator it = logic_names.begin();
+       it != logic_names.end(); ++it)
+  {
+    LogicBase *logic = logic_map.at(*it).logic;
+    if (logic != src_logic)
     {
-      logic->remoteReceivedTgUpdated(src_logic, tg);
+      logic->runInLogicThread(
+          [=]() { logic->remoteReceivedTgUpdated(src_logic, tg); });
     }
   }
 } /* LinkManager::onReceivedTgUpdated */
@@ -950,21 +997,48 @@ void LinkManager::onPublishStateEvent(LogicBase *src_logic,
   //     << "  event_name=" << event_name
   //     << "  msg=" << msg
   //     << endl;
-  const Async::AudioSelector *selector = sinks[src_logic->name()].selector;
-  const ConMap& con_map = sinks[src_logic->name()].connectors;
-  for (ConMap::const_iterator it = con_map.begin(); it != con_map.end(); ++it)
-  {
-    const std::string& logic_name = it->first;
-    const Async::AudioSource *con = it->second;
-    LogicBase *logic = logic_map.at(logic_name).logic;
-    if ((logic != src_logic) && (selector->autoSelectEnabled(con)))
+  if (!app.isCurrentThread())
+  {
+    app.post([=]()
+        {
+          if (isRegistered(src_logic))
+          {
+            onPublishStateEvent(src_logic, event_name, msg);
+          }
+        });
+    return;
+  }
+
+  const vector<string> logic_names(matrix.connectedSources(src_logic->name()));
+  for (vector<string>::const_iterator it = logic_names.begin();
+       it != logic_names.end(); ++it)
+  {
+    LogicBase *logic = logic_map.at(*it).logic;
+    if (logic != src_logic)
     {
-      logic->remoteReceivedPublishStateEvent(src_logic, event_name, msg);
+      logic->runInLogicThread([=]()
+          {
+            logic->remoteReceivedPublishStateEvent(src_logic, event_name, msg);
+          });
     }
   }
 } /* LinkManager::onPublishStateEvent */
 
 
+bool LinkManager::isRegistered(const LogicBase *logic) const
+{
+    // The logic core may have been deleted so it must not be dereferenced
+  for (const auto& entry : logic_map)
+  {
+    if (entry.second.logic == logic)
+    {
+      return true;
+    }
+  }
+  return false;
+} /* LinkManager::isRegistered */
+
+
 /*
  * This file has not been truncated
  */
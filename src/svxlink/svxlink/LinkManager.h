@@ -50,10 +50,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <AsyncApplication.h>
 #include <AsyncConfig.h>
 #include <AsyncTimer.h>
-#include <AsyncAudioSelector.h>
-#include <AsyncAudioSplitter.h>
+#include <AsyncAudioRoutingMatrix.h>
+#include <AsyncAudioThreadBridge.h>
 
 
 /****************************************************************************
@@ -71,11 +72,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
-namespace Async
-{
-  class AudioPassthrough;
-};
 class LogicBase;
+class Logic;
 
 
 /****************************************************************************
@@ -138,6 +136,12 @@ class LogicBase;
  * manually connected again using DTMF command 941 from the RepeaterLogic side.
  * It is not possible to control the link from the SimplexLogic side since no
  * command has been specified.
+ *
+ * The link manager run in the main thread. Logic cores may run in threads of
+ * their own. Calls from logic cores in other threads are passed on to the
+ * main thread and calls to the logic cores are passed on to their threads.
+ * Audio to and from logic cores in other threads is passed through
+ * Async::AudioThreadBridge objects.
  */
 class LinkManager : public sigc::trackable
 {
@@ -197,13 +201,19 @@ class LinkManager : public sigc::trackable
      * @brief Add a logic core to the link manager
      * @param logic The logic core to add
      *
-     * This function should be called by each logic core upon creation.
+     * This function should be called by each logic core upon creation. If
+     * the logic core run in another thread, the main thread must be blocked
+     * while this function is called, for example by initializing the logic
+     * core using Async::ApplicationThread::call.
      */
     void addLogic(LogicBase *logic);
 
     /**
      * @brief Delete a logic core from the link manager
      * @param logic The logic to delete
+     *
+     * If the logic core run in another thread, this function must be called
+     * from that thread while the main thread is blocked.
      */
     void deleteLogic(LogicBase *logic);
 
@@ -223,17 +233,19 @@ class LinkManager : public sigc::trackable
      * @param   link The link object associated with this command
      * @param   logic The logic core associated with this command
      * @param   subcmd The subcommand
-     * @return  Returns an event handler command to be executed by the logic
+     *
+     * The resulting event handler command, if any, is executed by the logic
+     * core.
      */
-    std::string cmdReceived(LinkRef link, LogicBase *logic,
-                            const std::string &subcmd);
+    void cmdReceived(LinkRef link, Logic *logic, const std::string &subcmd);
 
     /**
      * @brief   Get the current talker for the given logic core
      * @param   logic_name The name of the sink logic
      *
      * Get the pointer to the logic core that is currently producing audio to
-     * the given logic core.
+     * the given logic core. This function must only be called from the main
+     * thread.
      */
     LogicBase *currentTalkerFor(const std::string& logic_name);
 
@@ -304,41 +316,33 @@ class LinkManager : public sigc::trackable
     };
     typedef std::map<std::string, Link> LinkMap;
     typedef std::set<std::pair<std::string, std::string> > LogicConSet;
-    struct SourceInfo
-    {
-      Async::AudioSource      *source;
-      Async::AudioSplitter    *splitter;
-    };
-    typedef std::map<std::string, Async::AudioPassthrough *> ConMap;
-    struct SinkInfo
-    {
-      Async::AudioSink      *sink;
-      Async::AudioSelector  *selector;
-      ConMap                connectors;
-    };
-    typedef std::map<std::string, SourceInfo> SourceMap;
-    typedef std::map<std::string, SinkInfo>   SinkMap;
     struct LogicInfo
     {
-      LogicInfo(LogicBase* logic) : logic(logic), is_muted(false) {}
-      LogicBase         *logic;
-      sigc::connection  idle_state_changed_con;
-      sigc::connection  received_tg_update_con;
-      sigc::connection  received_publish_state_event_con;
-      bool              is_muted;
+      LogicInfo(LogicBase* logic)
+        : logic(logic), is_muted(false), is_idle(true), bridge_out(0),
+          bridge_in(0) {}
+      LogicBase                 *logic;
+      sigc::connection          idle_state_changed_con;
+      sigc::connection          received_tg_update_con;
+      sigc::connection          received_publish_state_event_con;
+      bool                      is_muted;
+      bool                      is_idle;
+      Async::AudioThreadBridge  *bridge_out;
+      Async::AudioThreadBridge  *bridge_in;
     };
     typedef std::map<std::string, LogicInfo> LogicMap;
 
     static LinkManager *_instance;
 
-    LinkMap     links;
-    LogicMap    logic_map;
-    LogicConSet current_cons;
-    SourceMap   sources;
-    SinkMap     sinks;
-    bool        all_logics_started;
+    LinkMap                   links;
+    LogicMap                  logic_map;
+    LogicConSet               current_cons;
+    Async::AudioRoutingMatrix matrix;
+    bool                      all_logics_started;
+    Async::Application&       app;
 
-    LinkManager(void) : all_logics_started(false) {};
+    LinkManager(void)
+      : all_logics_started(false), app(Async::Application::app()) {};
     LinkManager(const LinkManager&);
     ~LinkManager(void);
 
@@ -359,6 +363,7 @@ class LinkManager : public sigc::trackable
     void onReceivedTgUpdated(LogicBase *src_logic, uint32_t tg);
     void onPublishStateEvent(LogicBase *src_logic,
         const std::string& event_name, const std::string& msg);
+    bool isRegistered(const LogicBase *logic) const;
 
 };  /* class LinkManager */
 
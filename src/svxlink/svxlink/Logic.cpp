@@ -73,6 +73,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncAudioPacer.h>
 #include <AsyncAudioDebugger.h>
 #include <AsyncAudioRecorder.h>
+#include <AsyncAudioLatencyProbe.h>
 #include <common.h>
 #include <config.h>
 
@@ -243,6 +244,11 @@ bool Logic::initialize(void)
     return false;
   }
 
+    // Trace the latency through the receiver, the logic core and the
+    // transmitter as one audio path
+  AudioLatencyProbe::setTrace(rx_name, name());
+  AudioLatencyProbe::setTrace(tx_name, name());
+
   if (!cfg().getValue(name(), "CALLSIGN", m_callsign))
   {
     cerr << "*** ERROR: Config variable " << name() << "/CALLSIGN not set\n";
@@ -414,12 +420,16 @@ bool Logic::initialize(void)
     cleanup();
     return false;
   }
-  rx().squelchOpen.connect(mem_fun(*this, &Logic::squelchOpen));
-  rx().dtmfDigitDetected.connect(mem_fun(*this, &Logic::dtmfDigitDetectedP));
+    // Receiver events are emitted from within the audio processing so they
+    // are queued and handled when the audio processing is done
+  rx().squelchOpen.connect(mem_fun(*this, &Logic::onRxSquelchOpen));
+  rx().dtmfDigitDetected.connect(
+      mem_fun(*this, &Logic::onRxDtmfDigitDetected));
   rx().selcallSequenceDetected.connect(
-	mem_fun(*this, &Logic::selcallSequenceDetected));
+	mem_fun(*this, &Logic::onRxSelcallSequenceDetected));
   rx().setMuteState(Rx::MUTE_NONE);
-  rx().publishStateEvent.connect(mem_fun(*this, &Logic::onPublishStateEvent));
+  rx().publishStateEvent.connect(
+      mem_fun(*this, &Logic::onRxPublishStateEvent));
   prev_rx_src = m_rx;
 
     // This valve is used to turn RX audio on/off into the logic core
@@ -428,6 +438,11 @@ bool Logic::initialize(void)
   prev_rx_src->registerSink(rx_valve, true);
   prev_rx_src = rx_valve;
 
+    // Mark the point where RX audio enter the logic core when tracing latency
+  AudioLatencyProbe *rx_latency_probe = new AudioLatencyProbe(name() + ":rx");
+  prev_rx_src->registerSink(rx_latency_probe, true);
+  prev_rx_src = rx_latency_probe;
+
     // Split the RX audio stream to multiple sinks
   rx_splitter = new AudioSplitter;
   prev_rx_src->registerSink(rx_splitter, true);
@@ -578,6 +593,11 @@ bool Logic::initialize(void)
   tx().transmitterStateChange.connect(
       mem_fun(*this, &Logic::transmitterStateChange));
   tx().publishStateEvent.connect(mem_fun(*this, &Logic::onPublishStateEvent));
+
+    // Mark the point where audio leave the logic core when tracing latency
+  AudioLatencyProbe *tx_latency_probe = new AudioLatencyProbe(name() + ":tx");
+  prev_tx_src->registerSink(tx_latency_probe, true);
+  prev_tx_src = tx_latency_probe;
   prev_tx_src->registerSink(m_tx);
   prev_tx_src = 0;
 
@@ -661,6 +681,16 @@ bool Logic::initialize(void)
      LocationInfo::instance()->aprs_stats.insert(
          pair<string,LocationInfo::AprsStatistics>(name(), lis));
      LocationInfo::instance()->aprs_stats[name()].reset();
+
+       // The receiver telemetry is fed directly instead of through the
+       // event queue. Adding a sample is cheap and coalescing signal level
+       // events in the queue would skew the statistics.
+     rx().signalLevelUpdated.connect(
+         mem_fun(*this, &Logic::onRxSignalLevelUpdated));
+     rx().receiverSignalLevelUpdated.connect(
+         mem_fun(*this, &Logic::onRxReceiverSignalLevelUpdated));
+     rx().receiverSquelchOpen.connect(
+         mem_fun(*this, &Logic::onRxReceiverSquelchOpen));
   }
 
   every_minute_timer.setExpireOffset(100);
@@ -708,7 +738,7 @@ bool Logic::initialize(void)
            << name() << endl;
     }
   }
-  rx().toneDetected.connect(mem_fun(*this, &Logic::detectedTone));
+  rx().toneDetected.connect(mem_fun(*this, &Logic::onRxToneDetected));
 
   cfg().valueUpdated.connect(sigc::mem_fun(*this, &Logic::cfgUpdated));
 
@@ -1055,6 +1085,7 @@ void Logic::squelchOpen(bool is_open)
     struct timeval tv;
     gettimeofday(&tv, NULL);
     LocationInfo::instance()->setReceiving(name(), tv, is_open);
+    LocationInfo::instance()->rxSquelchOpen(rx().name(), tv, is_open);
   }
 
   updateTxCtcss(is_open, TX_CTCSS_SQL_OPEN);
@@ -1075,8 +1106,7 @@ bool Logic::getIdleState(void) const
 
 void Logic::transmitterStateChange(bool is_transmitting)
 {
-  if (LocationInfo::has_instance() &&
-      (LocationInfo::instance()->getTransmitting(name()) != is_transmitting))
+  if (LocationInfo::has_instance())
   {
     struct timeval tv;
     gettimeofday(&tv, NULL);
@@ -1772,6 +1802,61 @@ void Logic::detectedTone(float fq)
 } /* Logic::detectedTone */
 
 
+void Logic::onRxSquelchOpen(bool is_open)
+{
+  queueEvent(EVENT_SQUELCH,
+      sigc::bind(mem_fun(*this, &Logic::squelchOpen), is_open));
+} /* Logic::onRxSquelchOpen */
+
+
+void Logic::onRxDtmfDigitDetected(char digit, int duration)
+{
+  queueEvent(EVENT_DTMF,
+      sigc::bind(mem_fun(*this, &Logic::dtmfDigitDetectedP), digit, duration));
+} /* Logic::onRxDtmfDigitDetected */
+
+
+void Logic::onRxSelcallSequenceDetected(std::string sequence)
+{
+  queueEvent(EVENT_TONE,
+      sigc::bind(mem_fun(*this, &Logic::selcallSequenceDetected), sequence));
+} /* Logic::onRxSelcallSequenceDetected */
+
+
+void Logic::onRxToneDetected(float fq)
+{
+  queueEvent(EVENT_TONE, sigc::bind(mem_fun(*this, &Logic::detectedTone), fq));
+} /* Logic::onRxToneDetected */
+
+
+void Logic::onRxPublishStateEvent(const string &event_name, const string &msg)
+{
+  queueEvent(EVENT_SIGLEV,
+      sigc::bind(mem_fun(*this, &Logic::onPublishStateEvent), event_name, msg),
+      event_name);
+} /* Logic::onRxPublishStateEvent */
+
+
+void Logic::onRxSignalLevelUpdated(float siglev)
+{
+  LocationInfo::instance()->rxSignalLevelUpdated(rx().name(), siglev);
+} /* Logic::onRxSignalLevelUpdated */
+
+
+void Logic::onRxReceiverSignalLevelUpdated(const string &rx_name, float siglev)
+{
+  LocationInfo::instance()->rxSignalLevelUpdated(rx_name, siglev);
+} /* Logic::onRxReceiverSignalLevelUpdated */
+
+
+void Logic::onRxReceiverSquelchOpen(const string &rx_name, bool is_open)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  LocationInfo::instance()->rxSquelchOpen(rx_name, tv, is_open);
+} /* Logic::onRxReceiverSquelchOpen */
+
+
 void Logic::cfgUpdated(const std::string& section, const std::string& tag)
 {
   if (section == name())
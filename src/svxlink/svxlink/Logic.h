@@ -311,6 +311,16 @@ class Logic : public LogicBase
     void onPublishStateEvent(const std::string &event_name,
                              const std::string &msg);
     void detectedTone(float fq);
+    void onRxSquelchOpen(bool is_open);
+    void onRxDtmfDigitDetected(char digit, int duration);
+    void onRxSelcallSequenceDetected(std::string sequence);
+    void onRxToneDetected(float fq);
+    void onRxPublishStateEvent(const std::string &event_name,
+                               const std::string &msg);
+    void onRxSignalLevelUpdated(float siglev);
+    void onRxReceiverSignalLevelUpdated(const std::string &rx_name,
+                                        float siglev);
+    void onRxReceiverSquelchOpen(const std::string &rx_name, bool is_open);
     void cfgUpdated(const std::string& section, const std::string& tag);
 
 };  /* class Logic */
@@ -32,6 +32,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <algorithm>
+#include <iostream>
 
 
 /****************************************************************************
@@ -41,8 +43,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <AsyncConfig.h>
-#include <AsyncAudioSelector.h>
-#include <AsyncAudioSplitter.h>
+#include <AsyncMetrics.h>
 
 
 /****************************************************************************
@@ -111,22 +112,140 @@ using namespace Async;
  ****************************************************************************/
 
 LogicBase::LogicBase(Config &cfg, const string& name)
-  : m_cfg(cfg), m_name(name), m_is_idle(true)
+  : m_cfg(cfg), m_app(Application::app()), m_alive(make_shared<bool>(true)),
+    m_name(name), m_is_idle(true), m_received_tg(0),
+    m_event_timer(0, Timer::TYPE_ONESHOT, false)
 {
+  m_event_timer.expired.connect(
+      mem_fun(*this, &LogicBase::processEventQueue));
+
+  MetricsRegistry& metrics = MetricsRegistry::instance();
+  const MetricsRegistry::Labels labels = {{"logic", name}};
+  const vector<double> bounds = {
+    0.0001, 0.0005, 0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1.0
+  };
+  m_event_queue_depth = &metrics.gauge("svxlink_logic_event_queue_depth",
+      "Number of receiver events waiting to be handled by the logic core",
+      labels);
+  m_event_delay = &metrics.histogram("svxlink_logic_event_delay_seconds",
+      "Time from when a receiver event is queued until it is handled",
+      bounds, labels);
+  m_event_handler_time = &metrics.histogram(
+      "svxlink_logic_event_handler_seconds",
+      "Time spent in the handler for a receiver event", bounds, labels);
+  m_events_coalesced = &metrics.counter("svxlink_logic_events_coalesced_total",
+      "Number of signal level events replaced by a newer event", labels);
+  const char *event_type_names[] = { "squelch", "dtmf", "tone", "siglev" };
+  for (int type=EVENT_SQUELCH; type<=EVENT_SIGLEV; ++type)
+  {
+    MetricsRegistry::Labels type_labels(labels);
+    type_labels.push_back(make_pair("type", event_type_names[type]));
+    m_events_dropped[type] = &metrics.counter(
+        "svxlink_logic_events_dropped_total",
+        "Number of receiver events dropped since the event queue was full",
+        type_labels);
+  }
 } /* LogicBase::LogicBase */
 
 
 LogicBase::~LogicBase(void)
 {
+  *m_alive = false;
 } /* LogicBase::~LogicBase */
 
 
+void LogicBase::runInLogicThread(Application::Task task)
+{
+  if (m_app.isCurrentThread())
+  {
+    task();
+    return;
+  }
+
+  std::shared_ptr<bool> alive(m_alive);
+  m_app.post([alive, task]()
+      {
+        if (*alive)
+        {
+          task();
+        }
+      });
+} /* LogicBase::runInLogicThread */
+
+
 /****************************************************************************
  *
  * Protected member functions
  *
  ****************************************************************************/
 
+void LogicBase::queueEvent(EventType type, const sigc::slot<void>& handler,
+                           const string& coalesce_key)
+{
+  const auto now = chrono::steady_clock::now();
+
+  if (type == EVENT_SQUELCH)
+  {
+      // The squelch state must be known before the audio that follow is
+      // handled. The events queued before the squelch event are handled
+      // first to keep the order.
+    processEventQueue(0);
+    QueuedEvent event;
+    event.handler = handler;
+    event.queued = now;
+    handleQueuedEvent(event);
+    return;
+  }
+
+  if (type == EVENT_SIGLEV)
+  {
+    auto it = find_if(m_siglev_events.begin(), m_siglev_events.end(),
+        [&](const QueuedEvent& event) { return event.key == coalesce_key; });
+    if (it != m_siglev_events.end())
+    {
+      it->handler = handler;
+      m_events_coalesced->inc();
+      return;
+    }
+  }
+
+  if (m_ctrl_events.size() + m_siglev_events.size() >= MAX_QUEUED_EVENTS)
+  {
+      // Make room for more important events by dropping signal level events
+    if ((type != EVENT_SIGLEV) && !m_siglev_events.empty())
+    {
+      m_siglev_events.pop_front();
+      m_events_dropped[EVENT_SIGLEV]->inc();
+    }
+    else
+    {
+      m_events_dropped[type]->inc();
+      if (type == EVENT_DTMF)
+      {
+        cerr << "*** WARNING: The receiver event queue is full in logic "
+             << m_name << ". A DTMF digit was dropped." << endl;
+      }
+      return;
+    }
+  }
+
+  QueuedEvent event;
+  event.handler = handler;
+  event.key = coalesce_key;
+  event.queued = now;
+  if (type == EVENT_SIGLEV)
+  {
+    m_siglev_events.push_back(event);
+  }
+  else
+  {
+    m_ctrl_events.push_back(event);
+  }
+  m_event_queue_depth->set(m_ctrl_events.size() + m_siglev_events.size());
+  m_event_timer.setEnable(true);
+} /* LogicBase::queueEvent */
+
+
 
 
 /****************************************************************************
@@ -135,6 +254,35 @@ LogicBase::~LogicBase(void)
  *
  ****************************************************************************/
 
+void LogicBase::processEventQueue(Async::Timer *t)
+{
+  m_event_timer.setEnable(false);
+
+    // Handlers may queue new events so the queues are checked again after
+    // each handled event
+  while (!m_ctrl_events.empty() || !m_siglev_events.empty())
+  {
+    EventQueue& queue =
+      !m_ctrl_events.empty() ? m_ctrl_events : m_siglev_events;
+    QueuedEvent event(queue.front());
+    queue.pop_front();
+    m_event_queue_depth->set(m_ctrl_events.size() + m_siglev_events.size());
+    handleQueuedEvent(event);
+  }
+} /* LogicBase::processEventQueue */
+
+
+void LogicBase::handleQueuedEvent(QueuedEvent& event)
+{
+  const auto start = chrono::steady_clock::now();
+  m_event_delay->observe(
+      chrono::duration<double>(start - event.queued).count());
+  event.handler();
+  m_event_handler_time->observe(
+      chrono::duration<double>(chrono::steady_clock::now() - start).count());
+} /* LogicBase::handleQueuedEvent */
+
+
 
 
 /*
@@ -36,6 +36,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <string>
+#include <deque>
+#include <chrono>
+#include <memory>
 
 #include <sigc++/sigc++.h>
 
@@ -46,6 +49,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <AsyncTimer.h>
+#include <AsyncApplication.h>
 
 
 /****************************************************************************
@@ -69,6 +74,9 @@ namespace Async
   class Config;
   class AudioSink;
   class AudioSource;
+  class MetricGauge;
+  class MetricHistogram;
+  class MetricCounter;
 };
 
 
@@ -124,6 +132,15 @@ The LogicBase class can be used to implement all sorts of audio sources
 and sinks and not just transceiver based logic cores.
 LogicBase is a pure virtual class so it cannot be instatiated on its own.
 
+Events detected in the audio path, like squelch changes and DTMF digits,
+should not be handled directly from the audio processing call stack since a
+slow event handler would then stall the audio processing in the middle of a
+block. Such events are put in a queue using the queueEvent function. The
+queue is processed when the current audio processing has finished, that is
+when control has returned to the main loop. Squelch events are the exception.
+The logic core must know that the squelch is open before the audio that
+follow, so they are handled at once, right after the events already queued.
+
 @example DummyLogic.h
 */
 class LogicBase : public sigc::trackable
@@ -135,13 +152,12 @@ class LogicBase : public sigc::trackable
      * @param   cfg A previously initialized configuration object
      * @param   name The name of the logic core
      */
-    LogicBase(Async::Config& cfg, const std::string& name)
-      : m_cfg(cfg), m_name(name), m_is_idle(true), m_received_tg(0) {}
+    LogicBase(Async::Config& cfg, const std::string& name);
 
     /**
      * @brief 	Destructor
      */
-    virtual ~LogicBase(void) {}
+    virtual ~LogicBase(void);
 
     /**
      * @brief 	Initialize the logic core
@@ -172,6 +188,28 @@ class LogicBase : public sigc::trackable
      */
     bool isIdle(void) const { return m_is_idle; }
 
+    /**
+     * @brief   Get the application object that run this logic core
+     * @return  Returns the application object of the thread that created
+     *          the logic core
+     *
+     * Logic cores may be run in their own threads. All functions of the
+     * logic core must then be called from that thread. Use the
+     * runInLogicThread function to call the logic core from other threads.
+     */
+    Async::Application& app(void) const { return m_app; }
+
+    /**
+     * @brief   Run a task in the thread of the logic core
+     * @param   task The task to run
+     *
+     * If called from the thread running the logic core, the task is run
+     * directly. Otherwise it is posted to the thread of the logic core and
+     * run from its event loop. Tasks posted to a logic core that is deleted
+     * before they have been run are thrown away.
+     */
+    void runInLogicThread(Async::Application::Task task);
+
     /**
      * @brief   Set state for logic linking muting
      * @param   mute Set to \em true to mute this logic core
@@ -295,6 +333,45 @@ class LogicBase : public sigc::trackable
                  const std::string&> publishStateEvent;
 
   protected:
+    /**
+     * @brief   Types of events that can be queued
+     *
+     * Squelch, DTMF and tone events are handled first and in the order they
+     * were queued, since e.g. a squelch close must be handled after the DTMF
+     * digits received before it. Signal level events are handled last. They
+     * are coalesced so that only the latest event for each key is handled.
+     */
+    typedef enum
+    {
+      EVENT_SQUELCH,  ///< A squelch state change, handled at once
+      EVENT_DTMF,     ///< A detected DTMF digit
+      EVENT_TONE,     ///< A detected tone or selective call sequence
+      EVENT_SIGLEV    ///< A signal level or other state update
+    } EventType;
+
+    /**
+     * @brief   The maximum number of events waiting to be handled
+     */
+    static const size_t MAX_QUEUED_EVENTS = 64;
+
+    /**
+     * @brief   Queue an event for deferred handling
+     * @param   type The type of event
+     * @param   handler The function to call to handle the event
+     * @param   coalesce_key The key to coalesce EVENT_SIGLEV events on
+     *
+     * The handler will be called when control has returned to the main
+     * loop. A queued EVENT_SIGLEV event with the same key will be replaced
+     * by this one. When the queue is full, the oldest signal level event is
+     * dropped to make room for a DTMF or tone event. If there is no signal
+     * level event to drop, the new event is dropped. Dropped events are
+     * counted per event type and a dropped DTMF digit is also logged.
+     * An EVENT_SQUELCH event is handled before this function return, after
+     * all events that are already queued.
+     */
+    void queueEvent(EventType type, const sigc::slot<void>& handler,
+                    const std::string& coalesce_key="");
+
     /**
      * @brief   Used by derived classes to set the idle state of the logic core
      * @param   set_idle \em True to set to idle or \em false to set to active
@@ -325,10 +402,33 @@ class LogicBase : public sigc::trackable
     }
 
   private:
-    Async::Config     	  &m_cfg;
-    std::string       	  m_name;
-    bool      	      	  m_is_idle;
-    uint32_t              m_received_tg;
+    struct QueuedEvent
+    {
+      sigc::slot<void>                        handler;
+      std::string                             key;
+      std::chrono::steady_clock::time_point   queued;
+    };
+    typedef std::deque<QueuedEvent> EventQueue;
+
+    Async::Config             &m_cfg;
+    Async::Application        &m_app;
+    std::shared_ptr<bool>     m_alive;
+    std::string               m_name;
+    bool                      m_is_idle;
+    uint32_t                  m_received_tg;
+    EventQueue                m_ctrl_events;
+    EventQueue                m_siglev_events;
+    Async::Timer              m_event_timer;
+    Async::MetricGauge*       m_event_queue_depth;
+    Async::MetricHistogram*   m_event_delay;
+    Async::MetricHistogram*   m_event_handler_time;
+    Async::MetricCounter*     m_events_coalesced;
+    Async::MetricCounter*     m_events_dropped[EVENT_SIGLEV+1];
+
+    LogicBase(const LogicBase&);
+    LogicBase& operator=(const LogicBase&);
+    void processEventQueue(Async::Timer *t);
+    void handleQueuedEvent(QueuedEvent& event);
 
 };  /* class LogicBase */
 
@@ -0,0 +1,257 @@
+//
+// Test for the receiver event queue in LogicBase.
+//
+// A minimal logic core records the order in which queued event handlers are
+// called. The following is tested, one step at a time with the event loop
+// running in between so that the queue is processed:
+//
+//   - Events are not handled until control has returned to the main loop
+//   - DTMF and tone events are handled in FIFO order, before any signal
+//     level events
+//   - Signal level events are coalesced per key, keeping the queue position
+//     of the first event but calling the handler of the last one
+//   - When the queue is full, signal level events are dropped, oldest first,
+//     to make room for DTMF and tone events. When there are no signal level
+//     events left, new events are dropped. Drops are counted per event type.
+//   - Squelch events are handled at once, after the events already queued,
+//     and are never dropped
+//
+// Usage: LogicBaseQueueTest
+//
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <AsyncCppApplication.h>
+#include <AsyncConfig.h>
+#include <AsyncTimer.h>
+#include <AsyncMetrics.h>
+
+#include "LogicBase.h"
+
+using namespace std;
+using namespace Async;
+
+
+static const char *LOGIC_NAME = "QueueTestLogic";
+
+
+class TestLogic : public LogicBase
+{
+  public:
+    using LogicBase::EventType;
+    using LogicBase::EVENT_SQUELCH;
+    using LogicBase::EVENT_DTMF;
+    using LogicBase::EVENT_TONE;
+    using LogicBase::EVENT_SIGLEV;
+
+    vector<string> handled;
+
+    TestLogic(Config& cfg) : LogicBase(cfg, LOGIC_NAME) {}
+
+    virtual AudioSink *logicConIn(void) { return 0; }
+    virtual AudioSource *logicConOut(void) { return 0; }
+
+    void queue(EventType type, const string& what, const string& key="")
+    {
+      queueEvent(type, sigc::bind(mem_fun(*this, &TestLogic::handle), what),
+                 key);
+    }
+
+    static size_t maxQueuedEvents(void) { return MAX_QUEUED_EVENTS; }
+
+    static uint64_t dropped(const string& type)
+    {
+      return counter("svxlink_logic_events_dropped_total", type).value();
+    }
+
+    static uint64_t coalesced(void)
+    {
+      return counter("svxlink_logic_events_coalesced_total", "").value();
+    }
+
+  private:
+    void handle(string what)
+    {
+      handled.push_back(what);
+    }
+
+    static MetricCounter& counter(const string& name, const string& type)
+    {
+      MetricsRegistry::Labels labels = {{"logic", LOGIC_NAME}};
+      if (!type.empty())
+      {
+        labels.push_back(make_pair("type", type));
+      }
+      return MetricsRegistry::instance().counter(name, "", labels);
+    }
+};
+
+
+class QueueTest : public sigc::trackable
+{
+  public:
+    QueueTest(void)
+      : failed(false), m_logic(m_cfg), m_step(0),
+        m_step_timer(20, Timer::TYPE_PERIODIC)
+    {
+      m_step_timer.expired.connect(mem_fun(*this, &QueueTest::nextStep));
+    }
+
+    bool failed;
+
+  private:
+    Config      m_cfg;
+    TestLogic   m_logic;
+    unsigned    m_step;
+    Timer       m_step_timer;
+    uint64_t    m_coalesced;
+
+    void expect(const string& test, const vector<string>& expected)
+    {
+      if (m_logic.handled != expected)
+      {
+        cout << "*** " << test << ": Expected [" << join(expected)
+             << "] but got [" << join(m_logic.handled) << "]" << endl;
+        failed = true;
+      }
+      m_logic.handled.clear();
+    }
+
+    void expectCount(const string& test, uint64_t count, uint64_t expected)
+    {
+      if (count != expected)
+      {
+        cout << "*** " << test << ": Expected " << expected
+             << " but got " << count << endl;
+        failed = true;
+      }
+    }
+
+    static string join(const vector<string>& v)
+    {
+      ostringstream ss;
+      for (size_t i=0; i<v.size(); ++i)
+      {
+        ss << (i > 0 ? " " : "") << v[i];
+      }
+      return ss.str();
+    }
+
+    static string numbered(const string& prefix, unsigned n)
+    {
+      ostringstream ss;
+      ss << prefix << n;
+      return ss.str();
+    }
+
+    void nextStep(Timer *t)
+    {
+      switch (m_step++)
+      {
+        case 0:
+          m_logic.queue(TestLogic::EVENT_DTMF, "1");
+          m_logic.queue(TestLogic::EVENT_SIGLEV, "a", "a");
+          m_logic.queue(TestLogic::EVENT_TONE, "t");
+          m_logic.queue(TestLogic::EVENT_DTMF, "2");
+          expect("Deferred handling", {});
+          break;
+
+        case 1:
+          expect("FIFO order", {"1", "t", "2", "a"});
+          m_coalesced = TestLogic::coalesced();
+          m_logic.queue(TestLogic::EVENT_SIGLEV, "a1", "a");
+          m_logic.queue(TestLogic::EVENT_SIGLEV, "b1", "b");
+          m_logic.queue(TestLogic::EVENT_SIGLEV, "a2", "a");
+          m_logic.queue(TestLogic::EVENT_SIGLEV, "a3", "a");
+          break;
+
+        case 2:
+          expect("Coalescing", {"a3", "b1"});
+          expectCount("Coalesced count", TestLogic::coalesced() - m_coalesced,
+                      2);
+          fillQueue();
+          break;
+
+        case 3:
+          m_step_timer.setEnable(false);
+          Application::app().quit();
+          break;
+      }
+    }
+
+    void fillQueue(void)
+    {
+        // Fill the queue with signal level events and then DTMF digits
+      const unsigned siglev_cnt = 10;
+      const unsigned max_cnt = TestLogic::maxQueuedEvents();
+      vector<string> expected;
+      for (unsigned i=0; i<siglev_cnt; ++i)
+      {
+        m_logic.queue(TestLogic::EVENT_SIGLEV, numbered("s", i),
+                      numbered("s", i));
+      }
+      for (unsigned i=0; i<max_cnt-siglev_cnt; ++i)
+      {
+        m_logic.queue(TestLogic::EVENT_DTMF, numbered("d", i));
+        expected.push_back(numbered("d", i));
+      }
+
+        // The queue is now full. Each new control event push out the
+        // oldest signal level event.
+      const uint64_t siglev_dropped = TestLogic::dropped("siglev");
+      for (unsigned i=0; i<siglev_cnt; ++i)
+      {
+        m_logic.queue((i % 2) ? TestLogic::EVENT_TONE : TestLogic::EVENT_DTMF,
+                      numbered("x", i));
+        expected.push_back(numbered("x", i));
+      }
+      expectCount("Dropped signal level events",
+                  TestLogic::dropped("siglev") - siglev_dropped, siglev_cnt);
+
+        // With only control events left, new events are dropped
+      const uint64_t dtmf_dropped = TestLogic::dropped("dtmf");
+      const uint64_t tone_dropped = TestLogic::dropped("tone");
+      m_logic.queue(TestLogic::EVENT_DTMF, "lost_dtmf");
+      m_logic.queue(TestLogic::EVENT_TONE, "lost_tone");
+      m_logic.queue(TestLogic::EVENT_SIGLEV, "lost_siglev", "new");
+      expectCount("Dropped DTMF digits",
+                  TestLogic::dropped("dtmf") - dtmf_dropped, 1);
+      expectCount("Dropped tone events",
+                  TestLogic::dropped("tone") - tone_dropped, 1);
+      expectCount("Dropped new signal level event",
+                  TestLogic::dropped("siglev") - siglev_dropped,
+                  siglev_cnt + 1);
+      expect("Full queue not handled", {});
+
+        // A squelch event is never dropped and is handled at once, after
+        // the queued events
+      const uint64_t sql_dropped = TestLogic::dropped("squelch");
+      m_logic.queue(TestLogic::EVENT_SQUELCH, "sql_open");
+      expected.push_back("sql_open");
+      expect("Squelch on full queue", expected);
+      expectCount("Dropped squelch events",
+                  TestLogic::dropped("squelch") - sql_dropped, 0);
+
+        // A squelch event on an empty queue is also handled at once
+      m_logic.queue(TestLogic::EVENT_SQUELCH, "sql_close");
+      expect("Squelch on empty queue", {"sql_close"});
+    }
+};
+
+
+int main(int argc, const char **argv)
+{
+  CppApplication app;
+  QueueTest test;
+  app.exec();
+
+  if (test.failed)
+  {
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
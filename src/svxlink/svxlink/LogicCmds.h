@@ -221,12 +221,7 @@ class LinkCmd : public Command
      */
     void operator ()(const std::string& subcmd)
     {
-      std::string event =
-          LinkManager::instance()->cmdReceived(link, logic, subcmd);
-      if (!event.empty())
-      {
-        logic->processEvent(event);
-      }
+      LinkManager::instance()->cmdReceived(link, logic, subcmd);
     }
 
   protected:
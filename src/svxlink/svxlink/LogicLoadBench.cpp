@@ -0,0 +1,946 @@
+//
+// Load benchmark for the SvxLink logic cores.
+//
+// A number of SimplexLogic and RepeaterLogic cores are started in one
+// process, just like in svxlink, but with simulated receivers and
+// transmitters. The simulated receiver is a LocalRxBase, so the whole local
+// receiver chain with VOX squelch and software DTMF decoder is run, fed with
+// synthetic audio in 16ms blocks like from a sound card. The simulated
+// transmitter run the audio through the PTT control and a real time pacer,
+// just like a local transmitter writing to a sound card. By default all
+// logics are connected through one LinkManager link so that a transmission on
+// one receiver is sent out on all transmitters.
+//
+// Each receiver run the same script: The carrier is switched on for the
+// burst time every period, with a 1kHz tone as audio. The DTMF digits are
+// sent 500ms into each burst, 100ms per digit with 100ms pauses. The scripts
+// of the receivers are spread out evenly over the period unless --sync is
+// given. When done, the following is printed:
+//
+//   cpu       - User and system CPU time and the load in percent of one core,
+//               in total and per logic
+//   loop lag  - How late a 10ms timer fire, showing event loop congestion
+//   sql_open  - Carrier on until the receiver report an open squelch
+//   sql_close - Carrier off until the receiver report a closed squelch
+//   tx_on     - Carrier on until a transmitter is keyed up
+//   tx_audio  - Carrier on until audio come out of a transmitter
+//   dtmf      - End of a DTMF digit until the receiver report it
+//
+// All stages are measured from when the first audio block with the new state
+// is handed to the receiver so the time it take to fill a sound card block
+// is not included. The transmitter stages are only measured for the first
+// event after the latest carrier on, so with overlapping bursts they are
+// measured from the most recent carrier. The latencies are printed as count,
+// mean, 99th percentile and max in milliseconds.
+//
+// A base configuration file may be given with --config. Anything set for
+// the generated BenchLogicN, BenchRxN and BenchTxN sections in that file
+// override the defaults set by the benchmark. It may also contain module
+// sections, used with --modules, and extra logics, e.g. a ReflectorLogic
+// pointing at a local svxreflector, started with --extra-logics.
+//
+// With --threads, the logics are spread out round robin over the given number
+// of logic threads, like with LOGIC_THREADS in svxlink, while the link
+// manager run in the main thread. The loop lag is then measured for all
+// event loops.
+//
+// Usage: LogicLoadBench [--help] for a list of options
+//
+
+#include <popt.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <mutex>
+
+#include <AsyncCppApplication.h>
+#include <AsyncApplicationThread.h>
+#include <AsyncConfig.h>
+#include <AsyncTimer.h>
+#include <AsyncAudioSource.h>
+#include <AsyncAudioSink.h>
+#include <AsyncAudioPacer.h>
+#include <AsyncAudioLatencyProbe.h>
+#include <LocalRxBase.h>
+#include <PttCtrl.h>
+#include <Tx.h>
+#include <common.h>
+#include <config.h>
+
+#include "LinkManager.h"
+#include "SimplexLogic.h"
+#include "RepeaterLogic.h"
+#include "ReflectorLogic.h"
+#include "DummyLogic.h"
+
+using namespace std;
+using namespace Async;
+
+
+#define PROGRAM_NAME "LogicLoadBench"
+
+static const int BLOCK_SIZE = 256;
+static const int DTMF_DELAY = 500;
+static const int DTMF_DIGIT_TIME = 100;
+static const int DTMF_PAUSE_TIME = 100;
+static const float TONE_FQ = 1000.0f;
+static const float TONE_AMP = 0.5f;
+static const float DTMF_AMP = 0.3f;
+static const float NOISE_AMP = 0.001f;
+static const float TX_AUDIO_THRESH = 0.01f;
+static const int LOOP_LAG_INTERVAL = 10;
+
+static int          logic_cnt = 4;
+static int          repeater_cnt = -1;
+static int          duration = 60;
+static int          period = 10000;
+static int          burst = 4000;
+static char         *dtmf_digits = NULL;
+static int          sync_bursts = 0;
+static int          no_link = 0;
+static char         *modules = NULL;
+static char         *extra_logics = NULL;
+static char         *base_config = NULL;
+static char         *event_handler = NULL;
+static int          latency_trace = 0;
+static int          thread_cnt = 0;
+static int          verbose = 0;
+static string       event_wrapper;
+
+
+static int64_t nowUs(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+
+class Stage
+{
+  public:
+    void add(int64_t us) { m_lat.push_back(us / 1000.0); }
+
+    void print(const string& name)
+    {
+      double mean = 0.0, p99 = 0.0, max_lat = 0.0;
+      if (!m_lat.empty())
+      {
+        for (auto lat : m_lat)
+        {
+          mean += lat;
+        }
+        mean /= m_lat.size();
+        sort(m_lat.begin(), m_lat.end());
+        p99 = m_lat[m_lat.size() * 99 / 100];
+        max_lat = m_lat.back();
+      }
+      cout << left << setw(10) << name << right
+           << setw(8) << m_lat.size()
+           << setw(10) << mean << setw(10) << p99 << setw(10) << max_lat
+           << endl;
+    }
+
+  private:
+    vector<double> m_lat;
+};
+
+static Stage      sql_open_stage;
+static Stage      sql_close_stage;
+static Stage      tx_on_stage;
+static Stage      tx_audio_stage;
+static Stage      dtmf_stage;
+static Stage      loop_lag_stage;
+static int        carriers_active = 0;
+static unsigned   carrier_seq = 0;
+static int64_t    carrier_on_us = 0;
+static unsigned   digits_sent = 0;
+static unsigned   digits_detected = 0;
+static unsigned   digits_bad = 0;
+static uint64_t   rx_overruns = 0;
+
+  // Protect the statistics above when the logics run in several threads
+static std::mutex stats_mutex;
+
+
+  // Synthetic sound card input running the receiver script
+class ScriptSource : public AudioSource, public sigc::trackable
+{
+  public:
+    ScriptSource(void)
+      : m_timer(1000 * BLOCK_SIZE / INTERNAL_SAMPLE_RATE,
+                Timer::TYPE_PERIODIC, false),
+        m_script_start_us(0), m_offset(0), m_open_us(0), m_blocks(0),
+        m_phase(0), m_carrier(false), m_digit(0)
+    {
+      m_timer.expired.connect(mem_fun(*this, &ScriptSource::writeBlocks));
+    }
+
+    void start(int64_t script_start_us, int offset_ms)
+    {
+      m_script_start_us = script_start_us;
+      m_offset = offset_ms;
+    }
+
+    void setEnabled(bool enable)
+    {
+      m_open_us = nowUs();
+      m_blocks = 0;
+      m_timer.setEnable(enable);
+    }
+
+    virtual void resumeOutput(void) {}
+    virtual void allSamplesFlushed(void) {}
+
+    sigc::signal<void, bool> carrierChanged;
+    sigc::signal<void, char> digitSent;
+
+  private:
+    Timer     m_timer;
+    int64_t   m_script_start_us;
+    int       m_offset;
+    int64_t   m_open_us;
+    uint64_t  m_blocks;
+    uint64_t  m_phase;
+    bool      m_carrier;
+    char      m_digit;
+    float     m_buf[BLOCK_SIZE];
+
+    void writeBlocks(Timer *t)
+    {
+      const int64_t now = nowUs();
+      const uint64_t due =
+        (now - m_open_us) * INTERNAL_SAMPLE_RATE / 1000000 / BLOCK_SIZE;
+      while (m_blocks < due)
+      {
+        writeBlock(now);
+        ++m_blocks;
+      }
+    }
+
+    void writeBlock(int64_t now)
+    {
+      bool carrier = false;
+      char digit = 0;
+      const int64_t t0 = (now - m_script_start_us) / 1000 - m_offset;
+      if ((m_script_start_us > 0) && (t0 >= 0))
+      {
+        const int64_t t = t0 % period;
+        carrier = (t < burst);
+        const int64_t dt = t - DTMF_DELAY;
+        const int64_t slot = DTMF_DIGIT_TIME + DTMF_PAUSE_TIME;
+        if (carrier && (dtmf_digits != NULL) && (dt >= 0) &&
+            (dt / slot < static_cast<int64_t>(strlen(dtmf_digits))) &&
+            (dt % slot < DTMF_DIGIT_TIME))
+        {
+          digit = dtmf_digits[dt / slot];
+        }
+      }
+
+      if ((m_digit != 0) && (digit != m_digit))
+      {
+        digitSent(m_digit);
+      }
+      m_digit = digit;
+      if (carrier != m_carrier)
+      {
+        m_carrier = carrier;
+        carrierChanged(carrier);
+      }
+
+      float fq1 = TONE_FQ, fq2 = 0.0f, amp = TONE_AMP;
+      if (digit != 0)
+      {
+        digitFq(digit, fq1, fq2);
+        amp = DTMF_AMP;
+      }
+      for (int i=0; i<BLOCK_SIZE; ++i)
+      {
+        const float noise = NOISE_AMP * (2.0f * rand() / RAND_MAX - 1.0f);
+        const float tt =
+          static_cast<float>(m_phase + i) / INTERNAL_SAMPLE_RATE;
+        float sample = noise;
+        if (carrier)
+        {
+          sample += amp * sinf(2.0f * M_PI * fq1 * tt);
+          if (fq2 > 0.0f)
+          {
+            sample += amp * sinf(2.0f * M_PI * fq2 * tt);
+          }
+        }
+        m_buf[i] = sample;
+      }
+      m_phase = (m_phase + BLOCK_SIZE) % INTERNAL_SAMPLE_RATE;
+
+      const int written = sinkWriteSamples(m_buf, BLOCK_SIZE);
+      std::lock_guard<std::mutex> lk(stats_mutex);
+      rx_overruns += BLOCK_SIZE - written;
+    }
+
+    static void digitFq(char digit, float& row_fq, float& col_fq)
+    {
+      static const float row[] = { 697.0f, 770.0f, 852.0f, 941.0f };
+      static const float col[] = { 1209.0f, 1336.0f, 1477.0f, 1633.0f };
+      static const char *keys = "123A456B789C*0#D";
+      const char *pos = strchr(keys, digit);
+      const int idx = (pos != NULL) ? pos - keys : 0;
+      row_fq = row[idx / 4];
+      col_fq = col[idx % 4];
+    }
+};
+
+
+class BenchRx : public LocalRxBase
+{
+  public:
+    BenchRx(Config &cfg, const string& name)
+      : LocalRxBase(cfg, name), m_app(Application::app())
+    {
+      m_src.carrierChanged.connect(mem_fun(*this, &BenchRx::carrierChanged));
+      m_src.digitSent.connect(mem_fun(*this, &BenchRx::digitSent));
+      squelchOpen.connect(mem_fun(*this, &BenchRx::squelchChanged));
+      dtmfDigitDetected.connect(mem_fun(*this, &BenchRx::digitDetected));
+    }
+
+    void startScript(int64_t script_start_us, int offset_ms)
+    {
+      if (!m_app.isCurrentThread())
+      {
+        m_app.post([=]() { startScript(script_start_us, offset_ms); });
+        return;
+      }
+      m_src.start(script_start_us, offset_ms);
+    }
+
+  protected:
+    virtual bool audioOpen(void)
+    {
+      m_src.setEnabled(true);
+      return true;
+    }
+
+    virtual void audioClose(void) { m_src.setEnabled(false); }
+    virtual int audioSampleRate(void) { return INTERNAL_SAMPLE_RATE; }
+    virtual AudioSource *audioSource(void) { return &m_src; }
+
+  private:
+    Application&              m_app;
+    ScriptSource              m_src;
+    int64_t                   m_carrier_us = 0;
+    bool                      m_carrier = false;
+    bool                      m_sql_measured = false;
+    deque<pair<char,int64_t>> m_digits;
+
+    void carrierChanged(bool is_on)
+    {
+      m_carrier_us = nowUs();
+      m_carrier = is_on;
+      m_sql_measured = false;
+      std::lock_guard<std::mutex> lk(stats_mutex);
+      if (is_on)
+      {
+        ++carriers_active;
+        ++carrier_seq;
+        carrier_on_us = m_carrier_us;
+      }
+      else
+      {
+        --carriers_active;
+      }
+    }
+
+    void squelchChanged(bool is_open)
+    {
+      if (m_sql_measured || (m_carrier_us == 0) || (is_open != m_carrier))
+      {
+        return;
+      }
+      m_sql_measured = true;
+      std::lock_guard<std::mutex> lk(stats_mutex);
+      (is_open ? sql_open_stage : sql_close_stage).add(nowUs() - m_carrier_us);
+    }
+
+    void digitSent(char digit)
+    {
+      std::lock_guard<std::mutex> lk(stats_mutex);
+      ++digits_sent;
+      m_digits.push_back(make_pair(digit, nowUs()));
+    }
+
+    void digitDetected(char digit, int duration_ms)
+    {
+      std::lock_guard<std::mutex> lk(stats_mutex);
+      if (m_digits.empty() || (m_digits.front().first != digit))
+      {
+        ++digits_bad;
+        m_digits.clear();
+        return;
+      }
+      ++digits_detected;
+      dtmf_stage.add(nowUs() - m_digits.front().second);
+      m_digits.pop_front();
+    }
+};
+
+
+  // Synthetic sound card output measuring the transmitted audio
+class TxMeter : public AudioSink
+{
+  public:
+    virtual int writeSamples(const float *samples, int count)
+    {
+      float peak = 0.0f;
+      for (int i=0; i<count; ++i)
+      {
+        peak = max(peak, fabsf(samples[i]));
+      }
+      if (peak >= TX_AUDIO_THRESH)
+      {
+        audioDetected();
+      }
+      return count;
+    }
+
+    virtual void flushSamples(void) { sourceAllSamplesFlushed(); }
+
+    sigc::signal<void> audioDetected;
+};
+
+
+class BenchTx : public Tx
+{
+  public:
+    BenchTx(Config &cfg, const string& name)
+      : Tx(name), m_cfg(cfg), m_ptt_ctrl(0),
+        m_pacer(INTERNAL_SAMPLE_RATE, BLOCK_SIZE, 0),
+        m_on_seq(0), m_audio_seq(0)
+    {
+    }
+
+    virtual ~BenchTx(void)
+    {
+      clearHandler();
+      delete m_ptt_ctrl;
+    }
+
+    virtual bool initialize(void)
+    {
+      int tx_delay = 0;
+      m_cfg.getValue(name(), "TX_DELAY", tx_delay);
+      m_ptt_ctrl = new PttCtrl(tx_delay);
+      m_ptt_ctrl->transmitterStateChange.connect(
+          mem_fun(*this, &BenchTx::transmit));
+      setHandler(m_ptt_ctrl);
+      m_ptt_ctrl->registerSink(&m_pacer);
+      m_pacer.registerSink(&m_meter);
+      m_meter.audioDetected.connect(mem_fun(*this, &BenchTx::audioDetected));
+      return true;
+    }
+
+    virtual void setTxCtrlMode(TxCtrlMode mode)
+    {
+      m_ptt_ctrl->setTxCtrlMode(mode);
+    }
+
+  private:
+    Config&     m_cfg;
+    PttCtrl     *m_ptt_ctrl;
+    AudioPacer  m_pacer;
+    TxMeter     m_meter;
+    unsigned    m_on_seq;
+    unsigned    m_audio_seq;
+
+    void transmit(bool do_transmit)
+    {
+      setIsTransmitting(do_transmit);
+      std::lock_guard<std::mutex> lk(stats_mutex);
+      if (do_transmit && (carriers_active > 0) && (m_on_seq != carrier_seq))
+      {
+        m_on_seq = carrier_seq;
+        tx_on_stage.add(nowUs() - carrier_on_us);
+      }
+    }
+
+    void audioDetected(void)
+    {
+      std::lock_guard<std::mutex> lk(stats_mutex);
+      if ((carriers_active > 0) && (m_audio_seq != carrier_seq))
+      {
+        m_audio_seq = carrier_seq;
+        tx_audio_stage.add(nowUs() - carrier_on_us);
+      }
+    }
+};
+
+
+static vector<BenchRx*> bench_rxs;
+
+
+  // Measure how late a periodic timer fire in the current event loop. The
+  // first tick is not measured since it include the startup events.
+class LoopLagMeter
+{
+  public:
+    LoopLagMeter(void)
+      : m_timer(LOOP_LAG_INTERVAL, Timer::TYPE_PERIODIC), m_last_tick_us(0)
+    {
+      m_timer.expired.connect([this](Timer*) {
+          const int64_t now = nowUs();
+          if (m_last_tick_us > 0)
+          {
+            std::lock_guard<std::mutex> lk(stats_mutex);
+            loop_lag_stage.add(max(static_cast<int64_t>(0),
+                now - m_last_tick_us - 1000 * LOOP_LAG_INTERVAL));
+          }
+          m_last_tick_us = now;
+        });
+    }
+
+  private:
+    Timer   m_timer;
+    int64_t m_last_tick_us;
+};
+
+class BenchRxFactory : public RxFactory
+{
+  public:
+    BenchRxFactory(void) : RxFactory("Bench") {}
+
+  protected:
+    Rx *createRx(Config& cfg, const string& name)
+    {
+      BenchRx *rx = new BenchRx(cfg, name);
+      rx->setVerbose(verbose);
+      bench_rxs.push_back(rx);
+      return rx;
+    }
+};
+
+class BenchTxFactory : public TxFactory
+{
+  public:
+    BenchTxFactory(void) : TxFactory("Bench") {}
+
+  protected:
+    Tx *createTx(Config& cfg, const string& name)
+    {
+      BenchTx *tx = new BenchTx(cfg, name);
+      tx->setVerbose(verbose);
+      return tx;
+    }
+};
+
+
+static void setDefault(Config& cfg, const string& section, const string& tag,
+                       const string& value)
+{
+  string current;
+  if (!cfg.getValue(section, tag, current))
+  {
+    cfg.setValue(section, tag, value);
+  }
+}
+
+
+static LogicBase *createLogic(Config& cfg, const string& name)
+{
+  string type;
+  cfg.getValue(name, "TYPE", type);
+  if (type == "Simplex")
+  {
+    return new SimplexLogic(cfg, name);
+  }
+  else if (type == "Repeater")
+  {
+    return new RepeaterLogic(cfg, name);
+  }
+  else if (type == "Reflector")
+  {
+    return new ReflectorLogic(cfg, name);
+  }
+  else if (type == "Dummy")
+  {
+    return new DummyLogic(cfg, name);
+  }
+  cerr << "*** ERROR: Unknown logic type \"" << type
+       << "\" specified for logic " << name << ".\n";
+  return 0;
+}
+
+
+  // The configuration object is not thread safe so each logic thread get a
+  // copy of it
+static Config *copyConfig(Config& cfg)
+{
+  Config *copy = new Config;
+  for (const auto& section : cfg.listSections())
+  {
+    for (const auto& tag : cfg.listSection(section))
+    {
+      string value;
+      cfg.getValue(section, tag, value);
+      copy->setValue(section, tag, value);
+    }
+  }
+  return copy;
+}
+
+
+static vector<string> setupConfig(Config& cfg)
+{
+  vector<string> logic_names;
+  string link_logics;
+  for (int i=1; i<=logic_cnt; ++i)
+  {
+    const string idx = to_string(i);
+    const string logic = "BenchLogic" + idx;
+    const string rx = "BenchRx" + idx;
+    const string tx = "BenchTx" + idx;
+    const bool is_repeater = (i <= repeater_cnt);
+    logic_names.push_back(logic);
+
+    setDefault(cfg, logic, "TYPE", is_repeater ? "Repeater" : "Simplex");
+    setDefault(cfg, logic, "RX", rx);
+    setDefault(cfg, logic, "TX", tx);
+    setDefault(cfg, logic, "CALLSIGN", "BENCH" + idx);
+    setDefault(cfg, logic, "EVENT_HANDLER", event_wrapper);
+    if (is_repeater)
+    {
+      setDefault(cfg, logic, "OPEN_ON_SQL", "1");
+    }
+    if (modules != NULL)
+    {
+      setDefault(cfg, logic, "MODULES", modules);
+    }
+
+    setDefault(cfg, rx, "TYPE", "Bench");
+    setDefault(cfg, rx, "SQL_DET", "VOX");
+    setDefault(cfg, rx, "VOX_FILTER_DEPTH", "20");
+    setDefault(cfg, rx, "VOX_THRESH", "1000");
+    setDefault(cfg, rx, "SQL_HANGTIME", "100");
+    setDefault(cfg, rx, "DTMF_DEC_TYPE", "INTERNAL");
+    setDefault(cfg, rx, "DTMF_MUTING", "1");
+
+    setDefault(cfg, tx, "TYPE", "Bench");
+
+    ostringstream ss;
+    ss << logic << ":9" << setfill('0') << setw(3) << i;
+    link_logics += (link_logics.empty() ? "" : ",") + ss.str();
+  }
+
+  if (extra_logics != NULL)
+  {
+    vector<string> extra;
+    SvxLink::splitStr(extra, extra_logics, ",");
+    for (size_t i=0; i<extra.size(); ++i)
+    {
+      logic_names.push_back(extra[i]);
+      ostringstream ss;
+      ss << extra[i] << ":8" << setfill('0') << setw(3) << (i + 1);
+      link_logics += (link_logics.empty() ? "" : ",") + ss.str();
+    }
+  }
+
+  if (!no_link && (logic_names.size() > 1))
+  {
+    setDefault(cfg, "BenchLink", "CONNECT_LOGICS", link_logics);
+    setDefault(cfg, "BenchLink", "DEFAULT_ACTIVE", "1");
+  }
+  return logic_names;
+}
+
+
+static void parseArguments(int argc, const char **argv)
+{
+  const struct poptOption optionsTable[] =
+  {
+    POPT_AUTOHELP
+    {"logics", 'n', POPT_ARG_INT, &logic_cnt, 0,
+        "The number of simulated logic cores (default 4)", "<count>"},
+    {"repeaters", 'r', POPT_ARG_INT, &repeater_cnt, 0,
+        "How many of the logics that are repeaters (default half)",
+        "<count>"},
+    {"time", 't', POPT_ARG_INT, &duration, 0,
+        "The benchmark time in seconds (default 60)", "<seconds>"},
+    {"period", 'p', POPT_ARG_INT, &period, 0,
+        "The traffic script period in milliseconds (default 10000)", "<ms>"},
+    {"burst", 'b', POPT_ARG_INT, &burst, 0,
+        "The carrier time per period in milliseconds (default 4000)", "<ms>"},
+    {"dtmf", 'd', POPT_ARG_STRING, &dtmf_digits, 0,
+        "DTMF digits to send in each burst (default 123)", "<digits>"},
+    {"sync", 's', POPT_ARG_NONE, &sync_bursts, 0,
+        "Start the bursts on all receivers at the same time", NULL},
+    {"no-link", 0, POPT_ARG_NONE, &no_link, 0,
+        "Do not connect the logics with a link", NULL},
+    {"modules", 'm', POPT_ARG_STRING, &modules, 0,
+        "Modules to load in each logic", "<module,...>"},
+    {"extra-logics", 0, POPT_ARG_STRING, &extra_logics, 0,
+        "Extra logics from the base configuration to start", "<logic,...>"},
+    {"config", 'c', POPT_ARG_STRING, &base_config, 0,
+        "A base configuration file", "<filename>"},
+    {"event-handler", 'e', POPT_ARG_STRING, &event_handler, 0,
+        "The event handler script (default " SVX_SHARE_INSTALL_DIR
+        "/events.tcl)", "<filename>"},
+    {"latency-trace", 'l', POPT_ARG_NONE, &latency_trace, 0,
+        "Print the audio latency through the logic cores for each burst",
+        NULL},
+    {"threads", 'T', POPT_ARG_INT, &thread_cnt, 0,
+        "Run the logics in this many logic threads (default 0, all logics "
+        "in the main thread)", "<count>"},
+    {"verbose", 'v', POPT_ARG_NONE, &verbose, 0,
+        "Print squelch and transmitter state changes", NULL},
+    POPT_TABLEEND
+  };
+
+  poptContext optCon = poptGetContext(PROGRAM_NAME, argc, argv,
+                                      optionsTable, 0);
+  poptReadDefaultConfig(optCon, 0);
+  int err = poptGetNextOpt(optCon);
+  if (err != -1)
+  {
+    cerr << "\t" << poptBadOption(optCon, POPT_BADOPTION_NOALIAS) << " "
+         << poptStrerror(err) << endl;
+    exit(1);
+  }
+  poptFreeContext(optCon);
+
+  if ((logic_cnt < 1) || (duration < 1) || (period < 1) || (burst < 0) ||
+      (thread_cnt < 0))
+  {
+    cerr << "*** ERROR: Bad benchmark parameters\n";
+    exit(1);
+  }
+  if (repeater_cnt < 0)
+  {
+    repeater_cnt = logic_cnt / 2;
+  }
+  if (dtmf_digits == NULL)
+  {
+    dtmf_digits = const_cast<char*>("123");
+  }
+  if (event_handler == NULL)
+  {
+    event_handler = const_cast<char*>(SVX_SHARE_INSTALL_DIR "/events.tcl");
+  }
+}
+
+
+  // The event handler scripts only handle logics named after the logic core,
+  // e.g. SimplexLogic. The wrapper load the core event handlers under that
+  // name and make them available under the name of the benchmark logic.
+  // The wrapper is only read when the logics are initialized so it is
+  // removed right after that. On an early exit it is removed at exit.
+static void removeEventWrapper(void)
+{
+  if (!event_wrapper.empty())
+  {
+    unlink(event_wrapper.c_str());
+    event_wrapper.clear();
+  }
+}
+
+static void writeEventWrapper(void)
+{
+  char path[] = "/tmp/LogicLoadBench-XXXXXX";
+  int fd = mkstemp(path);
+  if (fd < 0)
+  {
+    cerr << "*** ERROR: Could not create the event handler wrapper\n";
+    exit(1);
+  }
+  close(fd);
+  event_wrapper = path;
+  atexit(removeEventWrapper);
+  ofstream os(path);
+  os << "set bench_logic_name $logic_name\n"
+     << "set logic_name \"${Logic::CFG_TYPE}Logic\"\n"
+     << "set script_path {" << event_handler << "}\n"
+     << "source $script_path\n"
+     << "namespace eval ::$bench_logic_name {}\n"
+     << "foreach cmd [info commands ::${logic_name}::*] {\n"
+     << "  interp alias {} ::${bench_logic_name}::[namespace tail $cmd] {} "
+        "$cmd\n"
+     << "}\n";
+}
+
+
+static double cpuTime(const struct timeval& tv)
+{
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+
+int main(int argc, const char **argv)
+{
+  parseArguments(argc, argv);
+  AudioLatencyProbe::setEnabled(latency_trace != 0);
+
+  CppApplication app;
+
+  Config cfg;
+  if ((base_config != NULL) && !cfg.open(base_config))
+  {
+    cerr << "*** ERROR: Could not open configuration file: "
+         << base_config << endl;
+    exit(1);
+  }
+  writeEventWrapper();
+  vector<string> logic_names = setupConfig(cfg);
+
+  BenchRxFactory bench_rx_factory;
+  BenchTxFactory bench_tx_factory;
+
+  string links;
+  cfg.getValue("GLOBAL", "LINKS", links);
+  if (!no_link && (logic_names.size() > 1))
+  {
+    links += (links.empty() ? "" : ",") + string("BenchLink");
+  }
+  if (!links.empty() && !LinkManager::initialize(cfg, links))
+  {
+    cerr << "*** ERROR: Could not initialize the link manager\n";
+    exit(1);
+  }
+
+  vector<ApplicationThread*> threads;
+  vector<Config*> thread_cfgs;
+  vector<LoopLagMeter*> lag_meters;
+  for (int i=0; i<thread_cnt; ++i)
+  {
+    ApplicationThread *thread =
+      new ApplicationThread("BenchThread" + to_string(i + 1));
+    if (!thread->start())
+    {
+      cerr << "*** ERROR: Could not start logic thread\n";
+      exit(1);
+    }
+    threads.push_back(thread);
+    thread_cfgs.push_back(copyConfig(cfg));
+    LoopLagMeter *lag_meter = 0;
+    thread->call([&]() { lag_meter = new LoopLagMeter; });
+    lag_meters.push_back(lag_meter);
+  }
+
+  vector<LogicBase*> logics;
+  for (size_t i=0; i<logic_names.size(); ++i)
+  {
+    const string& name = logic_names[i];
+    LogicBase *logic = 0;
+    bool init_ok = false;
+    auto create = [&](Config& logic_cfg)
+    {
+      logic = createLogic(logic_cfg, name);
+      init_ok = (logic != 0) && logic->initialize();
+    };
+    if (threads.empty())
+    {
+      create(cfg);
+    }
+    else
+    {
+      const size_t idx = i % threads.size();
+      threads[idx]->call([&]() { create(*thread_cfgs[idx]); });
+    }
+    if (!init_ok)
+    {
+      cerr << "*** ERROR: Could not initialize Logic object \""
+           << name << "\"\n";
+      exit(1);
+    }
+    logics.push_back(logic);
+  }
+  removeEventWrapper();
+  if (LinkManager::hasInstance())
+  {
+    LinkManager::instance()->allLogicsStarted();
+  }
+
+  const int64_t start_us = nowUs();
+  for (size_t i=0; i<bench_rxs.size(); ++i)
+  {
+    bench_rxs[i]->startScript(start_us,
+                              sync_bursts ? 0 : i * period / bench_rxs.size());
+  }
+
+  LoopLagMeter lag_meter;
+
+  struct rusage ru_start;
+  getrusage(RUSAGE_SELF, &ru_start);
+
+  Timer stop_timer(1000 * duration);
+  stop_timer.expired.connect([&](Timer*) { app.quit(); });
+  app.exec();
+
+  struct rusage ru_end;
+  getrusage(RUSAGE_SELF, &ru_end);
+  const double wall = (nowUs() - start_us) / 1000000.0;
+  const double user = cpuTime(ru_end.ru_utime) - cpuTime(ru_start.ru_utime);
+  const double sys = cpuTime(ru_end.ru_stime) - cpuTime(ru_start.ru_stime);
+  const double load = 100.0 * (user + sys) / wall;
+
+  std::unique_lock<std::mutex> stats_lk(stats_mutex);
+  cout << fixed << setprecision(2)
+       << "\nlogics=" << logic_cnt << " (" << (logic_cnt - repeater_cnt)
+       << " simplex, " << repeater_cnt << " repeater)"
+       << " threads=" << thread_cnt
+       << " time=" << wall << "s period=" << period << "ms burst=" << burst
+       << "ms dtmf=\"" << dtmf_digits << "\"\n"
+       << "cpu user=" << user << "s sys=" << sys << "s load=" << load
+       << "% of one core (" << (load / logic_cnt) << "% per logic)\n"
+       << "rx_overruns=" << rx_overruns << " dtmf sent=" << digits_sent
+       << " detected=" << digits_detected << " bad=" << digits_bad << "\n\n"
+       << left << setw(10) << "stage" << right << setw(8) << "count"
+       << setw(10) << "mean" << setw(10) << "p99" << setw(10) << "max"
+       << "  (ms)\n";
+  loop_lag_stage.print("loop lag");
+  sql_open_stage.print("sql_open");
+  sql_close_stage.print("sql_close");
+  tx_on_stage.print("tx_on");
+  tx_audio_stage.print("tx_audio");
+  dtmf_stage.print("dtmf");
+  stats_lk.unlock();
+
+    // Logics in other threads are removed from the link manager and deleted
+    // in their own thread
+  for (size_t i=0; i<logics.size(); ++i)
+  {
+    LogicBase *logic = logics[i];
+    if (threads.empty())
+    {
+      delete logic;
+      continue;
+    }
+    threads[i % threads.size()]->call([logic]()
+        {
+          if (LinkManager::hasInstance())
+          {
+            LinkManager::instance()->deleteLogic(logic);
+          }
+          delete logic;
+        });
+  }
+  LinkManager::deleteInstance();
+
+  for (size_t i=0; i<threads.size(); ++i)
+  {
+    LoopLagMeter *lag_meter = lag_meters[i];
+    threads[i]->call([lag_meter]() { delete lag_meter; });
+    threads[i]->stop();
+    delete threads[i];
+    delete thread_cfgs[i];
+  }
+
+  return 0;
+}
@@ -326,26 +326,22 @@ void MsgHandler::playTone(int fq, int amp, int length, bool idle_marked)
 
 void MsgHandler::playDtmf(char digit, int amp, int length, bool idle_marked)
 {
-  static map<char, pair<int, int> > tone_map;
-  tone_map['1'] = pair<int, int>(697, 1209);
-  tone_map['2'] = pair<int, int>(697, 1336);
-  tone_map['3'] = pair<int, int>(697, 1477);
-  tone_map['A'] = pair<int, int>(697, 1633);
-  tone_map['4'] = pair<int, int>(770, 1209);
-  tone_map['5'] = pair<int, int>(770, 1336);
-  tone_map['6'] = pair<int, int>(770, 1477);
-  tone_map['B'] = pair<int, int>(770, 1633);
-  tone_map['7'] = pair<int, int>(852, 1209);
-  tone_map['8'] = pair<int, int>(852, 1336);
-  tone_map['9'] = pair<int, int>(852, 1477);
-  tone_map['C'] = pair<int, int>(852, 1633);
-  tone_map['*'] = pair<int, int>(941, 1209);
-  tone_map['0'] = pair<int, int>(941, 1336);
-  tone_map['#'] = pair<int, int>(941, 1477);
-  tone_map['D'] = pair<int, int>(941, 1633);
-
-  int fql = tone_map[digit].first;
-  int fqh = tone_map[digit].second;
+  static const map<char, pair<int, int> > tone_map = {
+    {'1', {697, 1209}}, {'2', {697, 1336}}, {'3', {697, 1477}},
+    {'A', {697, 1633}}, {'4', {770, 1209}}, {'5', {770, 1336}},
+    {'6', {770, 1477}}, {'B', {770, 1633}}, {'7', {852, 1209}},
+    {'8', {852, 1336}}, {'9', {852, 1477}}, {'C', {852, 1633}},
+    {'*', {941, 1209}}, {'0', {941, 1336}}, {'#', {941, 1477}},
+    {'D', {941, 1633}}
+  };
+
+  map<char, pair<int, int> >::const_iterator it = tone_map.find(digit);
+  if (it == tone_map.end())
+  {
+    return;
+  }
+  int fql = it->second.first;
+  int fqh = it->second.second;
 
   if (fql > 0)
   {
@@ -48,7 +48,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncUdpSocket.h>
 #include <AsyncAudioPassthrough.h>
 #include <AsyncAudioValve.h>
+#include <AsyncAudioEncoderThreaded.h>
+#include <AsyncAudioDecoderThreaded.h>
+#include <AsyncAudioLatencyProbe.h>
 #include <version/SVXLINK.h>
+#include <LocationInfo.h>
 
 
 /****************************************************************************
@@ -137,6 +141,7 @@ ReflectorLogic::ReflectorLogic(Async::Config& cfg, const std::string& name)
     m_report_tg_timer(500, Async::Timer::TYPE_ONESHOT, false),
     m_tg_local_activity(false), m_last_qsy(0), m_logic_con_in_valve(0),
     m_mute_first_tx_loc(true), m_mute_first_tx_rem(false),
+    m_audio_codec_thread(false),
     m_tmp_monitor_timer(1000, Async::Timer::TYPE_PERIODIC),
     m_tmp_monitor_timeout(DEFAULT_TMP_MONITOR_TIMEOUT), m_use_prio(true),
     m_qsy_pending_timer(-1), m_verbose(true)
@@ -309,6 +314,7 @@ bool ReflectorLogic::initialize(void)
   }
   cfg().getValue(name(), "AUDIO_CODEC", audio_codec);
 #endif
+  cfg().getValue(name(), "AUDIO_CODEC_THREAD", m_audio_codec_thread);
 
     // Create logic connection incoming audio passthrough
   m_logic_con_in = new Async::AudioStreamStateDetector;
@@ -326,6 +332,12 @@ bool ReflectorLogic::initialize(void)
     prev_src = m_logic_con_in_valve;
   }
 
+    // Mark the point where audio enter the encoder when tracing latency
+  AudioLatencyProbe *enc_latency_probe =
+      new AudioLatencyProbe(name() + ":enc");
+  prev_src->registerSink(enc_latency_probe, true);
+  prev_src = enc_latency_probe;
+
   m_enc_endpoint = prev_src;
   prev_src = 0;
 
@@ -333,6 +345,13 @@ bool ReflectorLogic::initialize(void)
   if (!setAudioCodec("DUMMY")) { return false; }
   prev_src = m_dec;
 
+    // Mark the point where decoded audio enter the jitter buffer when tracing
+    // latency
+  AudioLatencyProbe *dec_latency_probe =
+      new AudioLatencyProbe(name() + ":dec");
+  prev_src->registerSink(dec_latency_probe, true);
+  prev_src = dec_latency_probe;
+
     // Create jitter buffer
   AudioFifo *fifo = new Async::AudioFifo(2*INTERNAL_SAMPLE_RATE);
   prev_src->registerSink(fifo, true);
@@ -438,6 +457,12 @@ bool ReflectorLogic::initialize(void)
   m_node_info["sw"] = "SvxLink";
   m_node_info["swVer"] = SVXLINK_VERSION;
 
+  if (LocationInfo::has_instance())
+  {
+    LocationInfo::instance()->rxTelemetryUpdated.connect(
+        mem_fun(*this, &ReflectorLogic::onRxTelemetryUpdated));
+  }
+
   cfg().getValue(name(), "UDP_HEARTBEAT_INTERVAL",
       m_udp_heartbeat_tx_cnt_reset);
 
@@ -1009,15 +1034,7 @@ void ReflectorLogic::handleMsgServerInfo(std::istream& is)
 
   m_con_state = STATE_CONNECTED;
 
-  std::ostringstream node_info_os;
-  Json::StreamWriterBuilder builder;
-  builder["commentStyle"] = "None";
-  builder["indentation"] = ""; //The JSON document is written on a single line
-  Json::StreamWriter* writer = builder.newStreamWriter();
-  writer->write(m_node_info, &node_info_os);
-  delete writer;
-  MsgNodeInfo node_info_msg(node_info_os.str());
-  sendMsg(node_info_msg);
+  sendNodeInfo();
 
 #if 0
     // Set up RX and TX sites node information
@@ -1263,6 +1280,59 @@ void ReflectorLogic::sendMsg(const ReflectorMsg& msg)
 } /* ReflectorLogic::sendMsg */
 
 
+void ReflectorLogic::sendNodeInfo(void)
+{
+  std::ostringstream node_info_os;
+  Json::StreamWriterBuilder builder;
+  builder["commentStyle"] = "None";
+  builder["indentation"] = ""; //The JSON document is written on a single line
+  Json::StreamWriter* writer = builder.newStreamWriter();
+  writer->write(m_node_info, &node_info_os);
+  delete writer;
+  MsgNodeInfo node_info_msg(node_info_os.str());
+  sendMsg(node_info_msg);
+} /* ReflectorLogic::sendNodeInfo */
+
+
+void ReflectorLogic::onRxTelemetryUpdated(void)
+{
+  const LocationInfo::RxTelemetryMap& rx_telemetry =
+    LocationInfo::instance()->rxTelemetry();
+  Json::Value rx_stats(Json::objectValue);
+  LocationInfo::RxTelemetryMap::const_iterator it;
+  for (it = rx_telemetry.begin(); it != rx_telemetry.end(); ++it)
+  {
+    const RxTelemetry::Summary& sum = (*it).second.lastSummary();
+    Json::Value stats(Json::objectValue);
+    stats["interval"] = static_cast<Json::UInt>(sum.window_sec + 0.5f);
+    stats["samples"] = static_cast<Json::UInt64>(sum.samples);
+    stats["siglevMin"] = sum.siglev_min;
+    stats["siglevMean"] = sum.siglev_mean;
+    stats["siglevP10"] = sum.siglev_p10;
+    stats["siglevP50"] = sum.siglev_p50;
+    stats["siglevP90"] = sum.siglev_p90;
+    stats["siglevMax"] = sum.siglev_max;
+    stats["sqlOpenings"] = sum.sql_openings;
+    stats["dutyCycle"] = sum.duty_cycle;
+    rx_stats[(*it).first] = stats;
+  }
+
+    // The telemetry is read in the thread running the location info. The
+    // node information belong to the thread running this logic core.
+  runInLogicThread([this, rx_stats]()
+      {
+        m_node_info["rxStats"] = rx_stats;
+
+          // The reflector replace the stored node information on each update
+          // so it is just sent again
+        if (isLoggedIn())
+        {
+          sendNodeInfo();
+        }
+      });
+} /* ReflectorLogic::onRxTelemetryUpdated */
+
+
 void ReflectorLogic::sendEncodedAudio(const void *buf, int count)
 {
   if (!isLoggedIn())
@@ -1525,6 +1595,10 @@ bool ReflectorLogic::setAudioCodec(const std::string& codec_name)
     assert(m_enc != 0);
     return false;
   }
+  if (m_audio_codec_thread)
+  {
+    m_enc = new Async::AudioEncoderThreaded(m_enc);
+  }
   m_enc->writeEncodedSamples.connect(
       mem_fun(*this, &ReflectorLogic::sendEncodedAudio));
   m_enc->flushEncodedSamples.connect(
@@ -1563,6 +1637,10 @@ bool ReflectorLogic::setAudioCodec(const std::string& codec_name)
     assert(m_dec != 0);
     return false;
   }
+  if (m_audio_codec_thread)
+  {
+    m_dec = new Async::AudioDecoderThreaded(m_dec);
+  }
   m_dec->allEncodedSamplesFlushed.connect(
       mem_fun(*this, &ReflectorLogic::allEncodedSamplesFlushed));
   if (sink != 0)
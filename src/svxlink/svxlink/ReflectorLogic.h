@@ -251,6 +251,7 @@ class ReflectorLogic : public LogicBase
     Async::AudioValve*                m_logic_con_in_valve;
     bool                              m_mute_first_tx_loc;
     bool                              m_mute_first_tx_rem;
+    bool                              m_audio_codec_thread;
     Async::Timer                      m_tmp_monitor_timer;
     int                               m_tmp_monitor_timeout;
     bool                              m_use_prio;
@@ -276,6 +277,8 @@ class ReflectorLogic : public LogicBase
     void handleMsgAuthOk(void);
     void handleMsgServerInfo(std::istream& is);
     void sendMsg(const ReflectorMsg& msg);
+    void sendNodeInfo(void);
+    void onRxTelemetryUpdated(void);
     void sendEncodedAudio(const void *buf, int count);
     void flushEncodedAudio(void);
     void udpDatagramReceived(const Async::IpAddress& addr, uint16_t port,
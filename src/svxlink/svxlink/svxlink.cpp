@@ -52,6 +52,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <iomanip>
 #include <algorithm>
 #include <vector>
+#include <list>
+#include <map>
 #include <cstring>
 #include <set>
 #include <cerrno>
@@ -64,10 +66,13 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <AsyncCppApplication.h>
+#include <AsyncApplicationThread.h>
 #include <AsyncConfig.h>
 #include <AsyncTimer.h>
 #include <AsyncFdWatch.h>
 #include <AsyncAudioIO.h>
+#include <AsyncAudioLatencyProbe.h>
+#include <AsyncMetricsHttpServer.h>
 #include <LocationInfo.h>
 #include <common.h>
 #include <config.h>
@@ -109,6 +114,15 @@ using namespace sigc;
 
 #define PROGRAM_NAME "SvxLink"
 
+  // A thread running a group of logic cores and its copy of the
+  // configuration
+struct LogicThread
+{
+  ApplicationThread *thread;
+  Config            *cfg;
+};
+typedef map<string, LogicThread> LogicThreadMap;
+
 
 
 /****************************************************************************
@@ -129,6 +143,12 @@ static void parse_arguments(int argc, const char **argv);
 static void stdinHandler(FdWatch *w);
 static void stdout_handler(FdWatch *w);
 static void initialize_logics(Config &cfg);
+static LogicBase *create_logic(Config &cfg, const string &logic_name);
+static ApplicationThread *logic_thread(Config &cfg, const string &group,
+                                       Config **thread_cfg);
+static void run_in_logic_thread(LogicBase *logic,
+                                ApplicationThread::Task task);
+static void delete_logic_threads(void);
 static void sighup_handler(int signal);
 static void sigterm_handler(int signal);
 static void handle_unix_signal(int signum);
@@ -160,8 +180,12 @@ static char   	      	  *config = NULL;
 static int    	      	  daemonize = 0;
 static int    	      	  logfd = -1;
 static vector<LogicBase*> logic_vec;
+static LogicThreadMap     logic_threads;
+static map<LogicBase*, ApplicationThread*> logic_thread_map;
+static sigc::connection   cfg_updated_con;
 static FdWatch	      	  *stdin_watch = 0;
 static FdWatch	      	  *stdout_watch = 0;
+static MetricsHttpServer  *metrics_server = 0;
 static string         	  tstamp_format;
 
 
@@ -483,6 +507,22 @@ int main(int argc, char **argv)
   cfg.getValue("GLOBAL", "CARD_CHANNELS", card_channels);
   AudioIO::setChannels(card_channels);
 
+  bool audio_latency_trace = false;
+  cfg.getValue("GLOBAL", "AUDIO_LATENCY_TRACE", audio_latency_trace);
+  if (audio_latency_trace)
+  {
+    AudioLatencyProbe::setEnabled(true);
+    cout << "--- Audio latency tracing enabled\n";
+  }
+
+  string metrics_http_port;
+  if (cfg.getValue("GLOBAL", "METRICS_HTTP_PORT", metrics_http_port))
+  {
+    metrics_server = new MetricsHttpServer(metrics_http_port);
+    cout << "--- Exporting metrics on HTTP port " << metrics_http_port
+         << "\n";
+  }
+
     // Init locationinfo
   if (cfg.getValue("GLOBAL", "LOCATION_INFO", value))
   {
@@ -529,6 +569,23 @@ int main(int argc, char **argv)
 
   app.exec();
 
+  delete metrics_server;
+  metrics_server = 0;
+
+  cfg_updated_con.disconnect();
+
+    // Logic cores running in other threads must be removed from the link
+    // manager from their own thread
+  if (LinkManager::hasInstance())
+  {
+    for (const auto& entry : logic_thread_map)
+    {
+      LogicBase *logic = entry.first;
+      entry.second->call(
+          [logic]() { LinkManager::instance()->deleteLogic(logic); });
+    }
+  }
+
   LinkManager::deleteInstance();
   LocationInfo::deleteInstance();
 
@@ -550,9 +607,11 @@ int main(int argc, char **argv)
   vector<LogicBase*>::iterator lit;
   for (lit=logic_vec.begin(); lit!=logic_vec.end(); lit++)
   {
-    delete *lit;
+    LogicBase *logic = *lit;
+    run_in_logic_thread(logic, [logic]() { delete logic; });
   }
   logic_vec.clear();
+  delete_logic_threads();
   
   if (logfd != -1)
   {
@@ -681,7 +740,9 @@ static void stdinHandler(FdWatch *w)
       Logic *logic = dynamic_cast<Logic*>(logic_vec[0]);
       if (logic != 0)
       {
-        logic->injectDtmfDigit(buf[0], 100);
+        const char digit = buf[0];
+        logic->runInLogicThread(
+            [logic, digit]() { logic->injectDtmfDigit(digit, 100); });
       }
       break;
     }
@@ -717,6 +778,9 @@ static void initialize_logics(Config &cfg)
     exit(1);
   }
 
+  bool use_logic_threads = false;
+  cfg.getValue("GLOBAL", "LOGIC_THREADS", use_logic_threads);
+
   string::iterator comma;
   string::iterator begin = logics.begin();
   do
@@ -735,45 +799,39 @@ static void initialize_logics(Config &cfg)
     
     cout << "\nStarting logic: " << logic_name << endl;
     
-    string logic_type;
-    if (!cfg.getValue(logic_name, "TYPE", logic_type) || logic_type.empty())
+      // The logic core is created and initialized in the thread that is
+      // going to run it while the main thread is blocked
+    ApplicationThread *thread = 0;
+    Config *logic_cfg = &cfg;
+    if (use_logic_threads)
     {
-      cerr << "*** ERROR: Logic TYPE not specified for logic \""
-      	   << logic_name << "\". Skipping...\n";
-      continue;
+      string group(logic_name);
+      cfg.getValue(logic_name, "THREAD", group);
+      thread = logic_thread(cfg, group, &logic_cfg);
     }
     LogicBase *logic = 0;
-    if (logic_type == "Simplex")
-    {
-      logic = new SimplexLogic(cfg, logic_name);
-    }
-    else if (logic_type == "Repeater")
+    ApplicationThread::Task create = [&]()
     {
-      logic = new RepeaterLogic(cfg, logic_name);
-    }
-    else if (logic_type == "Reflector")
-    {
-      logic = new ReflectorLogic(cfg, logic_name);
-    }
-    else if (logic_type == "Dummy")
+      logic = create_logic(*logic_cfg, logic_name);
+    };
+    if (thread != 0)
     {
-      logic = new DummyLogic(cfg, logic_name);
+      thread->call(create);
     }
     else
     {
-      cerr << "*** ERROR: Unknown logic type \"" << logic_type
-           << "\" specified for logic " << logic_name << ".\n";
-      continue;
+      create();
     }
-    if ((logic == 0) || !logic->initialize())
+    if (logic == 0)
     {
-      cerr << "*** ERROR: Could not initialize Logic object \""
-      	   << logic_name << "\". Skipping...\n";
-      delete logic;
       continue;
     }
     
     logic_vec.push_back(logic);
+    if (thread != 0)
+    {
+      logic_thread_map[logic] = thread;
+    }
   } while (comma != logics.end());
   
   if (logic_vec.size() == 0)
@@ -784,6 +842,153 @@ static void initialize_logics(Config &cfg)
 } /* initialize_logics */
 
 
+static LogicBase *create_logic(Config &cfg, const string &logic_name)
+{
+  string logic_type;
+  if (!cfg.getValue(logic_name, "TYPE", logic_type) || logic_type.empty())
+  {
+    cerr << "*** ERROR: Logic TYPE not specified for logic \""
+         << logic_name << "\". Skipping...\n";
+    return 0;
+  }
+  LogicBase *logic = 0;
+  if (logic_type == "Simplex")
+  {
+    logic = new SimplexLogic(cfg, logic_name);
+  }
+  else if (logic_type == "Repeater")
+  {
+    logic = new RepeaterLogic(cfg, logic_name);
+  }
+  else if (logic_type == "Reflector")
+  {
+    logic = new ReflectorLogic(cfg, logic_name);
+  }
+  else if (logic_type == "Dummy")
+  {
+    logic = new DummyLogic(cfg, logic_name);
+  }
+  else
+  {
+    cerr << "*** ERROR: Unknown logic type \"" << logic_type
+         << "\" specified for logic " << logic_name << ".\n";
+    return 0;
+  }
+  if ((logic == 0) || !logic->initialize())
+  {
+    cerr << "*** ERROR: Could not initialize Logic object \""
+         << logic_name << "\". Skipping...\n";
+    delete logic;
+    return 0;
+  }
+  return logic;
+} /* create_logic */
+
+
+/*
+ * Get the thread for a group of logic cores, starting it if it is not
+ * running. Each thread get its own copy of the configuration since the
+ * configuration object is not thread safe. Changes made to any of the
+ * copies, or to the original, are posted to all the others. If the thread
+ * could not be started, 0 is returned and the logic core is run in the main
+ * thread.
+ */
+static ApplicationThread *logic_thread(Config &cfg, const string &group,
+                                       Config **thread_cfg)
+{
+  LogicThreadMap::iterator it = logic_threads.find(group);
+  if (it != logic_threads.end())
+  {
+    *thread_cfg = it->second.cfg;
+    return it->second.thread;
+  }
+
+  ApplicationThread *thread = new ApplicationThread(group);
+  if (!thread->start())
+  {
+    cerr << "*** ERROR: Could not start logic thread \"" << group
+         << "\". Running the logic in the main thread.\n";
+    delete thread;
+    return 0;
+  }
+  cout << "--- Running logic thread " << group << endl;
+
+  Config *copy = new Config;
+  list<string> sections(cfg.listSections());
+  for (const auto& section : sections)
+  {
+    list<string> tags(cfg.listSection(section));
+    for (const auto& tag : tags)
+    {
+      string value;
+      cfg.getValue(section, tag, value);
+      copy->setValue(section, tag, value);
+    }
+  }
+
+  if (!cfg_updated_con.connected())
+  {
+    cfg_updated_con = cfg.valueUpdated.connect(
+        [&cfg](const string& section, const string& tag)
+        {
+          string value;
+          cfg.getValue(section, tag, value);
+          for (const auto& entry : logic_threads)
+          {
+            Config *thread_cfg = entry.second.cfg;
+            entry.second.thread->post(
+                [=]() { thread_cfg->setValue(section, tag, value); });
+          }
+        });
+  }
+
+    // The signal of the copy is only emitted from the logic thread
+  Application *main_app = &Application::app();
+  copy->valueUpdated.connect(
+      [copy, main_app, &cfg](const string& section, const string& tag)
+      {
+        string value;
+        copy->getValue(section, tag, value);
+        main_app->post([=, &cfg]() { cfg.setValue(section, tag, value); });
+      });
+
+  LogicThread &entry = logic_threads[group];
+  entry.thread = thread;
+  entry.cfg = copy;
+  *thread_cfg = copy;
+  return thread;
+} /* logic_thread */
+
+
+static void run_in_logic_thread(LogicBase *logic,
+                                ApplicationThread::Task task)
+{
+  map<LogicBase*, ApplicationThread*>::iterator it =
+    logic_thread_map.find(logic);
+  if (it != logic_thread_map.end())
+  {
+    it->second->call(task);
+  }
+  else
+  {
+    task();
+  }
+} /* run_in_logic_thread */
+
+
+static void delete_logic_threads(void)
+{
+  logic_thread_map.clear();
+  for (auto& entry : logic_threads)
+  {
+    entry.second.thread->stop();
+    delete entry.second.thread;
+    delete entry.second.cfg;
+  }
+  logic_threads.clear();
+} /* delete_logic_threads */
+
+
 static void sighup_handler(int signal)
 {
   if (logfile_name == 0)
@@ -72,6 +72,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Ddr.h"
 #include "WbRxRtlSdr.h"
 #include "DdrFilterCoeffs.h"
+#include "FmDiscriminator.h"
 
 
 /****************************************************************************
@@ -101,6 +102,90 @@ using namespace Async;
  ****************************************************************************/
 
 namespace {
+  /**
+   * @brief A preallocated scratch memory area for a signal chain
+   *
+   * All intermediate buffers in the signal chain of a channel are taken from
+   * the arena, which is reset before each block of IQ samples is processed.
+   * The same memory is thereby reused for every block. If a block need more
+   * memory than is available, the rest is allocated separately and the arena
+   * is grown to the peak size on the next reset. In steady state no memory
+   * is allocated. All allocations made after construction are counted so
+   * that this can be verified.
+   */
+  class ScratchArena
+  {
+    public:
+      static const size_t ALIGN = 16;
+
+      explicit ScratchArena(size_t size)
+        : buf(0), size(0), used(0), peak(0), alloc_cnt(0)
+      {
+        grow(size);
+        alloc_cnt = 0;
+      }
+
+      ~ScratchArena(void)
+      {
+        reset();
+        delete [] buf;
+      }
+
+      void reset(void)
+      {
+        if (!overflow.empty())
+        {
+          for (size_t i=0; i<overflow.size(); ++i)
+          {
+            delete [] overflow[i];
+          }
+          overflow.clear();
+          grow(peak);
+        }
+        used = 0;
+        peak = 0;
+      }
+
+      template <class T>
+      T *alloc(size_t count)
+      {
+        const size_t bytes = (count * sizeof(T) + ALIGN - 1) & ~(ALIGN - 1);
+        peak += bytes;
+        if (used + bytes <= size)
+        {
+          T *ptr = reinterpret_cast<T*>(buf + used);
+          used += bytes;
+          return ptr;
+        }
+        char *extra = new char[bytes];
+        ++alloc_cnt;
+        overflow.push_back(extra);
+        return reinterpret_cast<T*>(extra);
+      }
+
+      unsigned long allocCount(void) const { return alloc_cnt; }
+
+    private:
+      char            *buf;
+      size_t          size;
+      size_t          used;
+      size_t          peak;
+      vector<char*>   overflow;
+      unsigned long   alloc_cnt;
+
+      void grow(size_t new_size)
+      {
+        if (new_size > size)
+        {
+          delete [] buf;
+          buf = new char[new_size];
+          size = new_size;
+          ++alloc_cnt;
+        }
+      }
+  }; /* ScratchArena */
+
+
   template <class T>
   class Decimator
   {
@@ -142,18 +227,23 @@ namespace {
         }
       }
 
-      void decimate(vector<T> &out, const vector<T> &in)
+      /**
+       * @brief Decimate a block of samples
+       * @param out   Output buffer, room for count / decFact() samples
+       * @param in    Input samples
+       * @param count The number of input samples
+       * @return Returns the number of output samples
+       *
+       * Output sample n is written after input sample n * decFact() has been
+       * read so the output buffer may be the same as the input buffer.
+       */
+      size_t decimate(T *out, const T *in, size_t count)
       {
-        int orig_count = in.size();
-
-          // this implementation assumes in.size() is a multiple of factor_M
-        assert(in.size() % dec_fact == 0);
+          // this implementation assumes count is a multiple of factor_M
+        assert(count % dec_fact == 0);
 
-        int num_out = 0;
-        typename vector<T>::const_iterator src = in.begin();
-        out.clear();
-        out.reserve(in.size() / dec_fact);
-        while (src != in.end())
+        const size_t num_out = count / dec_fact;
+        for (size_t idx = 0; idx < num_out; ++idx)
         {
             // shift Z delay line up to make room for next samples
           memmove(p_Z + dec_fact, p_Z, (taps - dec_fact) * sizeof(T));
@@ -161,8 +251,7 @@ namespace {
             // copy next samples from input buffer to bottom of Z delay line
           for (int tap = dec_fact - 1; tap >= 0; tap--)
           {
-            assert(src != in.end());
-            p_Z[tap] = *src++;
+            p_Z[tap] = *in++;
           }
 
             // calculate FIR sum
@@ -171,10 +260,9 @@ namespace {
           {
             sum += coeff[tap] * p_Z[tap];
           }
-          out.push_back(sum);     /* store sum */
-          num_out++;
+          out[idx] = sum;     /* store sum */
         }
-        assert(num_out == orig_count / dec_fact);
+        return num_out;
       }
 
     private:
@@ -192,7 +280,8 @@ namespace {
       virtual ~DecimatorMS(void) {}
       virtual void setGain(float new_gain) = 0;
       virtual int decFact(void) const = 0;
-      virtual void decimate(vector<T> &out, const vector<T> &in) = 0;
+      virtual size_t decimate(T *out, const T *in, size_t count,
+                              ScratchArena &arena) = 0;
   };
 
   template <class T>
@@ -205,14 +294,14 @@ namespace {
         gain = pow(10.0, gain_db / 20.0);
       }
       virtual int decFact(void) const { return 1; }
-      virtual void decimate(vector<T> &out, const vector<T> &in)
+      virtual size_t decimate(T *out, const T *in, size_t count,
+                              ScratchArena &arena)
       {
-        out.clear();
-        out.reserve(in.size());
-        for (size_t i=0; i<in.size(); ++i)
+        for (size_t i=0; i<count; ++i)
         {
-          out.push_back(gain * in[i]);
+          out[i] = gain * in[i];
         }
+        return count;
       }
 
     private:
@@ -226,9 +315,10 @@ namespace {
       DecimatorMS1(Decimator<T> &d1) : d1(d1) {}
       virtual void setGain(float gain_db) { d1.setGain(gain_db); }
       virtual int decFact(void) const { return d1.decFact(); }
-      virtual void decimate(vector<T> &out, const vector<T> &in)
+      virtual size_t decimate(T *out, const T *in, size_t count,
+                              ScratchArena &arena)
       {
-        d1.decimate(out, in);
+        return d1.decimate(out, in, count);
       }
 
     private:
@@ -242,11 +332,12 @@ namespace {
       DecimatorMS2(Decimator<T> &d1, Decimator<T> &d2) : d1(d1), d2(d2) {}
       virtual void setGain(float gain_db) { d2.setGain(gain_db); }
       virtual int decFact(void) const { return d1.decFact() * d2.decFact(); }
-      virtual void decimate(vector<T> &out, const vector<T> &in)
+      virtual size_t decimate(T *out, const T *in, size_t count,
+                              ScratchArena &arena)
       {
-        vector<T> dec_samp1;
-        d1.decimate(dec_samp1, in);
-        d2.decimate(out, dec_samp1);
+        T *dec_samp = arena.alloc<T>(count / d1.decFact());
+        size_t dec_count = d1.decimate(dec_samp, in, count);
+        return d2.decimate(out, dec_samp, dec_count);
       }
 
     private:
@@ -264,12 +355,13 @@ namespace {
       {
         return d1.decFact() * d2.decFact() * d3.decFact();
       }
-      virtual void decimate(vector<T> &out, const vector<T> &in)
+      virtual size_t decimate(T *out, const T *in, size_t count,
+                              ScratchArena &arena)
       {
-        vector<T> dec_samp1, dec_samp2;
-        d1.decimate(dec_samp1, in);
-        d2.decimate(dec_samp2, dec_samp1);
-        d3.decimate(out, dec_samp2);
+        T *dec_samp = arena.alloc<T>(count / d1.decFact());
+        size_t dec_count = d1.decimate(dec_samp, in, count);
+        dec_count = d2.decimate(dec_samp, dec_samp, dec_count);
+        return d3.decimate(out, dec_samp, dec_count);
       }
 
     private:
@@ -288,13 +380,14 @@ namespace {
       {
         return d1.decFact() * d2.decFact() * d3.decFact() * d4.decFact();
       }
-      virtual void decimate(vector<T> &out, const vector<T> &in)
+      virtual size_t decimate(T *out, const T *in, size_t count,
+                              ScratchArena &arena)
       {
-        vector<T> dec_samp1, dec_samp2, dec_samp3;
-        d1.decimate(dec_samp1, in);
-        d2.decimate(dec_samp2, dec_samp1);
-        d3.decimate(dec_samp3, dec_samp2);
-        d4.decimate(out, dec_samp3);
+        T *dec_samp = arena.alloc<T>(count / d1.decFact());
+        size_t dec_count = d1.decimate(dec_samp, in, count);
+        dec_count = d2.decimate(dec_samp, dec_samp, dec_count);
+        dec_count = d3.decimate(dec_samp, dec_samp, dec_count);
+        return d4.decimate(out, dec_samp, dec_count);
       }
 
     private:
@@ -314,14 +407,15 @@ namespace {
         return d1.decFact() * d2.decFact() * d3.decFact() *
                d4.decFact() * d5.decFact();
       }
-      virtual void decimate(vector<T> &out, const vector<T> &in)
+      virtual size_t decimate(T *out, const T *in, size_t count,
+                              ScratchArena &arena)
       {
-        vector<T> dec_samp1, dec_samp2, dec_samp3, dec_samp4;
-        d1.decimate(dec_samp1, in);
-        d2.decimate(dec_samp2, dec_samp1);
-        d3.decimate(dec_samp3, dec_samp2);
-        d4.decimate(dec_samp4, dec_samp3);
-        d5.decimate(out, dec_samp4);
+        T *dec_samp = arena.alloc<T>(count / d1.decFact());
+        size_t dec_count = d1.decimate(dec_samp, in, count);
+        dec_count = d2.decimate(dec_samp, dec_samp, dec_count);
+        dec_count = d3.decimate(dec_samp, dec_samp, dec_count);
+        dec_count = d4.decimate(dec_samp, dec_samp, dec_count);
+        return d5.decimate(out, dec_samp, dec_count);
       }
 
     private:
@@ -356,26 +450,23 @@ namespace {
         }
       }
 
-      void iq_received(vector<WbRxRtlSdr::Sample> &out,
-                       const vector<WbRxRtlSdr::Sample> &in)
+      void iq_received(WbRxRtlSdr::Sample *out, const WbRxRtlSdr::Sample *in,
+                       size_t count)
       {
         if (exp_lut.size() > 0)
         {
-          out.clear();
-          out.reserve(in.size());
-          vector<WbRxRtlSdr::Sample>::const_iterator it;
-          for (it = in.begin(); it != in.end(); ++it)
+          for (size_t idx=0; idx<count; ++idx)
           {
-            out.push_back(*it * exp_lut[n]);
+            out[idx] = in[idx] * exp_lut[n];
             if (++n == exp_lut.size())
             {
               n = 0;
             }
           }
         }
-        else
+        else if (out != in)
         {
-          out = in;
+          copy(in, in + count, out);
         }
       }
 
@@ -420,20 +511,15 @@ namespace {
       void setDecay(float decay) { m_decay = decay; }
       void setAttack(float attack) { m_attack = attack; }
 
-      void iq_received(vector<WbRxRtlSdr::Sample> &out,
-                       const vector<WbRxRtlSdr::Sample> &in)
+      void iq_received(WbRxRtlSdr::Sample *out, const WbRxRtlSdr::Sample *in,
+                       size_t count)
       {
-        out.clear();
-        out.reserve(in.size());
         float P = 0.0f;
-        for (vector<WbRxRtlSdr::Sample>::const_iterator it = in.begin();
-             it != in.end();
-             ++it)
+        for (size_t idx=0; idx<count; ++idx)
         {
-          const WbRxRtlSdr::Sample &samp = *it;
-          WbRxRtlSdr::Sample osamp = m_gain * samp;
+          WbRxRtlSdr::Sample osamp = m_gain * in[idx];
           P = osamp.real() * osamp.real() + osamp.imag() * osamp.imag();
-          out.push_back(osamp);
+          out[idx] = osamp;
 
           float err = m_reference - P;
           float rate;
@@ -473,7 +559,14 @@ namespace {
     public:
       virtual ~Demodulator(void) {}
 
-      virtual void iq_received(vector<WbRxRtlSdr::Sample> samples) = 0;
+      /**
+       * @brief Demodulate a block of samples
+       * @param samples The channel samples
+       * @param count   The number of samples
+       * @param arena   Scratch memory for the intermediate buffers
+       */
+      virtual void iq_received(const WbRxRtlSdr::Sample *samples,
+                               size_t count, ScratchArena &arena) = 0;
 
       /**
        * @brief Resume audio output to the sink
@@ -503,8 +596,7 @@ namespace {
   {
     public:
       DemodulatorFm(unsigned samp_rate, double max_dev)
-        : iold(1.0f), qold(1.0f),
-          audio_dec(2, coeff_dec_audio_32k_16k, coeff_dec_audio_32k_16k_cnt),
+        : audio_dec(2, coeff_dec_audio_32k_16k, coeff_dec_audio_32k_16k_cnt),
           dec(0)
       {
         setDemodParams(samp_rate, max_dev);
@@ -553,7 +645,8 @@ namespace {
         dec->setGain(adj_db);
       }
 
-      void iq_received(vector<WbRxRtlSdr::Sample> samples)
+      void iq_received(const WbRxRtlSdr::Sample *samples, size_t count,
+                       ScratchArena &arena)
       {
           // From article-sdr-is-qs.pdf: Watch your Is and Qs:
           //   FM = (Qn.In-1 - In.Qn-1)/(In.In-1 + Qn.Qn-1)
@@ -561,31 +654,22 @@ namespace {
           // A more indepth report:
           //   Implementation of FM demodulator algorithms on a
           //   high performance digital signal processor
-        vector<float> audio;
-        for (size_t idx=0; idx<samples.size(); ++idx)
+          //
+          // The phase difference between two samples does not depend on
+          // the signal amplitude so the samples are not normalized. The
+          // audio is decimated in place.
+        if (count == 0)
         {
-          complex<float> samp = samples[idx];
-
-            // Normalize signal amplitude
-          samp = samp / abs(samp);
-
-            // Mixed demodulator (delay demodulator + phase adapter demodulator)
-          float i = samp.real();
-          float q = samp.imag();
-          double demod = atan2(q*iold - i*qold, i*iold + q*qold);
-          iold = i;
-          qold = q;
-
-          audio.push_back(demod);
+          return;
         }
-        vector<float> dec_audio;
-        dec->decimate(dec_audio, audio);
-        sinkWriteSamples(&dec_audio[0], dec_audio.size());
+        float *audio = arena.alloc<float>(count);
+        disc.process(audio, samples, count);
+        size_t dec_count = dec->decimate(audio, audio, count, arena);
+        sinkWriteSamples(audio, dec_count);
       }
 
     private:
-      float iold;
-      float qold;
+      FmDiscriminator disc;
       Decimator<float> audio_dec_wb;
       Decimator<float> audio_dec;
       DecimatorMS<float> *dec;
@@ -602,19 +686,19 @@ namespace {
         agc.setReference(1);
       }
 
-      void iq_received(vector<WbRxRtlSdr::Sample> samples)
+      void iq_received(const WbRxRtlSdr::Sample *samples, size_t count,
+                       ScratchArena &arena)
       {
-        vector<WbRxRtlSdr::Sample> gain_adjusted;
-        agc.iq_received(gain_adjusted, samples);
+        WbRxRtlSdr::Sample *gain_adjusted =
+          arena.alloc<WbRxRtlSdr::Sample>(count);
+        agc.iq_received(gain_adjusted, samples, count);
 
-        vector<float> audio;
-        for (size_t idx=0; idx<gain_adjusted.size(); ++idx)
+        float *audio = arena.alloc<float>(count);
+        for (size_t idx=0; idx<count; ++idx)
         {
-          complex<float> samp = gain_adjusted[idx];
-          float demod = abs(samp);
-          audio.push_back(demod);
+          audio[idx] = abs(gain_adjusted[idx]);
         }
-        sinkWriteSamples(&audio[0], audio.size());
+        sinkWriteSamples(audio, count);
       }
 
     private:
@@ -639,34 +723,31 @@ namespace {
         use_lsb = use;
       }
 
-      void iq_received(vector<WbRxRtlSdr::Sample> samples)
+      void iq_received(const WbRxRtlSdr::Sample *samples, size_t count,
+                       ScratchArena &arena)
       {
-        vector<float> Q, Qh, audio;
-        Q.reserve(samples.size());
-        for (vector<WbRxRtlSdr::Sample>::const_iterator it = samples.begin();
-             it != samples.end();
-             ++it)
+        float *Q = arena.alloc<float>(count);
+        for (size_t idx=0; idx<count; ++idx)
         {
-          I.push_back(it->real());
-          Q.push_back(it->imag());
+          I.push_back(samples[idx].real());
+          Q[idx] = samples[idx].imag();
         }
-        hilbert.decimate(Qh, Q);
-        audio.reserve(Qh.size());
-        for (size_t idx=0; idx<Qh.size(); ++idx)
+        float *Qh = arena.alloc<float>(count);
+        size_t Qh_count = hilbert.decimate(Qh, Q, count);
+        float *audio = arena.alloc<float>(Qh_count);
+        for (size_t idx=0; idx<Qh_count; ++idx)
         {
-          float demod;
           if (use_lsb)
           {
-            demod = I[idx] + Qh[idx];
+            audio[idx] = I[idx] + Qh[idx];
           }
           else
           {
-            demod = I[idx] - Qh[idx];
+            audio[idx] = I[idx] - Qh[idx];
           }
-          audio.push_back(demod);
         }
-        I.erase(I.begin(), I.begin() + Qh.size());
-        sinkWriteSamples(&audio[0], audio.size());
+        I.erase(I.begin(), I.begin() + Qh_count);
+        sinkWriteSamples(audio, Qh_count);
       }
 
     private:
@@ -690,24 +771,20 @@ namespace {
         trans.setOffset(lsb ? 2000 : -2000);
       }
 
-      void iq_received(vector<WbRxRtlSdr::Sample> samples)
+      void iq_received(const WbRxRtlSdr::Sample *samples, size_t count,
+                       ScratchArena &arena)
       {
-        vector<WbRxRtlSdr::Sample> gain_adjusted;
-        agc.iq_received(gain_adjusted, samples);
-
-        vector<WbRxRtlSdr::Sample> translated;
-        trans.iq_received(translated, gain_adjusted);
+        WbRxRtlSdr::Sample *translated =
+          arena.alloc<WbRxRtlSdr::Sample>(count);
+        agc.iq_received(translated, samples, count);
+        trans.iq_received(translated, translated, count);
 
-        vector<float> audio;
-        audio.reserve(gain_adjusted.size());
-        for (vector<WbRxRtlSdr::Sample>::const_iterator it = translated.begin();
-             it != translated.end();
-             ++it)
+        float *audio = arena.alloc<float>(count);
+        for (size_t idx=0; idx<count; ++idx)
         {
-          float demod = it->real();
-          audio.push_back(demod);
+          audio[idx] = translated[idx].real();
         }
-        sinkWriteSamples(&audio[0], audio.size());
+        sinkWriteSamples(audio, count);
       }
 
     private:
@@ -728,23 +805,20 @@ namespace {
         agc.setReference(0.05);
       }
 
-      void iq_received(vector<WbRxRtlSdr::Sample> samples)
+      void iq_received(const WbRxRtlSdr::Sample *samples, size_t count,
+                       ScratchArena &arena)
       {
-        vector<WbRxRtlSdr::Sample> gain_adjusted;
-        agc.iq_received(gain_adjusted, samples);
-
-        vector<WbRxRtlSdr::Sample> translated;
-        trans.iq_received(translated, gain_adjusted);
-        vector<float> audio;
-        audio.reserve(translated.size());
-        for (vector<WbRxRtlSdr::Sample>::const_iterator it = translated.begin();
-             it != translated.end();
-             ++it)
+        WbRxRtlSdr::Sample *translated =
+          arena.alloc<WbRxRtlSdr::Sample>(count);
+        agc.iq_received(translated, samples, count);
+        trans.iq_received(translated, translated, count);
+
+        float *audio = arena.alloc<float>(count);
+        for (size_t idx=0; idx<count; ++idx)
         {
-          float demod = it->real();
-          audio.push_back(demod);
+          audio[idx] = translated[idx].real();
         }
-        sinkWriteSamples(&audio[0], audio.size());
+        sinkWriteSamples(audio, count);
       }
 
     private:
@@ -764,10 +838,37 @@ namespace {
       virtual ~Channelizer(void) {}
       virtual void setBw(Bandwidth bw) = 0;
       virtual unsigned chSampRate(void) const = 0;
-      virtual void iq_received(vector<WbRxRtlSdr::Sample> &out,
-                               const vector<WbRxRtlSdr::Sample> &in) = 0;
+      virtual int decFact(void) const = 0;
+
+      /**
+       * @brief Filter and decimate a block of samples to the channel rate
+       * @param out   Output buffer, room for count / decFact() samples
+       * @param in    Input samples
+       * @param count The number of input samples
+       * @param arena Scratch memory for the intermediate buffers
+       * @return Returns the number of output samples
+       *
+       * The output buffer may be the same as the input buffer.
+       */
+      virtual size_t iq_received(WbRxRtlSdr::Sample *out,
+                                 const WbRxRtlSdr::Sample *in, size_t count,
+                                 ScratchArena &arena) = 0;
 
       sigc::signal<void, const std::vector<RtlTcp::Sample>&> preDemod;
+
+    protected:
+      void emitPreDemod(const WbRxRtlSdr::Sample *samples, size_t count)
+      {
+          // The vector keep its capacity between blocks
+        if (!preDemod.empty())
+        {
+          pre_demod.assign(samples, samples + count);
+          preDemod(pre_demod);
+        }
+      }
+
+    private:
+      vector<WbRxRtlSdr::Sample> pre_demod;
   };
 
   class Channelizer960 : public Channelizer
@@ -842,11 +943,15 @@ namespace {
         return 960000 / dec->decFact();
       }
 
-      virtual void iq_received(vector<WbRxRtlSdr::Sample> &out,
-                               const vector<WbRxRtlSdr::Sample> &in)
+      virtual int decFact(void) const { return dec->decFact(); }
+
+      virtual size_t iq_received(WbRxRtlSdr::Sample *out,
+                                 const WbRxRtlSdr::Sample *in, size_t count,
+                                 ScratchArena &arena)
       {
-        dec->decimate(out, in);
-        preDemod(out);
+        size_t out_count = dec->decimate(out, in, count, arena);
+        emitPreDemod(out, out_count);
+        return out_count;
       }
 
     private:
@@ -940,11 +1045,15 @@ namespace {
         return 2400000 / dec->decFact();
       }
 
-      virtual void iq_received(vector<WbRxRtlSdr::Sample> &out,
-                               const vector<WbRxRtlSdr::Sample> &in)
+      virtual int decFact(void) const { return dec->decFact(); }
+
+      virtual size_t iq_received(WbRxRtlSdr::Sample *out,
+                                 const WbRxRtlSdr::Sample *in, size_t count,
+                                 ScratchArena &arena)
       {
-        dec->decimate(out, in);
-        preDemod(out);
+        size_t out_count = dec->decimate(out, in, count, arena);
+        emitPreDemod(out, out_count);
+        return out_count;
       }
 
     private:
@@ -970,8 +1079,12 @@ class Ddr::Channel : public sigc::trackable, public Async::AudioSource
       : sample_rate(sample_rate), channelizer(0),
         fm_demod(32000, 5000.0), ssb_demod(16000), cw_demod(16000), demod(0),
         trans(sample_rate, fq_offset), enabled(true), ch_offset(0),
-        fq_offset(fq_offset)
+        fq_offset(fq_offset),
+        arena(2 * sizeof(WbRxRtlSdr::Sample) * sample_rate / 100)
     {
+        // The arena is sized for twice the 10ms blocks delivered by the
+        // tuner. That cover the translated block, decimated in place, plus
+        // the intermediate buffers for the channelizer and demodulator.
     }
 
     ~Channel(void)
@@ -1076,14 +1189,18 @@ class Ddr::Channel : public sigc::trackable, public Async::AudioSource
       return channelizer->chSampRate();
     }
 
-    void iq_received(vector<WbRxRtlSdr::Sample> samples)
+    void iq_received(const vector<WbRxRtlSdr::Sample> &samples)
     {
-      if (enabled)
+      if (enabled && !samples.empty())
       {
-        vector<WbRxRtlSdr::Sample> translated, channelized;
-        trans.iq_received(translated, samples);
-        channelizer->iq_received(channelized, translated);
-        demod->iq_received(channelized);
+        const size_t count = samples.size();
+        arena.reset();
+        WbRxRtlSdr::Sample *channelized =
+          arena.alloc<WbRxRtlSdr::Sample>(count);
+        trans.iq_received(channelized, &samples[0], count);
+        size_t ch_count =
+          channelizer->iq_received(channelized, channelized, count, arena);
+        demod->iq_received(channelized, ch_count, arena);
       }
     };
 
@@ -1099,6 +1216,8 @@ class Ddr::Channel : public sigc::trackable, public Async::AudioSource
 
     bool isEnabled(void) const { return enabled; }
 
+    unsigned long scratchAllocCount(void) const { return arena.allocCount(); }
+
     sigc::signal<void, const std::vector<RtlTcp::Sample>&> preDemod;
 
   private:
@@ -1113,6 +1232,7 @@ class Ddr::Channel : public sigc::trackable, public Async::AudioSource
     bool enabled;
     int ch_offset;
     int fq_offset;
+    ScratchArena arena;
 }; /* Channel */
 
 
@@ -1138,7 +1258,7 @@ class Ddr::Channel : public sigc::trackable, public Async::AudioSource
  *
  ****************************************************************************/
 
-Ddr::DdrMap Ddr::ddr_map;
+thread_local Ddr::DdrMap Ddr::ddr_map;
 
 
 /****************************************************************************
@@ -1272,6 +1392,12 @@ unsigned Ddr::preDemodSampleRate(void) const
 } /* Ddr::preDemodSampleRate */
 
 
+unsigned long Ddr::scratchAllocCount(void) const
+{
+  return (channel != 0) ? channel->scratchAllocCount() : 0;
+} /* Ddr::scratchAllocCount */
+
+
 bool Ddr::isReady(void) const
 {
   return (rtl != 0) && rtl->isReady();
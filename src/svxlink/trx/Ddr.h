@@ -157,6 +157,17 @@ class Ddr : public LocalRxBase
      */
     unsigned preDemodSampleRate(void) const;
 
+    /**
+     * @brief   Get the number of scratch memory allocations
+     * @returns Returns the number of allocations made by the signal chain
+     *
+     * The signal chain use preallocated scratch memory that only grow if a
+     * block of I/Q samples need more memory than before. This count the
+     * allocations made after construction so it should stay constant in
+     * steady state.
+     */
+    unsigned long scratchAllocCount(void) const;
+
     /**
      * @brief   Find out if the receiver is ready for operation
      * @returns Returns \em true if the receiver is ready for operation
@@ -230,7 +241,7 @@ class Ddr : public LocalRxBase
     class Channel;
     typedef std::map<std::string, Ddr*> DdrMap;
 
-    static DdrMap ddr_map;
+    static thread_local DdrMap ddr_map;
 
     Async::Config           &cfg;
     Channel                 *channel;
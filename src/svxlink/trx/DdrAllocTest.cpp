@@ -0,0 +1,325 @@
+//
+// Allocation test for the DDR signal chain.
+//
+// A DDR is fed with 10ms blocks of I/Q samples from a generated file, using
+// a WBRX of type RtlFile that replay one block for each turn of the event
+// loop. Every call to operator new is counted. The count is sampled right
+// before and right after the DDR channel handle a block, which give the
+// number of allocations made by the signal chain for that block. Allocations
+// made by the receiver audio pipeline after the DDR, e.g. for squelch state
+// events, are not counted. The DDR scratch allocation counter is checked as
+// well.
+//
+// The test is run for every modulation at both supported tuner sample rates.
+// The first blocks after a modulation change are used to warm up. The test
+// fail if any allocation is made while processing the blocks after that. The
+// following is printed for each run:
+//
+//   rate      - The tuner sample rate
+//   mod       - The modulation
+//   blocks    - The number of blocks checked after the warm up
+//   allocs    - Heap allocations made by the signal chain in those blocks
+//   scratch   - Scratch memory allocations made in those blocks
+//
+// Usage: DdrAllocTest [blocks]
+//
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <complex>
+#include <new>
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <unistd.h>
+
+#include <AsyncCppApplication.h>
+#include <AsyncConfig.h>
+#include <AsyncAudioPassthrough.h>
+
+#include "Ddr.h"
+#include "WbRxRtlSdr.h"
+
+using namespace std;
+using namespace Async;
+
+
+namespace {
+
+unsigned long alloc_cnt = 0;
+
+const unsigned WARMUP_BLOCKS = 10;
+const unsigned FILE_BLOCKS = 100;
+
+} /* anonymous namespace */
+
+
+void *operator new(size_t size)
+{
+  ++alloc_cnt;
+  void *ptr = malloc((size > 0) ? size : 1);
+  if (ptr == 0)
+  {
+    throw bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+  free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+  free(ptr);
+}
+
+
+namespace {
+
+  // Write a file with an FM modulated tone and some noise at the DDR
+  // frequency, in the cu8 format
+bool createIqFile(const string& path, unsigned rate, int fq_offset)
+{
+  ofstream file(path.c_str(), ios::binary);
+  const size_t count = static_cast<size_t>(rate) / 100 * FILE_BLOCKS;
+  vector<uint8_t> buf(2 * count);
+  double phase = 0.0;
+  srand(1);
+  for (size_t n=0; n<count; ++n)
+  {
+    const double t = static_cast<double>(n) / rate;
+    phase += 2.0 * M_PI * (fq_offset + 3000.0 * sin(2.0 * M_PI * 1000.0 * t))
+             / rate;
+    phase = fmod(phase, 2.0 * M_PI);
+    const double noise_i = 0.05 * (static_cast<double>(rand()) / RAND_MAX);
+    const double noise_q = 0.05 * (static_cast<double>(rand()) / RAND_MAX);
+    buf[2*n] = static_cast<uint8_t>(127.5 + 100.0 * (cos(phase) + noise_i));
+    buf[2*n+1] = static_cast<uint8_t>(127.5 + 100.0 * (sin(phase) + noise_q));
+  }
+  file.write(reinterpret_cast<const char*>(&buf[0]), buf.size());
+  return file.good();
+}
+
+  // Sit between the DDR channel and the receiver audio pipeline and count
+  // the allocations made by the pipeline
+class AudioProbe : public AudioPassthrough
+{
+  public:
+    AudioProbe(void) : allocs(0) {}
+
+    virtual int writeSamples(const float *samples, int count)
+    {
+      const unsigned long before = alloc_cnt;
+      const int ret = AudioPassthrough::writeSamples(samples, count);
+      allocs += alloc_cnt - before;
+      return ret;
+    }
+
+    unsigned long allocs;
+};
+
+class TestDdr : public Ddr
+{
+  public:
+    TestDdr(Config& cfg, const string& name) : Ddr(cfg, name) {}
+
+    unsigned long pipelineAllocs(void) const { return m_probe.allocs; }
+
+  protected:
+    virtual AudioSource *audioSource(void)
+    {
+      Ddr::audioSource()->registerSink(&m_probe);
+      return &m_probe;
+    }
+
+  private:
+    AudioProbe m_probe;
+};
+
+  // Step through all modulations, checking the given number of blocks for
+  // each one after the warm up
+class Run
+{
+  public:
+    Run(TestDdr& ddr, unsigned rate, unsigned blocks)
+      : m_ddr(ddr), m_rate(rate), m_blocks(blocks), m_mod_idx(0),
+        m_block(0), m_before(0), m_allocs(0), m_scratch(0), m_ok(true)
+    {
+      m_ddr.setModulation(MODS[m_mod_idx]);
+    }
+
+    void beforeBlock(const vector<WbRxRtlSdr::Sample>&)
+    {
+      if (m_block == WARMUP_BLOCKS)
+      {
+        m_scratch = m_ddr.scratchAllocCount();
+      }
+      m_before = alloc_cnt - m_ddr.pipelineAllocs();
+    }
+
+    void afterBlock(const vector<WbRxRtlSdr::Sample>&)
+    {
+      const unsigned long allocs = alloc_cnt - m_ddr.pipelineAllocs() -
+                                   m_before;
+      if (m_block >= WARMUP_BLOCKS)
+      {
+        m_allocs += allocs;
+      }
+      if (++m_block == WARMUP_BLOCKS + m_blocks)
+      {
+        m_scratch = m_ddr.scratchAllocCount() - m_scratch;
+        modulationDone();
+      }
+    }
+
+    bool ok(void) const { return m_ok; }
+
+  private:
+    static const Modulation::Type MODS[];
+    static const unsigned MOD_CNT = 9;
+
+    TestDdr&        m_ddr;
+    unsigned        m_rate;
+    unsigned        m_blocks;
+    unsigned        m_mod_idx;
+    unsigned        m_block;
+    unsigned long   m_before;
+    unsigned long   m_allocs;
+    unsigned long   m_scratch;
+    bool            m_ok;
+
+    void modulationDone(void)
+    {
+      const char *mod = Modulation::toString(MODS[m_mod_idx]);
+      cout << setw(8) << m_rate << setw(6) << mod << setw(8) << m_blocks
+           << setw(8) << m_allocs << setw(9) << m_scratch << endl;
+      if ((m_allocs != 0) || (m_scratch != 0))
+      {
+        cerr << "*** ERROR: The " << mod << " signal chain at " << m_rate
+             << "Hz allocated memory in steady state" << endl;
+        m_ok = false;
+      }
+
+      if (++m_mod_idx == MOD_CNT)
+      {
+        Application::app().quit();
+        return;
+      }
+      m_block = 0;
+      m_allocs = 0;
+      m_scratch = 0;
+      m_ddr.setModulation(MODS[m_mod_idx]);
+    }
+};
+
+const Modulation::Type Run::MODS[MOD_CNT] =
+{
+  Modulation::MOD_FM, Modulation::MOD_NBFM, Modulation::MOD_WBFM,
+  Modulation::MOD_AM, Modulation::MOD_NBAM, Modulation::MOD_USB,
+  Modulation::MOD_LSB, Modulation::MOD_CW, Modulation::MOD_WBCW
+};
+
+bool runRate(unsigned rate, unsigned blocks)
+{
+  const unsigned center_fq = 433000000;
+  const int fq_offset = 125000;
+  char path[] = "/tmp/DdrAllocTest-XXXXXX";
+  int fd = mkstemp(path);
+  if (fd < 0)
+  {
+    cerr << "*** ERROR: Could not create the I/Q file" << endl;
+    return false;
+  }
+  close(fd);
+  if (!createIqFile(path, rate, fq_offset))
+  {
+    cerr << "*** ERROR: Could not write the I/Q file" << endl;
+    unlink(path);
+    return false;
+  }
+
+  CppApplication app;
+  Config cfg;
+  const string wbrx_name = "WbRx" + to_string(rate);
+  cfg.setValue(wbrx_name, "TYPE", "RtlFile");
+  cfg.setValue(wbrx_name, "FILE", path);
+  cfg.setValue(wbrx_name, "REALTIME", "0");
+  cfg.setValue(wbrx_name, "LOOP", "1");
+  cfg.setValue(wbrx_name, "SAMPLE_RATE", rate);
+  cfg.setValue(wbrx_name, "CENTER_FQ", center_fq);
+  const string rx_name = "Rx" + to_string(rate);
+  cfg.setValue(rx_name, "FQ", center_fq + fq_offset);
+  cfg.setValue(rx_name, "WBRX", wbrx_name);
+  cfg.setValue(rx_name, "SQL_DET", "OPEN");
+
+    // The WBRX is created before the DDR so that a slot can be connected
+    // to the I/Q signal both before and after the DDR channel
+  WbRxRtlSdr *wbrx = WbRxRtlSdr::instance(cfg, wbrx_name);
+  TestDdr ddr(cfg, rx_name);
+  Run *run = 0;
+  sigc::connection first = wbrx->iqReceived.connect(
+      [&run](const vector<WbRxRtlSdr::Sample>& iq) {
+        if (run != 0)
+        {
+          run->beforeBlock(iq);
+        }
+      });
+  if (!ddr.initialize())
+  {
+    cerr << "*** ERROR: Could not initialize the DDR" << endl;
+    unlink(path);
+    return false;
+  }
+  sigc::connection last = wbrx->iqReceived.connect(
+      [&run](const vector<WbRxRtlSdr::Sample>& iq) {
+        if (run != 0)
+        {
+          run->afterBlock(iq);
+        }
+      });
+  ddr.preDemod.connect([](const vector<RtlTcp::Sample>&) {});
+  ddr.setMuteState(Rx::MUTE_NONE);
+
+  Run rate_run(ddr, rate, blocks);
+  run = &rate_run;
+  app.exec();
+  run = 0;
+  first.disconnect();
+  last.disconnect();
+
+  unlink(path);
+  return rate_run.ok();
+}
+
+} /* anonymous namespace */
+
+
+int main(int argc, char **argv)
+{
+  unsigned blocks = 300;
+  if (argc > 1)
+  {
+    blocks = atoi(argv[1]);
+  }
+  if (blocks == 0)
+  {
+    cerr << "Usage: DdrAllocTest [blocks]" << endl;
+    return 1;
+  }
+
+  cout << setw(8) << "rate" << setw(6) << "mod" << setw(8) << "blocks"
+       << setw(8) << "allocs" << setw(9) << "scratch" << endl;
+  bool ok = true;
+  const unsigned rates[] = { 960000, 2400000 };
+  for (unsigned rate : rates)
+  {
+    ok = runRate(rate, blocks) && ok;
+  }
+
+  return ok ? 0 : 1;
+}
@@ -106,7 +106,16 @@ using namespace std;
  *
  ****************************************************************************/
 
-static map<char, pair<int, int> > tone_map;
+  // Initialized statically since encoders may be created by more than one
+  // thread
+static const map<char, pair<int, int> > tone_map = {
+  {'1', {697, 1209}}, {'2', {697, 1336}}, {'3', {697, 1477}},
+  {'A', {697, 1633}}, {'4', {770, 1209}}, {'5', {770, 1336}},
+  {'6', {770, 1477}}, {'B', {770, 1633}}, {'7', {852, 1209}},
+  {'8', {852, 1336}}, {'9', {852, 1477}}, {'C', {852, 1633}},
+  {'*', {941, 1209}}, {'0', {941, 1336}}, {'#', {941, 1477}},
+  {'D', {941, 1633}}
+};
 
 
 /****************************************************************************
@@ -121,25 +130,6 @@ DtmfEncoder::DtmfEncoder(int sampling_rate)
     high_tone(0), pos(0), length(0), is_playing(false),
     is_sending_digits(false)
 {
-  if (tone_map.empty())
-  {
-    tone_map['1'] = make_pair(697, 1209);
-    tone_map['2'] = make_pair(697, 1336);
-    tone_map['3'] = make_pair(697, 1477);
-    tone_map['A'] = make_pair(697, 1633);
-    tone_map['4'] = make_pair(770, 1209);
-    tone_map['5'] = make_pair(770, 1336);
-    tone_map['6'] = make_pair(770, 1477);
-    tone_map['B'] = make_pair(770, 1633);
-    tone_map['7'] = make_pair(852, 1209);
-    tone_map['8'] = make_pair(852, 1336);
-    tone_map['9'] = make_pair(852, 1477);
-    tone_map['C'] = make_pair(852, 1633);
-    tone_map['*'] = make_pair(941, 1209);
-    tone_map['0'] = make_pair(941, 1336);
-    tone_map['#'] = make_pair(941, 1477);
-    tone_map['D'] = make_pair(941, 1633);
-  }
   
 } /* DtmfEncoder::DtmfEncoder */
 
@@ -284,7 +274,8 @@ void DtmfEncoder::playNextDigit(void)
   char digit = send_queue.front().digit;
   length = send_queue.front().duration;
   send_queue.pop_front();
-  if (tone_map.count(digit) == 0)
+  map<char, pair<int, int> >::const_iterator it = tone_map.find(digit);
+  if (it == tone_map.end())
   {
     playNextDigit();
     return;
@@ -292,8 +283,8 @@ void DtmfEncoder::playNextDigit(void)
   
   //printf("Playing digit %c...\n", digit);
   
-  low_tone = tone_map[digit].first;
-  high_tone = tone_map[digit].second;
+  low_tone = it->second.first;
+  high_tone = it->second.second;
   pos = 0;
   if (length <= 0)
   {
@@ -0,0 +1,207 @@
+/**
+@file	 FmDiscriminator.h
+@brief   A vectorizable FM discriminator for complex baseband samples
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+#ifndef FM_DISCRIMINATOR_INCLUDED
+#define FM_DISCRIMINATOR_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cmath>
+#include <cstddef>
+#include <complex>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+  
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	A vectorizable FM discriminator for complex baseband samples
+@author agent
+@date   2026-10-17
+
+The instantaneous frequency is calculated as the angle between each sample
+and the previous sample, i.e. the argument of x[n] * conj(x[n-1]). The
+phase difference does not depend on the signal amplitude so the samples do
+not need to be normalized.
+
+The angle is calculated using fastAtan2, a minimax polynomial approximation
+of atan2 with a maximum error of about 1e-5 radians. Branches have been
+replaced by arithmetic so that the discriminator loop can be vectorized by
+the compiler. A zero sample give an angle of zero instead of NaN.
+
+\code
+FmDiscriminator disc;
+disc.process(audio, iq_samples, count);
+\endcode
+*/
+class FmDiscriminator
+{
+  public:
+    /**
+     * @brief   Approximate atan2 for single precision floats
+     * @param   y The imaginary part
+     * @param   x The real part
+     * @return  Returns the angle in radians in the range [-pi, pi]
+     */
+    static inline float fastAtan2(float y, float x)
+    {
+      float ax = fabsf(x);
+      float ay = fabsf(y);
+      float d = fabsf(ax - ay);
+      float mx = 0.5f * (ax + ay + d);
+      float mn = 0.5f * (ax + ay - d);
+      float a = mn / (mx + 1.0e-30f);
+      float s = a * a;
+      float r = ((-0.0464964749f * s + 0.15931422f) * s - 0.327622764f) *
+                s * a + a;
+      float sw = copysignf(1.0f, ax - ay);
+      r = (1.0f - sw) * static_cast<float>(M_PI_4) + sw * r;
+        // Adding zero turns a negative zero into a positive zero so that a
+        // zero sample give zero and not pi
+      float sx = copysignf(1.0f, x + 0.0f);
+      r = (1.0f - sx) * static_cast<float>(M_PI_2) + sx * r;
+      return copysignf(r, y);
+    }
+
+    /**
+     * @brief   Default constructor
+     */
+    FmDiscriminator(void) : iold(1.0f), qold(1.0f) {}
+
+    /**
+     * @brief   Demodulate a block of samples
+     * @param   out   Output buffer, must have room for count samples
+     * @param   in    Input IQ samples
+     * @param   count The number of samples to process
+     *
+     * The IQ samples are accessed as an interleaved float array so that the
+     * loop can be vectorized. The last sample is remembered for the next
+     * call.
+     */
+    void process(float *out, const std::complex<float> *in, size_t count)
+    {
+      if (count == 0)
+      {
+        return;
+      }
+      const float *iq = reinterpret_cast<const float*>(in);
+      out[0] = fastAtan2(iq[1] * iold - iq[0] * qold,
+                         iq[0] * iold + iq[1] * qold);
+      for (size_t k=1; k<count; ++k)
+      {
+        float i = iq[2*k];
+        float q = iq[2*k+1];
+        float ip = iq[2*k-2];
+        float qp = iq[2*k-1];
+        out[k] = fastAtan2(q * ip - i * qp, i * ip + q * qp);
+      }
+      iold = iq[2*count-2];
+      qold = iq[2*count-1];
+    }
+
+  private:
+    float iold;
+    float qold;
+
+};  /* class FmDiscriminator */
+
+
+//} /* namespace */
+
+#endif /* FM_DISCRIMINATOR_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
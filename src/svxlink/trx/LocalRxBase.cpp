@@ -62,6 +62,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncAudioFifo.h>
 #include <AsyncAudioStreamStateDetector.h>
 #include <AsyncAudioFsf.h>
+#include <AsyncAudioLatencyProbe.h>
 #include <AsyncUdpSocket.h>
 #include <common.h>
 
@@ -630,6 +631,11 @@ bool LocalRxBase::initialize(void)
 #endif
   prev_src->registerSink(splatter_filter, true);
   prev_src = splatter_filter;
+
+    // Mark the point where the audio leave the receiver when tracing latency
+  AudioLatencyProbe *latency_probe = new AudioLatencyProbe(name() + ":out");
+  prev_src->registerSink(latency_probe, true);
+  prev_src = latency_probe;
   
     // Set the previous audio pipe object to handle audio distribution for
     // the LocalRxBase class
@@ -71,6 +71,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncAudioMixer.h>
 #include <AsyncAudioDebugger.h>
 #include <AsyncAudioPacer.h>
+#include <AsyncAudioLatencyProbe.h>
 #include <common.h>
 #include <HdlcFramer.h>
 #include <AfskModulator.h>
@@ -704,6 +705,14 @@ bool LocalTx::initialize(void)
     prev_src = i2;
   }
   
+    // Mark the point where the audio enter the audio device when tracing
+    // latency. The samples buffered in the device are reported as well.
+  AudioLatencyProbe *latency_probe = new AudioLatencyProbe(name() + ":dev");
+  latency_probe->setOutputDelayFunc(
+      mem_fun(*audio_io, &AudioIO::samplesToWrite), audio_io->sampleRate());
+  prev_src->registerSink(latency_probe, true);
+  prev_src = latency_probe;
+
     // Finally connect the whole audio pipe to the audio device
   prev_src->registerSink(audio_io, true);
 
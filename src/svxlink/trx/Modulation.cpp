@@ -109,19 +109,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 Modulation::Type Modulation::fromString(const std::string& modstr)
 {
-  static std::map<std::string,Type> modmap;
-  if (modmap.empty())
-  {
-    modmap["FM"] = MOD_FM;
-    modmap["NBFM"] = MOD_NBFM;
-    modmap["WBFM"] = MOD_WBFM;
-    modmap["AM"] = MOD_AM;
-    modmap["NBAM"] = MOD_NBAM;
-    modmap["USB"] = MOD_USB;
-    modmap["LSB"] = MOD_LSB;
-    modmap["CW"] = MOD_CW;
-    modmap["WBCW"] = MOD_WBCW;
-  }
+  static const std::map<std::string,Type> modmap = {
+    {"FM", MOD_FM}, {"NBFM", MOD_NBFM}, {"WBFM", MOD_WBFM}, {"AM", MOD_AM},
+    {"NBAM", MOD_NBAM}, {"USB", MOD_USB}, {"LSB", MOD_LSB}, {"CW", MOD_CW},
+    {"WBCW", MOD_WBCW}
+  };
   std::map<std::string,Type>::const_iterator it;
   it = modmap.find(modstr);
   if (it == modmap.end())
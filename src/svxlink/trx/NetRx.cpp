@@ -510,6 +510,17 @@ void NetRx::handleMsg(Msg *msg)
       break;
     }
     
+    case MsgSilence::TYPE:
+    {
+      if ((mute_state == Rx::MUTE_NONE) && sql_is_open)
+      {
+        MsgSilence *silence_msg = reinterpret_cast<MsgSilence*>(msg);
+        unflushed_samples = true;
+        audio_dec->writeSilence(silence_msg->count());
+      }
+      break;
+    }
+    
     case MsgSel5::TYPE:
     {
       if (mute_state == Rx::MUTE_NONE)
@@ -173,7 +173,7 @@ class MsgProtoVer : public Msg
   public:
     static const unsigned TYPE  = 0;
     static const uint16_t MAJOR = 2;
-    static const uint16_t MINOR = 8;
+    static const uint16_t MINOR = 9;
     MsgProtoVer(void)
       : Msg(TYPE, sizeof(MsgProtoVer)), m_major(MAJOR),
         m_minor(MINOR) {}
@@ -429,6 +429,24 @@ class MsgAudio : public Msg
 }; /* MsgAudio */
 
 
+class MsgSilence : public Msg
+{
+  public:
+    static const unsigned TYPE = 103;
+    static const uint32_t MAX_COUNT = 16000;
+    MsgSilence(uint32_t count)
+      : Msg(TYPE, sizeof(MsgSilence)), m_count(count) {}
+    uint32_t count(void) const
+    {
+      return (m_count < MAX_COUNT) ? m_count : MAX_COUNT;
+    }
+  
+  private:
+    uint32_t m_count;
+    
+}; /* MsgSilence */
+
+
 
 /******************************** RX Messages ********************************/
 
@@ -0,0 +1,331 @@
+//
+// Benchmark for the silence gate in front of the network audio encoders.
+//
+// A simulated audio stream is encoded and sent the way NetTx and NetUplink
+// do it, once with every sample encoded and once with an AudioSilenceGate
+// in front of the encoder. The messages are decoded again the way NetRx
+// does it, that is audio and silence is only played while the squelch is
+// open. The stream is made up of 10 second cycles:
+//
+//   0 - 4s   Squelch closed, low level receiver noise
+//   4 - 7s   Squelch open, speech like audio
+//   7 - 8s   Squelch open, digital silence (e.g. DTMF muting or a pause)
+//   8 - 10s  Squelch open, speech like audio
+//
+// For each codec and mode one line is printed with the following columns:
+//
+//   codec     - The name of the codec
+//   gate      - "off" if all audio is encoded, "on" with the silence gate
+//   kbit/s    - Bandwidth used by the MsgAudio and MsgSilence messages
+//   msg/s     - Messages sent per second
+//   cpu_us/s  - CPU time in microseconds used for encoding and decoding,
+//               per second of audio
+//   played    - Seconds of audio played at the receiving end
+//
+// The program exit with an error if the gated stream do not play the same
+// amount of audio at the receiving end as the ungated stream, within one
+// codec frame per squelch opening.
+//
+// Usage: NetTrxSilenceBench [seconds] [codec...]
+//
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#include <ctime>
+
+#include <AsyncAudioSource.h>
+#include <AsyncAudioSink.h>
+#include <AsyncAudioEncoder.h>
+#include <AsyncAudioDecoder.h>
+#include <AsyncAudioSilenceGate.h>
+
+#include "NetTrxMsg.h"
+
+using namespace std;
+using namespace Async;
+using namespace NetTrxMsg;
+
+
+namespace {
+
+const int BLOCK_SIZE = INTERNAL_SAMPLE_RATE / 50;        // 20ms
+const int CYCLE_LEN = 10 * INTERNAL_SAMPLE_RATE;
+
+class BlockSource : public AudioSource
+{
+  public:
+    void write(const float *samples, int count)
+    {
+      sinkWriteSamples(samples, count);
+    }
+    void flush(void) { sinkFlushSamples(); }
+    virtual void resumeOutput(void) {}
+    virtual void allSamplesFlushed(void) {}
+};
+
+class CountingSink : public AudioSink
+{
+  public:
+    CountingSink(void) : samples(0) {}
+    virtual int writeSamples(const float *buf, int count)
+    {
+      samples += count;
+      return count;
+    }
+    virtual void flushSamples(void) { sourceAllSamplesFlushed(); }
+    unsigned long long samples;
+};
+
+double cpuTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+  // A link from an encoder at the sending end to a decoder at the
+  // receiving end
+class Link : public sigc::trackable
+{
+  public:
+    unsigned long long  bytes;
+    unsigned long       msgs;
+
+    Link(const string& codec, bool use_gate)
+      : bytes(0), msgs(0), m_use_gate(use_gate), m_sql_open(false)
+    {
+      m_enc = AudioEncoder::create(codec);
+      m_dec = AudioDecoder::create(codec);
+      m_enc->writeEncodedSamples.connect(mem_fun(*this, &Link::sendAudio));
+      m_enc->flushEncodedSamples.connect(
+          mem_fun(*m_enc, &AudioEncoder::allEncodedSamplesFlushed));
+      m_dec->registerSink(&m_sink);
+      if (m_use_gate)
+      {
+        m_gate.silenceDetected.connect(mem_fun(*this, &Link::sendSilence));
+        m_gate.setHangtime(
+            max(m_gate.hangtime(), m_enc->packetSampleCount()));
+        m_gate.setSuspended(true);
+        m_src.registerSink(&m_gate);
+        m_gate.registerSink(m_enc);
+      }
+      else
+      {
+        m_src.registerSink(m_enc);
+      }
+    }
+
+    ~Link(void)
+    {
+      m_src.unregisterSink();
+      m_gate.unregisterSink();
+      m_dec->unregisterSink();
+      delete m_enc;
+      delete m_dec;
+    }
+
+    void write(const float *samples, int count)
+    {
+      m_src.write(samples, count);
+    }
+
+    void setSquelchOpen(bool is_open)
+    {
+      if (!is_open)
+      {
+          // The receiver flush the audio before the squelch close
+        m_src.flush();
+      }
+      if (m_use_gate)
+      {
+        m_gate.setSuspended(!is_open);
+      }
+      m_sql_open = is_open;
+    }
+
+    unsigned long long played(void) const { return m_sink.samples; }
+
+  private:
+    AudioEncoder*     m_enc;
+    AudioDecoder*     m_dec;
+    BlockSource       m_src;
+    AudioSilenceGate  m_gate;
+    CountingSink      m_sink;
+    bool              m_use_gate;
+    bool              m_sql_open;
+
+    void sendAudio(const void *buf, int size)
+    {
+      const char *ptr = reinterpret_cast<const char *>(buf);
+      while (size > 0)
+      {
+        int len = min(size, MsgAudio::BUFSIZE);
+        MsgAudio msg(ptr, len);
+        bytes += msg.size();
+        ++msgs;
+        if (m_sql_open)
+        {
+          m_dec->writeEncodedSamples(msg.buf(), msg.size());
+        }
+        size -= len;
+        ptr += len;
+      }
+    }
+
+    void sendSilence(unsigned count)
+    {
+      MsgSilence msg(count);
+      bytes += msg.size();
+      ++msgs;
+      if (m_sql_open)
+      {
+        m_dec->writeSilence(msg.count());
+      }
+    }
+};
+
+  // Create one cycle of the simulated stream
+void createCycle(vector<float>& cycle)
+{
+  cycle.resize(CYCLE_LEN);
+  for (int i=0; i<CYCLE_LEN; ++i)
+  {
+    const float t = static_cast<float>(i) / INTERNAL_SAMPLE_RATE;
+    const float noise = static_cast<float>(rand()) / RAND_MAX - 0.5f;
+    if ((t < 4.0f) || ((t >= 7.0f) && (t < 8.0f)))
+    {
+      cycle[i] = (t < 4.0f) ? 0.01f * noise : 0.0f;
+    }
+    else
+    {
+        // A couple of harmonics, syllable rate amplitude modulation and
+        // some noise
+      const float f0 = 140.0f + 30.0f * sinf(2.0f * M_PI * 0.7f * t);
+      float sample = 0.0f;
+      for (int h=1; h<=5; ++h)
+      {
+        sample += sinf(2.0f * M_PI * h * f0 * t) / h;
+      }
+      const float env = 0.5f + 0.5f * sinf(2.0f * M_PI * 4.0f * t);
+      cycle[i] = 0.2f * env * sample + 0.02f * noise;
+    }
+  }
+}
+
+struct Result
+{
+  double              kbps;
+  double              msgs_per_sec;
+  double              cpu_us;
+  unsigned long long  played;
+};
+
+Result run(const string& codec, bool use_gate, const vector<float>& cycle,
+           unsigned cycles)
+{
+  Link link(codec, use_gate);
+  const double start = cpuTime();
+  for (unsigned c=0; c<cycles; ++c)
+  {
+    for (int pos=0; pos<CYCLE_LEN; pos+=BLOCK_SIZE)
+    {
+      if (pos == 4 * INTERNAL_SAMPLE_RATE)
+      {
+        link.setSquelchOpen(true);
+      }
+      link.write(&cycle[pos], BLOCK_SIZE);
+    }
+    link.setSquelchOpen(false);
+  }
+  const double elapsed = cpuTime() - start;
+
+  const double audio_sec = 10.0 * cycles;
+  Result result;
+  result.kbps = 8.0 * link.bytes / audio_sec / 1000.0;
+  result.msgs_per_sec = link.msgs / audio_sec;
+  result.cpu_us = 1e6 * elapsed / audio_sec;
+  result.played = link.played();
+  return result;
+}
+
+void printResult(const string& codec, bool use_gate, const Result& result)
+{
+  cout << setw(7) << codec << setw(6) << (use_gate ? "on" : "off")
+       << setw(10) << fixed << setprecision(1) << result.kbps
+       << setw(8) << setprecision(1) << result.msgs_per_sec
+       << setw(10) << setprecision(1) << result.cpu_us
+       << setw(9) << setprecision(2)
+       << static_cast<double>(result.played) / INTERNAL_SAMPLE_RATE
+       << endl;
+}
+
+} /* anonymous namespace */
+
+
+int main(int argc, char **argv)
+{
+  unsigned seconds = 60;
+  if (argc > 1)
+  {
+    seconds = atoi(argv[1]);
+  }
+  const unsigned cycles = seconds / 10;
+  if (cycles == 0)
+  {
+    cerr << "Usage: NetTrxSilenceBench [seconds] [codec...]" << endl;
+    return 1;
+  }
+
+  vector<string> codecs;
+  for (int i=2; i<argc; ++i)
+  {
+    codecs.push_back(argv[i]);
+  }
+  if (codecs.empty())
+  {
+    const char *all[] = { "RAW", "S16", "GSM", "SPEEX", "OPUS" };
+    for (const char *codec : all)
+    {
+      if (AudioEncoder::isAvailable(codec))
+      {
+        codecs.push_back(codec);
+      }
+    }
+  }
+
+  vector<float> cycle;
+  createCycle(cycle);
+
+  cout << setw(7) << "codec" << setw(6) << "gate" << setw(10) << "kbit/s"
+       << setw(8) << "msg/s" << setw(10) << "cpu_us/s" << setw(9) << "played"
+       << endl;
+  bool ok = true;
+  for (const string& codec : codecs)
+  {
+    if (!AudioEncoder::isAvailable(codec) || !AudioDecoder::isAvailable(codec))
+    {
+      cerr << "*** ERROR: Codec " << codec << " is not available" << endl;
+      return 1;
+    }
+    const Result off = run(codec, false, cycle, cycles);
+    printResult(codec, false, off);
+    const Result on = run(codec, true, cycle, cycles);
+    printResult(codec, true, on);
+
+      // The largest codec frame is 120ms (Opus)
+    const long long diff = static_cast<long long>(on.played) - off.played;
+    if (llabs(diff) > cycles * INTERNAL_SAMPLE_RATE * 120LL / 1000)
+    {
+      cerr << "*** ERROR: The gated " << codec << " stream played " << diff
+           << " samples more than the ungated stream" << endl;
+      ok = false;
+    }
+  }
+
+  return ok ? 0 : 1;
+}
@@ -106,7 +106,9 @@ using namespace NetTrxMsg;
  *
  ****************************************************************************/
 
-std::map<std::pair<const std::string, uint16_t>, NetTrxTcpClient*>
+  // The clients are shared per thread since each client belong to the event
+  // loop of the thread that created it
+thread_local std::map<std::pair<const std::string, uint16_t>, NetTrxTcpClient*>
       	NetTrxTcpClient::clients;
 
 
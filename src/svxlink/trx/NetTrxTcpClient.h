@@ -211,7 +211,7 @@ class NetTrxTcpClient : public Async::TcpClient<>
     } State;
     
     static const int RECV_BUF_SIZE = 4096;
-    static Clients clients;
+    static thread_local Clients clients;
 
     char      	    recv_buf[RECV_BUF_SIZE];
     unsigned        recv_cnt;
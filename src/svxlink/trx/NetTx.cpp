@@ -36,6 +36,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <cassert>
 #include <cstring>
 #include <cstdlib>
+#include <algorithm>
 
 
 /****************************************************************************
@@ -47,6 +48,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncConfig.h>
 #include <AsyncAudioPacer.h>
 #include <AsyncAudioEncoder.h>
+#include <AsyncAudioLatencyProbe.h>
+#include <AsyncAudioSilenceGate.h>
 
 
 /****************************************************************************
@@ -122,7 +125,7 @@ NetTx::NetTx(Config &cfg, const string& name)
   : Tx(name), cfg(cfg), tcp_con(0), log_disconnects_once(false),
     log_disconnect(true), mode(Tx::TX_OFF),
     ctcss_enable(false), pacer(0), is_connected(false), pending_flush(false),
-    unflushed_samples(false), audio_enc(0), fq(0),
+    unflushed_samples(false), audio_enc(0), silence_gate(0), fq(0),
     modulation(Modulation::MOD_UNKNOWN)
 {
 } /* NetTx::NetTx */
@@ -169,6 +172,17 @@ bool NetTx::initialize(void)
   
   string auth_key;
   cfg.getValue(name(), "AUTH_KEY", auth_key);
+
+  bool silence_gate_enable = true;
+  cfg.getValue(name(), "SILENCE_GATE", silence_gate_enable, true);
+  unsigned silence_hangtime = 100;
+  if (!cfg.getValue(name(), "SILENCE_HANGTIME", 0U, 10000U, silence_hangtime,
+                    true))
+  {
+    cerr << "*** ERROR: Illegal value for config variable " << name()
+         << "/SILENCE_HANGTIME. Valid range is 0 to 10000.\n";
+    return false;
+  }
   
   pacer = new AudioPacer(INTERNAL_SAMPLE_RATE, 512, 50);
   setHandler(pacer);
@@ -199,7 +213,22 @@ bool NetTx::initialize(void)
     }
   }
   audio_enc->printCodecParams();
-  pacer->registerSink(audio_enc);
+
+    // Runs of digital silence are sent as MsgSilence instead of being
+    // encoded. The hangtime must cover at least one encoder packet so that
+    // no audio is left in the encoder when the silence is reported.
+  silence_gate = new AudioSilenceGate;
+  silence_gate->setEnabled(silence_gate_enable);
+  silence_gate->setHangtime(
+      max(silence_hangtime * INTERNAL_SAMPLE_RATE / 1000,
+          audio_enc->packetSampleCount()));
+  silence_gate->silenceDetected.connect(mem_fun(*this, &NetTx::writeSilence));
+  pacer->registerSink(silence_gate, true);
+
+    // Mark the point where audio enter the encoder when tracing latency
+  AudioLatencyProbe *latency_probe = new AudioLatencyProbe(name() + ":enc");
+  silence_gate->registerSink(latency_probe, true);
+  latency_probe->registerSink(audio_enc);
   
   tcp_con = NetTrxTcpClient::instance(host, atoi(tcp_port.c_str()));
   if (tcp_con == 0)
@@ -443,6 +472,26 @@ void NetTx::writeEncodedSamples(const void *buf, int size)
 } /* NetTx::writeEncodedSamples */
 
 
+void NetTx::writeSilence(unsigned count)
+{
+  pending_flush = false;
+  unflushed_samples = true;
+
+  if (is_connected)
+  {
+    MsgSilence *msg = new MsgSilence(count);
+    sendMsg(msg);
+  }
+  else
+  {
+    if (mode == Tx::TX_AUTO)
+    {
+      setIsTransmitting(true);
+    }
+  }
+} /* NetTx::writeSilence */
+
+
 void NetTx::flushEncodedSamples(void)
 {
   if (is_connected)
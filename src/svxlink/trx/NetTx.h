@@ -75,6 +75,7 @@ namespace Async
   class AudioPacer;
   class SigCAudioSink;
   class AudioEncoder;
+  class AudioSilenceGate;
 };
 
 
@@ -213,6 +214,7 @@ class NetTx : public Tx
     bool      	      	  pending_flush;
     bool      	      	  unflushed_samples;
     Async::AudioEncoder   *audio_enc;
+    Async::AudioSilenceGate *silence_gate;
     unsigned              fq;
     Modulation::Type      modulation;
     
@@ -220,6 +222,7 @@ class NetTx : public Tx
     void handleMsg(NetTrxMsg::Msg *msg);
     void sendMsg(NetTrxMsg::Msg *msg);
     void writeEncodedSamples(const void *buf, int size);
+    void writeSilence(unsigned count);
     void flushEncodedSamples(void);
     void allEncodedSamplesFlushed(void);
 
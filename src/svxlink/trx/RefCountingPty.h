@@ -162,7 +162,7 @@ class RefCountingPty : public Async::Pty
 
     static PtyMap& ptys(void)
     {
-      static PtyMap pty_map;
+      static thread_local PtyMap pty_map;
       return pty_map;
     }
 
@@ -0,0 +1,308 @@
+/**
+@file	 RtlFile.cpp
+@brief   An RtlSdr replaying IQ samples from a file
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "RtlFile.h"
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+bool RtlFile::formatFromString(const string &name, Format &format)
+{
+  if (name == "cu8")
+  {
+    format = FORMAT_CU8;
+  }
+  else if (name == "cf32")
+  {
+    format = FORMAT_CF32;
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+} /* RtlFile::formatFromString */
+
+
+RtlFile::RtlFile(const string &path, Format format, bool realtime, bool loop)
+  : path(path), format(format), realtime(realtime), loop(loop), file(0),
+    replay_timer(realtime ? REALTIME_INTERVAL : 0, Timer::TYPE_PERIODIC,
+                 false),
+    started(false), start_samples(0), samples_replayed(0)
+{
+  start_ts.tv_sec = 0;
+  start_ts.tv_nsec = 0;
+
+  file = fopen(path.c_str(), "rb");
+  if (file == 0)
+  {
+    cerr << "*** ERROR: Could not open IQ file \"" << path << "\": "
+         << strerror(errno) << endl;
+    return;
+  }
+  replay_timer.expired.connect(mem_fun(*this, &RtlFile::replay));
+  replay_timer.setEnable(true);
+} /* RtlFile::RtlFile */
+
+
+RtlFile::~RtlFile(void)
+{
+  if (file != 0)
+  {
+    fclose(file);
+    file = 0;
+  }
+} /* RtlFile::~RtlFile */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+void RtlFile::handleSetSampleRate(uint32_t rate)
+{
+  restartClock();
+} /* RtlFile::handleSetSampleRate */
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+/*
+ *----------------------------------------------------------------------------
+ * Method:    RtlFile::replay
+ * Purpose:   Replay the blocks that are due. In real time mode, the number
+ *            of samples that should have been replayed is calculated from
+ *            the time since the replay was started. Otherwise one block is
+ *            replayed for each timer tick.
+ * Input:     t - The timer that expired
+ * Output:    None
+ * Author:    agent
+ * Created:   2026-10-17
+ * Remarks:   If the real time replay fall too far behind, e.g. when the
+ *            process has been stopped, the clock is restarted instead of
+ *            trying to catch up with a big burst of samples.
+ * Bugs:
+ *----------------------------------------------------------------------------
+ */
+void RtlFile::replay(Timer *t)
+{
+  if (!started)
+  {
+    started = true;
+    restartClock();
+    readyStateChanged();
+  }
+
+  if (!realtime)
+  {
+    replayBlock();
+    return;
+  }
+
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  const double elapsed = (now.tv_sec - start_ts.tv_sec) +
+                         (now.tv_nsec - start_ts.tv_nsec) / 1000000000.0;
+  uint64_t due = start_samples +
+                 static_cast<uint64_t>(elapsed * sampleRate());
+  const uint64_t block_samples = blockSize() / 2;
+  if (due > samples_replayed + MAX_BLOCKS_BEHIND * block_samples)
+  {
+    restartClock();
+    due = samples_replayed + block_samples;
+  }
+  while (samples_replayed + block_samples <= due)
+  {
+    if (!replayBlock())
+    {
+      return;
+    }
+  }
+} /* RtlFile::replay */
+
+
+bool RtlFile::replayBlock(void)
+{
+    // The DDR decimators require whole blocks so when looping, a block that
+    // reach the end of the file is filled up from the start of the file
+  const size_t count = blockSize() / 2;
+  size_t n = readSamples(0, count);
+  while ((n < count) && loop && !ferror(file))
+  {
+    rewind(file);
+    const size_t read_cnt = readSamples(n, count - n);
+    if (read_cnt == 0)
+    {
+      break;
+    }
+    n += read_cnt;
+  }
+
+  if (n == count)
+  {
+    if (format == FORMAT_CU8)
+    {
+      handleIq(&cu8_buf[0], count);
+    }
+    else
+    {
+      handleIq(&cf32_buf[0], count);
+    }
+    samples_replayed += count;
+    return true;
+  }
+
+  if (ferror(file))
+  {
+    cerr << "*** ERROR: Read error on IQ file \"" << path << "\"\n";
+  }
+
+    // The samples that do not fill a whole block at the end of the file
+    // are dropped
+  replay_timer.setEnable(false);
+  fclose(file);
+  file = 0;
+  readyStateChanged();
+  endOfFile();
+  return false;
+} /* RtlFile::replayBlock */
+
+
+size_t RtlFile::readSamples(size_t offset, size_t count)
+{
+  if (format == FORMAT_CU8)
+  {
+    cu8_buf.resize(offset + count);
+    return fread(&cu8_buf[offset], sizeof(cu8_buf[0]), count, file);
+  }
+  cf32_buf.resize(offset + count);
+  return fread(&cf32_buf[offset], sizeof(cf32_buf[0]), count, file);
+} /* RtlFile::readSamples */
+
+
+void RtlFile::restartClock(void)
+{
+  clock_gettime(CLOCK_MONOTONIC, &start_ts);
+  start_samples = samples_replayed;
+} /* RtlFile::restartClock */
+
+
+
+/*
+ * This file has not been truncated
+ */
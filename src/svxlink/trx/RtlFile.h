@@ -0,0 +1,242 @@
+/**
+@file	 RtlFile.h
+@brief   An RtlSdr replaying IQ samples from a file
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef RTL_FILE_INCLUDED
+#define RTL_FILE_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include <complex>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncTimer.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "RtlSdr.h"
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	An RtlSdr replaying IQ samples from a file
+@author agent
+@date   2026-10-17
+
+This class read recorded IQ samples from a file and feed them to the upper
+layers just as if they came from a real RTL dongle. That make it possible to
+run the wide-band receiver and DDR code without any hardware, for example
+for benchmarking or for comparing the demodulated output from different
+versions of the code.
+
+Two file formats are supported. The "cu8" format is the raw format produced
+by the rtl_sdr utility, interleaved unsigned 8 bit I and Q samples. The
+"cf32" format is interleaved 32 bit native endian floats in the range -1 to
+1, as written by for example GNU Radio. The sample rate is not stored in the
+file so it must be set to the rate that was used when the file was recorded.
+
+The samples are either paced in real time, using the set sample rate, or
+replayed as fast as possible, one block for each turn of the event loop.
+Only whole blocks are replayed. When the end of the file is reached, the file
+is either rewound, and the block is filled up from the start of the file, or
+the replay is stopped and the endOfFile signal is emitted. In the latter case
+the samples at the end of the file that do not fill a whole block are
+dropped.
+*/
+class RtlFile : public RtlSdr
+{
+  public:
+    /**
+     * @brief   The supported file formats
+     */
+    typedef enum
+    {
+      FORMAT_CU8,   ///< Interleaved unsigned 8 bit I and Q
+      FORMAT_CF32   ///< Interleaved 32 bit float I and Q
+    } Format;
+
+    /**
+     * @brief   Translate a format name to a format
+     * @param   name The name of the format, "cu8" or "cf32"
+     * @param   format The format is returned here
+     * @return  Returns \em true on success or \em false if the name is unknown
+     */
+    static bool formatFromString(const std::string &name, Format &format);
+
+    /**
+     * @brief 	Constructor
+     * @param   path The path to the IQ file
+     * @param   format The format of the file
+     * @param   realtime Set to \em true to pace the samples in real time
+     * @param   loop Set to \em true to rewind the file when the end is reached
+     */
+    RtlFile(const std::string &path, Format format=FORMAT_CU8,
+            bool realtime=true, bool loop=true);
+
+    /**
+     * @brief 	Destructor
+     */
+    virtual ~RtlFile(void);
+
+    /**
+     * @brief   Find out if the file is ready for operation
+     * @returns Returns \em true if the file is open
+     */
+    virtual bool isReady(void) const { return file != 0; }
+
+    /**
+     * @brief   Return a string which identifies the file
+     * @returns Returns the path to the IQ file
+     */
+    virtual const std::string displayName(void) const { return path; }
+
+    /**
+     * @brief   Get the number of IQ samples replayed so far
+     * @returns Returns the total number of IQ samples emitted
+     */
+    uint64_t samplesReplayed(void) const { return samples_replayed; }
+
+    /**
+     * @brief   A signal that is emitted when the end of the file is reached
+     *
+     * This signal is only emitted if looping is disabled.
+     */
+    sigc::signal<void> endOfFile;
+
+  protected:
+      // There is no tuner to control so most settings are just ignored
+    virtual void handleSetTunerIfGain(uint16_t stage, int16_t gain) {}
+    virtual void handleSetCenterFq(uint32_t fq) {}
+    virtual void handleSetSampleRate(uint32_t rate);
+    virtual void handleSetGainMode(uint32_t mode) {}
+    virtual void handleSetGain(int32_t gain) {}
+    virtual void handleSetFqCorr(int corr) {}
+    virtual void handleEnableTestMode(bool enable) {}
+    virtual void handleEnableDigitalAgc(bool enable) {}
+
+  private:
+    static const unsigned REALTIME_INTERVAL = 10;
+    static const unsigned MAX_BLOCKS_BEHIND = 10;
+
+    std::string                         path;
+    Format                              format;
+    bool                                realtime;
+    bool                                loop;
+    FILE                                *file;
+    Async::Timer                        replay_timer;
+    bool                                started;
+    struct timespec                     start_ts;
+    uint64_t                            start_samples;
+    uint64_t                            samples_replayed;
+    std::vector<std::complex<uint8_t>>  cu8_buf;
+    std::vector<std::complex<float>>    cf32_buf;
+
+    RtlFile(const RtlFile&);
+    RtlFile& operator=(const RtlFile&);
+    void replay(Async::Timer *t);
+    bool replayBlock(void);
+    size_t readSamples(size_t offset, size_t count);
+    void restartClock(void);
+
+};  /* class RtlFile */
+
+
+//} /* namespace */
+
+#endif /* RTL_FILE_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,295 @@
+/**
+@file	 RtlSampleRing.cpp
+@brief   A lock free block ring used to hand over samples from a thread
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+#include <algorithm>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncFdWatch.h>
+#include <AsyncMetrics.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "RtlSampleRing.h"
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+RtlSampleRing::RtlSampleRing(uint32_t block_size, uint32_t max_block_size,
+                             unsigned block_count)
+  : block_count(max(block_count, 2U)),
+    max_block_size(max(block_size, max_block_size)),
+    block_len(this->block_count, 0), block_size(block_size), head(0),
+    tail(0), signal_pending(false), writer_closed(false), dropped(0),
+    buf_cnt(0), dropped_reported(0), wakeup_cnt(0), event_fd(-1), watch(0)
+{
+  mem.resize(static_cast<size_t>(this->block_count) * this->max_block_size);
+
+  event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (event_fd < 0)
+  {
+    cerr << "*** ERROR: Could not create RTL sample ring eventfd: "
+         << strerror(errno) << endl;
+    return;
+  }
+  watch = new FdWatch(event_fd, FdWatch::FD_WATCH_RD);
+  watch->activity.connect(mem_fun(*this, &RtlSampleRing::removeSamples));
+} /* RtlSampleRing::RtlSampleRing */
+
+
+RtlSampleRing::~RtlSampleRing(void)
+{
+  delete watch;
+  watch = 0;
+  if (event_fd >= 0)
+  {
+    close(event_fd);
+    event_fd = -1;
+  }
+} /* RtlSampleRing::~RtlSampleRing */
+
+
+void RtlSampleRing::setBlockSize(uint32_t new_block_size)
+{
+  block_size = min(max(new_block_size, 2U), max_block_size);
+} /* RtlSampleRing::setBlockSize */
+
+
+bool RtlSampleRing::addSamples(const unsigned char *samples, uint32_t len)
+{
+  while (len > 0)
+  {
+    const uint64_t h = head.load(memory_order_relaxed);
+
+      // A new block may only be started when the reader is done with it.
+      // If the ring is full, the rest of the samples are dropped.
+    if ((buf_cnt == 0) && (h - tail.load() >= block_count))
+    {
+      dropped += len / 2;
+      return true;
+    }
+
+    const uint32_t bs = block_size.load(memory_order_relaxed);
+    const uint32_t cpy_cnt = min(bs - min(buf_cnt, bs), len);
+    memcpy(block(h) + buf_cnt, samples, cpy_cnt);
+    buf_cnt += cpy_cnt;
+    len -= cpy_cnt;
+    samples += cpy_cnt;
+    if (buf_cnt >= bs)
+    {
+      block_len[h % block_count] = buf_cnt;
+      buf_cnt = 0;
+      head = h + 1;
+      if (!signalReader())
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+} /* RtlSampleRing::addSamples */
+
+
+void RtlSampleRing::closeWriter(void)
+{
+  writer_closed = true;
+  signal_pending = false;
+  signalReader();
+} /* RtlSampleRing::closeWriter */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+/*
+ *----------------------------------------------------------------------------
+ * Method:    RtlSampleRing::signalReader
+ * Purpose:   Wake the reader up if it is not already about to run.
+ * Input:     None
+ * Output:    Returns \em false if the eventfd could not be written
+ * Author:    agent
+ * Created:   2026-10-17
+ * Remarks:   The pending flag is cleared by the reader before it look at the
+ *            head index. A block published after that will cause a new
+ *            write to the eventfd. A block published before that will be
+ *            seen by the reader so no wakeup is needed.
+ * Bugs:
+ *----------------------------------------------------------------------------
+ */
+bool RtlSampleRing::signalReader(void)
+{
+  if (signal_pending.exchange(true))
+  {
+    return true;
+  }
+  const uint64_t one = 1;
+  return (write(event_fd, &one, sizeof(one)) == sizeof(one));
+} /* RtlSampleRing::signalReader */
+
+
+void RtlSampleRing::removeSamples(FdWatch *w)
+{
+  uint64_t cnt;
+  if (read(event_fd, &cnt, sizeof(cnt)) != sizeof(cnt))
+  {
+    if (errno == EAGAIN)
+    {
+      return;
+    }
+    cerr << "*** ERROR: Error while reading RTL sample ring eventfd: "
+         << strerror(errno) << endl;
+    abort();
+  }
+  ++wakeup_cnt;
+  signal_pending = false;
+
+  uint64_t t = tail.load(memory_order_relaxed);
+  while (t != head.load())
+  {
+    uint8_t *buf = block(t);
+    complex<uint8_t> *samples = reinterpret_cast<complex<uint8_t>*>(buf);
+    handleIq(samples, block_len[t % block_count] / 2);
+    tail = ++t;
+  }
+
+  const uint64_t dropped_now = dropped;
+  if (dropped_now != dropped_reported)
+  {
+    cerr << "*** WARNING: RTL sample buffer overflow. "
+         << (dropped_now - dropped_reported) << " samples dropped\n";
+    MetricsRegistry::instance().counter(
+        "svxlink_rtl_dropped_samples_total",
+        "Number of samples dropped due to RTL sample buffer overflow")
+      .inc(dropped_now - dropped_reported);
+    dropped_reported = dropped_now;
+  }
+
+  if (writer_closed)
+  {
+    watch->setEnabled(false);
+    writerClosed();
+  }
+} /* RtlSampleRing::removeSamples */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,253 @@
+/**
+@file	 RtlSampleRing.h
+@brief   A lock free block ring used to hand over samples from a thread
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef RTL_SAMPLE_RING_INCLUDED
+#define RTL_SAMPLE_RING_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <atomic>
+#include <complex>
+#include <vector>
+#include <sigc++/sigc++.h>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+  class FdWatch;
+};
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	A lock free block ring used to hand over samples from a thread
+@author agent
+@date   2026-10-17
+
+This class is used to move raw 8 bit IQ samples from the thread reading a
+RTL dongle over to the main thread. There must be exactly one writer thread,
+calling addSamples and closeWriter, and one reader, the main thread running
+the Async event loop.
+
+All blocks are allocated when the ring is created so no memory is allocated
+while samples are flowing, and no locks are taken. The writer fill the block
+at the head of the ring and publish it when it is full. The reader is woken
+up through an eventfd that is monitored by an Async::FdWatch. The eventfd is
+only written to when the reader is not already about to run so when the
+reader is busy, many blocks may be handed over for a single wakeup.
+
+If the reader cannot keep up and the ring is full, incoming samples are
+dropped. The number of dropped samples is reported by the reader.
+
+\code
+RtlSampleRing *ring = new RtlSampleRing(block_size, max_block_size);
+ring->handleIq.connect(mem_fun(*this, &MyClass::handleIq));
+// In the reader thread
+ring->addSamples(buf, len);
+\endcode
+*/
+class RtlSampleRing : public sigc::trackable
+{
+  public:
+    /**
+     * @brief   The default number of blocks in the ring
+     */
+    static const unsigned DEFAULT_BLOCK_COUNT = 32;
+
+    /**
+     * @brief 	Constructor
+     * @param 	block_size The number of bytes in a block
+     * @param 	max_block_size The largest block size that will be used
+     * @param   block_count The number of blocks in the ring
+     */
+    RtlSampleRing(uint32_t block_size, uint32_t max_block_size,
+                  unsigned block_count=DEFAULT_BLOCK_COUNT);
+
+    /**
+     * @brief 	Destructor
+     */
+    ~RtlSampleRing(void);
+
+    /**
+     * @brief   Check if the ring was successfully created
+     * @return  Returns \em true if the eventfd could be created
+     */
+    bool initOk(void) const { return event_fd >= 0; }
+
+    /**
+     * @brief   Set a new block size
+     * @param   new_block_size The new block size in bytes
+     *
+     * This function is called from the main thread and may be called while
+     * the writer is running. The new block size is used from the next block
+     * that is published. It is limited to the max_block_size given to the
+     * constructor.
+     */
+    void setBlockSize(uint32_t new_block_size);
+
+    /**
+     * @brief   Add samples to the ring (writer thread only)
+     * @param   samples The 8 bit interleaved IQ samples
+     * @param   len The number of bytes
+     * @return  Returns \em false if the reader could not be signalled
+     */
+    bool addSamples(const unsigned char *samples, uint32_t len);
+
+    /**
+     * @brief   Tell the reader that the writer is done (writer thread only)
+     *
+     * The reader will emit the writerClosed signal when all blocks have
+     * been handed out.
+     */
+    void closeWriter(void);
+
+    /**
+     * @brief   Get the number of samples dropped due to a full ring
+     * @return  Returns the number of dropped IQ samples since the start
+     */
+    uint64_t droppedSamples(void) const { return dropped; }
+
+    /**
+     * @brief   Get the number of reader wakeups
+     * @return  Returns the number of times the eventfd has been read
+     */
+    uint64_t wakeups(void) const { return wakeup_cnt; }
+
+    /**
+     * @brief   A signal that is emitted in the reader for each full block
+     * @param   samples The IQ samples
+     * @param   count The number of IQ samples
+     */
+    sigc::signal<void, std::complex<uint8_t>*, int> handleIq;
+
+    /**
+     * @brief   A signal that is emitted when the writer has been closed
+     */
+    sigc::signal<void> writerClosed;
+
+  private:
+    const unsigned            block_count;
+    const uint32_t            max_block_size;
+    std::vector<uint8_t>      mem;
+    std::vector<uint32_t>     block_len;
+    std::atomic<uint32_t>     block_size;
+    std::atomic<uint64_t>     head;
+    std::atomic<uint64_t>     tail;
+    std::atomic<bool>         signal_pending;
+    std::atomic<bool>         writer_closed;
+    std::atomic<uint64_t>     dropped;
+    uint32_t                  buf_cnt;
+    uint64_t                  dropped_reported;
+    uint64_t                  wakeup_cnt;
+    int                       event_fd;
+    Async::FdWatch            *watch;
+
+    RtlSampleRing(const RtlSampleRing&);
+    RtlSampleRing& operator=(const RtlSampleRing&);
+    uint8_t *block(uint64_t idx) { return &mem[(idx % block_count) *
+                                               max_block_size]; }
+    bool signalReader(void);
+    void removeSamples(Async::FdWatch *w);
+
+};  /* class RtlSampleRing */
+
+
+//} /* namespace */
+
+#endif /* RTL_SAMPLE_RING_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,230 @@
+//
+// Stress test for the RTL sample ring.
+//
+// A writer thread replay synthetic RTL USB callbacks into an RtlSampleRing,
+// just like the librtlsdr reader thread in the RtlUsb class. Each 64 bit word
+// in the sample stream hold its own position in the stream so that the
+// reader can check that every block it get is contiguous and find out which
+// callback completed the block. The reader may be given some extra work per
+// block to simulate a loaded main thread. When done, the following is
+// printed:
+//
+//   blocks    - The number of blocks handed out to the reader
+//   wakeups   - The number of reader wakeups (eventfd reads)
+//   dropped   - The number of IQ samples dropped due to a full ring
+//   corrupt   - The number of blocks that were not contiguous
+//   latency   - Time from the callback completing a block until the reader
+//               got it, in microseconds (mean, 99th percentile and max)
+//
+// Usage: RtlSampleRingTest [sample rate] [seconds] [reader load in us]
+//                          [ring blocks]
+//
+// A sample rate of 0 replay the callbacks as fast as possible.
+//
+
+#include <pthread.h>
+#include <time.h>
+#include <stdint.h>
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+
+#include <AsyncCppApplication.h>
+
+#include "RtlSampleRing.h"
+
+using namespace std;
+using namespace Async;
+
+
+static int64_t nowNs(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+
+class RingTest : public sigc::trackable
+{
+  public:
+    RingTest(unsigned rate, unsigned seconds, unsigned load_us,
+             unsigned blocks)
+      : m_rate(rate), m_load_us(load_us),
+        m_block_size(10 * 2 * (rate > 0 ? rate : 2400000) / 1000 / 8 * 8),
+        m_cb_len(16384 * ceil(m_block_size / 16384.0)),
+        m_ring(m_block_size, m_block_size, blocks),
+        m_blocks(0), m_corrupt(0)
+    {
+      const double bytes_per_sec = 2.0 * (rate > 0 ? rate : 2400000);
+      m_cb_cnt = seconds * bytes_per_sec / m_cb_len;
+      if (rate == 0)
+      {
+        m_cb_cnt *= 10;
+      }
+      m_cb_time.reset(new atomic<int64_t>[m_cb_cnt]);
+      m_latency.reserve(m_cb_cnt * m_cb_len / m_block_size + 1);
+      m_ring.handleIq.connect(mem_fun(*this, &RingTest::handleIq));
+      m_ring.writerClosed.connect(mem_fun(*this, &RingTest::writerClosed));
+    }
+
+    bool start(void)
+    {
+      return m_ring.initOk() &&
+             (pthread_create(&m_thread, NULL, startWriter, this) == 0);
+    }
+
+  private:
+    unsigned                      m_rate;
+    unsigned                      m_load_us;
+    uint32_t                      m_block_size;
+    uint32_t                      m_cb_len;
+    RtlSampleRing                 m_ring;
+    uint64_t                      m_cb_cnt;
+    unique_ptr<atomic<int64_t>[]> m_cb_time;
+    pthread_t                     m_thread;
+    uint64_t                      m_blocks;
+    uint64_t                      m_corrupt;
+    vector<double>                m_latency;
+    int64_t                       m_start;
+
+    static void *startWriter(void *data)
+    {
+      reinterpret_cast<RingTest*>(data)->writer();
+      return NULL;
+    }
+
+    void writer(void)
+    {
+      vector<uint64_t> buf(m_cb_len / 8);
+      const double cb_ns = (m_rate > 0) ? 1.0e9 * m_cb_len / (2.0 * m_rate)
+                                        : 0.0;
+      m_start = nowNs();
+      uint64_t pos = 0;
+      for (uint64_t cb=0; cb<m_cb_cnt; ++cb)
+      {
+        if (m_rate > 0)
+        {
+          int64_t deadline = m_start + static_cast<int64_t>((cb + 1) * cb_ns);
+          struct timespec ts;
+          ts.tv_sec = deadline / 1000000000;
+          ts.tv_nsec = deadline % 1000000000;
+          clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        }
+        for (auto& word : buf)
+        {
+          word = pos++;
+        }
+        m_cb_time[cb] = nowNs();
+        if (!m_ring.addSamples(reinterpret_cast<unsigned char*>(&buf[0]),
+                               m_cb_len))
+        {
+          cerr << "*** ERROR: Could not signal the reader\n";
+          break;
+        }
+      }
+      m_ring.closeWriter();
+    }
+
+    void handleIq(complex<uint8_t> *samples, int count)
+    {
+      const int64_t now = nowNs();
+      const uint64_t *words = reinterpret_cast<const uint64_t*>(samples);
+      const size_t word_cnt = 2 * count / 8;
+      ++m_blocks;
+      for (size_t i=1; i<word_cnt; ++i)
+      {
+        if (words[i] != words[0] + i)
+        {
+          ++m_corrupt;
+          return;
+        }
+      }
+      const uint64_t last_byte = 8 * (words[0] + word_cnt) - 1;
+      const uint64_t cb = last_byte / m_cb_len;
+      if (cb < m_cb_cnt)
+      {
+        m_latency.push_back((now - m_cb_time[cb]) / 1000.0);
+      }
+
+      const int64_t busy_until = now + 1000 * m_load_us;
+      while (nowNs() < busy_until)
+      {
+      }
+    }
+
+    void writerClosed(void)
+    {
+      pthread_join(m_thread, NULL);
+      const double secs = (nowNs() - m_start) / 1.0e9;
+
+      double mean = 0.0, p99 = 0.0, max_lat = 0.0;
+      if (!m_latency.empty())
+      {
+        for (auto lat : m_latency)
+        {
+          mean += lat;
+        }
+        mean /= m_latency.size();
+        sort(m_latency.begin(), m_latency.end());
+        p99 = m_latency[m_latency.size() * 99 / 100];
+        max_lat = m_latency.back();
+      }
+
+      cout << fixed << setprecision(1)
+           << "rate=" << m_rate << " block=" << m_block_size
+           << " callback=" << m_cb_len << " time=" << secs << "s\n"
+           << "blocks=" << m_blocks
+           << " wakeups=" << m_ring.wakeups()
+           << " (" << (m_ring.wakeups() / secs) << "/s)"
+           << " dropped=" << m_ring.droppedSamples()
+           << " corrupt=" << m_corrupt << "\n"
+           << "latency mean=" << mean << "us p99=" << p99
+           << "us max=" << max_lat << "us" << endl;
+
+      Application::app().quit();
+    }
+};
+
+
+int main(int argc, const char **argv)
+{
+  unsigned rate = 2400000;
+  unsigned seconds = 5;
+  unsigned load_us = 0;
+  unsigned blocks = RtlSampleRing::DEFAULT_BLOCK_COUNT;
+  if (argc > 1)
+  {
+    rate = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    seconds = atoi(argv[2]);
+  }
+  if (argc > 3)
+  {
+    load_us = atoi(argv[3]);
+  }
+  if (argc > 4)
+  {
+    blocks = atoi(argv[4]);
+  }
+
+  CppApplication app;
+  RingTest test(rate, seconds, load_us, blocks);
+  if (!test.start())
+  {
+    cerr << "*** ERROR: Could not start the test\n";
+    exit(1);
+  }
+  app.exec();
+
+  return 0;
+}
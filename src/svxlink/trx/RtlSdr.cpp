@@ -37,6 +37,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <iterator>
 #include <algorithm>
 #include <iostream>
+#include <cmath>
 
 
 /****************************************************************************
@@ -280,7 +281,8 @@ void RtlSdr::handleIq(const complex<uint8_t> *samples, int samp_count)
 {
   //cout << "RtlSdr::handleIq: samp_count=" << samp_count << endl;
 
-  vector<Sample> iq;
+    // The sample vector is reused so it only grow on the first blocks
+  iq.clear();
   iq.reserve(samp_count);
   for (int idx=0; idx<samp_count; ++idx)
   {
@@ -296,6 +298,52 @@ void RtlSdr::handleIq(const complex<uint8_t> *samples, int samp_count)
     iq.push_back(complex<float>(i, q));
   }
 
+  emitIq(samp_count);
+} /* RtlSdr::handleIq */
+
+
+void RtlSdr::handleIq(const complex<float> *samples, int samp_count)
+{
+  iq.assign(samples, samples + samp_count);
+  if (dist_print_cnt == 0)
+  {
+    for (int idx=0; idx<samp_count; ++idx)
+    {
+      if ((fabsf(samples[idx].real()) >= 1.0f) ||
+          (fabsf(samples[idx].imag()) >= 1.0f))
+      {
+        dist_print_cnt = samp_rate;
+        break;
+      }
+    }
+  }
+
+  emitIq(samp_count);
+} /* RtlSdr::handleIq */
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+/*
+ *----------------------------------------------------------------------------
+ * Method:    RtlSdr::emitIq
+ * Purpose:   Print a distortion warning if needed and emit the converted
+ *            IQ samples.
+ * Input:     samp_count - The number of samples in the block
+ * Output:    None
+ * Author:    agent
+ * Created:   2026-10-17
+ * Remarks:   
+ * Bugs:      
+ *----------------------------------------------------------------------------
+ */
+void RtlSdr::emitIq(int samp_count)
+{
   if (dist_print_cnt > 0)
   {
     if (dist_print_cnt == static_cast<int>(samp_rate))
@@ -311,16 +359,9 @@ void RtlSdr::handleIq(const complex<uint8_t> *samples, int samp_count)
   }
 
   iqReceived(iq);
-} /* RtlSdr::handleIq */
+} /* RtlSdr::emitIq */
 
 
-
-/****************************************************************************
- *
- * Private member functions
- *
- ****************************************************************************/
-
 void RtlSdr::updateSettings(void)
 {
   if (samp_rate_set)
@@ -294,9 +294,9 @@ class RtlSdr : public sigc::trackable
      *
      * Connecting to this signal is the way to get samples from the DVB-T
      * dongle. The format is a vector of complex floats (I/Q) with a range from
-     * -1 to 1.
+     * -1 to 1. The vector is only valid during the call.
      */
-    sigc::signal<void, std::vector<Sample> > iqReceived;
+    sigc::signal<void, const std::vector<Sample>&> iqReceived;
     
     /**
      * @brief   A signal that is emitted when the ready state changes
@@ -380,6 +380,13 @@ class RtlSdr : public sigc::trackable
      */
     void handleIq(const std::complex<uint8_t> *samples, int samp_count);
 
+    /**
+     * @brief   Handle IQ data that already have been converted to float
+     * @param   samples An array of complex IQ samples in the range -1 to 1
+     * @param   samp_count The number of complex samples
+     */
+    void handleIq(const std::complex<float> *samples, int samp_count);
+
     /**
      * @brief   Update all current settings in the dongle
      */
@@ -416,9 +423,11 @@ class RtlSdr : public sigc::trackable
     bool              use_digital_agc_set;
     bool              use_digital_agc;
     int               dist_print_cnt;
+    std::vector<Sample> iq;
 
     RtlSdr(const RtlSdr&);
     RtlSdr& operator=(const RtlSdr&);
+    void emitIq(int samp_count);
     
 };  /* class RtlSdr */
 
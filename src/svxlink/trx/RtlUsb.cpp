@@ -39,7 +39,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <sstream>
 #include <iostream>
 #include <cassert>
-#include <queue>
 #include <unistd.h>
 #include <stdio.h>
 #include <errno.h>
@@ -61,6 +60,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include "RtlUsb.h"
+#include "RtlSampleRing.h"
 
 
 
@@ -89,184 +89,6 @@ using namespace Async;
  *
  ****************************************************************************/
 
-class RtlUsb::SampleBuffer : public sigc::trackable
-{
-  public:
-    SampleBuffer(uint32_t block_size)
-      : block_size(block_size), buf(0), buf_cnt(0), watch(0)
-    {
-      pthread_mutex_init(&mutex, NULL);
-
-      buf = new uint8_t[block_size];
-
-      int r = pipe(signal_pipe);
-      assert (r == 0);
-      watch = new FdWatch(signal_pipe[0], FdWatch::FD_WATCH_RD);
-      watch->activity.connect(
-          sigc::hide(mem_fun(*this, &SampleBuffer::removeSamples)));
-    }
-
-    ~SampleBuffer(void)
-    {
-      pthread_mutex_destroy(&mutex);
-      delete [] buf;
-      buf = 0;
-      while (!block_queue.empty())
-      {
-        delete [] block_queue.front();
-        block_queue.pop();
-      }
-      closeReadPipe();
-      closeWritePipe();
-    }
-
-    void closeWritePipe(void)
-    {
-      if (signal_pipe[1] != -1)
-      {
-        if (close(signal_pipe[1]) != 0)
-        {
-          cerr << "*** ERROR: Close error on write end of SampleBuffer pipe: "
-               << strerror(errno) << "\n";
-        }
-        signal_pipe[1] = -1;
-      }
-    }
-
-    void closeReadPipe(void)
-    {
-      delete watch;
-      watch = 0;
-      if (signal_pipe[0] != -1)
-      {
-        if (close(signal_pipe[0]) != 0)
-        {
-          cerr << "*** ERROR: Close error on read end of SampleBuffer pipe: "
-               << strerror(errno) << endl;
-        }
-        signal_pipe[0] = -1;
-      }
-    }
-
-    void setBlockSize(uint32_t new_block_size)
-    {
-      lockMutex();
-      block_size = new_block_size;
-      while (!block_queue.empty())
-      {
-        delete block_queue.front();
-        block_queue.pop();
-      }
-      delete [] buf;
-      buf = new uint8_t[block_size];
-      buf_cnt = 0;
-      unlockMutex();
-    }
-
-    void clear(void)
-    {
-      lockMutex();
-      while (!block_queue.empty())
-      {
-        delete [] block_queue.front();
-        block_queue.pop();
-      }
-      buf_cnt = 0;
-      unlockMutex();
-    }
-
-    bool addSamples(const unsigned char *samples, uint32_t len)
-    {
-      lockMutex();
-      while (len > 0)
-      {
-        uint32_t cpy_cnt = min(block_size - buf_cnt, len);
-        memcpy(buf + buf_cnt, samples, cpy_cnt);
-        buf_cnt += cpy_cnt;
-        len -= cpy_cnt;
-        samples += cpy_cnt;
-        if (buf_cnt >= block_size)
-        {
-          block_queue.push(buf);
-          buf = new uint8_t[block_size];
-          buf_cnt = 0;
-          unlockMutex();
-          if (write(signal_pipe[1], "S", 1) != 1)
-          {
-            return false;
-          }
-          lockMutex();
-        }
-      }
-      unlockMutex();
-      return true;
-    }
-
-    sigc::signal<void, complex<uint8_t>*, int> handleIq;
-    sigc::signal<void> writePipeClosed;
-
-  private:
-    uint32_t          block_size;
-    uint8_t           *buf;
-    uint32_t          buf_cnt;
-    pthread_mutex_t   mutex;
-    int               signal_pipe[2];
-    FdWatch           *watch;
-    queue<uint8_t*>   block_queue;
-
-    void lockMutex(void)
-    {
-      int r = pthread_mutex_lock(&mutex);
-      if (r != 0)
-      {
-        cerr << "*** ERROR: pthread_mutex_lock failed: "
-             << strerror(r) << endl;
-        abort();
-      }
-    }
-
-    void unlockMutex(void)
-    {
-      int r = pthread_mutex_unlock(&mutex);
-      if (r != 0)
-      {
-        cerr << "*** ERROR: pthread_mutex_unlock failed: "
-             << strerror(r) << endl;
-        abort();
-      }
-    }
-
-    void removeSamples(void)
-    {
-      char read_buf[64];
-      int r = read(signal_pipe[0], read_buf, sizeof(read_buf));
-      if (r == 0)
-      {
-        closeReadPipe();
-        writePipeClosed();
-        return;
-      }
-      else if (r <= 0)
-      {
-        cerr << "*** ERROR: Error while reading SampleBuffer signal pipe\n";
-        abort();
-      }
-
-      lockMutex();
-      while (!block_queue.empty())
-      {
-        uint8_t *buf = block_queue.front();
-        block_queue.pop();
-        unlockMutex();
-        complex<uint8_t> *samples = reinterpret_cast<complex<uint8_t>*>(buf);
-        handleIq(samples, block_size / 2);
-        delete [] buf;
-        lockMutex();
-      }
-      unlockMutex();
-    }
-};
-
 
 
 /****************************************************************************
@@ -583,7 +405,7 @@ void RtlUsb::rtlReader(void)
   {
     cerr << "*** WARNING: Failed to read samples from RTL dongle\n";
   }
-  sample_buf->closeWritePipe();
+  sample_buf->closeWriter();
 } /* RtlUsb::rtlReader */
 
 
@@ -669,9 +491,15 @@ void RtlUsb::initializeDongle(void)
     return;
   }
 
-  sample_buf = new SampleBuffer(blockSize());
+  sample_buf = new RtlSampleRing(blockSize(),
+                                 10 * 2 * MAX_SAMPLE_RATE / 1000);
+  if (!sample_buf->initOk())
+  {
+    verboseClose();
+    return;
+  }
   sample_buf->handleIq.connect(mem_fun(*this, &RtlUsb::handleIq));
-  sample_buf->writePipeClosed.connect(mem_fun(*this, &RtlUsb::verboseClose));
+  sample_buf->writerClosed.connect(mem_fun(*this, &RtlUsb::verboseClose));
 
   r = pthread_create(&rtl_reader_thread, NULL, startRtlReader, this);
   if (r != 0)
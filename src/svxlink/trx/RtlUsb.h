@@ -68,6 +68,8 @@ namespace Async
   class FdWatch;
 };
 
+class RtlSampleRing;
+
 
 /****************************************************************************
  *
@@ -217,16 +219,15 @@ class RtlUsb : public RtlSdr
 
     
   private:
-    class SampleBuffer;
-
     static const unsigned RECONNECT_INTERVAL = 5000;
+    static const uint32_t MAX_SAMPLE_RATE = 3200000;
 
     Async::Timer    reconnect_timer;
     rtlsdr_dev_t    *dev;
     pthread_t       rtl_reader_thread;
     std::string     dev_match;
     std::string     dev_name;
-    SampleBuffer    *sample_buf;
+    RtlSampleRing   *sample_buf;
     bool            rtl_reader_thread_started;
 
     static void *startRtlReader(void *data);
@@ -45,6 +45,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <AsyncTimer.h>
 #include <AsyncConfig.h>
+#include <AsyncMetrics.h>
 
 
 /****************************************************************************
@@ -216,8 +217,14 @@ std::string Rx::muteStateToString(MuteState mute_state)
 
 Rx::Rx(Config &cfg, const string& name)
   : m_name(name), m_verbose(true), m_sql_open(false), m_cfg(cfg),
-    m_sql_tmo_timer(0)
+    m_sql_tmo_timer(0), m_sql_open_gauge(0), m_sql_open_cnt(0)
 {
+  MetricsRegistry& metrics = MetricsRegistry::instance();
+  const MetricsRegistry::Labels labels = {{"rx", m_name}};
+  m_sql_open_gauge = &metrics.gauge("svxlink_rx_squelch_open",
+      "Set to 1 when the receiver squelch is open", labels);
+  m_sql_open_cnt = &metrics.counter("svxlink_rx_squelch_open_total",
+      "Number of times the receiver squelch has opened", labels);
 } /* Rx::Rx */
 
 
@@ -332,6 +339,13 @@ void Rx::setSquelchState(bool is_open, const std::string& info)
   }
   m_sql_open = is_open;
   m_sql_info = info;
+
+  m_sql_open_gauge->set(is_open ? 1.0 : 0.0);
+  if (is_open)
+  {
+    m_sql_open_cnt->inc();
+  }
+
   squelchOpen(is_open);
 
   if (m_sql_tmo_timer != 0)
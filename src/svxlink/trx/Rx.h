@@ -72,6 +72,8 @@ namespace Async
 {
   class Timer;
   class Config;
+  class MetricGauge;
+  class MetricCounter;
 };
 
 
@@ -275,6 +277,28 @@ class Rx : public sigc::trackable, public Async::AudioSource
      */
     sigc::signal<void, float> signalLevelUpdated;
 
+    /**
+     * @brief	A signal that is emitted when the signal level is updated for
+     *		one of the receivers that make up this receiver
+     * @param	rx_name The name of the underlying receiver
+     * @param	siglev The new signal level
+     *
+     * This signal is only emitted by receivers that combine other receivers,
+     * like the Voter.
+     */
+    sigc::signal<void, const std::string&, float> receiverSignalLevelUpdated;
+
+    /**
+     * @brief	A signal that is emitted when the squelch state changes for
+     *		one of the receivers that make up this receiver
+     * @param	rx_name The name of the underlying receiver
+     * @param	is_open \em true if the squelch is open
+     *
+     * This signal is only emitted by receivers that combine other receivers,
+     * like the Voter.
+     */
+    sigc::signal<void, const std::string&, bool> receiverSquelchOpen;
+
     /**
      * @brief   A signal that is emitted when digital data have been received
      * @param   frame The data frame that was received
@@ -321,6 +345,8 @@ class Rx : public sigc::trackable, public Async::AudioSource
     Async::Config&  m_cfg;
     Async::Timer*   m_sql_tmo_timer;
     std::string     m_sql_info;
+    Async::MetricGauge*   m_sql_open_gauge;
+    Async::MetricCounter* m_sql_open_cnt;
     
     void sqlTimeout(Async::Timer *t);
     
@@ -226,7 +226,7 @@ class SigLevDet : public sigc::trackable, public Async::AudioSink
 
     static DetMap& detMap(void)
     {
-      static DetMap det_map;
+      static thread_local DetMap det_map;
       return det_map;
     }
 
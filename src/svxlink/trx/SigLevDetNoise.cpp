@@ -117,7 +117,7 @@ using namespace Async;
  ****************************************************************************/
 
 SigLevDetNoise::SigLevDetNoise(void)
-  : sample_rate(0), block_len(0), filter(0), sigc_sink(0),
+  : sample_rate(0), block_len(0), filter(0), sigc_sink(0), engine_ch(0),
     slope(10.0), offset(0.0), update_interval(0), update_counter(0),
     integration_time(0), ss(0.0), ss_cnt(0),
     bogus_thresh(numeric_limits<float>::max())
@@ -130,6 +130,7 @@ SigLevDetNoise::~SigLevDetNoise(void)
   clearHandler();
   delete filter;
   delete sigc_sink;
+  delete engine_ch;
 } /* SigLevDetNoise::~SigLevDetNoise */
 
 
@@ -138,21 +139,38 @@ bool SigLevDetNoise::initialize(Config &cfg, const string& name,
 {
   this->sample_rate = sample_rate;
   block_len = BLOCK_TIME * sample_rate / 1000;
+  string filter_spec("HpBu4/3500");
   if (sample_rate >= 16000)
   {
-    filter = new AudioFilter("BpBu4/5000-5500", sample_rate);
+    filter_spec = "BpBu4/5000-5500";
+  }
+
+    // Optionally run the filter in an engine shared by all noise siglev
+    // detectors using the same sample rate
+  bool shared_engine = false;
+  cfg.getValue(name, "SIGLEV_SHARED_ENGINE", shared_engine);
+  if (shared_engine)
+  {
+    engine_ch = SigLevEngine::createChannel(filter_spec, sample_rate);
+    if (engine_ch == 0)
+    {
+      return false;
+    }
+    engine_ch->filteredSamples.connect(
+        mem_fun(*this, &SigLevDetNoise::processSamples));
+    setHandler(engine_ch);
   }
   else
   {
-    filter = new AudioFilter("HpBu4/3500", sample_rate);
+    filter = new AudioFilter(filter_spec, sample_rate);
+    setHandler(filter);
+    sigc_sink = new SigCAudioSink;
+    sigc_sink->sigWriteSamples.connect(
+        mem_fun(*this, &SigLevDetNoise::processSamples));
+    sigc_sink->sigFlushSamples.connect(
+        mem_fun(*sigc_sink, &SigCAudioSink::allSamplesFlushed));
+    sigc_sink->registerSource(filter);
   }
-  setHandler(filter);
-  sigc_sink = new SigCAudioSink;
-  sigc_sink->sigWriteSamples.connect(
-      mem_fun(*this, &SigLevDetNoise::processSamples));
-  sigc_sink->sigFlushSamples.connect(
-      mem_fun(*sigc_sink, &SigCAudioSink::allSamplesFlushed));
-  sigc_sink->registerSource(filter);
   setIntegrationTime(0);
 
   cfg.getValue(name, "SIGLEV_OFFSET", offset);
@@ -265,7 +283,14 @@ float SigLevDetNoise::siglevIntegrated(void) const
 
 void SigLevDetNoise::reset(void)
 {
-  filter->reset();
+  if (filter != 0)
+  {
+    filter->reset();
+  }
+  if (engine_ch != 0)
+  {
+    engine_ch->reset();
+  }
   update_counter = 0;
   ss_values.clear();
   ss_idx.clear();
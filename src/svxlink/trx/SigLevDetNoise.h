@@ -55,6 +55,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include "SigLevDet.h"
+#include "SigLevEngine.h"
 
 
 /****************************************************************************
@@ -218,6 +219,7 @@ class SigLevDetNoise : public SigLevDet
     unsigned                  block_len;
     Async::AudioFilter	      *filter;
     Async::SigCAudioSink      *sigc_sink;
+    SigLevEngine::Channel     *engine_ch;
     float     	      	      slope;
     float     	      	      offset;
     int			      update_interval;
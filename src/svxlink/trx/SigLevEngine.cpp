@@ -0,0 +1,347 @@
+/**
+@file	 SigLevEngine.cpp
+@brief   Shared filter front-end for the noise signal level detectors
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <iostream>
+#include <limits>
+#include <algorithm>
+#include <cassert>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncApplication.h>
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "SigLevEngine.h"
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+SigLevEngine::Channel::~Channel(void)
+{
+  m_engine->removeChannel(this);
+} /* SigLevEngine::Channel::~Channel */
+
+
+int SigLevEngine::Channel::writeSamples(const float *samples, int count)
+{
+  m_pending.insert(m_pending.end(), samples, samples + count);
+  m_engine->samplesQueued();
+  return count;
+} /* SigLevEngine::Channel::writeSamples */
+
+
+void SigLevEngine::Channel::flushSamples(void)
+{
+  sourceAllSamplesFlushed();
+} /* SigLevEngine::Channel::flushSamples */
+
+
+void SigLevEngine::Channel::reset(void)
+{
+  m_pending.clear();
+  m_engine->m_bank.resetChannel(m_lane);
+} /* SigLevEngine::Channel::reset */
+
+
+SigLevEngine::Channel *SigLevEngine::createChannel(const string& filter_spec,
+                                                   int sample_rate)
+{
+  Key key(filter_spec, sample_rate);
+  SigLevEngine *engine = 0;
+  EngineMap::iterator it = engines().find(key);
+  if (it == engines().end())
+  {
+    engine = new SigLevEngine(key);
+    if (!engine->m_bank.initOk())
+    {
+      cerr << "*** ERROR: Could not create siglev filter bank for \""
+           << filter_spec << "\": " << engine->m_bank.errorString() << endl;
+      delete engine;
+      return 0;
+    }
+    engines()[key] = engine;
+  }
+  else
+  {
+    engine = it->second;
+  }
+  return engine->addChannel();
+} /* SigLevEngine::createChannel */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+SigLevEngine::Channel::Channel(SigLevEngine *engine, unsigned lane)
+  : m_engine(engine), m_lane(lane)
+{
+} /* SigLevEngine::Channel::Channel */
+
+
+SigLevEngine::SigLevEngine(const Key& key)
+  : m_key(key), m_bank(key.first, key.second), m_channel_cnt(0),
+    m_process_timer(0, Timer::TYPE_ONESHOT, false)
+{
+  m_process_timer.expired.connect(
+      mem_fun(*this, &SigLevEngine::processQueued));
+} /* SigLevEngine::SigLevEngine */
+
+
+SigLevEngine::~SigLevEngine(void)
+{
+  assert(m_channel_cnt == 0);
+} /* SigLevEngine::~SigLevEngine */
+
+
+SigLevEngine::Channel *SigLevEngine::addChannel(void)
+{
+  unsigned lane = m_bank.addChannel();
+  if (lane >= m_channels.size())
+  {
+    m_channels.resize(lane + 1, 0);
+  }
+  assert(m_channels[lane] == 0);
+  Channel *ch = new Channel(this, lane);
+  m_channels[lane] = ch;
+  ++m_channel_cnt;
+  return ch;
+} /* SigLevEngine::addChannel */
+
+
+void SigLevEngine::removeChannel(Channel *ch)
+{
+  assert(m_channels[ch->m_lane] == ch);
+  m_channels[ch->m_lane] = 0;
+  m_bank.removeChannel(ch->m_lane);
+  if (--m_channel_cnt == 0)
+  {
+      // The channel may be deleted from a filteredSamples handler, i.e. from
+      // within processQueued, so the engine is deleted on the next turn of
+      // the event loop instead of right away
+    engines().erase(m_key);
+    m_process_timer.setEnable(false);
+    Application::app().runTask(
+        sigc::bind(sigc::ptr_fun(&SigLevEngine::deleteEngine), this));
+  }
+} /* SigLevEngine::removeChannel */
+
+
+void SigLevEngine::deleteEngine(SigLevEngine *engine)
+{
+  delete engine;
+} /* SigLevEngine::deleteEngine */
+
+
+void SigLevEngine::samplesQueued(void)
+{
+  if (!m_process_timer.isEnabled())
+  {
+    m_process_timer.setEnable(true);
+  }
+} /* SigLevEngine::samplesQueued */
+
+
+/*
+ *----------------------------------------------------------------------------
+ * Method:    SigLevEngine::processQueued
+ * Purpose:   Filter all queued samples. The number of samples queued on
+ *            every channel is filtered for all channels at once using the
+ *            filter bank. What is left is filtered channel by channel.
+ * Input:     t - The timer that expired
+ * Output:    None
+ * Author:    agent
+ * Created:   2026-10-17
+ * Remarks:   A channel may be deleted by a handler connected to the
+ *            filteredSamples signal so the channel is looked up again
+ *            before each emission. The engine itself is never deleted from
+ *            within this function, see removeChannel.
+ * Bugs:
+ *----------------------------------------------------------------------------
+ */
+void SigLevEngine::processQueued(Timer *t)
+{
+  m_process_timer.setEnable(false);
+
+  const unsigned lanes = m_channels.size();
+  size_t common = numeric_limits<size_t>::max();
+  for (const auto& ch : m_channels)
+  {
+    if (ch != 0)
+    {
+      common = min(common, ch->m_pending.size());
+    }
+  }
+  if (m_channel_cnt < 2)
+  {
+    common = 0;
+  }
+
+    // The buffers only grow, so after the first few ticks no memory is
+    // allocated here
+  if (common > 0)
+  {
+    if (m_frames.size() < common * lanes)
+    {
+      m_frames.resize(common * lanes);
+    }
+    for (unsigned lane=0; lane<lanes; ++lane)
+    {
+      Channel *ch = m_channels[lane];
+      const float *src = (ch != 0) ? &ch->m_pending[0] : 0;
+      for (size_t n=0; n<common; ++n)
+      {
+        m_frames[n * lanes + lane] = (src != 0) ? src[n] : 0.0f;
+      }
+    }
+    m_bank.process(&m_frames[0], &m_frames[0], common);
+  }
+
+  for (unsigned lane=0; lane<lanes; ++lane)
+  {
+    Channel *ch = m_channels[lane];
+    if (ch == 0)
+    {
+      continue;
+    }
+    const size_t count = ch->m_pending.size();
+    ch->m_filtered.resize(count);
+    for (size_t n=0; n<common; ++n)
+    {
+      ch->m_filtered[n] = m_frames[n * lanes + lane];
+    }
+    if (count > common)
+    {
+      m_bank.processChannel(lane, &ch->m_filtered[common],
+                            &ch->m_pending[common], count - common);
+    }
+    ch->m_pending.clear();
+  }
+
+    // Hand out the result. A handler may delete any channel.
+  for (unsigned lane=0; lane<lanes; ++lane)
+  {
+    Channel *ch = m_channels[lane];
+    if ((ch != 0) && !ch->m_filtered.empty())
+    {
+      ch->filteredSamples(&ch->m_filtered[0], ch->m_filtered.size());
+    }
+  }
+} /* SigLevEngine::processQueued */
+
+
+
+/*
+ * This file has not been truncated
+ */
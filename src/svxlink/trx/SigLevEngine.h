@@ -0,0 +1,248 @@
+/**
+@file	 SigLevEngine.h
+@brief   Shared filter front-end for the noise signal level detectors
+@author  agent
+@date	 2026-10-17
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef SIG_LEV_ENGINE_INCLUDED
+#define SIG_LEV_ENGINE_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <map>
+#include <string>
+#include <vector>
+#include <utility>
+#include <sigc++/sigc++.h>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioSink.h>
+#include <AsyncAudioFilterBank.h>
+#include <AsyncTimer.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	Shared filter front-end for the noise signal level detectors
+@author agent
+@date   2026-10-17
+
+Each noise signal level detector run its audio through a high pass or band
+pass filter before measuring the noise energy. With many receivers, e.g. on
+a voter site, that mean many small filters each called with a short block of
+audio. This class collect the audio for all detectors using the same filter
+specification and sample rate and run the filters for all of them in a single
+pass using an Async::AudioFilterBank.
+
+Audio written to a channel is queued and a zero length timer is started.
+When the timer expires, on the next turn of the event loop, all queued audio
+is filtered. The part that all channels have in common is run through the
+filter bank in lock step, which allow the filter to be vectorized over the
+channels. Any remaining samples are filtered channel by channel. The filtered
+samples are then handed back to each channel through the filteredSamples
+signal. This mean that all detectors are updated from one timer tick instead
+of from N separate audio callbacks.
+
+\code
+SigLevEngine::Channel *ch =
+    SigLevEngine::createChannel("BpBu4/5000-5500", 16000);
+ch->filteredSamples.connect(mem_fun(*this, &MyClass::processSamples));
+source->registerSink(ch);
+\endcode
+*/
+class SigLevEngine
+{
+  public:
+    /**
+     * @brief   One signal level detector input to the engine
+     *
+     * Audio written to this sink is filtered by the engine and then emitted
+     * through the filteredSamples signal. Delete the channel to remove it
+     * from the engine.
+     */
+    class Channel : public Async::AudioSink
+    {
+      public:
+        /**
+         * @brief 	Destructor
+         */
+        ~Channel(void);
+
+        /**
+         * @brief 	Write samples into this audio sink
+         * @param 	samples The buffer containing the samples
+         * @param 	count The number of samples in the buffer
+         * @return	Returns the number of samples that has been taken care of
+         */
+        virtual int writeSamples(const float *samples, int count);
+
+        /**
+         * @brief 	Tell the sink to flush the previously written samples
+         */
+        virtual void flushSamples(void);
+
+        /**
+         * @brief   Clear queued samples and the filter state
+         */
+        void reset(void);
+
+        /**
+         * @brief   A signal that is emitted with filtered samples
+         * @param   samples The filtered samples
+         * @param   count The number of samples
+         */
+        sigc::signal<int, float*, int> filteredSamples;
+
+      private:
+        friend class SigLevEngine;
+
+        SigLevEngine*       m_engine;
+        unsigned            m_lane;
+        std::vector<float>  m_pending;
+        std::vector<float>  m_filtered;
+
+        Channel(SigLevEngine *engine, unsigned lane);
+        Channel(const Channel&);
+        Channel& operator=(const Channel&);
+
+    };  /* class Channel */
+
+    /**
+     * @brief   Create a new channel
+     * @param   filter_spec The filter specification to use
+     * @param   sample_rate The sample rate of the audio
+     * @return  Returns a new channel or 0 if the filter was not accepted
+     *
+     * The channel is added to the engine for the given filter specification
+     * and sample rate. An engine is created if it does not already exist.
+     */
+    static Channel *createChannel(const std::string& filter_spec,
+                                  int sample_rate);
+
+  private:
+    typedef std::pair<std::string, int>     Key;
+    typedef std::map<Key, SigLevEngine*>    EngineMap;
+
+    Key                     m_key;
+    Async::AudioFilterBank  m_bank;
+    std::vector<Channel*>   m_channels;
+    unsigned                m_channel_cnt;
+    Async::Timer            m_process_timer;
+    std::vector<float>      m_frames;
+
+      // Engines are shared per thread since the channels are handled by the
+      // event loop of the thread that created them
+    static EngineMap& engines(void)
+    {
+      static thread_local EngineMap engine_map;
+      return engine_map;
+    }
+
+    SigLevEngine(const Key& key);
+    ~SigLevEngine(void);
+    SigLevEngine(const SigLevEngine&);
+    SigLevEngine& operator=(const SigLevEngine&);
+    Channel *addChannel(void);
+    void removeChannel(Channel *ch);
+    static void deleteEngine(SigLevEngine *engine);
+    void samplesQueued(void);
+    void processQueued(Async::Timer *t);
+
+};  /* class SigLevEngine */
+
+
+//} /* namespace */
+
+#endif /* SIG_LEV_ENGINE_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,200 @@
+//
+// Benchmark for the shared noise siglev engine.
+//
+// A number of noise siglev detectors are fed with 16ms blocks of noise, one
+// block per detector for every turn of the event loop, just like when a
+// number of local receivers share a sound card. This is done once with a
+// separate filter in each detector and once with the filters run in the
+// shared SigLevEngine (SIGLEV_SHARED_ENGINE=1). For each number of
+// receivers the following is printed:
+//
+//   rx        - The number of receivers
+//   separate  - CPU time in ns per sample and receiver, separate filters
+//   shared    - CPU time in ns per sample and receiver, shared engine
+//   speedup   - separate / shared
+//   max_diff  - The largest siglev difference between the two modes
+//
+// The program exit with an error if the siglev difference is above 0.001.
+//
+// Usage: SigLevEngineBench [max receivers] [rounds]
+//
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <ctime>
+#include <cstdlib>
+#include <cmath>
+
+#include <AsyncCppApplication.h>
+#include <AsyncConfig.h>
+#include <AsyncTimer.h>
+
+#include "SigLevDetNoise.h"
+
+using namespace std;
+using namespace Async;
+
+
+static const int SAMPLE_RATE = 16000;
+static const int BLOCK_SIZE = 256;
+
+
+class Bench : public sigc::trackable
+{
+  public:
+    Bench(unsigned max_rx, unsigned rounds)
+      : m_max_rx(max_rx), m_rounds(rounds), m_rx(1), m_shared(false),
+        m_round(0), m_ns_separate(0.0), m_failed(false),
+        m_timer(0, Timer::TYPE_ONESHOT, false)
+    {
+      m_noise.resize(BLOCK_SIZE * 64);
+      for (auto& sample : m_noise)
+      {
+        sample = 0.2f * (static_cast<float>(rand()) / RAND_MAX - 0.5f);
+      }
+      m_timer.expired.connect(mem_fun(*this, &Bench::onTick));
+      cout << setw(4) << "rx" << setw(12) << "separate" << setw(12)
+           << "shared" << setw(10) << "speedup" << setw(10) << "max_diff"
+           << endl;
+      startStep();
+    }
+
+    ~Bench(void)
+    {
+      clearDetectors();
+    }
+
+    bool failed(void) const { return m_failed; }
+
+  private:
+    unsigned                m_max_rx;
+    unsigned                m_rounds;
+    unsigned                m_rx;
+    bool                    m_shared;
+    unsigned                m_round;
+    double                  m_ns_separate;
+    bool                    m_failed;
+    clock_t                 m_start;
+    Timer                   m_timer;
+    vector<SigLevDetNoise*> m_dets;
+    vector<float>           m_noise;
+    vector<float>           m_siglevs;
+
+    void clearDetectors(void)
+    {
+      for (auto det : m_dets)
+      {
+        delete det;
+      }
+      m_dets.clear();
+    }
+
+    void startStep(void)
+    {
+      clearDetectors();
+      Config cfg;
+      cfg.setValue("Rx", "SIGLEV_SHARED_ENGINE", m_shared ? "1" : "0");
+      for (unsigned i=0; i<m_rx; ++i)
+      {
+        SigLevDetNoise *det = new SigLevDetNoise;
+        if (!det->initialize(cfg, "Rx", SAMPLE_RATE))
+        {
+          cerr << "*** ERROR: Could not initialize siglev detector" << endl;
+          exit(1);
+        }
+        det->setIntegrationTime(100);
+        m_dets.push_back(det);
+      }
+      m_round = 0;
+      m_start = clock();
+      m_timer.setEnable(true);
+    }
+
+    void onTick(Timer *t)
+    {
+        // The timer is restarted after the blocks have been written so that
+        // the zero length timer in the shared engine expire first
+      m_timer.setEnable(false);
+      ++m_round;
+      if (m_round <= m_rounds)
+      {
+        for (unsigned i=0; i<m_dets.size(); ++i)
+        {
+          const unsigned pos =
+            ((m_round * 7 + i * 13) % 64) * BLOCK_SIZE;
+          m_dets[i]->writeSamples(&m_noise[pos], BLOCK_SIZE);
+        }
+        m_timer.setEnable(true);
+        return;
+      }
+      else if (m_round <= m_rounds + 2)
+      {
+          // Let the shared engine process the last block
+        m_timer.setEnable(true);
+        return;
+      }
+
+      double ns = 1.0e9 * (clock() - m_start) / CLOCKS_PER_SEC /
+                  (static_cast<double>(m_rounds) * BLOCK_SIZE * m_rx);
+      if (!m_shared)
+      {
+        m_ns_separate = ns;
+        m_siglevs.clear();
+        for (auto det : m_dets)
+        {
+          m_siglevs.push_back(det->siglevIntegrated());
+        }
+        m_shared = true;
+      }
+      else
+      {
+        float max_diff = 0.0f;
+        for (unsigned i=0; i<m_dets.size(); ++i)
+        {
+          max_diff = max(max_diff,
+              fabsf(m_dets[i]->siglevIntegrated() - m_siglevs[i]));
+        }
+        cout << fixed << setw(4) << m_rx
+             << setw(12) << setprecision(1) << m_ns_separate
+             << setw(12) << ns
+             << setw(10) << setprecision(2) << (m_ns_separate / ns)
+             << setw(10) << setprecision(4) << max_diff << endl;
+        if (!(max_diff <= 1.0e-3f))
+        {
+          cerr << "*** ERROR: The shared engine siglev differ from the "
+                  "separate filters by " << max_diff << endl;
+          m_failed = true;
+        }
+        if (m_rx >= m_max_rx)
+        {
+          Application::app().quit();
+          return;
+        }
+        m_rx *= 2;
+        m_shared = false;
+      }
+      startStep();
+    }
+};
+
+
+int main(int argc, const char **argv)
+{
+  unsigned max_rx = 32;
+  unsigned rounds = 2000;
+  if (argc > 1)
+  {
+    max_rx = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    rounds = atoi(argv[2]);
+  }
+
+  CppApplication app;
+  Bench bench(max_rx, rounds);
+  app.exec();
+
+  return bench.failed() ? 1 : 0;
+}
@@ -79,6 +79,7 @@ class SquelchCombine::Node
 {
   public:
     typedef std::set<std::string> SquelchStates;
+    typedef sigc::slot<void, uint8_t, bool> InputChangedSlot;
     Node(const std::string& name) : m_name(name) {}
     virtual ~Node(void) {}
     const std::string name(void) const { return m_name; }
@@ -90,7 +91,8 @@ class SquelchCombine::Node
     virtual bool isOpen(void) const = 0;
     virtual std::string activityInfo(void) const = 0;
     virtual SquelchStates& squelchStates(SquelchStates& states) = 0;
-    sigc::signal<void, bool> squelchOpen;
+    virtual bool compile(Program& prog, const InputChangedSlot& changed) = 0;
+    virtual uint64_t inputState(void) const = 0;
 
   private:
     std::string m_name;
@@ -125,10 +127,30 @@ class SquelchCombine::LeafNode : public SquelchCombine::Node
                   << name() << "\"\n";
         return false;
       }
-      m_squelch->squelchOpen.connect(squelchOpen.make_slot());
       return true;
     }
 
+    virtual bool compile(Program& prog, const InputChangedSlot& changed)
+    {
+      if (!prog.addInput(m_idx))
+      {
+        std::cerr << "*** ERROR: Too many squelch detectors in squelch "
+                     "combiner expression. The maximum is "
+                  << Program::MAX_INPUTS << std::endl;
+        return false;
+      }
+      prog.addOp(m_idx);
+      m_changed = changed;
+      m_squelch->squelchOpen.connect(
+          sigc::mem_fun(*this, &LeafNode::onSquelchOpen));
+      return true;
+    }
+
+    virtual uint64_t inputState(void) const
+    {
+      return isOpen() ? (uint64_t(1) << m_idx) : 0;
+    }
+
     virtual bool isOpen(void) const { return m_squelch->isOpen(); }
 
     virtual std::string activityInfo(void) const
@@ -176,17 +198,24 @@ class SquelchCombine::LeafNode : public SquelchCombine::Node
     }
 
   private:
-    Squelch* m_squelch = nullptr;
+    Squelch*          m_squelch = nullptr;
+    uint8_t           m_idx     = 0;
+    InputChangedSlot  m_changed;
+
+    void onSquelchOpen(bool is_open)
+    {
+        // The timeout state is not included in is_open
+      m_changed(m_idx, m_squelch->isOpen());
+    }
 }; /* SquelchCombine::LeafNode */
 
 
 class SquelchCombine::UnaryOpNode : public SquelchCombine::Node
 {
   public:
-    UnaryOpNode(const std::string& name, Node *node)
-      : Node(name), m_node(node)
+    UnaryOpNode(const std::string& name, uint8_t op, Node *node)
+      : Node(name), m_op(op), m_node(node)
     {
-      m_node->squelchOpen.connect(squelchOpen.make_slot());
     }
 
     virtual ~UnaryOpNode(void)
@@ -227,19 +256,35 @@ class SquelchCombine::UnaryOpNode : public SquelchCombine::Node
       return m_node->squelchStates(states);
     }
 
+    virtual bool compile(Program& prog, const InputChangedSlot& changed)
+    {
+      if (!m_node->compile(prog, changed))
+      {
+        return false;
+      }
+      prog.addOp(m_op);
+      return true;
+    }
+
+    virtual uint64_t inputState(void) const
+    {
+      return m_node->inputState();
+    }
+
     virtual std::string activityInfo(void) const
     {
       return name() + "(" + m_node->activityInfo() + ")";
     }
 
   protected:
-    Node* m_node;
+    uint8_t m_op;
+    Node*   m_node;
 }; /* SquelchCombine::UnaryOpNode */
 
 
 struct SquelchCombine::NegationOpNode : public SquelchCombine::UnaryOpNode
 {
-  NegationOpNode(Node* node) : UnaryOpNode("NOT", node) {}
+  NegationOpNode(Node* node) : UnaryOpNode("NOT", Program::OP_NOT, node) {}
   virtual bool isOpen(void) const { return !m_node->isOpen(); }
 }; /* SquelchCombine::NegationOpNode */
 
@@ -247,13 +292,9 @@ struct SquelchCombine::NegationOpNode : public SquelchCombine::UnaryOpNode
 class SquelchCombine::BinaryOpNode : public SquelchCombine::Node
 {
   public:
-    BinaryOpNode(const std::string& n, Node* l, Node* r)
-      : Node(n), m_left(l), m_right(r)
+    BinaryOpNode(const std::string& n, uint8_t op, Node* l, Node* r)
+      : Node(n), m_op(op), m_left(l), m_right(r)
     {
-      m_left->squelchOpen.connect(
-          sigc::mem_fun(*this, &BinaryOpNode::onSquelchOpen));
-      m_right->squelchOpen.connect(
-          sigc::mem_fun(*this, &BinaryOpNode::onSquelchOpen));
     }
 
     virtual ~BinaryOpNode(void)
@@ -296,11 +337,6 @@ class SquelchCombine::BinaryOpNode : public SquelchCombine::Node
       m_right->processSamples(samples, count);
     }
 
-    void onSquelchOpen(bool is_open)
-    {
-      squelchOpen(isOpen());
-    }
-
     virtual SquelchStates& squelchStates(SquelchStates& states)
     {
       m_left->squelchStates(states);
@@ -308,6 +344,21 @@ class SquelchCombine::BinaryOpNode : public SquelchCombine::Node
       return states;
     }
 
+    virtual bool compile(Program& prog, const InputChangedSlot& changed)
+    {
+      if (!m_left->compile(prog, changed) || !m_right->compile(prog, changed))
+      {
+        return false;
+      }
+      prog.addOp(m_op);
+      return true;
+    }
+
+    virtual uint64_t inputState(void) const
+    {
+      return m_left->inputState() | m_right->inputState();
+    }
+
     virtual std::string activityInfo(void) const
     {
       return name() + "(" + m_left->activityInfo() + ", " +
@@ -315,14 +366,15 @@ class SquelchCombine::BinaryOpNode : public SquelchCombine::Node
     }
 
   protected:
-    Node* m_left;
-    Node* m_right;
+    uint8_t m_op;
+    Node*   m_left;
+    Node*   m_right;
 }; /* SquelchCombine::BinaryOpNode */
 
 
 struct SquelchCombine::OrOpNode : public SquelchCombine::BinaryOpNode
 {
-  OrOpNode(Node* l, Node* r) : BinaryOpNode("OR", l, r) {}
+  OrOpNode(Node* l, Node* r) : BinaryOpNode("OR", Program::OP_OR, l, r) {}
 
   virtual bool isOpen(void) const
   {
@@ -333,7 +385,7 @@ struct SquelchCombine::OrOpNode : public SquelchCombine::BinaryOpNode
 
 struct SquelchCombine::AndOpNode : public SquelchCombine::BinaryOpNode
 {
-  AndOpNode(Node* l, Node* r) : BinaryOpNode("AND", l, r) {}
+  AndOpNode(Node* l, Node* r) : BinaryOpNode("AND", Program::OP_AND, l, r) {}
 
   virtual bool isOpen(void) const
   {
@@ -422,17 +474,32 @@ bool SquelchCombine::initialize(Async::Config& cfg,
   m_comb->print(std::cout);
   std::cout << std::endl;
 
-  m_comb->squelchOpen.connect(
-      sigc::mem_fun(*this, &SquelchCombine::onSquelchOpen));
+  if (!m_comb->initialize(cfg) ||
+      !m_comb->compile(m_prog,
+                       sigc::mem_fun(*this, &SquelchCombine::onInputChanged)))
+  {
+    return false;
+  }
+  m_prog.buildTable();
+
+  if (!Squelch::initialize(cfg, rx_name))
+  {
+    return false;
+  }
+
+    // An expression like "!Rx1:SQL" is open when all detectors are closed
+  updateSignalDetected();
 
-  return m_comb->initialize(cfg) && Squelch::initialize(cfg, rx_name);
+  return true;
 } /* SquelchCombine::initialize */
 
 
 void SquelchCombine::reset(void)
 {
   m_comb->reset();
+  m_state = m_comb->inputState();
   Squelch::reset();
+  updateSignalDetected();
 } /* SquelchCombine::reset */
 
 
@@ -462,8 +529,17 @@ int SquelchCombine::processSamples(const float *samples, int count)
  *
  ****************************************************************************/
 
-void SquelchCombine::onSquelchOpen(bool is_open)
+void SquelchCombine::onInputChanged(uint8_t idx, bool is_open)
 {
+  const uint64_t mask = uint64_t(1) << idx;
+  m_state = is_open ? (m_state | mask) : (m_state & ~mask);
+  updateSignalDetected();
+} /* SquelchCombine::onInputChanged */
+
+
+void SquelchCombine::updateSignalDetected(void)
+{
+  const bool is_open = m_prog.evaluate(m_state);
   if (is_open != signalDetected())
   {
     std::string info;
@@ -480,7 +556,7 @@ void SquelchCombine::onSquelchOpen(bool is_open)
     setSignalDetected(is_open, info);
     //setSignalDetected(is_open, m_comb->activityInfo());
   }
-} /* SquelchCombine::onSquelchOpen */
+} /* SquelchCombine::updateSignalDetected */
 
 
 bool SquelchCombine::tokenize(const std::string& expr)
@@ -645,6 +721,93 @@ SquelchCombine::Node* SquelchCombine::parseExpression(void)
 } /* SquelchCombine::parseExpresseion */
 
 
+bool SquelchCombine::Program::addInput(uint8_t& idx)
+{
+  if (m_inputs >= MAX_INPUTS)
+  {
+    return false;
+  }
+  idx = m_inputs++;
+  return true;
+} /* SquelchCombine::Program::addInput */
+
+
+/*
+ *----------------------------------------------------------------------------
+ * Method:    SquelchCombine::Program::buildTable
+ * Purpose:   Run the program for all combinations of input states and store
+ *            the result in a truth table, one bit per combination. This is
+ *            only done if the number of inputs is small enough to keep the
+ *            table size down. The table for MAX_TABLE_INPUTS is 8kB.
+ * Input:     None
+ * Output:    None
+ * Author:    agent
+ * Created:   2026-10-17
+ * Remarks:
+ * Bugs:
+ *----------------------------------------------------------------------------
+ */
+void SquelchCombine::Program::buildTable(void)
+{
+  m_table.clear();
+  if (m_inputs > MAX_TABLE_INPUTS)
+  {
+    return;
+  }
+  const uint64_t combinations = uint64_t(1) << m_inputs;
+  std::vector<uint64_t> table((combinations + 63) / 64, 0);
+  for (uint64_t state=0; state<combinations; ++state)
+  {
+    if (run(state))
+    {
+      table[state >> 6] |= uint64_t(1) << (state & 63);
+    }
+  }
+  m_table.swap(table);
+} /* SquelchCombine::Program::buildTable */
+
+
+/*
+ *----------------------------------------------------------------------------
+ * Method:    SquelchCombine::Program::run
+ * Purpose:   Run the program for the given input states. The stack is kept
+ *            as bits in a 64 bit word with the top of the stack in bit 0.
+ *            The stack can never be deeper than the number of inputs so 64
+ *            bits is enough.
+ * Input:     state - One bit per input, set if the input is open
+ * Output:    Returns the result of the expression
+ * Author:    agent
+ * Created:   2026-10-17
+ * Remarks:
+ * Bugs:
+ *----------------------------------------------------------------------------
+ */
+bool SquelchCombine::Program::run(uint64_t state) const
+{
+  uint64_t stack = 0;
+  for (const auto& op : m_code)
+  {
+    if (op < OP_NOT)
+    {
+      stack = (stack << 1) | ((state >> op) & 1);
+    }
+    else if (op == OP_NOT)
+    {
+      stack ^= 1;
+    }
+    else
+    {
+      const uint64_t right = stack & 1;
+      stack >>= 1;
+      const uint64_t left = stack & 1;
+      const uint64_t res = (op == OP_AND) ? (left & right) : (left | right);
+      stack = (stack & ~uint64_t(1)) | res;
+    }
+  }
+  return stack & 1;
+} /* SquelchCombine::Program::run */
+
+
 /*
  * This file has not been truncated
  */
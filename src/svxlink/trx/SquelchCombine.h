@@ -36,6 +36,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <string>
 #include <deque>
+#include <vector>
+#include <cstdint>
 
 
 /****************************************************************************
@@ -135,6 +137,15 @@ SIGLEV_CLOSE_THRESH=2
 SQL_DET=COMBINE
 SQL_COMBINE=Rx1:CTCSS | Rx1:SIGLEV
 ...
+
+The expression is parsed into a tree which is then compiled into a short
+postfix program where each squelch detector is an input bit. The state of
+all squelch detectors is kept in a 64 bit mask so at most 64 squelch
+detectors can be used in one expression. For expressions with up to 16
+squelch detectors the program is run for all input combinations at
+initialization time to produce a truth table, so a squelch state change is
+evaluated using a single table lookup. For larger expressions the program is
+run on each state change.
 */
 class SquelchCombine : public Squelch
 {
@@ -142,6 +153,75 @@ class SquelchCombine : public Squelch
       /// The name of this class when used by the object factory
     static constexpr const char* OBJNAME = "COMBINE";
 
+    /**
+     * @brief   A compiled squelch combiner expression
+     *
+     * The code is a postfix program. An opcode below OP_NOT push the state
+     * of the input with that index onto a bit stack. The operators pop their
+     * operands from the stack and push the result.
+     */
+    class Program
+    {
+      public:
+        static const unsigned MAX_INPUTS        = 64;
+        static const unsigned MAX_TABLE_INPUTS  = 16;
+        static const uint8_t  OP_NOT            = MAX_INPUTS;
+        static const uint8_t  OP_AND            = MAX_INPUTS + 1;
+        static const uint8_t  OP_OR             = MAX_INPUTS + 2;
+
+        /**
+         * @brief   Allocate a new input bit
+         * @param   idx Set to the index of the new input
+         * @return  Returns \em false if there are no more inputs available
+         */
+        bool addInput(uint8_t& idx);
+
+        /**
+         * @brief   Append an input index or an operator to the program
+         * @param   op An input index or one of the OP_* operators
+         */
+        void addOp(uint8_t op) { m_code.push_back(op); }
+
+        /**
+         * @brief   Get the number of allocated inputs
+         * @return  Returns the number of inputs
+         */
+        unsigned inputCount(void) const { return m_inputs; }
+
+        /**
+         * @brief   Build the truth table if there are few enough inputs
+         *
+         * Call this function when the whole program has been added.
+         */
+        void buildTable(void);
+
+        /**
+         * @brief   Run the program without using the truth table
+         * @param   state The input states, one bit per input
+         * @return  Returns the result of the expression
+         */
+        bool run(uint64_t state) const;
+
+        /**
+         * @brief   Evaluate the expression
+         * @param   state The input states, one bit per input
+         * @return  Returns the result of the expression
+         */
+        bool evaluate(uint64_t state) const
+        {
+          if (!m_table.empty())
+          {
+            return (m_table[state >> 6] >> (state & 63)) & 1;
+          }
+          return run(state);
+        }
+
+      private:
+        std::vector<uint8_t>  m_code;
+        std::vector<uint64_t> m_table;
+        unsigned              m_inputs = 0;
+    };
+
     /**
      * @brief   Default constructor
      */
@@ -207,10 +287,13 @@ class SquelchCombine : public Squelch
     struct OrOpNode;
     struct AndOpNode;
 
-    Tokens  m_tokens;
-    Node*   m_comb    = nullptr;
+    Tokens    m_tokens;
+    Node*     m_comb    = nullptr;
+    Program   m_prog;
+    uint64_t  m_state   = 0;
 
-    void onSquelchOpen(bool is_open);
+    void onInputChanged(uint8_t idx, bool is_open);
+    void updateSignalDetected(void);
     bool tokenize(const std::string& expr);
     Node* parseInstExpression(void);
     Node* parseUnaryOpExpression(void);
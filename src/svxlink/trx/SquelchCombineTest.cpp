@@ -0,0 +1,356 @@
+//
+// Fuzz test for the compiled squelch combiner expressions.
+//
+// Random SQL_COMBINE expressions are created using a test squelch detector
+// whose state is set directly by the test. Each expression is also kept as a
+// tree in the test, which is used as the reference. Two things are tested for
+// each expression:
+//
+//   - The expression tree is compiled into a SquelchCombine::Program by the
+//     test. The result of the truth table, if built, and of the bytecode
+//     interpreter is compared to the reference for random input states.
+//   - The expression is given to a SquelchCombine. The input states are
+//     changed randomly and the squelch state is compared to the reference.
+//     This is also done after a reset.
+//
+// Both the truth table (up to 16 inputs) and the bytecode interpreter (17 to
+// 64 inputs) are exercised.
+//
+// Usage: SquelchCombineTest [expressions] [seed]
+//
+
+#include <iostream>
+#include <sstream>
+#include <map>
+#include <vector>
+#include <cstdlib>
+#include <memory>
+
+#include <AsyncConfig.h>
+
+#include "SquelchCombine.h"
+
+using namespace std;
+using namespace Async;
+
+
+class SquelchFuzz : public Squelch
+{
+  public:
+    static constexpr const char* OBJNAME = "FUZZ";
+
+    typedef multimap<string, SquelchFuzz*> Instances;
+    static Instances instances;
+
+    ~SquelchFuzz(void)
+    {
+      for (auto it=instances.begin(); it!=instances.end(); ++it)
+      {
+        if (it->second == this)
+        {
+          instances.erase(it);
+          break;
+        }
+      }
+    }
+
+    virtual bool initialize(Async::Config& cfg, const std::string& rx_name)
+    {
+      instances.insert(make_pair(rx_name, this));
+      return Squelch::initialize(cfg, rx_name);
+    }
+
+    static void setState(const string& name, bool is_open)
+    {
+      auto range = instances.equal_range(name);
+      for (auto it=range.first; it!=range.second; ++it)
+      {
+        it->second->setSignalDetected(is_open);
+      }
+    }
+};
+
+SquelchFuzz::Instances SquelchFuzz::instances;
+
+
+  // A reference expression tree
+struct Expr
+{
+  enum Type { LEAF, NOT, AND, OR };
+
+  Type              type;
+  unsigned          name;
+  unique_ptr<Expr>  left;
+  unique_ptr<Expr>  right;
+
+  Expr(Type t, unsigned n=0) : type(t), name(n) {}
+
+  bool isOpen(const vector<bool>& names) const
+  {
+    switch (type)
+    {
+      case LEAF:
+        return names[name];
+      case NOT:
+        return !left->isOpen(names);
+      case AND:
+        return left->isOpen(names) && right->isOpen(names);
+      case OR:
+        return left->isOpen(names) || right->isOpen(names);
+    }
+    return false;
+  }
+
+    // Compile the tree the same way as SquelchCombine do, recording the
+    // name used by each input
+  bool compile(SquelchCombine::Program& prog, vector<unsigned>& inputs) const
+  {
+    switch (type)
+    {
+      case LEAF:
+      {
+        uint8_t idx;
+        if (!prog.addInput(idx))
+        {
+          return false;
+        }
+        inputs.push_back(name);
+        prog.addOp(idx);
+        return true;
+      }
+      case NOT:
+        if (!left->compile(prog, inputs))
+        {
+          return false;
+        }
+        prog.addOp(SquelchCombine::Program::OP_NOT);
+        return true;
+      case AND:
+      case OR:
+        if (!left->compile(prog, inputs) || !right->compile(prog, inputs))
+        {
+          return false;
+        }
+        prog.addOp((type == AND) ? SquelchCombine::Program::OP_AND
+                                 : SquelchCombine::Program::OP_OR);
+        return true;
+    }
+    return false;
+  }
+};
+
+
+class SquelchCombineTest
+{
+  public:
+    SquelchCombineTest(void) : m_leaves(0), m_max_leaves(0) {}
+
+    bool runExpression(unsigned names, unsigned max_leaves)
+    {
+      m_names = names;
+      m_leaves = 0;
+      m_max_leaves = max_leaves;
+      string expr;
+      unique_ptr<Expr> tree(orExpr(0, expr));
+
+      return testProgram(*tree, expr) && testSquelch(*tree, expr);
+    }
+
+    unsigned tested(bool interpreted) const { return m_tested[interpreted]; }
+
+  private:
+    unsigned  m_names;
+    unsigned  m_leaves;
+    unsigned  m_max_leaves;
+    unsigned  m_tested[2] = {0, 0};
+
+    bool testProgram(const Expr& tree, const string& expr)
+    {
+      SquelchCombine::Program prog;
+      vector<unsigned> inputs;
+      if (!tree.compile(prog, inputs))
+      {
+        cout << "*** Compilation failed for: " << expr << endl;
+        return false;
+      }
+      prog.buildTable();
+      if (prog.inputCount() != m_leaves)
+      {
+        cout << "*** Wrong input count for: " << expr << endl;
+        return false;
+      }
+
+      vector<bool> name_state(m_names);
+      for (unsigned step=0; step<200; ++step)
+      {
+        uint64_t state = 0;
+        for (unsigned i=0; i<m_names; ++i)
+        {
+          name_state[i] = rand() % 2;
+        }
+        for (unsigned idx=0; idx<inputs.size(); ++idx)
+        {
+          if (name_state[inputs[idx]])
+          {
+            state |= uint64_t(1) << idx;
+          }
+        }
+        const bool is_open = tree.isOpen(name_state);
+        if ((prog.evaluate(state) != is_open) ||
+            (prog.run(state) != is_open))
+        {
+          cout << "*** Program mismatch for expression: " << expr << endl;
+          return false;
+        }
+      }
+
+      ++m_tested[m_leaves > SquelchCombine::Program::MAX_TABLE_INPUTS];
+      return true;
+    }
+
+    bool testSquelch(const Expr& tree, const string& expr)
+    {
+      Config cfg;
+      for (unsigned i=0; i<m_names; ++i)
+      {
+        cfg.setValue(name(i), "SQL_DET", "FUZZ");
+      }
+      cfg.setValue("Rx", "SQL_COMBINE", expr);
+
+      SquelchCombine sql;
+      streambuf *cout_buf = cout.rdbuf(0);
+      bool init_ok = sql.initialize(cfg, "Rx");
+      cout.rdbuf(cout_buf);
+      if (!init_ok)
+      {
+        cout << "*** Initialization failed for: " << expr << endl;
+        return false;
+      }
+
+      vector<bool> name_state(m_names);
+      if (sql.isOpen() != tree.isOpen(name_state))
+      {
+        cout << "*** Wrong initial state for: " << expr << endl;
+        return false;
+      }
+      for (unsigned step=0; step<200; ++step)
+      {
+        const unsigned idx = rand() % m_names;
+        name_state[idx] = rand() % 2;
+        SquelchFuzz::setState(name(idx), name_state[idx]);
+        if (sql.isOpen() != tree.isOpen(name_state))
+        {
+          cout << "*** Mismatch for expression: " << expr << endl;
+          return false;
+        }
+      }
+
+      sql.reset();
+      name_state.assign(m_names, false);
+      if (sql.isOpen() != tree.isOpen(name_state))
+      {
+        cout << "*** Wrong state after reset for: " << expr << endl;
+        return false;
+      }
+
+      return true;
+    }
+
+    string name(unsigned i)
+    {
+      ostringstream ss;
+      ss << "Rx:SQL" << i;
+      return ss.str();
+    }
+
+    Expr* factor(unsigned depth, string& expr)
+    {
+      Expr *node = 0;
+      const bool neg = (rand() % 4 == 0);
+      if (neg)
+      {
+        expr += "!";
+      }
+      if ((depth < 4) && (rand() % 4 == 0) && (m_leaves + 2 <= m_max_leaves))
+      {
+        expr += "(";
+        node = orExpr(depth + 1, expr);
+        expr += ")";
+      }
+      else
+      {
+        ++m_leaves;
+        node = new Expr(Expr::LEAF, rand() % m_names);
+        expr += name(node->name);
+      }
+      if (neg)
+      {
+        Expr *not_node = new Expr(Expr::NOT);
+        not_node->left.reset(node);
+        node = not_node;
+      }
+      return node;
+    }
+
+    Expr* andExpr(unsigned depth, string& expr)
+    {
+      Expr *node = factor(depth, expr);
+      while ((m_leaves < m_max_leaves) && (rand() % 3 != 0))
+      {
+        expr += " & ";
+        Expr *and_node = new Expr(Expr::AND);
+        and_node->left.reset(node);
+        and_node->right.reset(factor(depth, expr));
+        node = and_node;
+      }
+      return node;
+    }
+
+    Expr* orExpr(unsigned depth, string& expr)
+    {
+      Expr *node = andExpr(depth, expr);
+      while ((m_leaves < m_max_leaves) && (rand() % 3 != 0))
+      {
+        expr += " | ";
+        Expr *or_node = new Expr(Expr::OR);
+        or_node->left.reset(node);
+        or_node->right.reset(andExpr(depth, expr));
+        node = or_node;
+      }
+      return node;
+    }
+};
+
+
+int main(int argc, const char **argv)
+{
+  unsigned expressions = 2000;
+  unsigned seed = 1;
+  if (argc > 1)
+  {
+    expressions = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    seed = atoi(argv[2]);
+  }
+  srand(seed);
+
+  static SquelchSpecificFactory<SquelchFuzz> fuzz_factory;
+
+  SquelchCombineTest test;
+  for (unsigned i=0; i<expressions; ++i)
+  {
+    const unsigned names = 1 + rand() % 32;
+    const unsigned max_leaves = 1 + rand() % 64;
+    if (!test.runExpression(names, max_leaves))
+    {
+      exit(1);
+    }
+  }
+
+  cout << "OK: " << test.tested(false) << " truth table and "
+       << test.tested(true) << " interpreted expressions tested" << endl;
+
+  return 0;
+}
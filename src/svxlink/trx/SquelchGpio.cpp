@@ -47,6 +47,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <AsyncTimer.h>
+#include <AsyncFdWatch.h>
 
 
 /****************************************************************************
@@ -118,9 +119,11 @@ using namespace Async;
  ****************************************************************************/
 
 SquelchGpio::SquelchGpio(void)
-  : fd(-1), timer(0), active_low(false), gpio_path("/sys/class/gpio")
+  : fd(-1), timer(0), watch(0), debounce_timer(0), active_low(false),
+    gpio_path("/sys/class/gpio"), debounce(0)
 {
-  
+  last_change.tv_sec = 0;
+  last_change.tv_nsec = 0;
 } /* SquelchGpio::SquelchGpio */
 
 
@@ -128,6 +131,10 @@ SquelchGpio::~SquelchGpio(void)
 {
   delete timer;
   timer = 0;
+  delete watch;
+  watch = 0;
+  delete debounce_timer;
+  debounce_timer = 0;
   if (fd >= 0)
   {
     close(fd);
@@ -159,20 +166,45 @@ bool SquelchGpio::initialize(Async::Config& cfg, const std::string& rx_name)
     sql_pin.erase(0, 1);
   }
 
-  stringstream ss;
-  ss << gpio_path << "/" << sql_pin << "/value";
-  fd = open(ss.str().c_str(), O_RDONLY);
+  cfg.getValue(rx_name, "GPIO_SQL_DEBOUNCE", debounce);
+  if (debounce > 0)
+  {
+    debounce_timer = new Timer(debounce);
+    debounce_timer->setEnable(false);
+    debounce_timer->expired.connect(
+        hide(mem_fun(*this, &SquelchGpio::readGpioValueData)));
+  }
+
+  const string pin_path(gpio_path + "/" + sql_pin);
+  const string value_path(pin_path + "/value");
+  fd = open(value_path.c_str(), O_RDONLY);
   if (fd < 0)
   {
-    cerr << "*** ERROR: Could not open GPIO device " << ss.str()
+    cerr << "*** ERROR: Could not open GPIO device " << value_path
          << " specified in " << rx_name << "/GPIO_SQL_PIN: "
          << strerror(errno) << endl;
     return false;
   }
 
-  timer = new Timer(100, Timer::TYPE_PERIODIC);
-  timer->expired.connect(
-      hide(mem_fun(*this, &SquelchGpio::readGpioValueData)));
+    // Prefer to be notified by the kernel on pin changes. If the pin does
+    // not support edge detection, fall back to polling the pin value.
+  if (enableEdgeDetection(pin_path))
+  {
+    watch = new FdWatch(fd, FdWatch::FD_WATCH_PRI);
+    watch->activity.connect(
+        hide(mem_fun(*this, &SquelchGpio::readGpioValueData)));
+  }
+  else
+  {
+    cerr << "*** WARNING: Edge detection could not be enabled for GPIO pin "
+         << pin_path << " specified in " << rx_name << "/GPIO_SQL_PIN. "
+         << "Falling back to polling the pin every 100ms." << endl;
+    timer = new Timer(100, Timer::TYPE_PERIODIC);
+    timer->expired.connect(
+        hide(mem_fun(*this, &SquelchGpio::readGpioValueData)));
+  }
+
+  readGpioValueData();
 
   return true;
 }
@@ -194,7 +226,51 @@ bool SquelchGpio::initialize(Async::Config& cfg, const std::string& rx_name)
  ****************************************************************************/
 
 /**
- * @brief  Called by a timer to periodically read the state of the GPIO pin
+ * @brief  Make the kernel notify us when the GPIO pin change state
+ *
+ * Writing "both" to the edge attribute of the pin will make the kernel
+ * signal an exceptional condition (POLLPRI) on the value file descriptor each
+ * time the pin change state. If we are not allowed to write the edge
+ * attribute it may already have been set up, e.g. by the svxlink_gpio_up
+ * script, so also accept that.
+ */
+bool SquelchGpio::enableEdgeDetection(const std::string& pin_path)
+{
+  const string edge_path(pin_path + "/edge");
+  int edge_fd = open(edge_path.c_str(), O_WRONLY);
+  if (edge_fd >= 0)
+  {
+    const char both[] = "both";
+    ssize_t cnt = write(edge_fd, both, sizeof(both) - 1);
+    close(edge_fd);
+    if (cnt == static_cast<ssize_t>(sizeof(both) - 1))
+    {
+      return true;
+    }
+  }
+
+  edge_fd = open(edge_path.c_str(), O_RDONLY);
+  if (edge_fd < 0)
+  {
+    return false;
+  }
+  char edge[8];
+  ssize_t cnt = read(edge_fd, edge, sizeof(edge) - 1);
+  close(edge_fd);
+  if (cnt <= 0)
+  {
+    return false;
+  }
+  edge[cnt] = '\0';
+  return (strncmp(edge, "both", 4) == 0);
+} /* SquelchGpio::enableEdgeDetection */
+
+
+/**
+ * @brief  Read the state of the GPIO pin
+ *
+ * This function is called when the kernel signal an edge on the GPIO pin or,
+ * if edge detection is not available, periodically by a timer.
  *
  * An example of reading a GPIO ports can be found at:
  * http://elinux.org/RPi_Low-level_peripherals#C_.2B_sysfs
@@ -229,10 +305,32 @@ void SquelchGpio::readGpioValueData(void)
   }
 
   bool is_active = active_low ^ (value == '1');
-  if (signalDetected() != is_active)
+  if (signalDetected() == is_active)
   {
-    setSignalDetected(is_active);
+    return;
   }
+
+    // Debounce by ignoring changes that occur too soon after the last
+    // accepted change. The first edge is acted upon immediately so that no
+    // extra delay is added. The pin is read again when the debounce time
+    // has passed so that the final state is not missed.
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  if (debounce > 0)
+  {
+    long elapsed = (now.tv_sec - last_change.tv_sec) * 1000 +
+                   (now.tv_nsec - last_change.tv_nsec) / 1000000;
+    if ((elapsed >= 0) && (elapsed < static_cast<long>(debounce)))
+    {
+      debounce_timer->setEnable(false);
+      debounce_timer->setTimeout(debounce - elapsed);
+      debounce_timer->setEnable(true);
+      return;
+    }
+  }
+
+  last_change = now;
+  setSignalDetected(is_active);
 } /* SquelchGpio::readGpioValueData */
 
 
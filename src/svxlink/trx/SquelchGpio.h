@@ -35,6 +35,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <string>
+#include <ctime>
 
 
 /****************************************************************************
@@ -63,6 +64,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 namespace Async
 {
   class Timer;
+  class FdWatch;
 };
 
 
@@ -142,13 +144,18 @@ class SquelchGpio : public Squelch
   protected:
 
   private:
-    int           fd;
-    Async::Timer  *timer;
-    bool          active_low;
-    std::string   gpio_path;
+    int             fd;
+    Async::Timer    *timer;
+    Async::FdWatch  *watch;
+    Async::Timer    *debounce_timer;
+    bool            active_low;
+    std::string     gpio_path;
+    unsigned        debounce;
+    struct timespec last_change;
 
     SquelchGpio(const SquelchGpio&);
     SquelchGpio& operator=(const SquelchGpio&);
+    bool enableEdgeDetection(const std::string& pin_path);
     void readGpioValueData(void);
 
 };  /* class SquelchGpio */
@@ -0,0 +1,268 @@
+//
+// Test for the sysfs GPIO squelch detector using a fake GPIO directory.
+//
+// A temporary directory is set up to look like the sysfs GPIO directory,
+// with a pin directory containing a value file and, for some test cases, an
+// edge file. The test then change the value file and check that the squelch
+// detector follow the pin state the way it should. The following is tested:
+//
+//   - Edge detection is enabled by writing "both" to the edge attribute
+//   - The initial pin state is read, also for active low pins
+//   - When edge detection is enabled the value file is not polled, i.e.
+//     there are no periodic wakeups
+//   - Without an edge attribute the detector fall back to polling the value
+//     file
+//   - With GPIO_SQL_DEBOUNCE set, a change within the debounce time of the
+//     last accepted change is postponed until the debounce time has passed,
+//     while the first change is acted upon directly
+//
+// A regular file can not signal an exceptional condition, like the sysfs
+// value file does on a pin edge, so the edge triggered read itself is not
+// covered. It use the same read and debounce code as the polling mode.
+//
+// Usage: SquelchGpioTest
+//
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <AsyncCppApplication.h>
+#include <AsyncConfig.h>
+#include <AsyncTimer.h>
+
+#include "SquelchGpio.h"
+
+using namespace std;
+using namespace Async;
+
+
+namespace {
+
+  // Expose the detector state without going through the audio pipe
+class TestSquelchGpio : public SquelchGpio
+{
+  public:
+    using Squelch::signalDetected;
+};
+
+class FakeGpio
+{
+  public:
+    FakeGpio(const string& dir, const string& pin, bool with_edge)
+      : m_pin_path(dir + "/" + pin)
+    {
+      mkdir(m_pin_path.c_str(), 0700);
+      setValue(false);
+      if (with_edge)
+      {
+        ofstream(m_pin_path + "/edge") << "none" << endl;
+      }
+    }
+
+    ~FakeGpio(void)
+    {
+      unlink((m_pin_path + "/value").c_str());
+      unlink((m_pin_path + "/edge").c_str());
+      rmdir(m_pin_path.c_str());
+    }
+
+    void setValue(bool high)
+    {
+      ofstream(m_pin_path + "/value") << (high ? "1" : "0") << endl;
+    }
+
+    string edge(void) const
+    {
+      string edge;
+      ifstream(m_pin_path + "/edge") >> edge;
+      return edge;
+    }
+
+  private:
+    string m_pin_path;
+};
+
+class SquelchGpioTest
+{
+  public:
+    SquelchGpioTest(void) : m_failures(0)
+    {
+      char dir[] = "/tmp/SquelchGpioTest-XXXXXX";
+      if (mkdtemp(dir) == 0)
+      {
+        cerr << "*** ERROR: Could not create the fake GPIO directory: "
+             << strerror(errno) << endl;
+        exit(1);
+      }
+      m_dir = dir;
+    }
+
+    ~SquelchGpioTest(void)
+    {
+      m_timers.clear();
+      m_sql.clear();
+      m_gpio.clear();
+      rmdir(m_dir.c_str());
+    }
+
+    FakeGpio* addPin(const string& pin, bool with_edge)
+    {
+      m_gpio.emplace_back(new FakeGpio(m_dir, pin, with_edge));
+      return m_gpio.back().get();
+    }
+
+    TestSquelchGpio* addSquelch(const string& pin, unsigned debounce=0)
+    {
+      Config cfg;
+      cfg.setValue("Rx", "GPIO_PATH", m_dir);
+      cfg.setValue("Rx", "GPIO_SQL_PIN", pin);
+      if (debounce > 0)
+      {
+        cfg.setValue("Rx", "GPIO_SQL_DEBOUNCE", debounce);
+      }
+      TestSquelchGpio *sql = new TestSquelchGpio;
+      m_sql.emplace_back(sql);
+      if (!sql->initialize(cfg, "Rx"))
+      {
+        fail("SquelchGpio::initialize failed for pin " + pin);
+      }
+      return sql;
+    }
+
+      // Run a function the given number of milliseconds after start
+    void at(unsigned ms, function<void(void)> func)
+    {
+      Timer *timer = new Timer(max(ms, 1U));
+      timer->expired.connect([func](Timer*) { func(); });
+      m_timers.emplace_back(timer);
+    }
+
+    void check(bool ok, const string& what)
+    {
+      if (!ok)
+      {
+        fail(what);
+      }
+    }
+
+    void fail(const string& what)
+    {
+      cerr << "*** ERROR: " << what << endl;
+      ++m_failures;
+    }
+
+    unsigned failures(void) const { return m_failures; }
+
+  private:
+    string                          m_dir;
+    vector<unique_ptr<FakeGpio> >   m_gpio;
+    vector<unique_ptr<SquelchGpio> > m_sql;
+    vector<unique_ptr<Timer> >      m_timers;
+    unsigned                        m_failures;
+};
+
+long nowMs(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+} /* anonymous namespace */
+
+
+int main(int argc, const char **argv)
+{
+  CppApplication app;
+  SquelchGpioTest test;
+
+    // Edge detection is enabled and the initial state is read
+  FakeGpio *edge_pin = test.addPin("gpio1", true);
+  TestSquelchGpio *edge_sql = test.addSquelch("gpio1");
+  test.check(edge_pin->edge() == "both",
+             "The edge attribute was not set to \"both\"");
+  test.check(!edge_sql->signalDetected(),
+             "The squelch is open for a low pin");
+
+  FakeGpio *low_pin = test.addPin("gpio2", true);
+  low_pin->setValue(false);
+  TestSquelchGpio *low_sql = test.addSquelch("!gpio2");
+  test.check(low_sql->signalDetected(),
+             "The squelch is closed for an active low pin that is low");
+
+    // With edge detection enabled the value file must not be polled
+  test.at(10, [=]() { edge_pin->setValue(true); });
+  test.at(400, [=, &test]() {
+      test.check(!edge_sql->signalDetected(),
+                 "The value file was polled although edge detection is "
+                 "enabled");
+    });
+
+    // Without an edge attribute the detector fall back to polling
+  FakeGpio *poll_pin = test.addPin("gpio3", false);
+  TestSquelchGpio *poll_sql = test.addSquelch("gpio3");
+  test.at(10, [=]() { poll_pin->setValue(true); });
+  test.at(250, [=, &test]() {
+      test.check(poll_sql->signalDetected(),
+                 "The squelch did not open when polling the value file");
+      poll_pin->setValue(false);
+    });
+  test.at(500, [=, &test]() {
+      test.check(!poll_sql->signalDetected(),
+                 "The squelch did not close when polling the value file");
+    });
+
+    // Debounce. The first edge is accepted directly, the edge that follow
+    // within the debounce time is postponed until the time has passed.
+  const unsigned debounce = 400;
+  FakeGpio *deb_pin = test.addPin("gpio4", false);
+  TestSquelchGpio *deb_sql = test.addSquelch("gpio4", debounce);
+  auto opened = make_shared<long>(0);
+  auto closed = make_shared<long>(0);
+  Timer sample_timer(5, Timer::TYPE_PERIODIC);
+  sample_timer.expired.connect([=](Timer*) {
+      if ((*opened == 0) && deb_sql->signalDetected())
+      {
+        *opened = nowMs();
+      }
+      if ((*opened != 0) && (*closed == 0) && !deb_sql->signalDetected())
+      {
+        *closed = nowMs();
+      }
+    });
+  const long start = nowMs();
+  test.at(10, [=]() { deb_pin->setValue(true); });
+  test.at(160, [=]() { deb_pin->setValue(false); });
+  test.at(1000, [=, &test]() {
+      test.check(*opened != 0, "The debounced squelch never opened");
+      test.check(*opened - start <= 10 + 100 + 50,
+                 "The first edge was delayed by the debounce");
+      test.check(*closed != 0, "The debounced squelch never closed");
+      test.check(*closed - *opened >= static_cast<long>(debounce) - 10,
+                 "The squelch closed within the debounce time: " +
+                 to_string(*closed - *opened) + "ms");
+      test.check(*closed - *opened <= static_cast<long>(debounce) + 150,
+                 "The postponed edge was not picked up after the debounce "
+                 "time: " + to_string(*closed - *opened) + "ms");
+    });
+
+  test.at(1100, [&app]() { app.quit(); });
+  app.exec();
+
+  if (test.failures() > 0)
+  {
+    return 1;
+  }
+  cout << "OK" << endl;
+  return 0;
+}
@@ -107,15 +107,23 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 SquelchGpiod::SquelchGpiod(void)
-  : m_timer(100, Async::Timer::TYPE_PERIODIC)
+  : m_timer(100, Async::Timer::TYPE_PERIODIC, false),
+    m_debounce_timer(0, Async::Timer::TYPE_ONESHOT, false)
 {
+  m_timer.expired.connect(
+      sigc::hide(sigc::mem_fun(*this, &SquelchGpiod::readGpioValueData)));
+  m_debounce_timer.expired.connect(
+      sigc::hide(sigc::mem_fun(*this, &SquelchGpiod::readGpioValueData)));
+  m_watch.activity.connect(
+      sigc::hide(sigc::mem_fun(*this, &SquelchGpiod::readGpioEventData)));
 } /* SquelchGpiod::SquelchGpiod */
 
 
 SquelchGpiod::~SquelchGpiod(void)
 {
   m_timer.setEnable(false);
-  //m_watch.setEnabled(false);
+  m_debounce_timer.setEnable(false);
+  m_watch.setEnabled(false);
 
   if (m_line != nullptr)
   {
@@ -141,10 +149,11 @@ bool SquelchGpiod::initialize(Async::Config& cfg, const std::string& rx_name)
   std::string chip("gpiochip0");
   cfg.getValue(rx_name, "SQL_GPIOD_CHIP", chip);
 
+  cfg.getValue(rx_name, "SQL_GPIOD_DEBOUNCE", m_debounce);
+
   struct gpiod_line_request_config req_cfg;
   req_cfg.consumer = "SvxLink";
-  //req_cfg.request_type = GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES;
-  req_cfg.request_type = GPIOD_LINE_REQUEST_DIRECTION_INPUT;
+  req_cfg.request_type = GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES;
   req_cfg.flags = 0;
 
   std::string line;
@@ -224,42 +233,46 @@ bool SquelchGpiod::initialize(Async::Config& cfg, const std::string& rx_name)
     return false;
   }
 
+  m_line_name = line;
+
+    // Prefer to get edge events from the kernel. Not all GPIO chips are
+    // able to generate interrupts though so fall back to polling the pin
+    // if the event request fail.
+  int fd = -1;
   int ret = gpiod_line_request(m_line, &req_cfg, 0);
-  if (ret < 0)
+  if (ret == 0)
   {
-    std::cerr << "*** ERROR: Set GPIOD line \"" << line_num
-              << "\" to input failed for RX \"" << rx_name << "\": "
-              << std::strerror(errno) << std::endl;
-    return false;
+    fd = gpiod_line_event_get_fd(m_line);
+    if (fd < 0)
+    {
+      gpiod_line_release(m_line);
+    }
   }
-
-#if 0
-  int fd = gpiod_line_event_get_fd(m_line);
   if (fd < 0)
   {
-    std::cerr << "*** ERROR: Retrieve GPIOD line \"" << line_num
-              << "\" file descriptor failed for RX \"" << rx_name << "\": "
-              << std::strerror(errno) << std::endl;
-    return false;
+    std::cerr << "*** WARNING: Edge events not available for GPIOD line \""
+              << line << "\" for RX \"" << rx_name << "\": "
+              << std::strerror(errno)
+              << ". Falling back to polling the line every 100ms."
+              << std::endl;
+    req_cfg.request_type = GPIOD_LINE_REQUEST_DIRECTION_INPUT;
+    ret = gpiod_line_request(m_line, &req_cfg, 0);
+    if (ret < 0)
+    {
+      std::cerr << "*** ERROR: Set GPIOD line \"" << line
+                << "\" to input failed for RX \"" << rx_name << "\": "
+                << std::strerror(errno) << std::endl;
+      return false;
+    }
+    m_timer.setEnable(true);
+  }
+  else
+  {
+    m_watch.setFd(fd, Async::FdWatch::FD_WATCH_RD);
+    m_watch.setEnabled(true);
   }
 
-  m_watch.activity.connect(
-      hide(mem_fun(*this, &SquelchGpiod::readGpioValueData)));
-  m_watch.setFd(fd, Async::FdWatch::FD_WATCH_RD);
-  m_watch.setEnabled(true);
-#endif
-
-  m_timer.expired.connect([&](Async::Timer*) {
-        int val = gpiod_line_get_value(m_line);
-        if (val < 0)
-        {
-          std::cerr << "*** WARNING: Read GPIOD line \"" << line_num
-                    << "\" failed for RX \"" << rx_name << "\": "
-                    << std::strerror(errno) << std::endl;
-          return;
-        }
-        setSignalDetected(val > 0);
-      });
+  readGpioValueData();
 
   return true;
 } /* SquelchGpiod::initialize */
@@ -271,30 +284,66 @@ bool SquelchGpiod::initialize(Async::Config& cfg, const std::string& rx_name)
  *
  ****************************************************************************/
 
-#if 0
-void SquelchGpiod::readGpioValueData(void)
+/**
+ * @brief  Called when there are edge events available on the GPIO line
+ *
+ * The event is only read to acknowledge it. The line value is then read to
+ * get the logical state since that take the active low setting into account.
+ */
+void SquelchGpiod::readGpioEventData(void)
 {
   struct gpiod_line_event event;
   int ret = gpiod_line_event_read_fd(m_watch.fd(), &event);
   if (ret < 0)
   {
-    std::cerr << "*** WARNING: SquelchGpiod::readGpioValueData: "
-                 "gpiod_line_event_read failed: "
+    std::cerr << "*** WARNING: SquelchGpiod::readGpioEventData: "
+                 "gpiod_line_event_read_fd failed for RX \"" << rxName()
+              << "\": " << std::strerror(errno) << std::endl;
+    return;
+  }
+  readGpioValueData();
+} /* SquelchGpiod::readGpioEventData */
+
+
+void SquelchGpiod::readGpioValueData(void)
+{
+  int val = gpiod_line_get_value(m_line);
+  if (val < 0)
+  {
+    std::cerr << "*** WARNING: Read GPIOD line \"" << m_line_name
+              << "\" failed for RX \"" << rxName() << "\": "
               << std::strerror(errno) << std::endl;
     return;
   }
 
-  int event_type = event.event_type;
-  if (event_type == GPIOD_LINE_EVENT_RISING_EDGE)
+  bool is_active = (val > 0);
+  if (signalDetected() == is_active)
   {
-    setSignalDetected(true);
+    return;
   }
-  else if (event_type == GPIOD_LINE_EVENT_FALLING_EDGE)
+
+    // Debounce by ignoring changes that occur too soon after the last
+    // accepted change. The first edge is acted upon immediately. The line is
+    // read again when the debounce time has passed so that the final state
+    // is not missed.
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  if (m_debounce > 0)
   {
-    setSignalDetected(false);
+    long elapsed = (now.tv_sec - m_last_change.tv_sec) * 1000 +
+                   (now.tv_nsec - m_last_change.tv_nsec) / 1000000;
+    if ((elapsed >= 0) && (elapsed < static_cast<long>(m_debounce)))
+    {
+      m_debounce_timer.setEnable(false);
+      m_debounce_timer.setTimeout(m_debounce - elapsed);
+      m_debounce_timer.setEnable(true);
+      return;
+    }
   }
+
+  m_last_change = now;
+  setSignalDetected(is_active);
 } /* SquelchGpiod::readGpioValueData */
-#endif
 
 
 /*
@@ -36,6 +36,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <gpiod.h>
 #include <string>
+#include <ctime>
 
 
 /****************************************************************************
@@ -44,7 +45,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
-//#include <AsyncFdWatch.h>
+#include <AsyncFdWatch.h>
 #include <AsyncTimer.h>
 
 
@@ -139,11 +140,16 @@ class SquelchGpiod : public Squelch
 
   private:
     Async::Timer        m_timer;
-    //Async::FdWatch      m_watch;
+    Async::Timer        m_debounce_timer;
+    Async::FdWatch      m_watch;
     struct gpiod_chip*  m_chip  = nullptr;
     struct gpiod_line*  m_line  = nullptr;
+    std::string         m_line_name;
+    unsigned            m_debounce = 0;
+    struct timespec     m_last_change = {0, 0};
 
-    //void readGpioValueData(void);
+    void readGpioEventData(void);
+    void readGpioValueData(void);
 
 };  /* class SquelchGpiod */
 
@@ -44,6 +44,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <AsyncMetrics.h>
 
 
 /****************************************************************************
@@ -242,6 +243,7 @@ void Tx::setIsTransmitting(bool is_transmitting)
            << (is_transmitting ? "ON" : "OFF") << endl;
     }
     m_is_transmitting = is_transmitting;
+    updateMetrics();
     transmitterStateChange(is_transmitting);
 
     char tx_id = id();
@@ -272,6 +274,36 @@ void Tx::setIsTransmitting(bool is_transmitting)
  *
  ****************************************************************************/
 
+void Tx::updateMetrics(void)
+{
+    // The metrics are looked up once, on the first transmitter state change
+  if (m_tx_gauge == 0)
+  {
+    MetricsRegistry& metrics = MetricsRegistry::instance();
+    const MetricsRegistry::Labels labels = {{"tx", name()}};
+    m_tx_gauge = &metrics.gauge("svxlink_tx_transmitting",
+        "Set to 1 when the transmitter is on", labels);
+    m_tx_cnt = &metrics.counter("svxlink_tx_transmissions_total",
+        "Number of times the transmitter has been turned on", labels);
+    m_tx_time_cnt = &metrics.counter("svxlink_tx_transmit_seconds_total",
+        "Time that the transmitter has been on", labels, 1.0e-6);
+  }
+
+  m_tx_gauge->set(m_is_transmitting ? 1.0 : 0.0);
+  auto now = std::chrono::steady_clock::now();
+  if (m_is_transmitting)
+  {
+    m_tx_cnt->inc();
+    m_tx_on_time = now;
+  }
+  else
+  {
+    auto on_time = std::chrono::duration_cast<std::chrono::microseconds>(
+        now - m_tx_on_time);
+    m_tx_time_cnt->inc(on_time.count());
+  }
+} /* Tx::updateMetrics */
+
 
 
 /*
@@ -40,6 +40,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <string>
 #include <vector>
+#include <chrono>
 
 
 /****************************************************************************
@@ -67,6 +68,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+namespace Async
+{
+  class MetricGauge;
+  class MetricCounter;
+};
 
 
 /****************************************************************************
@@ -137,7 +143,8 @@ class Tx : public sigc::trackable, public Async::AudioSink
      */
     Tx(std::string tx_name)
       : m_name(tx_name), m_tx_id('\0'), m_verbose(true),
-        m_is_transmitting(false)
+        m_is_transmitting(false), m_tx_gauge(0), m_tx_cnt(0),
+        m_tx_time_cnt(0)
     {
     }
   
@@ -276,6 +283,12 @@ class Tx : public sigc::trackable, public Async::AudioSink
     char        m_tx_id;
     bool        m_verbose;
     bool        m_is_transmitting;
+    std::chrono::steady_clock::time_point m_tx_on_time;
+    Async::MetricGauge*   m_tx_gauge;
+    Async::MetricCounter* m_tx_cnt;
+    Async::MetricCounter* m_tx_time_cnt;
+
+    void updateMetrics(void);
 
 };  /* class Tx */
 
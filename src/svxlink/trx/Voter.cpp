@@ -649,6 +649,7 @@ void Voter::dispatchEvent(Macho::IEvent<Top> *event)
 
 void Voter::satSquelchOpen(bool is_open, SatRx *srx)
 {
+  receiverSquelchOpen(srx->name(), is_open);
   if (m_print_sat_squelch)
   {
     std::cout << name() << "[" << srx->name() << "]"
@@ -671,6 +672,7 @@ void Voter::satSignalLevelUpdated(float siglev, SatRx *srx)
 {
   if (srx->isEnabled())
   {
+    receiverSignalLevelUpdated(srx->name(), siglev);
     dispatchEvent(Macho::Event(&Top::satSignalLevelUpdated, srx, siglev));
   }
 } /* Voter::satSignalLevelUpdated */
@@ -57,6 +57,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "WbRxRtlSdr.h"
 #include "RtlTcp.h"
+#include "RtlFile.h"
 #ifdef HAS_RTLSDR_SUPPORT
 #include "RtlUsb.h"
 #endif
@@ -113,7 +114,8 @@ using namespace std;
  *
  ****************************************************************************/
 
-WbRxRtlSdr::InstanceMap WbRxRtlSdr::instances;
+  // Receivers can only share a dongle within one thread
+thread_local WbRxRtlSdr::InstanceMap WbRxRtlSdr::instances;
 
 
 /****************************************************************************
@@ -162,6 +164,30 @@ WbRxRtlSdr::WbRxRtlSdr(Async::Config &cfg, const string &name)
     rtl = new RtlUsb(dev_match);
   }
 #endif
+  else if (rtl_type == "RtlFile")
+  {
+    string path;
+    if (!cfg.getValue(name, "FILE", path))
+    {
+      cerr << "*** ERROR: Config variable " << name
+           << "/FILE not set\n";
+      exit(1);
+    }
+    string format_str = "cu8";
+    cfg.getValue(name, "FILE_FORMAT", format_str);
+    RtlFile::Format format;
+    if (!RtlFile::formatFromString(format_str, format))
+    {
+      cerr << "*** ERROR: Unknown file format in config variable " << name
+           << "/FILE_FORMAT: " << format_str << endl;
+      exit(1);
+    }
+    bool realtime = true;
+    cfg.getValue(name, "REALTIME", realtime);
+    bool loop = true;
+    cfg.getValue(name, "LOOP", loop);
+    rtl = new RtlFile(path, format, realtime, loop);
+  }
   else
   {
     cerr << "*** ERROR: Unknown WbRx type: " << rtl_type << endl;
@@ -201,9 +201,9 @@ class WbRxRtlSdr : public sigc::trackable
      *
      * Connecting to this signal is the way to get samples from the DVB-T
      * dongle. The format is a vector of complex floats (I/Q) with a range from
-     * -1 to 1.
+     * -1 to 1. The vector is only valid during the call.
      */
-    sigc::signal<void, std::vector<Sample> > iqReceived;
+    sigc::signal<void, const std::vector<Sample>&> iqReceived;
     
     /**
      * @brief   A signal that is emitted when the ready state changes
@@ -216,7 +216,7 @@ class WbRxRtlSdr : public sigc::trackable
     typedef std::map<std::string, WbRxRtlSdr*> InstanceMap;
     typedef std::set<Ddr*> Ddrs;
 
-    static InstanceMap instances;
+    static thread_local InstanceMap instances;
 
     RtlSdr *rtl;
     Ddrs ddrs;